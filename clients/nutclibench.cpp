@@ -0,0 +1,389 @@
+/* nutclibench - measure the listing cost of the nutclient C++ library
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "nutclient.h"
+
+#include <iostream>
+#include <new>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+/* Count the allocations done by the library, through operator new.
+ * Atomically, since the library may run an I/O thread. */
+static unsigned long allocations = 0;
+
+void* operator new(size_t size)throw(std::bad_alloc)
+{
+	__sync_fetch_and_add(&allocations, 1);
+	void* ptr = malloc(size ? size : 1);
+	if(!ptr)
+	{
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void operator delete(void* ptr)throw()
+{
+	free(ptr);
+}
+
+static void usage(const char* prog)
+{
+	printf("Network UPS Tools nutclibench\n\n");
+	printf("usage: %s [-n <count>] <ups>\n", prog);
+	printf("       %s -s [-n <count>] <hostname>[:<port>]\n", prog);
+	printf("       %s -t <threads> [-n <count>] <ups>\n", prog);
+	printf("       %s -c [-n <count>] <ups>\n\n", prog);
+	printf("Measure the time, CPU and allocations taken by <count> listings of\n");
+	printf("the variables of a UPS with the nutclient library, for UPSes with\n");
+	printf("many variables.\n");
+	printf("With -s, measure <count> snapshots of the variables of all the UPSes\n");
+	printf("of the server instead, one UPS at a time, then pipelined.\n");
+	printf("With -t, measure <count> reads of ups.status by each of <threads>\n");
+	printf("threads sharing a client, synchronous then asynchronous.\n");
+	printf("With -c, measure <count> refreshes of a UPS status display, without\n");
+	printf("then with a cache.\n\n");
+	printf("  -c           - benchmark a client cache\n");
+	printf("  -s           - benchmark snapshots of all the UPSes\n");
+	printf("  -t <threads> - benchmark a client shared between threads\n");
+	printf("  -n <count>   - number of listings, snapshots, reads or refreshes\n");
+	printf("                 (default: 100)\n");
+	printf("  <ups>        - upsd server, <upsname>[@<hostname>[:<port>]] form\n");
+}
+
+static double now(void)
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static double cputime(void)
+{
+	struct rusage ru;
+	getrusage(RUSAGE_SELF, &ru);
+	return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1000000.0 +
+		ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1000000.0;
+}
+
+static void report(const char* mode, unsigned int count, size_t vars,
+	double start, double cpu, unsigned long allocs)
+{
+	double time = now() - start;
+	printf("%-24s %8u %8lu %10.3f %10.3f %12.0f\n", mode, count,
+		(unsigned long)vars, time, cputime() - cpu, (double)allocs / count);
+}
+
+/* Values of all the variables of all the devices, one device at a time,
+ * then with the pipelined batch method. */
+static void bench_snapshot(nut::TcpClient& client, unsigned int count)
+{
+	std::set<std::string> devs = client.getDeviceNames();
+	double start, cpu;
+	unsigned long allocs;
+	size_t vars = 0;
+
+	printf("%-24s %8s %8s %10s %10s %12s\n", "mode", "count", "devices", "time(s)", "cpu(s)", "allocs/snap");
+
+	start = now();
+	cpu = cputime();
+	allocs = allocations;
+	for(unsigned int n = 0; n < count; n++)
+	{
+		std::map<std::string,std::map<std::string,std::vector<std::string> > > snap;
+		for(std::set<std::string>::iterator it = devs.begin(); it != devs.end(); ++it)
+		{
+			snap[*it] = client.getDeviceVariableValues(*it);
+		}
+		vars = snap.size();
+	}
+	report("per device", count, vars, start, cpu, allocations - allocs);
+
+	start = now();
+	cpu = cputime();
+	allocs = allocations;
+	for(unsigned int n = 0; n < count; n++)
+	{
+		vars = client.getDevicesVariableValues(devs).size();
+	}
+	report("getDevicesVariableValues", count, vars, start, cpu, allocations - allocs);
+}
+
+#ifdef HAVE_PTHREAD
+
+/* Client shared by the threads of bench_threads(). */
+struct shared_client
+{
+	nut::TcpClient* client;
+	nut::AsyncTcpClient* async;
+	pthread_mutex_t lock;
+	std::string ups;
+	unsigned int count;
+	bool failed;
+};
+
+static void* bench_thread(void* arg)
+{
+	shared_client* shared = (shared_client*)arg;
+
+	try
+	{
+		for(unsigned int n = 0; n < shared->count; n++)
+		{
+			if(shared->async)
+			{
+				shared->async->getDeviceVariableValue(shared->ups, "ups.status").get();
+			}
+			else
+			{
+				pthread_mutex_lock(&shared->lock);
+				shared->client->getDeviceVariableValue(shared->ups, "ups.status");
+				pthread_mutex_unlock(&shared->lock);
+			}
+		}
+	}
+	catch(nut::NutException& ex)
+	{
+		if(!shared->async)
+		{
+			pthread_mutex_unlock(&shared->lock);
+		}
+		std::cerr << "Error: " << ex.what() << std::endl;
+		shared->failed = true;
+	}
+	return NULL;
+}
+
+static void run_threads(const char* mode, shared_client& shared, unsigned int threads)
+{
+	std::vector<pthread_t> tids(threads);
+	double start = now(), cpu = cputime();
+
+	for(unsigned int n = 0; n < threads; n++)
+	{
+		pthread_create(&tids[n], NULL, bench_thread, &shared);
+	}
+	for(unsigned int n = 0; n < threads; n++)
+	{
+		pthread_join(tids[n], NULL);
+	}
+
+	double time = now() - start;
+	printf("%-24s %8u %8u %10.3f %10.3f %12.0f\n", mode, shared.count, threads,
+		time, cputime() - cpu, shared.count * threads / time);
+}
+
+/* Reads by several threads sharing a synchronous client, which must be
+ * locked, then sharing an asynchronous one. */
+static void bench_threads(const std::string& host, int port, const std::string& ups,
+	unsigned int threads, unsigned int count)
+{
+	nut::TcpClient client(host, port);
+	nut::AsyncTcpClient async(host, port);
+	shared_client shared;
+
+	shared.client = &client;
+	shared.async = NULL;
+	pthread_mutex_init(&shared.lock, NULL);
+	shared.ups = ups;
+	shared.count = count;
+	shared.failed = false;
+
+	printf("%-24s %8s %8s %10s %10s %12s\n", "mode", "count", "threads", "time(s)", "cpu(s)", "reads/s");
+
+	run_threads("TcpClient + lock", shared, threads);
+	shared.async = &async;
+	run_threads("AsyncTcpClient", shared, threads);
+
+	pthread_mutex_destroy(&shared.lock);
+	client.logout();
+	if(shared.failed)
+	{
+		exit(EXIT_FAILURE);
+	}
+}
+
+#endif /* HAVE_PTHREAD */
+
+/* What a status display reads from a UPS at each refresh. */
+static void refresh(nut::Client& client, const std::string& ups)
+{
+	nut::Device dev = client.getDevice(ups);
+	dev.getDescription();
+	if(client.hasDeviceVariable(ups, "battery.charge"))
+	{
+		dev.getVariable("battery.charge").getDescription();
+		dev.getVariableValue("battery.charge");
+	}
+	dev.getVariableValue("ups.status");
+	dev.getVariableValue("ups.load");
+	dev.getCommandNames();
+}
+
+/* Refreshes with the client, then through a cache. */
+static void bench_cache(nut::TcpClient& client, const std::string& ups, unsigned int count)
+{
+	nut::CachedClient cached(client);
+	double start, cpu;
+	unsigned long allocs;
+
+	printf("%-24s %8s %8s %10s %10s %12s\n", "mode", "count", "devices", "time(s)", "cpu(s)", "allocs/ref");
+
+	start = now();
+	cpu = cputime();
+	allocs = allocations;
+	for(unsigned int n = 0; n < count; n++)
+	{
+		refresh(client, ups);
+	}
+	report("TcpClient", count, 1, start, cpu, allocations - allocs);
+
+	start = now();
+	cpu = cputime();
+	allocs = allocations;
+	for(unsigned int n = 0; n < count; n++)
+	{
+		refresh(cached, ups);
+	}
+	report("CachedClient", count, 1, start, cpu, allocations - allocs);
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int count = 100, threads = 0;
+	bool snapshot = false, cache = false;
+	int opt;
+
+	while((opt = getopt(argc, argv, "hcst:n:")) != -1)
+	{
+		switch(opt)
+		{
+		case 'c':
+			cache = true;
+			break;
+		case 's':
+			snapshot = true;
+			break;
+		case 't':
+			threads = atoi(optarg);
+			break;
+		case 'n':
+			count = atoi(optarg);
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+		}
+	}
+
+	if(optind >= argc || count < 1)
+	{
+		usage("nutclibench");
+		exit(EXIT_FAILURE);
+	}
+
+	/* <upsname>[@<hostname>[:<port>]], or <hostname>[:<port>] with -s */
+	std::string ups = argv[optind], host = "localhost";
+	int port = 3493;
+	size_t at = snapshot ? 0 : ups.find('@');
+	if(at != std::string::npos)
+	{
+		host = ups.substr(snapshot ? 0 : at + 1);
+		ups.erase(at);
+		size_t colon = host.rfind(':');
+		if(colon != std::string::npos)
+		{
+			port = atoi(host.c_str() + colon + 1);
+			host.erase(colon);
+		}
+	}
+
+	try
+	{
+		if(threads > 0)
+		{
+#ifdef HAVE_PTHREAD
+			bench_threads(host, port, ups, threads, count);
+			exit(EXIT_SUCCESS);
+#else
+			std::cerr << "Error: -t needs a library built with POSIX threads" << std::endl;
+			exit(EXIT_FAILURE);
+#endif
+		}
+
+		nut::TcpClient client(host, port);
+		double start, cpu;
+		unsigned long allocs;
+		size_t vars = 0;
+
+		if(cache)
+		{
+			bench_cache(client, ups, count);
+			client.logout();
+			exit(EXIT_SUCCESS);
+		}
+
+		if(snapshot)
+		{
+			bench_snapshot(client, count);
+			client.logout();
+			exit(EXIT_SUCCESS);
+		}
+
+		printf("%-24s %8s %8s %10s %10s %12s\n", "mode", "count", "vars", "time(s)", "cpu(s)", "allocs/list");
+
+		start = now();
+		cpu = cputime();
+		allocs = allocations;
+		for(unsigned int n = 0; n < count; n++)
+		{
+			vars = client.getDeviceVariableValues(ups).size();
+		}
+		report("getDeviceVariableValues", count, vars, start, cpu, allocations - allocs);
+
+		start = now();
+		cpu = cputime();
+		allocs = allocations;
+		for(unsigned int n = 0; n < count; n++)
+		{
+			vars = client.getDeviceVariableNames(ups).size();
+		}
+		report("getDeviceVariableNames", count, vars, start, cpu, allocations - allocs);
+
+		client.logout();
+	}
+	catch(nut::NutException& ex)
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		exit(EXIT_FAILURE);
+	}
+
+	exit(EXIT_SUCCESS);
+}
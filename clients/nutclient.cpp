@@ -17,13 +17,21 @@
    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 */
 
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
 #include "nutclient.h"
 
 #include <sstream>
+#include <deque>
 
 #include <errno.h>
 #include <string.h>
 #include <stdio.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 
 /* Windows/Linux Socket compatibility layer: */
 /* Thanks to Benjamin Roux (http://broux.developpez.com/articles/c/sockets/) */
@@ -37,6 +45,8 @@
 #  include <unistd.h> /* close */
 #  include <netdb.h> /* gethostbyname */
 #  include <fcntl.h>
+#  include <poll.h>
+#  include <sys/time.h>
 #  define INVALID_SOCKET -1
 #  define SOCKET_ERROR -1
 #  define closesocket(s) close(s) 
@@ -95,6 +105,7 @@ class Socket
 {
 public:
 	Socket();
+	~Socket();
 
 	void connect(const std::string& host, int port)throw(nut::IOException);
 	void disconnect();
@@ -103,27 +114,51 @@ public:
 	void setTimeout(long timeout);
 	bool hasTimeout()const{return _tv.tv_sec>=0;}
 
+	SOCKET getSocket()const{return _sock;}
+
 	size_t read(void* buf, size_t sz)throw(nut::IOException);
 	size_t write(const void* buf, size_t sz)throw(nut::IOException);
 
 	std::string read()throw(nut::IOException);
 	void write(const std::string& str)throw(nut::IOException);
 
+	/* Write the whole buffer, unlike write(buf, sz). */
+	void writeAll(const void* buf, size_t sz)throw(nut::IOException);
+
+	/* Next line, valid until the next call. */
+	const std::string& readLine()throw(nut::IOException);
 
 private:
 	SOCKET _sock;
 	struct timeval	_tv;
-	std::string _buffer; /* Received buffer, string because data should be text only. */
+
+	/* Received data, not consumed yet between _rbegin and _rend. */
+	char* _rbuf;
+	size_t _rsize, _rbegin, _rend;
+	std::string _line; /* Last line returned by readLine. */
 };
 
+/* Initial size of the receive buffer, which grows for longer lines. */
+static const size_t SOCKET_READ_SIZE = 16384;
+
 Socket::Socket():
 _sock(INVALID_SOCKET),
-_tv()
+_tv(),
+_rbuf(NULL),
+_rsize(0),
+_rbegin(0),
+_rend(0)
 {
 	_tv.tv_sec = -1;
 	_tv.tv_usec = 0;
 }
 
+Socket::~Socket()
+{
+	disconnect();
+	free(_rbuf);
+}
+
 void Socket::setTimeout(long timeout)
 {
 	_tv.tv_sec = timeout;
@@ -290,7 +325,7 @@ void Socket::disconnect()
 		::closesocket(_sock);
 		_sock = INVALID_SOCKET;
 	}
-	_buffer.clear();
+	_rbegin = _rend = 0;
 }
 
 bool Socket::isConnected()const
@@ -354,32 +389,53 @@ size_t Socket::write(const void* buf, size_t sz)throw(nut::IOException)
 
 std::string Socket::read()throw(nut::IOException)
 {
-	std::string res;
-	char buff[256];
+	return readLine();
+}
+
+const std::string& Socket::readLine()throw(nut::IOException)
+{
+	size_t scanned = _rbegin;
 
 	while(true)
 	{
-		// Look at already read data in _buffer
-		if(!_buffer.empty())
+		// Look at already read data, without scanning it twice
+		const char* nl = _rend > scanned ?
+			(const char*)memchr(_rbuf + scanned, '\n', _rend - scanned) : NULL;
+		if(nl)
+		{
+			_line.assign(_rbuf + _rbegin, nl - (_rbuf + _rbegin));
+			_rbegin = nl - _rbuf + 1;
+			return _line;
+		}
+
+		// Make room: drop the consumed data, or grow for a long line
+		if(_rbegin > 0)
+		{
+			memmove(_rbuf, _rbuf + _rbegin, _rend - _rbegin);
+			_rend -= _rbegin;
+			_rbegin = 0;
+		}
+		if(_rend == _rsize)
 		{
-			size_t idx = _buffer.find('\n');
-			if(idx!=std::string::npos)
+			size_t size = _rsize ? _rsize * 2 : SOCKET_READ_SIZE;
+			char* buf = (char*)xrealloc(_rbuf, size);
+			if(!buf)
 			{
-				res += _buffer.substr(0, idx);
-				_buffer.erase(0, idx+1);
-				return res;
+				throw nut::IOException("Cannot allocate receive buffer");
 			}
-			res += _buffer;
+			_rbuf = buf;
+			_rsize = size;
 		}
+		scanned = _rend;
 
-		// Read new buffer
-		size_t sz = read(&buff, 256);
+		// Read new data
+		size_t sz = read(_rbuf + _rend, _rsize - _rend);
 		if(sz==0)
 		{
 			disconnect();
 			throw nut::IOException("Server closed connection unexpectedly");
 		}
-		_buffer.assign(buff, sz);
+		_rend += sz;
 	}
 }
 
@@ -388,7 +444,36 @@ void Socket::write(const std::string& str)throw(nut::IOException)
 //	write(str.c_str(), str.size());
 //	write("\n", 1);
 	std::string buff = str + "\n";
-	write(buff.c_str(), buff.size());
+	writeAll(buff.c_str(), buff.size());
+}
+
+void Socket::writeAll(const void* buf, size_t sz)throw(nut::IOException)
+{
+	const char* ptr = (const char*)buf;
+	while(sz > 0)
+	{
+		size_t res = write(ptr, sz);
+		ptr += res;
+		sz -= res;
+	}
+}
+
+/* Append an empty element to arr, growing it by swapping the elements
+ * rather than copying them. */
+static void appendRow(std::vector<std::vector<std::string> >& arr)
+{
+	if(arr.size() == arr.capacity())
+	{
+		std::vector<std::vector<std::string> > tmp;
+		tmp.reserve(arr.capacity() * 2 + 16);
+		tmp.resize(arr.size());
+		for(size_t n=0; n<arr.size(); ++n)
+		{
+			tmp[n].swap(arr[n]);
+		}
+		arr.swap(tmp);
+	}
+	arr.resize(arr.size() + 1);
 }
 
 }/* namespace internal */
@@ -455,6 +540,88 @@ std::map<std::string,std::vector<std::string> > Client::getDeviceVariableValues(
   return res;
 }
 
+/* Default batch implementations: one query at a time, skipping the items
+ * which can't be retrieved, but not the connection errors. */
+std::map<std::string,std::string> Client::getDeviceDescriptions(const std::set<std::string>& devs)throw(NutException)
+{
+	std::map<std::string,std::string> res;
+
+	for(std::set<std::string>::const_iterator it=devs.begin(); it!=devs.end(); ++it)
+	{
+		try
+		{
+			res[*it] = getDeviceDescription(*it);
+		}
+		catch(IOException&)
+		{
+			throw;
+		}
+		catch(NutException&) {}
+	}
+
+	return res;
+}
+
+std::map<std::string,std::vector<std::string> > Client::getDeviceVariableValues(const std::string& dev, const std::set<std::string>& names)throw(NutException)
+{
+	std::map<std::string,std::vector<std::string> > res;
+
+	for(std::set<std::string>::const_iterator it=names.begin(); it!=names.end(); ++it)
+	{
+		try
+		{
+			res[*it] = getDeviceVariableValue(dev, *it);
+		}
+		catch(IOException&)
+		{
+			throw;
+		}
+		catch(NutException&) {}
+	}
+
+	return res;
+}
+
+std::map<std::string,std::map<std::string,std::vector<std::string> > > Client::getDevicesVariableValues(const std::set<std::string>& devs)throw(NutException)
+{
+	std::map<std::string,std::map<std::string,std::vector<std::string> > > res;
+
+	for(std::set<std::string>::const_iterator it=devs.begin(); it!=devs.end(); ++it)
+	{
+		try
+		{
+			res[*it] = getDeviceVariableValues(*it);
+		}
+		catch(IOException&)
+		{
+			throw;
+		}
+		catch(NutException&) {}
+	}
+
+	return res;
+}
+
+std::map<std::string,std::string> Client::getDeviceVariableDescriptions(const std::string& dev, const std::set<std::string>& names)throw(NutException)
+{
+	std::map<std::string,std::string> res;
+
+	for(std::set<std::string>::const_iterator it=names.begin(); it!=names.end(); ++it)
+	{
+		try
+		{
+			res[*it] = getDeviceVariableDescription(dev, *it);
+		}
+		catch(IOException&)
+		{
+			throw;
+		}
+		catch(NutException&) {}
+	}
+
+	return res;
+}
+
 bool Client::hasDeviceCommand(const std::string& dev, const std::string& name)throw(NutException)
 {
   std::set<std::string> names = getDeviceCommandNames(dev);
@@ -468,6 +635,12 @@ bool Client::hasDeviceCommand(const std::string& dev, const std::string& name)th
  *
  */
 
+/* Bytes of pipelined requests in flight at once: enough for hundreds of
+ * requests per round trip, little enough to always fit in the socket
+ * buffers, so that neither side blocks writing while the other one does. */
+static const size_t PIPELINE_WINDOW = 8192;
+
+
 TcpClient::TcpClient():
 Client(),
 _host("localhost"),
@@ -584,11 +757,14 @@ std::string TcpClient::getDeviceDescription(const std::string& name)throw(NutExc
 std::set<std::string> TcpClient::getDeviceVariableNames(const std::string& dev)throw(NutException)
 {
 	std::set<std::string> set;
-	
-	std::vector<std::vector<std::string> > res = list("VAR", dev);
-	for(size_t n=0; n<res.size(); ++n)
+	std::vector<std::string> fields;
+
+	std::string req = "VAR " + dev;
+	listBegin(req);
+	while(listNext(req, fields))
 	{
-		set.insert(res[n][0]);
+		if(!fields.empty())
+			set.insert(set.end(), fields[0]);
 	}
 
 	return set;
@@ -597,11 +773,14 @@ std::set<std::string> TcpClient::getDeviceVariableNames(const std::string& dev)t
 std::set<std::string> TcpClient::getDeviceRWVariableNames(const std::string& dev)throw(NutException)
 {
 	std::set<std::string> set;
-	
-	std::vector<std::vector<std::string> > res = list("RW", dev);
-	for(size_t n=0; n<res.size(); ++n)
+	std::vector<std::string> fields;
+
+	std::string req = "RW " + dev;
+	listBegin(req);
+	while(listNext(req, fields))
 	{
-		set.insert(res[n][0]);
+		if(!fields.empty())
+			set.insert(set.end(), fields[0]);
 	}
 
 	return set;
@@ -621,14 +800,149 @@ std::map<std::string,std::vector<std::string> > TcpClient::getDeviceVariableValu
 {
 
 	std::map<std::string,std::vector<std::string> >  map;
-	
-	std::vector<std::vector<std::string> > res = list("VAR", dev);
-	for(size_t n=0; n<res.size(); ++n)
+	std::vector<std::string> fields;
+
+	// Build the map in place, values are moved in rather than copied
+	std::string req = "VAR " + dev;
+	listBegin(req);
+	while(listNext(req, fields))
+	{
+		if(fields.empty())
+			continue;
+		std::vector<std::string>& vals = map.insert(map.end(),
+			std::make_pair(fields[0], std::vector<std::string>()))->second;
+		vals.resize(fields.size() - 1);
+		for(size_t n=1; n<fields.size(); ++n)
+		{
+			vals[n-1].swap(fields[n]);
+		}
+	}
+
+	return map;
+}
+
+std::map<std::string,std::string> TcpClient::getDeviceDescriptions(const std::set<std::string>& devs)throw(NutException)
+{
+	std::map<std::string,std::string> map;
+	std::vector<std::string> reqs;
+	std::vector<std::vector<std::string> > res;
+	std::vector<bool> found;
+
+	for(std::set<std::string>::const_iterator it=devs.begin(); it!=devs.end(); ++it)
+	{
+		reqs.push_back("UPSDESC " + *it);
+	}
+
+	getMulti(reqs, res, found);
+
+	std::set<std::string>::const_iterator it=devs.begin();
+	for(size_t n=0; n<reqs.size(); ++n, ++it)
+	{
+		if(found[n] && !res[n].empty())
+			map.insert(map.end(), std::make_pair(*it, res[n][0]));
+	}
+
+	return map;
+}
+
+std::map<std::string,std::vector<std::string> > TcpClient::getDeviceVariableValues(const std::string& dev, const std::set<std::string>& names)throw(NutException)
+{
+	std::map<std::string,std::vector<std::string> > map;
+	std::vector<std::string> reqs;
+	std::vector<std::vector<std::string> > res;
+	std::vector<bool> found;
+
+	for(std::set<std::string>::const_iterator it=names.begin(); it!=names.end(); ++it)
+	{
+		reqs.push_back("VAR " + dev + " " + *it);
+	}
+
+	getMulti(reqs, res, found);
+
+	std::set<std::string>::const_iterator it=names.begin();
+	for(size_t n=0; n<reqs.size(); ++n, ++it)
+	{
+		if(found[n])
+			map.insert(map.end(), std::make_pair(*it, std::vector<std::string>()))->second.swap(res[n]);
+	}
+
+	return map;
+}
+
+std::map<std::string,std::map<std::string,std::vector<std::string> > > TcpClient::getDevicesVariableValues(const std::set<std::string>& devs)throw(NutException)
+{
+	std::map<std::string,std::map<std::string,std::vector<std::string> > > map;
+	std::vector<std::string> reqs, fields;
+
+	for(std::set<std::string>::const_iterator it=devs.begin(); it!=devs.end(); ++it)
+	{
+		reqs.push_back("VAR " + *it);
+	}
+
+	try
 	{
-		std::vector<std::string>& vals = res[n];
-		std::string var = vals[0];
-		vals.erase(vals.begin());
-		map[var] = vals;
+		std::set<std::string>::const_iterator it=devs.begin();
+		size_t sent = 0, inflight = 0;
+		for(size_t n=0; n<reqs.size(); ++n, ++it)
+		{
+			if(sent < reqs.size() && inflight <= PIPELINE_WINDOW / 2)
+			{
+				sent = sendQueries("LIST ", reqs, sent, inflight);
+			}
+			inflight -= 6 + reqs[n].size();
+
+			// Errors (unknown device, stale data...) only skip this device
+			const std::string& res = _socket->readLine();
+			if(res.compare(0, 3, "ERR") == 0)
+				continue;
+			if(res.compare(0, 11, "BEGIN LIST ") != 0 || res.compare(11, std::string::npos, reqs[n]) != 0)
+				throw NutException("Invalid response");
+
+			std::map<std::string,std::vector<std::string> >& vars =
+				map.insert(map.end(), std::make_pair(*it, std::map<std::string,std::vector<std::string> >()))->second;
+			while(listNext(reqs[n], fields))
+			{
+				if(fields.empty())
+					continue;
+				std::vector<std::string>& vals = vars.insert(vars.end(),
+					std::make_pair(fields[0], std::vector<std::string>()))->second;
+				vals.resize(fields.size() - 1);
+				for(size_t v=1; v<fields.size(); ++v)
+				{
+					vals[v-1].swap(fields[v]);
+				}
+			}
+		}
+	}
+	catch(...)
+	{
+		// The remaining answers can't be matched to their requests
+		_socket->disconnect();
+		throw;
+	}
+
+	return map;
+}
+
+std::map<std::string,std::string> TcpClient::getDeviceVariableDescriptions(const std::string& dev, const std::set<std::string>& names)throw(NutException)
+{
+	std::map<std::string,std::string> map;
+	std::vector<std::string> reqs;
+	std::vector<std::vector<std::string> > res;
+	std::vector<bool> found;
+
+	for(std::set<std::string>::const_iterator it=names.begin(); it!=names.end(); ++it)
+	{
+		reqs.push_back("DESC " + dev + " " + *it);
+	}
+
+	getMulti(reqs, res, found);
+
+	std::set<std::string>::const_iterator it=names.begin();
+	for(size_t n=0; n<reqs.size(); ++n, ++it)
+	{
+		if(found[n] && !res[n].empty())
+			map.insert(map.end(), std::make_pair(*it, res[n][0]));
 	}
 
 	return map;
@@ -653,11 +967,14 @@ void TcpClient::setDeviceVariable(const std::string& dev, const std::string& nam
 std::set<std::string> TcpClient::getDeviceCommandNames(const std::string& dev)throw(NutException)
 {
 	std::set<std::string> cmds;
+	std::vector<std::string> fields;
 
-	std::vector<std::vector<std::string> > res = list("CMD", dev);
-	for(size_t n=0; n<res.size(); ++n)
+	std::string req = "CMD " + dev;
+	listBegin(req);
+	while(listNext(req, fields))
 	{
-		cmds.insert(res[n][0]);
+		if(!fields.empty())
+			cmds.insert(cmds.end(), fields[0]);
 	}
 
 	return cmds;
@@ -721,31 +1038,95 @@ std::vector<std::vector<std::string> > TcpClient::list
 	{
 		req += " " + params;
 	}
-	std::string res = sendQuery("LIST " + req);
-	detectError(res);
-	if(res != ("BEGIN LIST " + req))
-	{
-		throw NutException("Invalid response");
-	}
+	listBegin(req);
 
 	std::vector<std::vector<std::string> > arr;
 	while(true)
 	{
-		res = _socket->read();
-		detectError(res);
-		if(res == ("END LIST " + req))
+		internal::appendRow(arr);
+		if(!listNext(req, arr.back()))
 		{
+			arr.pop_back();
 			return arr;
 		}
-		if(res.substr(0, req.size()) == req)
-		{
-			arr.push_back(explode(res, req.size()));
-		}
-		else
+	}
+}
+
+void TcpClient::listBegin(const std::string& req)throw(NutException)
+{
+	std::string res = sendQuery("LIST " + req);
+	detectError(res);
+	if(res.compare(0, 11, "BEGIN LIST ") != 0 || res.compare(11, std::string::npos, req) != 0)
+	{
+		throw NutException("Invalid response");
+	}
+}
+
+bool TcpClient::listNext(const std::string& req, std::vector<std::string>& fields)throw(NutException)
+{
+	const std::string& res = _socket->readLine();
+	detectError(res);
+	if(res.compare(0, 9, "END LIST ") == 0 && res.compare(9, std::string::npos, req) == 0)
+	{
+		return false;
+	}
+	if(res.compare(0, req.size(), req) != 0)
+	{
+		throw NutException("Invalid response");
+	}
+	explode(res, req.size(), fields);
+	return true;
+}
+
+size_t TcpClient::sendQueries(const std::string& cmd, const std::vector<std::string>& reqs, size_t begin, size_t& inflight)throw(IOException)
+{
+	std::string buff;
+	size_t end = begin;
+	while(end < reqs.size() && (buff.empty() ||
+		inflight + buff.size() + cmd.size() + reqs[end].size() + 1 <= PIPELINE_WINDOW))
+	{
+		buff += cmd;
+		buff += reqs[end++];
+		buff += '\n';
+	}
+	_socket->writeAll(buff.c_str(), buff.size());
+	inflight += buff.size();
+	return end;
+}
+
+void TcpClient::getMulti(const std::vector<std::string>& reqs, std::vector<std::vector<std::string> >& res, std::vector<bool>& found)throw(NutException)
+{
+	res.resize(reqs.size());
+	found.assign(reqs.size(), false);
+
+	try
+	{
+		size_t sent = 0, inflight = 0;
+		for(size_t n=0; n<reqs.size(); ++n)
 		{
-			throw NutException("Invalid response");
+			// Top up the requests in flight, in one write
+			if(sent < reqs.size() && inflight <= PIPELINE_WINDOW / 2)
+			{
+				sent = sendQueries("GET ", reqs, sent, inflight);
+			}
+			inflight -= 5 + reqs[n].size();
+
+			// Errors (unknown variable, stale data...) only fail this request
+			const std::string& line = _socket->readLine();
+			if(line.compare(0, 3, "ERR") == 0)
+				continue;
+			if(line.compare(0, reqs[n].size(), reqs[n]) != 0)
+				throw NutException("Invalid response");
+			explode(line, reqs[n].size(), res[n]);
+			found[n] = true;
 		}
 	}
+	catch(...)
+	{
+		// The remaining answers can't be matched to their requests
+		_socket->disconnect();
+		throw;
+	}
 }
 
 std::string TcpClient::sendQuery(const std::string& req)throw(IOException)
@@ -756,7 +1137,7 @@ std::string TcpClient::sendQuery(const std::string& req)throw(IOException)
 
 void TcpClient::detectError(const std::string& req)throw(NutException)
 {
-	if(req.substr(0,3)=="ERR")
+	if(req.compare(0, 3, "ERR")==0)
 	{
 		throw NutException(req.substr(4));
 	}
@@ -765,7 +1146,15 @@ void TcpClient::detectError(const std::string& req)throw(NutException)
 std::vector<std::string> TcpClient::explode(const std::string& str, size_t begin)
 {
 	std::vector<std::string> res;
-	std::string temp;
+	explode(str, begin, res);
+	return res;
+}
+
+void TcpClient::explode(const std::string& str, size_t begin, std::vector<std::string>& res)
+{
+	// The strings already in res are reused, to keep their storage
+	size_t count = 0;
+	std::string* temp = NULL;
 
 	enum STATE {
 		INIT,
@@ -778,6 +1167,18 @@ std::vector<std::string> TcpClient::explode(const std::string& str, size_t begin
 	for(size_t idx=begin; idx<str.size(); ++idx)
 	{
 		char c = str[idx];
+
+		// Start a new word
+		if(!temp)
+		{
+			if(count == res.size())
+			{
+				res.resize(count + 1);
+			}
+			temp = &res[count];
+			temp->clear();
+		}
+
 		switch(state)
 		{
 		case INIT:
@@ -794,7 +1195,7 @@ std::vector<std::string> TcpClient::explode(const std::string& str, size_t begin
 			/* What about bad characters ? */
 			else
 			{
-				temp += c;
+				*temp += c;
 				state = SIMPLE_STRING;
 			}
 			break;
@@ -802,8 +1203,8 @@ std::vector<std::string> TcpClient::explode(const std::string& str, size_t begin
 			if(c==' ' /* || c=='\t' */)
 			{
 				/* if(!temp.empty()) : Must not occur */
-					res.push_back(temp);
-				temp.clear();
+				count++;
+				temp = NULL;
 				state = INIT;
 			}
 			else if(c=='\\')
@@ -813,14 +1214,14 @@ std::vector<std::string> TcpClient::explode(const std::string& str, size_t begin
 			else if(c=='"')
 			{
 				/* if(!temp.empty()) : Must not occur */
-					res.push_back(temp);
-				temp.clear();
+				count++;
+				temp = NULL;
 				state = QUOTED_STRING;
 			}
 			/* What about bad characters ? */
 			else
 			{
-				temp += c;
+				*temp += c;
 			}		
 			break;
 		case QUOTED_STRING:
@@ -830,47 +1231,49 @@ std::vector<std::string> TcpClient::explode(const std::string& str, size_t begin
 			}
 			else if(c=='"')
 			{
-				res.push_back(temp);
-				temp.clear();
+				count++;
+				temp = NULL;
 				state = INIT;
 			}
 			/* What about bad characters ? */
 			else
 			{
-				temp += c;
+				*temp += c;
 			}
 			break;
 		case SIMPLE_ESCAPE:
 			if(c=='\\' || c=='"' || c==' ' /* || c=='\t'*/)
 			{
-				temp += c;
+				*temp += c;
 			}
 			else
 			{
-				temp += '\\' + c; // Really do this ?
+				*temp += '\\';
+				*temp += c;
 			}
 			state = SIMPLE_STRING;
 			break;
 		case QUOTED_ESCAPE:
 			if(c=='\\' || c=='"')
 			{
-				temp += c;
+				*temp += c;
 			}
 			else
 			{
-				temp += '\\' + c; // Really do this ?
+				*temp += '\\';
+				*temp += c;
 			}
 			state = QUOTED_STRING;
 			break;
 		}
 	}
 
-	if(!temp.empty())
+	if(temp && !temp->empty())
 	{
-		res.push_back(temp);
+		count++;
 	}
 
-	return res;
+	res.resize(count);
 }
 
 std::string TcpClient::escape(const std::string& str)
@@ -894,64 +1297,510 @@ std::string TcpClient::escape(const std::string& str)
 
 /*
  *
- * Device implementation
+ * Cached Client implementation
  *
  */
 
-Device::Device(Client* client, const std::string& name):
-_client(client),
-_name(name)
+namespace internal
 {
-}
 
-Device::Device(const Device& dev):
-_client(dev._client),
-_name(dev._name)
+/* Answer cached until its expiration date. */
+template<typename T>
+struct Cached
 {
-}
+	Cached():valid(false), expires(0){}
+	T value;
+	bool valid;
+	double expires; /* In milliseconds, negative for never */
+};
 
-Device::~Device()
+/**
+ * Answers cached by a CachedClient.
+ */
+class Cache
 {
-}
+public:
+	struct DeviceEntry
+	{
+		Cached<std::string> desc;
+		Cached<std::set<std::string> > varNames, rwNames, cmdNames;
+		std::map<std::string,Cached<std::vector<std::string> > > values;
+		std::map<std::string,Cached<std::string> > varDescs, cmdDescs;
+	};
+
+	Cache();
+
+	/* Give a cached answer, if it is still valid. */
+	template<typename T>
+	bool find(const Cached<T>& entry, T& value)const;
+	/* Cache an answer, unless its kind isn't cached. */
+	template<typename T>
+	void store(Cached<T>& entry, const T& value, CachedClient::CacheKind kind);
+
+	/* Give all the variable values of a device, if they are still valid. */
+	bool findValues(const std::string& dev, std::map<std::string,std::vector<std::string> >& values);
+	/* Cache variable values, and the variable names if they are all of them. */
+	void storeValues(const std::string& dev, const std::map<std::string,std::vector<std::string> >& values, bool all);
+
+	long ttl[CachedClient::CACHE_VALUES + 1];
+	Cached<std::set<std::string> > devNames;
+	std::map<std::string,DeviceEntry> devices;
 
-std::string Device::getName()const
-{
-	return _name;
-}
+private:
+	static double now();
+};
 
-const Client* Device::getClient()const
+Cache::Cache()
 {
-	return _client;
+	ttl[CachedClient::CACHE_DESCRIPTIONS] = -1;
+	ttl[CachedClient::CACHE_NAMES] = -1;
+	ttl[CachedClient::CACHE_VALUES] = 1000;
 }
 
-Client* Device::getClient()
+double Cache::now()
 {
-	return _client;
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
 }
 
-bool Device::isOk()const
+template<typename T>
+bool Cache::find(const Cached<T>& entry, T& value)const
 {
-	return _client!=NULL && !_name.empty();
+	if(!entry.valid || (entry.expires >= 0 && now() >= entry.expires))
+	{
+		return false;
+	}
+	value = entry.value;
+	return true;
 }
 
-Device::operator bool()const
+template<typename T>
+void Cache::store(Cached<T>& entry, const T& value, CachedClient::CacheKind kind)
 {
-	return isOk();	
+	if(ttl[kind] == 0)
+	{
+		return;
+	}
+	entry.value = value;
+	entry.valid = true;
+	entry.expires = ttl[kind] < 0 ? -1 : now() + ttl[kind];
 }
 
-bool Device::operator!()const
+bool Cache::findValues(const std::string& dev, std::map<std::string,std::vector<std::string> >& values)
 {
-	return !isOk();
-}
+	DeviceEntry& entry = devices[dev];
+	std::set<std::string> names;
+	std::vector<std::string> value;
 
-bool Device::operator==(const Device& dev)const
-{
-	return dev._client==_client && dev._name==_name;
+	if(!find(entry.varNames, names))
+	{
+		return false;
+	}
+	values.clear();
+	for(std::set<std::string>::iterator it=names.begin(); it!=names.end(); ++it)
+	{
+		if(!find(entry.values[*it], value))
+		{
+			return false;
+		}
+		values.insert(values.end(), std::make_pair(*it, value));
+	}
+	return true;
 }
 
-bool Device::operator<(const Device& dev)const
+void Cache::storeValues(const std::string& dev, const std::map<std::string,std::vector<std::string> >& values, bool all)
 {
-  return getName()<dev.getName();
+	DeviceEntry& entry = devices[dev];
+	std::set<std::string> names;
+
+	for(std::map<std::string,std::vector<std::string> >::const_iterator it=values.begin(); it!=values.end(); ++it)
+	{
+		store(entry.values[it->first], it->second, CachedClient::CACHE_VALUES);
+		if(all)
+		{
+			names.insert(names.end(), it->first);
+		}
+	}
+	if(all)
+	{
+		store(entry.varNames, names, CachedClient::CACHE_NAMES);
+	}
+}
+
+} /* namespace internal */
+
+
+CachedClient::CachedClient(Client& client):
+Client(),
+_client(client),
+_cache(new internal::Cache)
+{
+}
+
+CachedClient::~CachedClient()
+{
+	delete _cache;
+}
+
+void CachedClient::setTTL(CacheKind kind, long ttl)
+{
+	_cache->ttl[kind] = ttl;
+}
+
+long CachedClient::getTTL(CacheKind kind)const
+{
+	return _cache->ttl[kind];
+}
+
+void CachedClient::invalidate()
+{
+	_cache->devNames = internal::Cached<std::set<std::string> >();
+	_cache->devices.clear();
+}
+
+void CachedClient::invalidate(const std::string& dev)
+{
+	_cache->devices.erase(dev);
+}
+
+void CachedClient::invalidate(const std::string& dev, const std::string& name)
+{
+	std::map<std::string,internal::Cache::DeviceEntry>::iterator it = _cache->devices.find(dev);
+	if(it != _cache->devices.end())
+	{
+		it->second.values.erase(name);
+		it->second.varDescs.erase(name);
+	}
+}
+
+void CachedClient::warmUp(const std::string& dev)throw(NutException)
+{
+	_cache->storeValues(dev, _client.getDeviceVariableValues(dev), true);
+}
+
+void CachedClient::authenticate(const std::string& user, const std::string& passwd)throw(NutException)
+{
+	_client.authenticate(user, passwd);
+}
+
+void CachedClient::logout()throw(NutException)
+{
+	_client.logout();
+}
+
+std::set<std::string> CachedClient::getDeviceNames()throw(NutException)
+{
+	std::set<std::string> res;
+	if(!_cache->find(_cache->devNames, res))
+	{
+		res = _client.getDeviceNames();
+		_cache->store(_cache->devNames, res, CACHE_NAMES);
+	}
+	return res;
+}
+
+std::string CachedClient::getDeviceDescription(const std::string& name)throw(NutException)
+{
+	internal::Cached<std::string>& entry = _cache->devices[name].desc;
+	std::string res;
+	if(!_cache->find(entry, res))
+	{
+		res = _client.getDeviceDescription(name);
+		_cache->store(entry, res, CACHE_DESCRIPTIONS);
+	}
+	return res;
+}
+
+std::map<std::string,std::string> CachedClient::getDeviceDescriptions(const std::set<std::string>& devs)throw(NutException)
+{
+	std::map<std::string,std::string> res;
+	std::set<std::string> missing;
+	std::string desc;
+
+	for(std::set<std::string>::const_iterator it=devs.begin(); it!=devs.end(); ++it)
+	{
+		if(_cache->find(_cache->devices[*it].desc, desc))
+			res[*it] = desc;
+		else
+			missing.insert(missing.end(), *it);
+	}
+
+	if(!missing.empty())
+	{
+		std::map<std::string,std::string> descs = _client.getDeviceDescriptions(missing);
+		for(std::map<std::string,std::string>::iterator it=descs.begin(); it!=descs.end(); ++it)
+		{
+			_cache->store(_cache->devices[it->first].desc, it->second, CACHE_DESCRIPTIONS);
+			res[it->first] = it->second;
+		}
+	}
+
+	return res;
+}
+
+std::set<std::string> CachedClient::getDeviceVariableNames(const std::string& dev)throw(NutException)
+{
+	internal::Cached<std::set<std::string> >& entry = _cache->devices[dev].varNames;
+	std::set<std::string> res;
+	if(!_cache->find(entry, res))
+	{
+		res = _client.getDeviceVariableNames(dev);
+		_cache->store(entry, res, CACHE_NAMES);
+	}
+	return res;
+}
+
+std::set<std::string> CachedClient::getDeviceRWVariableNames(const std::string& dev)throw(NutException)
+{
+	internal::Cached<std::set<std::string> >& entry = _cache->devices[dev].rwNames;
+	std::set<std::string> res;
+	if(!_cache->find(entry, res))
+	{
+		res = _client.getDeviceRWVariableNames(dev);
+		_cache->store(entry, res, CACHE_NAMES);
+	}
+	return res;
+}
+
+std::string CachedClient::getDeviceVariableDescription(const std::string& dev, const std::string& name)throw(NutException)
+{
+	internal::Cached<std::string>& entry = _cache->devices[dev].varDescs[name];
+	std::string res;
+	if(!_cache->find(entry, res))
+	{
+		res = _client.getDeviceVariableDescription(dev, name);
+		_cache->store(entry, res, CACHE_DESCRIPTIONS);
+	}
+	return res;
+}
+
+std::vector<std::string> CachedClient::getDeviceVariableValue(const std::string& dev, const std::string& name)throw(NutException)
+{
+	internal::Cached<std::vector<std::string> >& entry = _cache->devices[dev].values[name];
+	std::vector<std::string> res;
+	if(!_cache->find(entry, res))
+	{
+		res = _client.getDeviceVariableValue(dev, name);
+		_cache->store(entry, res, CACHE_VALUES);
+	}
+	return res;
+}
+
+std::map<std::string,std::vector<std::string> > CachedClient::getDeviceVariableValues(const std::string& dev)throw(NutException)
+{
+	std::map<std::string,std::vector<std::string> > res;
+	if(!_cache->findValues(dev, res))
+	{
+		res = _client.getDeviceVariableValues(dev);
+		_cache->storeValues(dev, res, true);
+	}
+	return res;
+}
+
+std::map<std::string,std::vector<std::string> > CachedClient::getDeviceVariableValues(const std::string& dev, const std::set<std::string>& names)throw(NutException)
+{
+	internal::Cache::DeviceEntry& entry = _cache->devices[dev];
+	std::map<std::string,std::vector<std::string> > res;
+	std::set<std::string> missing;
+	std::vector<std::string> value;
+
+	for(std::set<std::string>::const_iterator it=names.begin(); it!=names.end(); ++it)
+	{
+		if(_cache->find(entry.values[*it], value))
+			res[*it] = value;
+		else
+			missing.insert(missing.end(), *it);
+	}
+
+	if(!missing.empty())
+	{
+		std::map<std::string,std::vector<std::string> > values = _client.getDeviceVariableValues(dev, missing);
+		_cache->storeValues(dev, values, false);
+		res.insert(values.begin(), values.end());
+	}
+
+	return res;
+}
+
+std::map<std::string,std::map<std::string,std::vector<std::string> > > CachedClient::getDevicesVariableValues(const std::set<std::string>& devs)throw(NutException)
+{
+	std::map<std::string,std::map<std::string,std::vector<std::string> > > res;
+	std::set<std::string> missing;
+
+	for(std::set<std::string>::const_iterator it=devs.begin(); it!=devs.end(); ++it)
+	{
+		if(!_cache->findValues(*it, res[*it]))
+		{
+			res.erase(*it);
+			missing.insert(missing.end(), *it);
+		}
+	}
+
+	if(!missing.empty())
+	{
+		std::map<std::string,std::map<std::string,std::vector<std::string> > > values = _client.getDevicesVariableValues(missing);
+		for(std::map<std::string,std::map<std::string,std::vector<std::string> > >::iterator it=values.begin(); it!=values.end(); ++it)
+		{
+			_cache->storeValues(it->first, it->second, true);
+			res[it->first].swap(it->second);
+		}
+	}
+
+	return res;
+}
+
+std::map<std::string,std::string> CachedClient::getDeviceVariableDescriptions(const std::string& dev, const std::set<std::string>& names)throw(NutException)
+{
+	internal::Cache::DeviceEntry& entry = _cache->devices[dev];
+	std::map<std::string,std::string> res;
+	std::set<std::string> missing;
+	std::string desc;
+
+	for(std::set<std::string>::const_iterator it=names.begin(); it!=names.end(); ++it)
+	{
+		if(_cache->find(entry.varDescs[*it], desc))
+			res[*it] = desc;
+		else
+			missing.insert(missing.end(), *it);
+	}
+
+	if(!missing.empty())
+	{
+		std::map<std::string,std::string> descs = _client.getDeviceVariableDescriptions(dev, missing);
+		for(std::map<std::string,std::string>::iterator it=descs.begin(); it!=descs.end(); ++it)
+		{
+			_cache->store(entry.varDescs[it->first], it->second, CACHE_DESCRIPTIONS);
+			res[it->first] = it->second;
+		}
+	}
+
+	return res;
+}
+
+void CachedClient::setDeviceVariable(const std::string& dev, const std::string& name, const std::string& value)throw(NutException)
+{
+	_cache->devices[dev].values.erase(name);
+	_client.setDeviceVariable(dev, name, value);
+}
+
+void CachedClient::setDeviceVariable(const std::string& dev, const std::string& name, const std::vector<std::string>& values)throw(NutException)
+{
+	_cache->devices[dev].values.erase(name);
+	_client.setDeviceVariable(dev, name, values);
+}
+
+std::set<std::string> CachedClient::getDeviceCommandNames(const std::string& dev)throw(NutException)
+{
+	internal::Cached<std::set<std::string> >& entry = _cache->devices[dev].cmdNames;
+	std::set<std::string> res;
+	if(!_cache->find(entry, res))
+	{
+		res = _client.getDeviceCommandNames(dev);
+		_cache->store(entry, res, CACHE_NAMES);
+	}
+	return res;
+}
+
+std::string CachedClient::getDeviceCommandDescription(const std::string& dev, const std::string& name)throw(NutException)
+{
+	internal::Cached<std::string>& entry = _cache->devices[dev].cmdDescs[name];
+	std::string res;
+	if(!_cache->find(entry, res))
+	{
+		res = _client.getDeviceCommandDescription(dev, name);
+		_cache->store(entry, res, CACHE_DESCRIPTIONS);
+	}
+	return res;
+}
+
+void CachedClient::executeDeviceCommand(const std::string& dev, const std::string& name)throw(NutException)
+{
+	// Commands may change any value of the device
+	_cache->devices[dev].values.clear();
+	_client.executeDeviceCommand(dev, name);
+}
+
+void CachedClient::deviceLogin(const std::string& dev)throw(NutException)
+{
+	_client.deviceLogin(dev);
+}
+
+void CachedClient::deviceMaster(const std::string& dev)throw(NutException)
+{
+	_client.deviceMaster(dev);
+}
+
+void CachedClient::deviceForcedShutdown(const std::string& dev)throw(NutException)
+{
+	_client.deviceForcedShutdown(dev);
+}
+
+int CachedClient::deviceGetNumLogins(const std::string& dev)throw(NutException)
+{
+	return _client.deviceGetNumLogins(dev);
+}
+
+/*
+ *
+ * Device implementation
+ *
+ */
+
+Device::Device(Client* client, const std::string& name):
+_client(client),
+_name(name)
+{
+}
+
+Device::Device(const Device& dev):
+_client(dev._client),
+_name(dev._name)
+{
+}
+
+Device::~Device()
+{
+}
+
+std::string Device::getName()const
+{
+	return _name;
+}
+
+const Client* Device::getClient()const
+{
+	return _client;
+}
+
+Client* Device::getClient()
+{
+	return _client;
+}
+
+bool Device::isOk()const
+{
+	return _client!=NULL && !_name.empty();
+}
+
+Device::operator bool()const
+{
+	return isOk();	
+}
+
+bool Device::operator!()const
+{
+	return !isOk();
+}
+
+bool Device::operator==(const Device& dev)const
+{
+	return dev._client==_client && dev._name==_name;
+}
+
+bool Device::operator<(const Device& dev)const
+{
+  return getName()<dev.getName();
 }
 
 std::string Device::getDescription()throw(NutException)
@@ -971,6 +1820,18 @@ std::map<std::string,std::vector<std::string> > Device::getVariableValues()
 	return getClient()->getDeviceVariableValues(getName());
 }
 
+std::map<std::string,std::vector<std::string> > Device::getVariableValues(const std::set<std::string>& names)
+	throw(NutException)
+{
+	return getClient()->getDeviceVariableValues(getName(), names);
+}
+
+std::map<std::string,std::string> Device::getVariableDescriptions(const std::set<std::string>& names)
+	throw(NutException)
+{
+	return getClient()->getDeviceVariableDescriptions(getName(), names);
+}
+
 std::set<std::string> Device::getVariableNames()throw(NutException)
 {
   return getClient()->getDeviceVariableNames(getName());
@@ -1235,6 +2096,748 @@ void Command::execute()throw(NutException)
 	getDevice()->executeCommand(getName());
 }
 
+#ifdef HAVE_PTHREAD
+
+/*
+ *
+ * Asynchronous TCP Client implementation
+ *
+ */
+
+namespace internal
+{
+
+/**
+ * Request sent by an AsyncTcpClient.
+ * It is shared by its futures and by the connection until it is answered.
+ */
+class AsyncRequest
+{
+public:
+	enum Type
+	{
+		GET,	/* One answer, starting with req */
+		LIST,	/* BEGIN LIST, elements starting with req, END LIST */
+		ACK	/* answers "OK" answers */
+	};
+	enum Error
+	{
+		NONE,
+		SERVER,	/* ERR answer, in msg */
+		CONNECTION	/* Connection failure, in msg */
+	};
+
+	AsyncRequest(Type type, const std::string& req, unsigned int answers,
+		AsyncCallback callback, void* arg);
+
+	void ref();
+	void unref();
+
+	/* Make the answer available to the futures, then call the callback. */
+	void complete();
+	void complete(Error err, const std::string& text);
+
+	bool isReady();
+	void wait();
+	bool wait(long timeout);
+	/* Wait for the answer, and throw its error. */
+	void check()throw(nut::NutException);
+
+	const Type type;
+	const std::string req;
+
+	/* Written by the I/O thread, then read by the futures once ready. */
+	unsigned int answers;
+	bool listing;
+	std::vector<std::vector<std::string> > rows;
+	Error error;
+	std::string msg;
+
+private:
+	~AsyncRequest();
+
+	AsyncCallback _callback;
+	void* _arg;
+
+	pthread_mutex_t _mutex;
+	pthread_cond_t _cond;
+	unsigned int _refs;
+	bool _ready;
+};
+
+AsyncRequest::AsyncRequest(Type type, const std::string& req, unsigned int answers,
+	AsyncCallback callback, void* arg):
+type(type),
+req(req),
+answers(answers),
+listing(false),
+error(NONE),
+_callback(callback),
+_arg(arg),
+_refs(1),
+_ready(false)
+{
+	pthread_mutex_init(&_mutex, NULL);
+	pthread_cond_init(&_cond, NULL);
+}
+
+AsyncRequest::~AsyncRequest()
+{
+	pthread_cond_destroy(&_cond);
+	pthread_mutex_destroy(&_mutex);
+}
+
+void AsyncRequest::ref()
+{
+	pthread_mutex_lock(&_mutex);
+	_refs++;
+	pthread_mutex_unlock(&_mutex);
+}
+
+void AsyncRequest::unref()
+{
+	pthread_mutex_lock(&_mutex);
+	bool last = --_refs == 0;
+	pthread_mutex_unlock(&_mutex);
+	if(last)
+	{
+		delete this;
+	}
+}
+
+void AsyncRequest::complete()
+{
+	pthread_mutex_lock(&_mutex);
+	_ready = true;
+	pthread_cond_broadcast(&_cond);
+	pthread_mutex_unlock(&_mutex);
+
+	if(_callback)
+	{
+		_callback(Future(this), _arg);
+	}
+}
+
+void AsyncRequest::complete(Error err, const std::string& text)
+{
+	error = err;
+	msg = text;
+	complete();
+}
+
+bool AsyncRequest::isReady()
+{
+	pthread_mutex_lock(&_mutex);
+	bool ready = _ready;
+	pthread_mutex_unlock(&_mutex);
+	return ready;
+}
+
+void AsyncRequest::wait()
+{
+	pthread_mutex_lock(&_mutex);
+	while(!_ready)
+	{
+		pthread_cond_wait(&_cond, &_mutex);
+	}
+	pthread_mutex_unlock(&_mutex);
+}
+
+bool AsyncRequest::wait(long timeout)
+{
+	struct timeval now;
+	struct timespec end;
+
+	gettimeofday(&now, NULL);
+	end.tv_sec = now.tv_sec + timeout / 1000;
+	end.tv_nsec = now.tv_usec * 1000 + (timeout % 1000) * 1000000;
+	if(end.tv_nsec >= 1000000000)
+	{
+		end.tv_sec++;
+		end.tv_nsec -= 1000000000;
+	}
+
+	pthread_mutex_lock(&_mutex);
+	while(!_ready)
+	{
+		if(pthread_cond_timedwait(&_cond, &_mutex, &end) == ETIMEDOUT)
+			break;
+	}
+	bool ready = _ready;
+	pthread_mutex_unlock(&_mutex);
+	return ready;
+}
+
+void AsyncRequest::check()throw(nut::NutException)
+{
+	wait();
+	switch(error)
+	{
+	case SERVER:
+		throw nut::NutException(msg);
+	case CONNECTION:
+		throw nut::IOException(msg);
+	default:
+		break;
+	}
+}
+
+/**
+ * Connection of an AsyncTcpClient, and its I/O thread.
+ * The requests are queued in the order they are sent, which is the order
+ * of their answers.
+ */
+class AsyncConnection
+{
+public:
+	AsyncConnection(const std::string& host, int port)throw(nut::IOException);
+	~AsyncConnection();
+
+	bool isConnected();
+
+	/* Queue a request, and the lines to send for it. */
+	Future send(AsyncRequest* req, const std::string& lines);
+
+private:
+	static void* run(void* conn);
+	void loop();
+	bool flush();
+	bool receive()throw(nut::NutException);
+	void answer(const std::string& line)throw(nut::NutException);
+	void fail(const std::string& msg);
+	void wake();
+
+	Socket _socket;
+	int _wake[2];
+	pthread_t _thread;
+
+	/* Shared with the requesting threads. */
+	pthread_mutex_t _mutex;
+	bool _connected, _stop;
+	std::deque<AsyncRequest*> _queue;
+	std::string _out;
+
+	/* I/O thread only. */
+	std::string _wbuf;
+	size_t _wpos;
+	std::string _rbuf;
+	std::string _line;
+};
+
+AsyncConnection::AsyncConnection(const std::string& host, int port)throw(nut::IOException):
+_connected(true),
+_stop(false),
+_wpos(0)
+{
+	_socket.connect(host, port);
+
+	if(pipe(_wake) < 0)
+	{
+		throw nut::SystemException();
+	}
+	fcntl(_wake[0], F_SETFL, fcntl(_wake[0], F_GETFL) | O_NONBLOCK);
+	fcntl(_wake[1], F_SETFL, fcntl(_wake[1], F_GETFL) | O_NONBLOCK);
+	fcntl(_socket.getSocket(), F_SETFL, fcntl(_socket.getSocket(), F_GETFL) | O_NONBLOCK);
+
+	pthread_mutex_init(&_mutex, NULL);
+	if(pthread_create(&_thread, NULL, run, this) != 0)
+	{
+		pthread_mutex_destroy(&_mutex);
+		close(_wake[0]);
+		close(_wake[1]);
+		throw nut::IOException("Cannot create I/O thread");
+	}
+}
+
+AsyncConnection::~AsyncConnection()
+{
+	pthread_mutex_lock(&_mutex);
+	_stop = true;
+	pthread_mutex_unlock(&_mutex);
+	wake();
+	pthread_join(_thread, NULL);
+
+	pthread_mutex_destroy(&_mutex);
+	close(_wake[0]);
+	close(_wake[1]);
+}
+
+bool AsyncConnection::isConnected()
+{
+	pthread_mutex_lock(&_mutex);
+	bool connected = _connected;
+	pthread_mutex_unlock(&_mutex);
+	return connected;
+}
+
+Future AsyncConnection::send(AsyncRequest* req, const std::string& lines)
+{
+	Future fut(req);
+	bool connected, idle = false;
+
+	pthread_mutex_lock(&_mutex);
+	connected = _connected && !_stop;
+	if(connected)
+	{
+		// The reference given by the caller is now the queue's one
+		_queue.push_back(req);
+		idle = _out.empty();
+		_out += lines;
+	}
+	pthread_mutex_unlock(&_mutex);
+
+	if(!connected)
+	{
+		req->complete(AsyncRequest::CONNECTION, "Not connected");
+		req->unref();
+	}
+	else if(idle)
+	{
+		// Otherwise, the I/O thread is already woken up
+		wake();
+	}
+	return fut;
+}
+
+void AsyncConnection::wake()
+{
+	char c = 0;
+	// A full pipe already wakes the I/O thread up
+	while(::write(_wake[1], &c, 1) < 0 && errno == EINTR)
+		;
+}
+
+void* AsyncConnection::run(void* conn)
+{
+	static_cast<AsyncConnection*>(conn)->loop();
+	return NULL;
+}
+
+void AsyncConnection::loop()
+{
+	while(true)
+	{
+		pthread_mutex_lock(&_mutex);
+		bool stop = _stop;
+		if(_wpos == _wbuf.size() && !_out.empty())
+		{
+			_wbuf.swap(_out);
+			_out.clear();
+			_wpos = 0;
+		}
+		pthread_mutex_unlock(&_mutex);
+
+		if(stop)
+		{
+			fail("Not connected");
+			return;
+		}
+
+		// The socket is usually writable: try before polling
+		if(!flush())
+		{
+			fail("Error while writing on socket");
+			return;
+		}
+
+		struct pollfd fds[2];
+		fds[0].fd = _socket.getSocket();
+		fds[0].events = POLLIN;
+		if(_wpos < _wbuf.size())
+		{
+			fds[0].events |= POLLOUT;
+		}
+		fds[0].revents = 0;
+		fds[1].fd = _wake[0];
+		fds[1].events = POLLIN;
+		fds[1].revents = 0;
+
+		if(poll(fds, 2, -1) < 0)
+		{
+			if(errno == EINTR)
+				continue;
+			fail("Error while polling socket");
+			return;
+		}
+
+		if(fds[1].revents)
+		{
+			char buf[64];
+			while(::read(_wake[0], buf, sizeof(buf)) > 0)
+				;
+		}
+
+		if(fds[0].revents & (POLLIN | POLLERR | POLLHUP))
+		{
+			try
+			{
+				if(!receive())
+				{
+					fail("Server closed connection unexpectedly");
+					return;
+				}
+			}
+			catch(nut::NutException& ex)
+			{
+				// The remaining answers can't be matched to their requests
+				fail(ex.str());
+				return;
+			}
+		}
+	}
+}
+
+bool AsyncConnection::flush()
+{
+	while(_wpos < _wbuf.size())
+	{
+		ssize_t res = ::write(_socket.getSocket(), _wbuf.data() + _wpos, _wbuf.size() - _wpos);
+		if(res < 0)
+		{
+			if(errno == EINTR)
+				continue;
+			return errno == EAGAIN || errno == EWOULDBLOCK;
+		}
+		_wpos += res;
+	}
+	_wbuf.clear();
+	_wpos = 0;
+	return true;
+}
+
+bool AsyncConnection::receive()throw(nut::NutException)
+{
+	char buf[SOCKET_READ_SIZE];
+	ssize_t res;
+
+	while((res = ::read(_socket.getSocket(), buf, sizeof(buf))) < 0)
+	{
+		if(errno == EAGAIN || errno == EWOULDBLOCK)
+			return true;
+		if(errno != EINTR)
+			throw nut::IOException("Error while reading on socket");
+	}
+	if(res == 0)
+	{
+		return false;
+	}
+
+	// Only scan the new data for line ends
+	size_t begin = 0, scan = _rbuf.size(), nl;
+	_rbuf.append(buf, res);
+	while((nl = _rbuf.find('\n', scan)) != std::string::npos)
+	{
+		_line.assign(_rbuf, begin, nl - begin);
+		answer(_line);
+		begin = scan = nl + 1;
+	}
+	_rbuf.erase(0, begin);
+	return true;
+}
+
+void AsyncConnection::answer(const std::string& line)throw(nut::NutException)
+{
+	// Only this thread removes requests from the queue
+	pthread_mutex_lock(&_mutex);
+	AsyncRequest* req = _queue.empty() ? NULL : _queue.front();
+	pthread_mutex_unlock(&_mutex);
+	if(!req)
+	{
+		throw nut::NutException("Unexpected response");
+	}
+
+	bool err = line.compare(0, 3, "ERR") == 0;
+	switch(req->type)
+	{
+	case AsyncRequest::GET:
+		if(err)
+		{
+			req->error = AsyncRequest::SERVER;
+			req->msg = line.substr(4);
+			break;
+		}
+		if(line.compare(0, req->req.size(), req->req) != 0)
+		{
+			throw nut::NutException("Invalid response");
+		}
+		req->rows.resize(1);
+		TcpClient::explode(line, req->req.size(), req->rows[0]);
+		break;
+
+	case AsyncRequest::LIST:
+		if(err)
+		{
+			req->error = AsyncRequest::SERVER;
+			req->msg = line.substr(4);
+			break;
+		}
+		if(!req->listing)
+		{
+			if(line.compare(0, 11, "BEGIN LIST ") != 0 || line.compare(11, std::string::npos, req->req) != 0)
+			{
+				throw nut::NutException("Invalid response");
+			}
+			req->listing = true;
+			return;
+		}
+		if(line.compare(0, 9, "END LIST ") == 0 && line.compare(9, std::string::npos, req->req) == 0)
+		{
+			break;
+		}
+		if(line.compare(0, req->req.size(), req->req) != 0)
+		{
+			throw nut::NutException("Invalid response");
+		}
+		appendRow(req->rows);
+		TcpClient::explode(line, req->req.size(), req->rows.back());
+		return;
+
+	case AsyncRequest::ACK:
+		// Report the first error, but wait for all the answers
+		if(err)
+		{
+			if(req->error == AsyncRequest::NONE)
+			{
+				req->error = AsyncRequest::SERVER;
+				req->msg = line.substr(4);
+			}
+		}
+		else if(line.compare(0, 2, "OK") != 0)
+		{
+			throw nut::NutException("Invalid response");
+		}
+		if(--req->answers > 0)
+		{
+			return;
+		}
+		break;
+	}
+
+	pthread_mutex_lock(&_mutex);
+	_queue.pop_front();
+	pthread_mutex_unlock(&_mutex);
+
+	req->complete();
+	req->unref();
+}
+
+void AsyncConnection::fail(const std::string& msg)
+{
+	std::deque<AsyncRequest*> queue;
+
+	_socket.disconnect();
+
+	pthread_mutex_lock(&_mutex);
+	_connected = false;
+	queue.swap(_queue);
+	_out.clear();
+	pthread_mutex_unlock(&_mutex);
+
+	for(std::deque<AsyncRequest*>::iterator it = queue.begin(); it != queue.end(); ++it)
+	{
+		(*it)->complete(AsyncRequest::CONNECTION, msg);
+		(*it)->unref();
+	}
+}
+
+} /* namespace internal */
+
+
+Future::Future():
+_req(NULL)
+{
+}
+
+Future::Future(internal::AsyncRequest* req):
+_req(req)
+{
+	_req->ref();
+}
+
+Future::Future(const Future& fut):
+_req(fut._req)
+{
+	if(_req)
+	{
+		_req->ref();
+	}
+}
+
+Future::~Future()
+{
+	if(_req)
+	{
+		_req->unref();
+	}
+}
+
+Future& Future::operator=(const Future& fut)
+{
+	if(fut._req)
+	{
+		fut._req->ref();
+	}
+	if(_req)
+	{
+		_req->unref();
+	}
+	_req = fut._req;
+	return *this;
+}
+
+bool Future::isOk()const
+{
+	return _req != NULL;
+}
+
+bool Future::isReady()const
+{
+	return _req && _req->isReady();
+}
+
+void Future::wait()const
+{
+	if(_req)
+	{
+		_req->wait();
+	}
+}
+
+bool Future::wait(long timeout)const
+{
+	return _req && _req->wait(timeout);
+}
+
+std::vector<std::string> Future::get()const throw(NutException)
+{
+	if(!_req)
+	{
+		throw NutException("No request");
+	}
+	_req->check();
+	return _req->rows.empty() ? std::vector<std::string>() : _req->rows[0];
+}
+
+std::vector<std::vector<std::string> > Future::getList()const throw(NutException)
+{
+	if(!_req)
+	{
+		throw NutException("No request");
+	}
+	_req->check();
+	return _req->rows;
+}
+
+
+AsyncTcpClient::AsyncTcpClient(const std::string& host, int port)throw(IOException):
+_host(host),
+_port(port),
+_conn(new internal::AsyncConnection(host, port))
+{
+}
+
+AsyncTcpClient::~AsyncTcpClient()
+{
+	delete _conn;
+}
+
+bool AsyncTcpClient::isConnected()const
+{
+	return _conn->isConnected();
+}
+
+std::string AsyncTcpClient::getHost()const
+{
+	return _host;
+}
+
+int AsyncTcpClient::getPort()const
+{
+	return _port;
+}
+
+Future AsyncTcpClient::get(const std::string& subcmd, const std::string& params,
+	AsyncCallback callback, void* arg)
+{
+	std::string req = subcmd;
+	if(!params.empty())
+	{
+		req += " " + params;
+	}
+	return _conn->send(new internal::AsyncRequest(internal::AsyncRequest::GET, req, 1, callback, arg),
+		"GET " + req + "\n");
+}
+
+Future AsyncTcpClient::list(const std::string& subcmd, const std::string& params,
+	AsyncCallback callback, void* arg)
+{
+	std::string req = subcmd;
+	if(!params.empty())
+	{
+		req += " " + params;
+	}
+	return _conn->send(new internal::AsyncRequest(internal::AsyncRequest::LIST, req, 1, callback, arg),
+		"LIST " + req + "\n");
+}
+
+Future AsyncTcpClient::authenticate(const std::string& user, const std::string& passwd,
+	AsyncCallback callback, void* arg)
+{
+	return _conn->send(new internal::AsyncRequest(internal::AsyncRequest::ACK, "", 2, callback, arg),
+		"USERNAME " + user + "\nPASSWORD " + passwd + "\n");
+}
+
+Future AsyncTcpClient::getDevices(AsyncCallback callback, void* arg)
+{
+	return list("UPS", "", callback, arg);
+}
+
+Future AsyncTcpClient::getDeviceDescription(const std::string& dev,
+	AsyncCallback callback, void* arg)
+{
+	return get("UPSDESC", dev, callback, arg);
+}
+
+Future AsyncTcpClient::getDeviceVariableValue(const std::string& dev, const std::string& name,
+	AsyncCallback callback, void* arg)
+{
+	return get("VAR", dev + " " + name, callback, arg);
+}
+
+Future AsyncTcpClient::getDeviceVariableValues(const std::string& dev,
+	AsyncCallback callback, void* arg)
+{
+	return list("VAR", dev, callback, arg);
+}
+
+Future AsyncTcpClient::getDeviceVariableDescription(const std::string& dev, const std::string& name,
+	AsyncCallback callback, void* arg)
+{
+	return get("DESC", dev + " " + name, callback, arg);
+}
+
+Future AsyncTcpClient::setDeviceVariable(const std::string& dev, const std::string& name, const std::string& value,
+	AsyncCallback callback, void* arg)
+{
+	return _conn->send(new internal::AsyncRequest(internal::AsyncRequest::ACK, "", 1, callback, arg),
+		"SET VAR " + dev + " " + name + " " + TcpClient::escape(value) + "\n");
+}
+
+Future AsyncTcpClient::getDeviceCommandNames(const std::string& dev,
+	AsyncCallback callback, void* arg)
+{
+	return list("CMD", dev, callback, arg);
+}
+
+Future AsyncTcpClient::executeDeviceCommand(const std::string& dev, const std::string& name,
+	AsyncCallback callback, void* arg)
+{
+	return _conn->send(new internal::AsyncRequest(internal::AsyncRequest::ACK, "", 1, callback, arg),
+		"INSTCMD " + dev + " " + name + "\n");
+}
+
+#endif /* HAVE_PTHREAD */
+
 } /* namespace nut */
 
 
@@ -35,14 +35,20 @@ namespace nut
 namespace internal
 {
 class Socket;
+class Cache;
+class AsyncRequest;
+class AsyncConnection;
 } /* namespace internal */
 
 
 class Client;
 class TcpClient;
+class CachedClient;
 class Device;
 class Variable;
 class Command;
+class Future;
+class AsyncTcpClient;
 
 /**
  * Basic nut exception.
@@ -174,6 +180,14 @@ public:
 	 * \return Device description.
 	 */
 	virtual std::string getDeviceDescription(const std::string& name)throw(NutException)=0;
+	/**
+	 * Retrieve the descriptions of several devices at once.
+	 * The requests are pipelined when the client supports it.
+	 * \param devs Device names.
+	 * \return Device descriptions indexed by device names, without the
+	 * devices which could not be retrieved.
+	 */
+	virtual std::map<std::string,std::string> getDeviceDescriptions(const std::set<std::string>& devs)throw(NutException);
 	/** \} */
 
 	/**
@@ -220,6 +234,32 @@ public:
 	 * \return Variable values indexed by variable names.
 	 */
 	virtual std::map<std::string,std::vector<std::string> > getDeviceVariableValues(const std::string& dev)throw(NutException);
+	/**
+	 * Retrieve values of several variables of a device at once.
+	 * The requests are pipelined when the client supports it.
+	 * \param dev Device name
+	 * \param names Variable names
+	 * \return Variable values indexed by variable names, without the
+	 * variables which could not be retrieved.
+	 */
+	virtual std::map<std::string,std::vector<std::string> > getDeviceVariableValues(const std::string& dev, const std::set<std::string>& names)throw(NutException);
+	/**
+	 * Retrieve values of all variables of several devices at once.
+	 * The requests are pipelined when the client supports it.
+	 * \param devs Device names
+	 * \return Variable values indexed by device names then variable names,
+	 * without the devices which could not be retrieved.
+	 */
+	virtual std::map<std::string,std::map<std::string,std::vector<std::string> > > getDevicesVariableValues(const std::set<std::string>& devs)throw(NutException);
+	/**
+	 * Retrieve the descriptions of several variables of a device at once.
+	 * The requests are pipelined when the client supports it.
+	 * \param dev Device name
+	 * \param names Variable names
+	 * \return Variable descriptions indexed by variable names, without the
+	 * variables which could not be retrieved.
+	 */
+	virtual std::map<std::string,std::string> getDeviceVariableDescriptions(const std::string& dev, const std::set<std::string>& names)throw(NutException);
 	/**
 	 * Intend to set the value of a variable.
 	 * \param dev Device name
@@ -297,6 +337,8 @@ protected:
  */
 class TcpClient : public Client
 {
+	friend class AsyncTcpClient;
+	friend class internal::AsyncConnection;
 public:
 	/**
 	 * Construct a nut TcpClient object.
@@ -364,12 +406,16 @@ public:
 	virtual Device getDevice(const std::string& name)throw(NutException);
 	virtual std::set<std::string> getDeviceNames()throw(NutException);
 	virtual std::string getDeviceDescription(const std::string& name)throw(NutException);
+	virtual std::map<std::string,std::string> getDeviceDescriptions(const std::set<std::string>& devs)throw(NutException);
 
 	virtual std::set<std::string> getDeviceVariableNames(const std::string& dev)throw(NutException);
 	virtual std::set<std::string> getDeviceRWVariableNames(const std::string& dev)throw(NutException);
 	virtual std::string getDeviceVariableDescription(const std::string& dev, const std::string& name)throw(NutException);
 	virtual std::vector<std::string> getDeviceVariableValue(const std::string& dev, const std::string& name)throw(NutException);
 	virtual std::map<std::string,std::vector<std::string> > getDeviceVariableValues(const std::string& dev)throw(NutException);
+	virtual std::map<std::string,std::vector<std::string> > getDeviceVariableValues(const std::string& dev, const std::set<std::string>& names)throw(NutException);
+	virtual std::map<std::string,std::map<std::string,std::vector<std::string> > > getDevicesVariableValues(const std::set<std::string>& devs)throw(NutException);
+	virtual std::map<std::string,std::string> getDeviceVariableDescriptions(const std::string& dev, const std::set<std::string>& names)throw(NutException);
 	virtual void setDeviceVariable(const std::string& dev, const std::string& name, const std::string& value)throw(NutException);
 	virtual void setDeviceVariable(const std::string& dev, const std::string& name, const std::vector<std::string>& values)throw(NutException);
 
@@ -393,9 +439,16 @@ protected:
 		throw(nut::NutException);
 
 	static std::vector<std::string> explode(const std::string& str, size_t begin=0);
+	static void explode(const std::string& str, size_t begin, std::vector<std::string>& res);
 	static std::string escape(const std::string& str);
 
 private:
+	void listBegin(const std::string& req)throw(nut::NutException);
+	bool listNext(const std::string& req, std::vector<std::string>& fields)throw(nut::NutException);
+
+	size_t sendQueries(const std::string& cmd, const std::vector<std::string>& reqs, size_t begin, size_t& inflight)throw(nut::IOException);
+	void getMulti(const std::vector<std::string>& reqs, std::vector<std::vector<std::string> >& res, std::vector<bool>& found)throw(nut::NutException);
+
 	std::string _host;
 	int _port;
 	long _timeout;
@@ -403,6 +456,109 @@ private:
 };
 
 
+/**
+ * Client caching the answers of another client.
+ * Answers are kept for a time to live depending on their kind, during
+ * which they are read again without any request to NUTD.  Devices,
+ * variables and commands retrieved from the cached client use its cache.
+ * The writes done through it invalidate the values they change.
+ */
+class CachedClient : public Client
+{
+public:
+	/**
+	 * Kinds of cached answers, which have their own time to live.
+	 */
+	enum CacheKind
+	{
+		/** Descriptions of devices, variables and commands. Default: never expire. */
+		CACHE_DESCRIPTIONS,
+		/** Names of devices, variables and commands. Default: never expire. */
+		CACHE_NAMES,
+		/** Values of variables. Default: 1 second. */
+		CACHE_VALUES
+	};
+
+	/**
+	 * Construct a cache for a client.
+	 * \param client Client to cache, which must remain valid.
+	 */
+	CachedClient(Client& client);
+	~CachedClient();
+
+	/**
+	 * Set the time to live of a kind of answers.
+	 * It applies to the answers received afterwards.
+	 * \param kind Kind of answers.
+	 * \param ttl Time to live in milliseconds, 0 to not cache them, negative
+	 * to keep them until they are invalidated.
+	 */
+	void setTTL(CacheKind kind, long ttl);
+	/**
+	 * Retrieve the time to live of a kind of answers.
+	 * \param kind Kind of answers.
+	 * \return Time to live in milliseconds.
+	 */
+	long getTTL(CacheKind kind)const;
+
+	/**
+	 * Drop all the cached answers.
+	 */
+	void invalidate();
+	/**
+	 * Drop the cached answers about a device, its variables and commands.
+	 * \param dev Device name.
+	 */
+	void invalidate(const std::string& dev);
+	/**
+	 * Drop the cached value and description of a variable.
+	 * \param dev Device name.
+	 * \param name Variable name.
+	 */
+	void invalidate(const std::string& dev, const std::string& name);
+
+	/**
+	 * Fill the cache with the names and values of all variables of a
+	 * device, with a single request.
+	 * \param dev Device name.
+	 */
+	void warmUp(const std::string& dev)throw(NutException);
+
+	virtual void authenticate(const std::string& user, const std::string& passwd)throw(NutException);
+	virtual void logout()throw(NutException);
+
+	virtual std::set<std::string> getDeviceNames()throw(NutException);
+	virtual std::string getDeviceDescription(const std::string& name)throw(NutException);
+	virtual std::map<std::string,std::string> getDeviceDescriptions(const std::set<std::string>& devs)throw(NutException);
+
+	virtual std::set<std::string> getDeviceVariableNames(const std::string& dev)throw(NutException);
+	virtual std::set<std::string> getDeviceRWVariableNames(const std::string& dev)throw(NutException);
+	virtual std::string getDeviceVariableDescription(const std::string& dev, const std::string& name)throw(NutException);
+	virtual std::vector<std::string> getDeviceVariableValue(const std::string& dev, const std::string& name)throw(NutException);
+	virtual std::map<std::string,std::vector<std::string> > getDeviceVariableValues(const std::string& dev)throw(NutException);
+	virtual std::map<std::string,std::vector<std::string> > getDeviceVariableValues(const std::string& dev, const std::set<std::string>& names)throw(NutException);
+	virtual std::map<std::string,std::map<std::string,std::vector<std::string> > > getDevicesVariableValues(const std::set<std::string>& devs)throw(NutException);
+	virtual std::map<std::string,std::string> getDeviceVariableDescriptions(const std::string& dev, const std::set<std::string>& names)throw(NutException);
+	virtual void setDeviceVariable(const std::string& dev, const std::string& name, const std::string& value)throw(NutException);
+	virtual void setDeviceVariable(const std::string& dev, const std::string& name, const std::vector<std::string>& values)throw(NutException);
+
+	virtual std::set<std::string> getDeviceCommandNames(const std::string& dev)throw(NutException);
+	virtual std::string getDeviceCommandDescription(const std::string& dev, const std::string& name)throw(NutException);
+	virtual void executeDeviceCommand(const std::string& dev, const std::string& name)throw(NutException);
+
+	virtual void deviceLogin(const std::string& dev)throw(NutException);
+	virtual void deviceMaster(const std::string& dev)throw(NutException);
+	virtual void deviceForcedShutdown(const std::string& dev)throw(NutException);
+	virtual int deviceGetNumLogins(const std::string& dev)throw(NutException);
+
+private:
+	CachedClient(const CachedClient&);
+	CachedClient& operator=(const CachedClient&);
+
+	Client& _client;
+	internal::Cache* _cache;
+};
+
 /**
  * Device attached to a client.
  * Device is a lightweight class which can be copied easily.
@@ -468,6 +624,18 @@ public:
 	 * \return Map of all variables values indexed by their names.
 	 */
 	std::map<std::string,std::vector<std::string> > getVariableValues()throw(NutException);
+	/**
+	 * Intend to retrieve values of several variables of the device at once.
+	 * \param names Names of the variables to get.
+	 * \return Map of the variables values indexed by their names.
+	 */
+	std::map<std::string,std::vector<std::string> > getVariableValues(const std::set<std::string>& names)throw(NutException);
+	/**
+	 * Intend to retrieve descriptions of several variables of the device at once.
+	 * \param names Names of the variables.
+	 * \return Map of the variables descriptions indexed by their names.
+	 */
+	std::map<std::string,std::string> getVariableDescriptions(const std::set<std::string>& names)throw(NutException);
 	/**
 	 * Retrieve all variables names supported by the device.
 	 * \return Set of available variable names.
@@ -699,6 +867,197 @@ private:
 	std::string _name;
 };
 
+/**
+ * Answer of a request sent with an AsyncTcpClient.
+ * The answer, or the error, becomes available once it is received.
+ * Future is a lightweight class which can be copied easily, and used from
+ * any thread.
+ */
+class Future
+{
+	friend class internal::AsyncRequest;
+	friend class internal::AsyncConnection;
+public:
+	Future();
+	Future(const Future& fut);
+	~Future();
+	Future& operator=(const Future& fut);
+
+	/**
+	 * Test if the future is attached to a request.
+	 */
+	bool isOk()const;
+	/**
+	 * Test if the answer, or the error, is available.
+	 */
+	bool isReady()const;
+	/**
+	 * Wait for the answer.
+	 */
+	void wait()const;
+	/**
+	 * Wait for the answer, at most the specified time.
+	 * \param timeout Timeout in milliseconds.
+	 * \return true if the answer is available.
+	 */
+	bool wait(long timeout)const;
+
+	/**
+	 * Wait for the answer of a single answer request (GET, SET, INSTCMD...).
+	 * \return Fields of the answer, the values of a variable for example.
+	 * Empty for requests which are only acknowledged by the server.
+	 * \throw IOException if the connection failed, or NutException with the
+	 * error sent by the server.
+	 */
+	std::vector<std::string> get()const throw(NutException);
+	/**
+	 * Wait for the answer of a LIST request.
+	 * \return Fields of each element of the list.
+	 * \throw IOException if the connection failed, or NutException with the
+	 * error sent by the server.
+	 */
+	std::vector<std::vector<std::string> > getList()const throw(NutException);
+
+protected:
+	Future(internal::AsyncRequest* req);
+
+private:
+	internal::AsyncRequest* _req;
+};
+
+/**
+ * Callback of an asynchronous request.
+ * It is called once the answer is available, from the I/O thread of the
+ * client, or from the requesting thread if the client is not connected.
+ * It must not wait for another answer from the same client, nor destroy it.
+ * \param answer Answer of the request, ready.
+ * \param arg Argument given with the request.
+ */
+typedef void (*AsyncCallback)(const Future& answer, void* arg);
+
+/**
+ * Asynchronous TCP NUTD client.
+ * Requests return at once a Future of their answer, and optionally call
+ * a callback when it is received.  They are pipelined over one connection
+ * by an I/O thread owned by the client, and their answers are matched to
+ * them in order.
+ * The client can be shared between threads, without locking.
+ * It is only part of the library when it is built with POSIX threads.
+ */
+class AsyncTcpClient
+{
+public:
+	/**
+	 * Construct a nut AsyncTcpClient object, connected to the specified server.
+	 * \param host Server host name.
+	 * \param port Server port.
+	 */
+	AsyncTcpClient(const std::string& host, int port = 3493)throw(nut::IOException);
+	/**
+	 * Disconnect from the server.
+	 * The requests still waiting for their answer fail.
+	 */
+	~AsyncTcpClient();
+
+	/**
+	 * Test if the connection is active.
+	 * Once it failed, all the requests fail.
+	 */
+	bool isConnected()const;
+	/**
+	 * Retrieve the host name of the server the client is connected to.
+	 */
+	std::string getHost()const;
+	/**
+	 * Retrieve the port of the server the client is connected to.
+	 */
+	int getPort()const;
+
+	/**
+	 * Send a GET request.
+	 * \param subcmd GET sub-command, "VAR" for example.
+	 * \param params Parameters of the sub-command.
+	 * \param callback Callback to call with the answer, if not NULL.
+	 * \param arg Argument given to callback.
+	 * \return Future of the answer fields following the request.
+	 */
+	Future get(const std::string& subcmd, const std::string& params = "",
+		AsyncCallback callback = NULL, void* arg = NULL);
+	/**
+	 * Send a LIST request.
+	 * \param subcmd LIST sub-command, "VAR" for example.
+	 * \param params Parameters of the sub-command.
+	 * \param callback Callback to call with the answer, if not NULL.
+	 * \param arg Argument given to callback.
+	 * \return Future of the fields following the request in each element of
+	 * the list.
+	 */
+	Future list(const std::string& subcmd, const std::string& params = "",
+		AsyncCallback callback = NULL, void* arg = NULL);
+
+	/**
+	 * Authenticate to the server.
+	 * The requests sent afterwards are done as this user.
+	 */
+	Future authenticate(const std::string& user, const std::string& passwd,
+		AsyncCallback callback = NULL, void* arg = NULL);
+	/**
+	 * Retrieve the names and descriptions of the devices.
+	 * \see list()
+	 */
+	Future getDevices(AsyncCallback callback = NULL, void* arg = NULL);
+	/**
+	 * Retrieve the description of a device.
+	 * \see get()
+	 */
+	Future getDeviceDescription(const std::string& dev,
+		AsyncCallback callback = NULL, void* arg = NULL);
+	/**
+	 * Retrieve values of a variable.
+	 * \see get()
+	 */
+	Future getDeviceVariableValue(const std::string& dev, const std::string& name,
+		AsyncCallback callback = NULL, void* arg = NULL);
+	/**
+	 * Retrieve names and values of all variables of a device.
+	 * \see list()
+	 */
+	Future getDeviceVariableValues(const std::string& dev,
+		AsyncCallback callback = NULL, void* arg = NULL);
+	/**
+	 * Retrieve the description of a variable.
+	 * \see get()
+	 */
+	Future getDeviceVariableDescription(const std::string& dev, const std::string& name,
+		AsyncCallback callback = NULL, void* arg = NULL);
+	/**
+	 * Intend to set the value of a variable.
+	 * Requires to be authenticated.
+	 */
+	Future setDeviceVariable(const std::string& dev, const std::string& name, const std::string& value,
+		AsyncCallback callback = NULL, void* arg = NULL);
+	/**
+	 * Retrieve names of all commands supported by a device.
+	 * \see list()
+	 */
+	Future getDeviceCommandNames(const std::string& dev,
+		AsyncCallback callback = NULL, void* arg = NULL);
+	/**
+	 * Intend to execute a command.
+	 * Requires to be authenticated.
+	 */
+	Future executeDeviceCommand(const std::string& dev, const std::string& name,
+		AsyncCallback callback = NULL, void* arg = NULL);
+
+private:
+	AsyncTcpClient(const AsyncTcpClient&);
+	AsyncTcpClient& operator=(const AsyncTcpClient&);
+
+	std::string _host;
+	int _port;
+	internal::AsyncConnection* _conn;
+};
+
 } /* namespace nut */
 
 #endif /* __cplusplus */
@@ -0,0 +1,646 @@
+/* upsclibench - measure the request throughput of libupsclient
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "common.h"
+#include "nut_platform.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include "upsclient.h"
+#include "timehead.h"
+
+static pid_t	proxy_pid = -1;
+
+/* data in transit through the delay proxy */
+typedef struct chunk_s {
+	struct timeval	due;
+	size_t		len, off;
+	char		data[UPSCLI_NETBUF_LEN];
+	struct chunk_s	*next;
+} chunk_t;
+
+static void usage(const char *prog)
+{
+	printf("Network UPS Tools upsclibench %s\n\n", UPS_VERSION);
+
+	printf("usage: %s [-n <count>] [-d <rtt>] [-b <size>] <ups> [<variable> ...]\n", prog);
+	printf("       %s -l [-n <count>] [-d <rtt>] [-b <size>] <ups>\n", prog);
+	printf("       %s -a <conns> [-n <count>] [-d <rtt>] <ups> [<variable> ...]\n", prog);
+
+	printf("\nMeasure the time taken by <count> GET VAR requests to upsd, sent one\n");
+	printf("by one with upscli_get(), then pipelined with upscli_get_multi().\n");
+	printf("With -l, measure the time taken by <count> LIST VAR of the UPS instead.\n");
+	printf("With -a, spread the GET VAR requests over <conns> asynchronous connections.\n\n");
+
+	printf("  -l         - benchmark LIST VAR, for UPSes with many variables (such as\n");
+	printf("               dummy-ups serving data/epdu-managed-3026.dev)\n");
+	printf("  -a <conns> - benchmark the asynchronous API, with <conns> connections\n");
+	printf("  -n <count> - number of requests or listings (default: 10000)\n");
+	printf("  -d <rtt>   - emulate a link with this round trip time, in ms\n");
+	printf("  -b <size>  - size of the receive buffer (default: %d)\n", UPSCLI_READBUF_LEN);
+	printf("  <ups>      - upsd server, <upsname>[@<hostname>[:<port>]] form\n");
+	printf("  <variable> - variables to request in turn (default: ups.status)\n");
+}
+
+static double elapsed(const struct timeval *start)
+{
+	struct timeval	now;
+
+	gettimeofday(&now, NULL);
+
+	return (now.tv_sec - start->tv_sec) + (now.tv_usec - start->tv_usec) / 1000000.0;
+}
+
+static int due_in(const struct timeval *due)
+{
+	struct timeval	now;
+	long	ms;
+
+	gettimeofday(&now, NULL);
+
+	ms = (due->tv_sec - now.tv_sec) * 1000 + (due->tv_usec - now.tv_usec) / 1000;
+
+	return (ms > 0) ? ms : 0;
+}
+
+/* read what's available on 'from' and queue it for later delivery */
+static int proxy_recv(int from, chunk_t **head, chunk_t **tail, int delay)
+{
+	chunk_t	*chunk;
+	ssize_t	ret;
+
+	chunk = xcalloc(1, sizeof(*chunk));
+
+	ret = read(from, chunk->data, sizeof(chunk->data));
+
+	if (ret < 1) {
+		free(chunk);
+		return -1;
+	}
+
+	chunk->len = ret;
+
+	gettimeofday(&chunk->due, NULL);
+	chunk->due.tv_usec += delay * 1000;
+	chunk->due.tv_sec += chunk->due.tv_usec / 1000000;
+	chunk->due.tv_usec %= 1000000;
+
+	if (*tail) {
+		(*tail)->next = chunk;
+	} else {
+		*head = chunk;
+	}
+
+	*tail = chunk;
+
+	return 0;
+}
+
+/* deliver the queued data which is due */
+static int proxy_send(int to, chunk_t **head, chunk_t **tail)
+{
+	chunk_t	*chunk;
+	ssize_t	ret;
+
+	while ((chunk = *head) != NULL) {
+
+		if (due_in(&chunk->due) > 0) {
+			return 0;
+		}
+
+		ret = write(to, &chunk->data[chunk->off], chunk->len - chunk->off);
+
+		if (ret < 1) {
+			return -1;
+		}
+
+		chunk->off += ret;
+
+		if (chunk->off < chunk->len) {
+			return 0;
+		}
+
+		*head = chunk->next;
+
+		if (!*head) {
+			*tail = NULL;
+		}
+
+		free(chunk);
+	}
+
+	return 0;
+}
+
+/* forward a connection to upsd, delaying the data by half the round
+ * trip time in each direction */
+static void proxy_run(int client, const struct sockaddr_in *server, int rtt)
+{
+	struct pollfd	fds[2];
+	chunk_t	*head[2] = { NULL, NULL }, *tail[2] = { NULL, NULL };
+	int	i, timeout;
+
+	fds[0].fd = client;
+	fds[1].fd = socket(AF_INET, SOCK_STREAM, 0);
+
+	if ((fds[1].fd < 0) || (connect(fds[1].fd, (const struct sockaddr *)server, sizeof(*server)) < 0)) {
+		fatal_with_errno(EXIT_FAILURE, "connect");
+	}
+
+	for (;;) {
+		timeout = -1;
+
+		for (i = 0; i < 2; i++) {
+			/* head[i] is waiting to be written to fds[i] */
+			fds[i].events = POLLIN;
+
+			if (head[i]) {
+				if (due_in(&head[i]->due) > 0) {
+					if ((timeout < 0) || (due_in(&head[i]->due) < timeout)) {
+						timeout = due_in(&head[i]->due);
+					}
+				} else {
+					fds[i].events |= POLLOUT;
+				}
+			}
+		}
+
+		if (poll(fds, 2, timeout) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			fatal_with_errno(EXIT_FAILURE, "poll");
+		}
+
+		for (i = 0; i < 2; i++) {
+			if (fds[i].revents & (POLLIN | POLLHUP)) {
+				if (proxy_recv(fds[i].fd, &head[!i], &tail[!i], rtt / 2) < 0) {
+					exit(EXIT_SUCCESS);
+				}
+			}
+
+			if (proxy_send(fds[i].fd, &head[i], &tail[i]) < 0) {
+				exit(EXIT_SUCCESS);
+			}
+		}
+	}
+}
+
+/* start the delay proxy, and return the port to connect to */
+static int proxy_start(const char *hostname, int port, int rtt)
+{
+	struct addrinfo	hints, *res;
+	struct sockaddr_in	server, local;
+	socklen_t	len = sizeof(local);
+	char	sport[NI_MAXSERV];
+	int	listener, client;
+
+	snprintf(sport, sizeof(sport), "%d", port);
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+
+	if (getaddrinfo(hostname, sport, &hints, &res) != 0) {
+		fatalx(EXIT_FAILURE, "Can't resolve %s", hostname);
+	}
+
+	memcpy(&server, res->ai_addr, sizeof(server));
+	freeaddrinfo(res);
+
+	memset(&local, 0, sizeof(local));
+	local.sin_family = AF_INET;
+	local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	listener = socket(AF_INET, SOCK_STREAM, 0);
+
+	if ((listener < 0) ||
+		(bind(listener, (struct sockaddr *)&local, sizeof(local)) < 0) ||
+		(listen(listener, 16) < 0) ||
+		(getsockname(listener, (struct sockaddr *)&local, &len) < 0)) {
+		fatal_with_errno(EXIT_FAILURE, "Can't start the delay proxy");
+	}
+
+	proxy_pid = fork();
+
+	if (proxy_pid < 0) {
+		fatal_with_errno(EXIT_FAILURE, "fork");
+	}
+
+	if (proxy_pid > 0) {
+		close(listener);
+		return ntohs(local.sin_port);
+	}
+
+	/* one process per connection */
+	signal(SIGCHLD, SIG_IGN);
+
+	for (;;) {
+		client = accept(listener, NULL, NULL);
+
+		if (client < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			fatal_with_errno(EXIT_FAILURE, "accept");
+		}
+
+		switch (fork())
+		{
+		case -1:
+			fatal_with_errno(EXIT_FAILURE, "fork");
+		case 0:
+			close(listener);
+			proxy_run(client, &server, rtt);
+			exit(EXIT_SUCCESS);
+		}
+
+		close(client);
+	}
+}
+
+/* time 'count' GET VAR, one by one then pipelined */
+static void bench_get(UPSCONN_t *ups, const char *upsname, unsigned int count,
+	const char **var, unsigned int numvar)
+{
+	UPSCLI_QUERY_t	*req;
+	struct timeval	start;
+	char	**answer;
+	const char	***query;
+	unsigned int	i, numa;
+	int	failed = 0, ret;
+	double	seq, multi;
+
+	/* the same queries for both runs */
+	query = xcalloc(numvar, sizeof(*query));
+
+	for (i = 0; i < numvar; i++) {
+		query[i] = xcalloc(3, sizeof(**query));
+		query[i][0] = "VAR";
+		query[i][1] = upsname;
+		query[i][2] = var[i];
+	}
+
+	gettimeofday(&start, NULL);
+
+	for (i = 0; i < count; i++) {
+		if (upscli_get(ups, 3, query[i % numvar], &numa, &answer) < 0) {
+			if (upscli_fd(ups) < 0) {
+				fatalx(EXIT_FAILURE, "Error: %s", upscli_strerror(ups));
+			}
+
+			failed++;
+		}
+	}
+
+	seq = elapsed(&start);
+
+	req = xcalloc(count, sizeof(*req));
+
+	for (i = 0; i < count; i++) {
+		req[i].numq = 3;
+		req[i].query = query[i % numvar];
+	}
+
+	gettimeofday(&start, NULL);
+
+	ret = upscli_get_multi(ups, count, req);
+
+	multi = elapsed(&start);
+
+	if (ret < 0) {
+		fatalx(EXIT_FAILURE, "Error: %s", upscli_strerror(ups));
+	}
+
+	printf("%-12s %10s %10s %10s %10s\n", "mode", "requests", "failed", "time(s)", "req/s");
+	printf("%-12s %10u %10d %10.3f %10.0f\n", "get", count, failed, seq, count / seq);
+	printf("%-12s %10u %10d %10.3f %10.0f\n", "get_multi", count, ret, multi, count / multi);
+
+	upscli_free_multi(count, req);
+	free(req);
+
+	for (i = 0; i < numvar; i++) {
+		free(query[i]);
+	}
+
+	free(query);
+}
+
+static double cputime(void)
+{
+	struct rusage	ru;
+
+	getrusage(RUSAGE_SELF, &ru);
+
+	return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1000000.0 +
+		ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1000000.0;
+}
+
+/* time 'count' LIST VAR of the UPS, with the generic list functions then
+ * with the LIST VAR iterator */
+static void bench_list(UPSCONN_t *ups, const char *upsname, unsigned int count)
+{
+	struct timeval	start;
+	char	**answer;
+	const char	*query[2], *var, *val;
+	unsigned int	i, numa, numvar = 0;
+	double	list, cpu;
+
+	query[0] = "VAR";
+	query[1] = upsname;
+
+	printf("%-12s %10s %10s %10s %10s %10s\n", "mode", "listings", "vars", "time(s)", "cpu(s)", "vars/s");
+
+	gettimeofday(&start, NULL);
+	cpu = cputime();
+
+	for (i = 0; i < count; i++) {
+		if (upscli_list_start(ups, 2, query) < 0) {
+			fatalx(EXIT_FAILURE, "Error: %s", upscli_strerror(ups));
+		}
+
+		while (upscli_list_next(ups, 2, query, &numa, &answer) == 1) {
+			numvar++;
+		}
+	}
+
+	list = elapsed(&start);
+	cpu = cputime() - cpu;
+
+	printf("%-12s %10u %10u %10.3f %10.3f %10.0f\n", "list_next", count, numvar / count, list, cpu, numvar / list);
+
+	numvar = 0;
+	gettimeofday(&start, NULL);
+	cpu = cputime();
+
+	for (i = 0; i < count; i++) {
+		if (upscli_list_var_start(ups, upsname) < 0) {
+			fatalx(EXIT_FAILURE, "Error: %s", upscli_strerror(ups));
+		}
+
+		while (upscli_list_var_next(ups, upsname, &var, &val) == 1) {
+			numvar++;
+		}
+	}
+
+	list = elapsed(&start);
+	cpu = cputime() - cpu;
+
+	printf("%-12s %10u %10u %10.3f %10.3f %10.0f\n", "list_var", count, numvar / count, list, cpu, numvar / list);
+}
+
+/* one connection of the asynchronous benchmark */
+typedef struct {
+	UPSCONN_t	ups;
+	const char	***query;
+	unsigned int	numvar;
+	unsigned int	total, sent, done;
+	int	failed;
+} bench_conn_t;
+
+static void bench_async_queue(bench_conn_t *conn);
+
+static void bench_async_answer(UPSCONN_t *ups, void *arg, int status,
+	unsigned int numa, char **answer)
+{
+	bench_conn_t	*conn = arg;
+
+	conn->done++;
+
+	if (status < 0) {
+		conn->failed++;
+	}
+
+	bench_async_queue(conn);
+}
+
+static void bench_async_connected(UPSCONN_t *ups, void *arg, int status,
+	unsigned int numa, char **answer)
+{
+	bench_conn_t	*conn = arg;
+
+	if (status < 0) {
+		upslogx(LOG_ERR, "Connection failed: %s", upscli_strerror(ups));
+		conn->done = conn->total;
+		return;
+	}
+
+	bench_async_queue(conn);
+}
+
+/* keep up to 32 requests in flight on the connection */
+static void bench_async_queue(bench_conn_t *conn)
+{
+	while ((conn->sent < conn->total) && (conn->sent - conn->done < 32)) {
+		if (upscli_get_async(&conn->ups, 3, conn->query[conn->sent % conn->numvar],
+			bench_async_answer, conn) < 0) {
+			fatalx(EXIT_FAILURE, "Error: %s", upscli_strerror(&conn->ups));
+		}
+
+		conn->sent++;
+	}
+}
+
+/* time 'count' GET VAR, spread over 'numconn' asynchronous connections
+ * handled by a single poll() loop */
+static void bench_async(const char *hostname, int port, const char *upsname,
+	unsigned int count, unsigned int numconn, const char **var, unsigned int numvar)
+{
+	bench_conn_t	*conn;
+	struct pollfd	*fds;
+	struct timeval	start;
+	const char	***query;
+	unsigned int	i, active, failed = 0;
+	int	events;
+	double	async;
+
+	query = xcalloc(numvar, sizeof(*query));
+
+	for (i = 0; i < numvar; i++) {
+		query[i] = xcalloc(3, sizeof(**query));
+		query[i][0] = "VAR";
+		query[i][1] = upsname;
+		query[i][2] = var[i];
+	}
+
+	conn = xcalloc(numconn, sizeof(*conn));
+	fds = xcalloc(numconn, sizeof(*fds));
+
+	gettimeofday(&start, NULL);
+
+	for (i = 0; i < numconn; i++) {
+		conn[i].query = query;
+		conn[i].numvar = numvar;
+		conn[i].total = count / numconn + (i < count % numconn);
+
+		if (upscli_connect_async(&conn[i].ups, hostname, port, 0,
+			bench_async_connected, &conn[i]) < 0) {
+			fatalx(EXIT_FAILURE, "Error: %s", upscli_strerror(&conn[i].ups));
+		}
+	}
+
+	for (;;) {
+		for (i = 0, active = 0; i < numconn; i++) {
+			events = upscli_async_events(&conn[i].ups);
+
+			fds[i].fd = -1;
+			fds[i].events = 0;
+
+			if (conn[i].done < conn[i].total) {
+				fds[i].fd = upscli_fd(&conn[i].ups);
+				fds[i].events = ((events & UPSCLI_EV_READ) ? POLLIN : 0) |
+					((events & UPSCLI_EV_WRITE) ? POLLOUT : 0);
+				active += (fds[i].fd >= 0);
+			}
+		}
+
+		if (active == 0) {
+			break;
+		}
+
+		if (poll(fds, numconn, -1) < 0) {
+			fatal_with_errno(EXIT_FAILURE, "poll");
+		}
+
+		for (i = 0; i < numconn; i++) {
+			events = ((fds[i].revents & (POLLIN | POLLHUP | POLLERR)) ? UPSCLI_EV_READ : 0) |
+				((fds[i].revents & (POLLOUT | POLLHUP | POLLERR)) ? UPSCLI_EV_WRITE : 0);
+
+			if (events) {
+				upscli_async_process(&conn[i].ups, events);
+			}
+		}
+	}
+
+	async = elapsed(&start);
+
+	for (i = 0; i < numconn; i++) {
+		failed += conn[i].failed + (conn[i].total - conn[i].done);
+		upscli_disconnect(&conn[i].ups);
+	}
+
+	printf("%-12s %10s %10s %10s %10s %10s\n", "mode", "conns", "requests", "failed", "time(s)", "req/s");
+	printf("%-12s %10u %10u %10u %10.3f %10.0f\n", "get_async", numconn, count, failed, async, count / async);
+
+	free(fds);
+	free(conn);
+
+	for (i = 0; i < numvar; i++) {
+		free(query[i]);
+	}
+
+	free(query);
+}
+
+int main(int argc, char **argv)
+{
+	UPSCONN_t	ups;
+	char	*upsname = NULL, *hostname = NULL;
+	const char	*defvar[] = { "ups.status" };
+	unsigned int	count = 10000;
+	int	opt, port, rtt = 0, listing = 0, readbuf = 0, numconn = 0;
+
+	while ((opt = getopt(argc, argv, "hla:n:d:b:")) != -1) {
+		switch (opt)
+		{
+		case 'a':
+			numconn = atoi(optarg);
+			break;
+		case 'b':
+			readbuf = atoi(optarg);
+			break;
+		case 'l':
+			listing = 1;
+			break;
+		case 'n':
+			count = atoi(optarg);
+			break;
+		case 'd':
+			rtt = atoi(optarg);
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+		}
+	}
+
+	argc -= optind;
+	argv += optind;
+
+	if ((argc < 1) || (count < 1)) {
+		usage("upsclibench");
+		exit(EXIT_FAILURE);
+	}
+
+	if (upscli_splitname(argv[0], &upsname, &hostname, &port) != 0) {
+		fatalx(EXIT_FAILURE, "Error: invalid UPS definition.\nRequired format: upsname[@hostname[:port]]");
+	}
+
+	signal(SIGPIPE, SIG_IGN);
+
+	if (rtt > 0) {
+		port = proxy_start(hostname, port, rtt);
+		free(hostname);
+		hostname = xstrdup("127.0.0.1");
+	}
+
+	if (numconn > 0) {
+		if (argc > 1) {
+			bench_async(hostname, port, upsname, count, numconn, (const char **)&argv[1], argc - 1);
+		} else {
+			bench_async(hostname, port, upsname, count, numconn, defvar, 1);
+		}
+	} else {
+		if (upscli_connect(&ups, hostname, port, 0) < 0) {
+			fatalx(EXIT_FAILURE, "Error: %s", upscli_strerror(&ups));
+		}
+
+		if ((readbuf > 0) && (upscli_set_readbuf_size(&ups, readbuf) < 0)) {
+			fatalx(EXIT_FAILURE, "Error: %s", upscli_strerror(&ups));
+		}
+
+		if (listing) {
+			bench_list(&ups, upsname, count);
+		} else if (argc > 1) {
+			bench_get(&ups, upsname, count, (const char **)&argv[1], argc - 1);
+		} else {
+			bench_get(&ups, upsname, count, defvar, 1);
+		}
+
+		upscli_disconnect(&ups);
+	}
+
+	free(upsname);
+	free(hostname);
+
+	if (proxy_pid > 0) {
+		kill(proxy_pid, SIGTERM);
+		wait(NULL);
+	}
+
+	exit(EXIT_SUCCESS);
+}
@@ -667,48 +667,33 @@ static int net_write(UPSCONN_t *ups, const char *buf, size_t buflen)
 
 #ifdef WITH_SSL
 
+/* Intend to initialize upscli with no ssl db if not already done.
+ * Compatibility stuff for old clients which do not initialize them.
+ */
+static void ssl_check_init(void)
+{
+	if (upscli_initialized==0) {
+		upsdebugx(3, "upscli not initialized, "
+			"force initialisation without SSL configuration");
+		upscli_init(0, NULL, NULL, NULL);
+	}
+}
+
 /*
+ * set up the SSL layer over the connection, once upsd accepted STARTTLS
+ *
  * 1 : OK
  * -1 : ERROR
  * 0 : SSL NOT SUPPORTED 
  */
-static int upscli_sslinit(UPSCONN_t *ups, int verifycert)
+static int ssl_prepare(UPSCONN_t *ups, int verifycert)
 {
-#ifdef WITH_OPENSSL
-	int res;
-#elif defined(WITH_NSS) /* WITH_OPENSSL */
+#ifdef WITH_NSS
 	SECStatus	status;
 	PRFileDesc	*socket;
 	HOST_CERT_t *cert; 
-#endif /* WITH_OPENSSL | WITH_NSS */
-	char	buf[UPSCLI_NETBUF_LEN];
-
-	/* Intend to initialize upscli with no ssl db if not already done.
-	 * Compatibility stuff for old clients which do not initialize them.
-	 */
-	if (upscli_initialized==0) {
-		upsdebugx(3, "upscli not initialized, "
-			"force initialisation without SSL configuration");
-		upscli_init(0, NULL, NULL, NULL);
-	}
-	
-	/* see if upsd even talks SSL/TLS */
-	snprintf(buf, sizeof(buf), "STARTTLS\n");
-
-	if (upscli_sendline(ups, buf, strlen(buf)) != 0) {
-		return -1;
-	}
-
-	if (upscli_readline(ups, buf, sizeof(buf)) != 0) {
-		return -1;
-	}
-
-	if (strncmp(buf, "OK STARTTLS", 11) != 0) {
-		return 0;		/* not supported */
-	}
+#endif /* WITH_NSS */
 
-	/* upsd is happy, so let's crank up the client */
-	
 #ifdef WITH_OPENSSL
 
 	if (!ssl_ctx) {
@@ -733,22 +718,6 @@ static int upscli_sslinit(UPSCONN_t *ups, int verifycert)
 		SSL_set_verify(ups->ssl, SSL_VERIFY_NONE, NULL);
 	}
 
-	res = SSL_connect(ups->ssl);
-	switch(res)
-	{
-	case 1:
-		upsdebugx(3, "SSL connected");
-		break;
-	case 0:
-		upslog_with_errno(1, "SSL_connect do not accept handshake.");
-		ssl_error(ups->ssl, res);
-		return -1;
-	default:
-		upslog_with_errno(1, "Unknown return value from SSL_connect %d", res);
-		ssl_error(ups->ssl, res);
-		return -1;
-	}	
-
 	return 1;
 
 #elif defined(WITH_NSS) /* WITH_OPENSSL */
@@ -822,8 +791,57 @@ static int upscli_sslinit(UPSCONN_t *ups, int verifycert)
 		return -1;
 	}
 
+	return 1;
+
+#endif /* WITH_OPENSSL | WITH_NSS */
+}
+
+/*
+ * run the SSL handshake, or continue it on a non-blocking connection
+ *
+ * 1 : OK
+ * -1 : ERROR
+ * 0 : WOULD BLOCK
+ */
+static int ssl_handshake(UPSCONN_t *ups)
+{
+#ifdef WITH_OPENSSL
+	int res;
+
+	res = SSL_connect(ups->ssl);
+	switch(res)
+	{
+	case 1:
+		upsdebugx(3, "SSL connected");
+		break;
+	case 0:
+		upslog_with_errno(1, "SSL_connect do not accept handshake.");
+		ssl_error(ups->ssl, res);
+		return -1;
+	default:
+		switch (SSL_get_error(ups->ssl, res))
+		{
+		case SSL_ERROR_WANT_READ:
+		case SSL_ERROR_WANT_WRITE:
+			return 0;
+		}
+
+		upslog_with_errno(1, "Unknown return value from SSL_connect %d", res);
+		ssl_error(ups->ssl, res);
+		return -1;
+	}	
+
+	return 1;
+
+#elif defined(WITH_NSS) /* WITH_OPENSSL */
+	SECStatus	status;
+
 	status = SSL_ForceHandshake(ups->ssl);
 	if (status != SECSuccess) {
+		if (PR_GetError() == PR_WOULD_BLOCK_ERROR) {
+			return 0;
+		}
+
 		nss_error("upscli_sslinit / SSL_ForceHandshake");
 		ups->ssl = NULL;
 		/* EKI wtf unimport or free the socket ? */
@@ -836,6 +854,45 @@ static int upscli_sslinit(UPSCONN_t *ups, int verifycert)
 #endif /* WITH_OPENSSL | WITH_NSS */
 }
 
+/*
+ * 1 : OK
+ * -1 : ERROR
+ * 0 : SSL NOT SUPPORTED 
+ */
+static int upscli_sslinit(UPSCONN_t *ups, int verifycert)
+{
+	char	buf[UPSCLI_NETBUF_LEN];
+	int	ret;
+
+	ssl_check_init();
+	
+	/* see if upsd even talks SSL/TLS */
+	snprintf(buf, sizeof(buf), "STARTTLS\n");
+
+	if (upscli_sendline(ups, buf, strlen(buf)) != 0) {
+		return -1;
+	}
+
+	if (upscli_readline(ups, buf, sizeof(buf)) != 0) {
+		return -1;
+	}
+
+	if (strncmp(buf, "OK STARTTLS", 11) != 0) {
+		return 0;		/* not supported */
+	}
+
+	/* upsd is happy, so let's crank up the client */
+
+	ret = ssl_prepare(ups, verifycert);
+
+	if (ret != 1) {
+		return ret;
+	}
+
+	/* a blocking connection never gets 0 */
+	return (ssl_handshake(ups) == 1) ? 1 : -1;
+}
+
 #else /* WITH_SSL */
 
 static int upscli_sslinit(UPSCONN_t *ups, int verifycert)
@@ -845,13 +902,70 @@ static int upscli_sslinit(UPSCONN_t *ups, int verifycert)
 
 #endif /* WITH_SSL */
 
+/* internal: the SSL wanted on a connection to host, from the CERTHOST
+ * settings for it, or else from the flags */
+static void ssl_settings(const char *host, int flags, int *certverify,
+	int *forcessl, int *tryssl)
+{
+	HOST_CERT_t	*hostcert;
+
+	hostcert = upscli_find_host_cert(host);
+	
+	if (hostcert != NULL) {
+		/* An host security rule is specified. */
+		*certverify	= hostcert->certverify;
+		*forcessl	= hostcert->forcessl;
+	} else {
+		*certverify	= (flags & UPSCLI_CONN_CERTVERIF) != 0 ? 1 : 0;
+		*forcessl	= (flags & UPSCLI_CONN_REQSSL) != 0 ? 1 : 0;
+	}
+	*tryssl = (flags & UPSCLI_CONN_TRYSSL) != 0 ? 1 : 0;
+}
+
+/* internal: decide if the connection may go on after an attempt to start
+ * SSL which returned ret, as upscli_sslinit does; -1 if it must be closed */
+static int ssl_result(UPSCONN_t *ups, int flags, int ret)
+{
+	int	certverify, forcessl, tryssl;
+
+	ssl_settings(ups->host, flags, &certverify, &forcessl, &tryssl);
+
+	if ((!tryssl) && (!forcessl)) {
+		return 0;
+	}
+
+	if (forcessl && ret != 1) {
+		upslogx(LOG_ERR, "Can not connect to %s in SSL, disconnect", ups->host);
+		ups->upserror = UPSCLI_ERR_SSLFAIL;
+		return -1;
+	} else if (tryssl && ret == -1) {
+		upslogx(LOG_NOTICE, "Error while connecting to %s, disconnect", ups->host);
+		return -1;
+	} else if (tryssl && ret == 0) {
+		if (certverify != 0) {
+			upslogx(LOG_NOTICE, "Can not connect to %s in SSL and "
+			"certificate is needed, disconnect", ups->host);
+			ups->upserror = UPSCLI_ERR_SSLFAIL;
+			return -1;
+		}
+		upsdebugx(3, "Can not connect to %s in SSL, continue uncrypted", ups->host);
+	} else {
+		upslogx(LOG_INFO, "Connected to %s in SSL", ups->host);
+		if (certverify == 0) {
+			/* you REALLY should set CERTVERIFY to 1 if using SSL... */
+			upslogx(LOG_WARNING, "Certificate verification is disabled");
+		}
+	}
+
+	return 0;
+}
+
 int upscli_tryconnect(UPSCONN_t *ups, const char *host, int port, int flags,struct timeval * timeout)
 {
 	int				sock_fd;
 	struct addrinfo	hints, *res, *ai;
 	char			sport[NI_MAXSERV];
 	int				v, certverify, tryssl, forcessl, ret;
-	HOST_CERT_t*	hostcert;
 	fd_set 			wfds;
 	int			error;
 	socklen_t		error_size;
@@ -861,6 +975,13 @@ int upscli_tryconnect(UPSCONN_t *ups, const char *host, int port, int flags,stru
 		return -1;
 	}
 
+	/* a connection used before keeps its buffers until disconnect */
+	if (ups->upsclient_magic == UPSCLIENT_MAGIC) {
+		pconf_finish(&ups->pc_ctx);
+		free(ups->readbuf);
+		free(ups->host);
+	}
+
 	/* clear out any lingering junk */
 	memset(ups, 0, sizeof(*ups));
 	ups->upsclient_magic = UPSCLIENT_MAGIC;
@@ -1004,43 +1125,14 @@ int upscli_tryconnect(UPSCONN_t *ups, const char *host, int port, int flags,stru
 
 	ups->port = port;
 
-	hostcert = upscli_find_host_cert(host);
-	
-	if (hostcert != NULL) {
-		/* An host security rule is specified. */
-		certverify	= hostcert->certverify;
-		forcessl	= hostcert->forcessl;
-	} else {
-		certverify	= (flags & UPSCLI_CONN_CERTVERIF) != 0 ? 1 : 0;
-		forcessl	= (flags & UPSCLI_CONN_REQSSL) != 0 ? 1 : 0;
-	}
-	tryssl = (flags & UPSCLI_CONN_TRYSSL) != 0 ? 1 : 0;
+	ssl_settings(host, flags, &certverify, &forcessl, &tryssl);
 	
 	if (tryssl || forcessl) {
 		ret = upscli_sslinit(ups, certverify);
-		if (forcessl && ret != 1) {
-			upslogx(LOG_ERR, "Can not connect to %s in SSL, disconnect", host);
-			ups->upserror = UPSCLI_ERR_SSLFAIL;
-			upscli_disconnect(ups);
-			return -1;
-		} else if (tryssl && ret == -1) {
-			upslogx(LOG_NOTICE, "Error while connecting to %s, disconnect", host);
+
+		if (ssl_result(ups, flags, ret) < 0) {
 			upscli_disconnect(ups);
 			return -1;
-		} else if (tryssl && ret == 0) {
-			if (certverify != 0) {
-				upslogx(LOG_NOTICE, "Can not connect to %s in SSL and "
-				"certificate is needed, disconnect", host);
-				upscli_disconnect(ups);
-				return -1;
-			}
-			upsdebugx(3, "Can not connect to %s in SSL, continue uncrypted", host);
-		} else {
-			upslogx(LOG_INFO, "Connected to %s in SSL", host);
-			if (certverify == 0) {
-				/* you REALLY should set CERTVERIFY to 1 if using SSL... */
-				upslogx(LOG_WARNING, "Certificate verification is disabled");
-			}
 		}
 	}
 	
@@ -1166,164 +1258,1688 @@ static int verify_resp(int num, const char **q, char **a)
 	return 1;	/* OK */
 }
 
-int upscli_get(UPSCONN_t *ups, unsigned int numq, const char **query, 
-		unsigned int *numa, char ***answer)
+/* internal: make room in readbuf for more data, after what's pending */
+static int readbuf_prepare(UPSCONN_t *ups)
 {
-	char	cmd[UPSCLI_NETBUF_LEN], tmp[UPSCLI_NETBUF_LEN];
-	
-	if (!ups) {
-		return -1;
-	}
-
-	if (numq < 1) {
-		ups->upserror = UPSCLI_ERR_INVALIDARG;
-		return -1;
-	}
-
-	/* create the string to send to upsd */
-	build_cmd(cmd, sizeof(cmd), "GET", numq, query);
+	if (!ups->readbuf) {
+		if (ups->readsize == 0) {
+			ups->readsize = UPSCLI_READBUF_LEN;
+		}
 
-	if (upscli_sendline(ups, cmd, strlen(cmd)) != 0) {
-		return -1;
-	}
+		/* one more byte to terminate a line as long as the buffer */
+		ups->readbuf = malloc(ups->readsize + 1);
 
-	if (upscli_readline(ups, tmp, sizeof(tmp)) != 0) {
-		return -1;
+		if (!ups->readbuf) {
+			ups->upserror = UPSCLI_ERR_NOMEM;
+			return -1;
+		}
 	}
 
-	if (upscli_errcheck(ups, tmp) != 0) {
-		return -1;
+	/* move the start of a partial line to the front */
+	if (ups->readidx > 0) {
+		memmove(ups->readbuf, &ups->readbuf[ups->readidx],
+			ups->readlen - ups->readidx);
+		ups->readlen -= ups->readidx;
+		ups->readidx = 0;
 	}
 
-	if (!pconf_line(&ups->pc_ctx, tmp)) {
-		ups->upserror = UPSCLI_ERR_PARSE;
-		return -1;
-	}
+	return 0;
+}
 
-	/* q: [GET] VAR <ups> <var>   *
-	 * a: VAR <ups> <var> <val> */
+/* internal: read more data from upsd, after what's pending in readbuf */
+static int readbuf_fill(UPSCONN_t *ups)
+{
+	int	ret;
 
-	if (ups->pc_ctx.numargs < numq) {
-		ups->upserror = UPSCLI_ERR_PROTOCOL;
+	if (readbuf_prepare(ups) != 0) {
 		return -1;
 	}
 
-	if (!verify_resp(numq, query, ups->pc_ctx.arglist)) {
-		ups->upserror = UPSCLI_ERR_PROTOCOL;
+	ret = net_read(ups, &ups->readbuf[ups->readlen],
+		ups->readsize - ups->readlen);
+
+	if (ret < 1) {
+		upscli_disconnect(ups);
 		return -1;
 	}
 
-	*numa = ups->pc_ctx.numargs;
-	*answer = ups->pc_ctx.arglist;
-
+	ups->readlen += ret;
 	return 0;
 }
 
-int upscli_list_start(UPSCONN_t *ups, unsigned int numq, const char **query)
+/* internal: take the next complete line from readbuf, in place, or NULL
+ * if more data is needed */
+static char *readbuf_line(UPSCONN_t *ups)
 {
-	char	cmd[UPSCLI_NETBUF_LEN], tmp[UPSCLI_NETBUF_LEN];
+	char	*line, *nl;
 
-	if (!ups) {
-		return -1;
+	if (!ups->readbuf) {
+		return NULL;
 	}
 
-	if (numq < 1) {
-		ups->upserror = UPSCLI_ERR_INVALIDARG;
-		return -1;
-	}
+	line = &ups->readbuf[ups->readidx];
+	nl = memchr(line, '\n', ups->readlen - ups->readidx);
 
-	/* create the string to send to upsd */
-	build_cmd(cmd, sizeof(cmd), "LIST", numq, query);
+	if (!nl) {
+		/* no room for the rest: hand out what we have */
+		if ((ups->readidx != 0) || (ups->readlen < ups->readsize)) {
+			return NULL;
+		}
 
-	if (upscli_sendline(ups, cmd, strlen(cmd)) != 0) {
-		return -1;
+		nl = &ups->readbuf[ups->readlen];
 	}
 
-	if (upscli_readline(ups, tmp, sizeof(tmp)) != 0) {
-		return -1;
-	}
+	ups->readidx = nl - ups->readbuf;
 
-	if (upscli_errcheck(ups, tmp) != 0) {
-		return -1;
+	if (ups->readidx < ups->readlen) {
+		ups->readidx++;		/* skip the newline */
 	}
 
-	if (!pconf_line(&ups->pc_ctx, tmp)) {
-		ups->upserror = UPSCLI_ERR_PARSE;
-		return -1;
-	}
+	*nl = '\0';
+	return line;
+}
 
-	if (ups->pc_ctx.numargs < 2) {
-		ups->upserror = UPSCLI_ERR_PROTOCOL;
+/* internal: like upscli_readline, but return the line in place in readbuf,
+ * which avoids a copy; it's valid until the next read */
+static int upscli_getline(UPSCONN_t *ups, char **line)
+{
+	if (ups->fd < 0) {
+		ups->upserror = UPSCLI_ERR_DRVNOTCONN;
 		return -1;
 	}
 
-	/* the response must start with BEGIN LIST */
-	if ((strcasecmp(ups->pc_ctx.arglist[0], "BEGIN") != 0) ||
-		(strcasecmp(ups->pc_ctx.arglist[1], "LIST") != 0)) {
-		ups->upserror = UPSCLI_ERR_PROTOCOL;
+	if (ups->upsclient_magic != UPSCLIENT_MAGIC) {
+		ups->upserror = UPSCLI_ERR_INVALIDARG;
 		return -1;
 	}
 
-	/* q: [LIST] VAR <ups>       *
-	 * a: [BEGIN LIST] VAR <ups> */
-
-	/* compare q[0]... to a[2]... */
-
-	if (!verify_resp(numq, query, &ups->pc_ctx.arglist[2])) {
-		ups->upserror = UPSCLI_ERR_PROTOCOL;
-		return -1;
+	while ((*line = readbuf_line(ups)) == NULL) {
+		if (readbuf_fill(ups) != 0) {
+			return -1;
+		}
 	}
 
 	return 0;
 }
 
-int upscli_list_next(UPSCONN_t *ups, unsigned int numq, const char **query, 
-		unsigned int *numa, char ***answer)
+/* internal: split a line in words into arglist. The usual lines (plain
+ * words and "quoted" values, without escapes) are split in place, without
+ * going through the parser char by char; the others use pc_ctx */
+static int upscli_splitline(UPSCONN_t *ups, char *line)
 {
-	char	tmp[UPSCLI_NETBUF_LEN];
+	char	*p, *end[PCONF_DEFAULT_ARG_LIMIT];
+	size_t	i, n = 0;
 
-	if (!ups) {
-		return -1;
+	for (p = line; *p != '\0'; p++) {
+		if (((unsigned char)*p < 0x20) || ((unsigned char)*p > 0x7e) ||
+			(*p == '\\') || (*p == '#')) {
+			goto parse;
+		}
 	}
 
-	if (upscli_readline(ups, tmp, sizeof(tmp)) != 0) {
-		return -1;
+	for (p = line; ; ) {
+
+		while (*p == ' ') {
+			p++;
+		}
+
+		if (*p == '\0') {
+			break;
+		}
+
+		if (n >= PCONF_DEFAULT_ARG_LIMIT) {
+			goto parse;
+		}
+
+		if (*p == '"') {
+			ups->fastarg[n] = ++p;
+			p = strchr(p, '"');
+
+			if (!p) {
+				goto parse;
+			}
+
+			end[n] = p++;
+		} else {
+			/* '=' and '"' within a word need the parser */
+			ups->fastarg[n] = p;
+			p += strcspn(p, " \"=");
+			end[n] = p;
+		}
+
+		if (((*p != ' ') && (*p != '\0')) ||
+			(end[n] - ups->fastarg[n] > PCONF_DEFAULT_WORDLEN_LIMIT)) {
+			goto parse;
+		}
+
+		n++;
+	}
+
+	for (i = 0; i < n; i++) {
+		*end[i] = '\0';
+	}
+
+	ups->arglist = ups->fastarg;
+	ups->numargs = n;
+	return 1;
+
+parse:
+	if (!pconf_line(&ups->pc_ctx, line)) {
+		return 0;
+	}
+
+	ups->arglist = ups->pc_ctx.arglist;
+	ups->numargs = ups->pc_ctx.numargs;
+	return 1;
+}
+
+int upscli_get(UPSCONN_t *ups, unsigned int numq, const char **query, 
+		unsigned int *numa, char ***answer)
+{
+	char	cmd[UPSCLI_NETBUF_LEN], *line;
+	
+	if (!ups) {
+		return -1;
+	}
+
+	if (numq < 1) {
+		ups->upserror = UPSCLI_ERR_INVALIDARG;
+		return -1;
+	}
+
+	/* create the string to send to upsd */
+	build_cmd(cmd, sizeof(cmd), "GET", numq, query);
+
+	if (upscli_sendline(ups, cmd, strlen(cmd)) != 0) {
+		return -1;
+	}
+
+	if (upscli_getline(ups, &line) != 0) {
+		return -1;
+	}
+
+	if (upscli_errcheck(ups, line) != 0) {
+		return -1;
+	}
+
+	if (!upscli_splitline(ups, line)) {
+		ups->upserror = UPSCLI_ERR_PARSE;
+		return -1;
+	}
+
+	/* q: [GET] VAR <ups> <var>   *
+	 * a: VAR <ups> <var> <val> */
+
+	if (ups->numargs < numq) {
+		ups->upserror = UPSCLI_ERR_PROTOCOL;
+		return -1;
+	}
+
+	if (!verify_resp(numq, query, ups->arglist)) {
+		ups->upserror = UPSCLI_ERR_PROTOCOL;
+		return -1;
+	}
+
+	*numa = ups->numargs;
+	*answer = ups->arglist;
+
+	return 0;
+}
+
+int upscli_list_start(UPSCONN_t *ups, unsigned int numq, const char **query)
+{
+	char	cmd[UPSCLI_NETBUF_LEN], *line;
+
+	if (!ups) {
+		return -1;
+	}
+
+	if (numq < 1) {
+		ups->upserror = UPSCLI_ERR_INVALIDARG;
+		return -1;
+	}
+
+	/* create the string to send to upsd */
+	build_cmd(cmd, sizeof(cmd), "LIST", numq, query);
+
+	if (upscli_sendline(ups, cmd, strlen(cmd)) != 0) {
+		return -1;
+	}
+
+	if (upscli_getline(ups, &line) != 0) {
+		return -1;
+	}
+
+	if (upscli_errcheck(ups, line) != 0) {
+		return -1;
+	}
+
+	if (!upscli_splitline(ups, line)) {
+		ups->upserror = UPSCLI_ERR_PARSE;
+		return -1;
+	}
+
+	if (ups->numargs < 2) {
+		ups->upserror = UPSCLI_ERR_PROTOCOL;
+		return -1;
+	}
+
+	/* the response must start with BEGIN LIST */
+	if ((strcasecmp(ups->arglist[0], "BEGIN") != 0) ||
+		(strcasecmp(ups->arglist[1], "LIST") != 0)) {
+		ups->upserror = UPSCLI_ERR_PROTOCOL;
+		return -1;
+	}
+
+	/* q: [LIST] VAR <ups>       *
+	 * a: [BEGIN LIST] VAR <ups> */
+
+	/* compare q[0]... to a[2]... */
+
+	if (!verify_resp(numq, query, &ups->arglist[2])) {
+		ups->upserror = UPSCLI_ERR_PROTOCOL;
+		return -1;
+	}
+
+	return 0;
+}
+
+int upscli_list_next(UPSCONN_t *ups, unsigned int numq, const char **query, 
+		unsigned int *numa, char ***answer)
+{
+	char	*line;
+
+	if (!ups) {
+		return -1;
+	}
+
+	if (upscli_getline(ups, &line) != 0) {
+		return -1;
+	}
+
+	if (upscli_errcheck(ups, line) != 0) {
+		return -1;
+	}
+
+	if (!upscli_splitline(ups, line)) {
+		ups->upserror = UPSCLI_ERR_PARSE;
+		return -1;
+	}
+
+	if (ups->numargs < 1) {
+		ups->upserror = UPSCLI_ERR_PROTOCOL;
+		return -1;
+	}
+
+	*numa = ups->numargs;
+	*answer = ups->arglist;
+
+	/* see if this is the end */
+	if (ups->numargs >= 2) {
+		if ((!strcmp(ups->arglist[0], "END")) &&
+			(!strcmp(ups->arglist[1], "LIST")))
+			return 0;
+	}
+
+	/* q: VAR <ups> */
+	/* a: VAR <ups> <val> */
+
+	if (!verify_resp(numq, query, ups->arglist)) {
+		ups->upserror = UPSCLI_ERR_PROTOCOL;
+		return -1;
+	}
+
+	/* just another part of the list */
+	return 1;
+}
+
+/* pipelined requests: at most this many are waiting for an answer, so that
+ * upsd (which writes its answers synchronously) never blocks on us */
+#define UPSCLI_MULTI_WINDOW	64
+
+/* internal: send the requests [first, last[ of a batch in one write */
+static int multi_send(UPSCONN_t *ups, const char *cmdname,
+	UPSCLI_QUERY_t *req, unsigned int first, unsigned int last)
+{
+	char	cmd[UPSCLI_NETBUF_LEN], *buf;
+	size_t	len, buflen = 0;
+	unsigned int	i;
+	int	ret;
+
+	buf = malloc((last - first) * sizeof(cmd));
+
+	if (!buf) {
+		ups->upserror = UPSCLI_ERR_NOMEM;
+		return -1;
+	}
+
+	for (i = first; i < last; i++) {
+		build_cmd(cmd, sizeof(cmd), cmdname, req[i].numq, req[i].query);
+		len = strlen(cmd);
+		memcpy(&buf[buflen], cmd, len);
+		buflen += len;
+	}
+
+	/* upscli_sendline does a single write, which may be short here */
+	for (len = 0; len < buflen; len += ret) {
+		ret = net_write(ups, &buf[len], buflen - len);
+
+		if (ret < 1) {
+			free(buf);
+			upscli_disconnect(ups);
+			return -1;
+		}
+	}
+
+	free(buf);
+	return 0;
+}
+
+/* internal: keep the window of a batch filled */
+static int multi_fill(UPSCONN_t *ups, const char *cmdname,
+	unsigned int numreq, UPSCLI_QUERY_t *req, unsigned int done,
+	unsigned int *sent)
+{
+	unsigned int	last;
+
+	/* top up by half windows, not one line at a time */
+	if ((*sent == numreq) || (*sent - done > UPSCLI_MULTI_WINDOW / 2)) {
+		return 0;
+	}
+
+	last = done + UPSCLI_MULTI_WINDOW;
+
+	if (last > numreq) {
+		last = numreq;
+	}
+
+	if (multi_send(ups, cmdname, req, *sent, last) != 0) {
+		return -1;
+	}
+
+	*sent = last;
+	return 0;
+}
+
+/* internal: check the arguments of a batch and clear its results */
+static int multi_init(UPSCONN_t *ups, unsigned int numreq, UPSCLI_QUERY_t *req)
+{
+	unsigned int	i;
+
+	if ((!req) && (numreq > 0)) {
+		ups->upserror = UPSCLI_ERR_INVALIDARG;
+		return -1;
+	}
+
+	for (i = 0; i < numreq; i++) {
+		if ((req[i].numq < 1) || (!req[i].query)) {
+			ups->upserror = UPSCLI_ERR_INVALIDARG;
+			return -1;
+		}
+	}
+
+	for (i = 0; i < numreq; i++) {
+		req[i].upserror = 0;
+		req[i].numa = 0;
+		req[i].answer = NULL;
+	}
+
+	return 0;
+}
+
+/* internal: mark the requests that didn't get an answer */
+static void multi_abort(UPSCONN_t *ups, unsigned int numreq,
+	UPSCLI_QUERY_t *req, unsigned int done)
+{
+	for (; done < numreq; done++) {
+		req[done].upserror = ups->upserror;
+	}
+}
+
+/* internal: copy an answer, so it survives the next line read */
+static char **multi_copy(unsigned int numa, char **answer)
+{
+	char	**copy, *str;
+	size_t	len = numa * sizeof(char *);
+	unsigned int	i;
+
+	for (i = 0; i < numa; i++) {
+		len += strlen(answer[i]) + 1;
+	}
+
+	copy = malloc(len);
+
+	if (!copy) {
+		return NULL;
+	}
+
+	str = (char *)&copy[numa];
+
+	for (i = 0; i < numa; i++) {
+		len = strlen(answer[i]) + 1;
+		memcpy(str, answer[i], len);
+		copy[i] = str;
+		str += len;
+	}
+
+	return copy;
+}
+
+int upscli_get_multi(UPSCONN_t *ups, unsigned int numreq, UPSCLI_QUERY_t *req)
+{
+	char	*line;
+	unsigned int	sent = 0, done, failed = 0;
+
+	if (!ups) {
+		return -1;
+	}
+
+	if (multi_init(ups, numreq, req) != 0) {
+		return -1;
+	}
+
+	for (done = 0; done < numreq; done++) {
+
+		if (multi_fill(ups, "GET", numreq, req, done, &sent) != 0) {
+			multi_abort(ups, numreq, req, done);
+			return -1;
+		}
+
+		if (upscli_getline(ups, &line) != 0) {
+			multi_abort(ups, numreq, req, done);
+			return -1;
+		}
+
+		/* an ERR only fails this request, the next answer follows */
+		if (upscli_errcheck(ups, line) != 0) {
+			req[done].upserror = ups->upserror;
+			failed++;
+			continue;
+		}
+
+		if (!upscli_splitline(ups, line)) {
+			req[done].upserror = UPSCLI_ERR_PARSE;
+			failed++;
+			continue;
+		}
+
+		/* q: [GET] VAR <ups> <var>   *
+		 * a: VAR <ups> <var> <val> */
+
+		if ((ups->numargs < req[done].numq) ||
+			(!verify_resp(req[done].numq, req[done].query, ups->arglist))) {
+			req[done].upserror = UPSCLI_ERR_PROTOCOL;
+			failed++;
+			continue;
+		}
+
+		req[done].answer = multi_copy(ups->numargs, ups->arglist);
+
+		if (!req[done].answer) {
+			req[done].upserror = UPSCLI_ERR_NOMEM;
+			failed++;
+			continue;
+		}
+
+		req[done].numa = ups->numargs;
+	}
+
+	return failed;
+}
+
+int upscli_list_multi(UPSCONN_t *ups, unsigned int numreq, UPSCLI_QUERY_t *req,
+		void (*callback)(void *arg, unsigned int idx, unsigned int numa, char **answer),
+		void *arg)
+{
+	char	*line;
+	unsigned int	sent = 0, done, failed = 0;
+
+	if (!ups) {
+		return -1;
+	}
+
+	if (!callback) {
+		ups->upserror = UPSCLI_ERR_INVALIDARG;
+		return -1;
+	}
+
+	if (multi_init(ups, numreq, req) != 0) {
+		return -1;
+	}
+
+	for (done = 0; done < numreq; done++) {
+
+		if (multi_fill(ups, "LIST", numreq, req, done, &sent) != 0) {
+			multi_abort(ups, numreq, req, done);
+			return -1;
+		}
+
+		if (upscli_getline(ups, &line) != 0) {
+			multi_abort(ups, numreq, req, done);
+			return -1;
+		}
+
+		/* an ERR instead of the list only fails this request */
+		if (upscli_errcheck(ups, line) != 0) {
+			req[done].upserror = ups->upserror;
+			failed++;
+			continue;
+		}
+
+		/* q: [LIST] VAR <ups>       *
+		 * a: [BEGIN LIST] VAR <ups> */
+
+		if ((!upscli_splitline(ups, line)) ||
+			(ups->numargs < req[done].numq + 2) ||
+			(strcasecmp(ups->arglist[0], "BEGIN") != 0) ||
+			(strcasecmp(ups->arglist[1], "LIST") != 0) ||
+			(!verify_resp(req[done].numq, req[done].query, &ups->arglist[2]))) {
+			ups->upserror = UPSCLI_ERR_PROTOCOL;
+			goto desync;
+		}
+
+		for (;;) {
+			if (upscli_getline(ups, &line) != 0) {
+				multi_abort(ups, numreq, req, done);
+				return -1;
+			}
+
+			if (upscli_errcheck(ups, line) != 0) {
+				goto desync;
+			}
+
+			if (!upscli_splitline(ups, line)) {
+				ups->upserror = UPSCLI_ERR_PARSE;
+				goto desync;
+			}
+
+			if ((ups->numargs >= 2) &&
+				(!strcmp(ups->arglist[0], "END")) &&
+				(!strcmp(ups->arglist[1], "LIST"))) {
+				break;
+			}
+
+			/* q: VAR <ups> */
+			/* a: VAR <ups> <val> */
+
+			if ((ups->numargs < req[done].numq) ||
+				(!verify_resp(req[done].numq, req[done].query, ups->arglist))) {
+				ups->upserror = UPSCLI_ERR_PROTOCOL;
+				goto desync;
+			}
+
+			callback(arg, done, ups->numargs, ups->arglist);
+		}
+	}
+
+	return failed;
+
+desync:
+	/* the rest of the pipeline can't be matched to the requests anymore */
+	multi_abort(ups, numreq, req, done);
+	upscli_disconnect(ups);
+	return -1;
+}
+
+void upscli_free_multi(unsigned int numreq, UPSCLI_QUERY_t *req)
+{
+	unsigned int	i;
+
+	if (!req) {
+		return;
+	}
+
+	for (i = 0; i < numreq; i++) {
+		free(req[i].answer);
+		req[i].answer = NULL;
+		req[i].numa = 0;
+	}
+}
+
+int upscli_list_var_start(UPSCONN_t *ups, const char *upsname)
+{
+	const char	*query[2];
+
+	if (!ups) {
+		return -1;
+	}
+
+	if (!upsname) {
+		ups->upserror = UPSCLI_ERR_INVALIDARG;
+		return -1;
+	}
+
+	query[0] = "VAR";
+	query[1] = upsname;
+
+	return upscli_list_start(ups, 2, query);
+}
+
+/* LIST VAR without the generic answer array: var and val point directly
+ * into the receive buffer, until the next call */
+int upscli_list_var_next(UPSCONN_t *ups, const char *upsname,
+		const char **var, const char **val)
+{
+	const char	*query[2];
+	unsigned int	numa;
+	char	**answer;
+	int	ret;
+
+	if (!ups) {
+		return -1;
+	}
+
+	if ((!upsname) || (!var) || (!val)) {
+		ups->upserror = UPSCLI_ERR_INVALIDARG;
+		return -1;
+	}
+
+	query[0] = "VAR";
+	query[1] = upsname;
+
+	ret = upscli_list_next(ups, 2, query, &numa, &answer);
+
+	if (ret != 1) {
+		return ret;
+	}
+
+	/* a: VAR <ups> <var> <val> */
+
+	if (numa < 4) {
+		ups->upserror = UPSCLI_ERR_PROTOCOL;
+		return -1;
+	}
+
+	*var = answer[2];
+	*val = answer[3];
+
+	return 1;
+}
+
+/* asynchronous connections: the states of upscli_connect_async */
+#define ASYNC_CONNECTING	1
+#define ASYNC_STARTTLS		2	/* waiting for the answer to STARTTLS */
+#define ASYNC_HANDSHAKE		3	/* SSL handshake in progress */
+#define ASYNC_READY		4
+
+/* the kinds of requests */
+#define ASYNC_GET		1
+#define ASYNC_LIST		2
+#define ASYNC_CMD		3	/* any command answered by OK */
+
+/* a lost connection is reported through the callbacks, not SIGPIPE */
+#ifdef MSG_NOSIGNAL
+#define ASYNC_SEND_FLAGS	MSG_NOSIGNAL
+#else
+#define ASYNC_SEND_FLAGS	0
+#endif
+
+#define ASYNC_STARTTLS_CMD	"STARTTLS\n"
+
+/* a request waiting for its answer */
+typedef struct upscli_req_s {
+	int	type;
+	int	started;		/* BEGIN LIST seen */
+	unsigned int	numq;
+	char	**query;		/* copy, to check the answer */
+	upscli_callback_t	callback;
+	void	*arg;
+	struct upscli_req_s	*next;
+}	upscli_req_t;
+
+struct upscli_async_s {
+	int	state;
+	int	flags;			/* of upscli_connect_async */
+	int	busy;			/* in upscli_async_process */
+	int	closing;		/* disconnect asked by a callback */
+
+	struct addrinfo	*res;		/* addresses to try */
+	struct addrinfo	*ai;
+
+	upscli_callback_t	callback;	/* connection completion */
+	void	*arg;
+
+	upscli_callback_t	notify;		/* NOTIFY lines from upsd */
+	void	*notifyarg;
+
+	size_t	tlsidx;			/* bytes of STARTTLS sent */
+
+	char	*writebuf;		/* commands not sent yet */
+	size_t	writesize;
+	size_t	writelen;
+	size_t	writeidx;
+
+	upscli_req_t	*head;		/* requests in order of sending */
+	upscli_req_t	*tail;
+};
+
+/* internal: release the asynchronous state, without calling back */
+static void async_free(UPSCONN_t *ups)
+{
+	struct upscli_async_s	*async = ups->async;
+	upscli_req_t	*req;
+
+	if (!async) {
+		return;
+	}
+
+	while ((req = async->head) != NULL) {
+		async->head = req->next;
+		free(req->query);
+		free(req);
+	}
+
+	if (async->res) {
+		freeaddrinfo(async->res);
+	}
+
+	free(async->writebuf);
+	free(async);
+
+	ups->async = NULL;
+}
+
+/* internal: close a broken connection, with no LOGOUT nor SSL shutdown */
+static void async_close(UPSCONN_t *ups)
+{
+#ifdef WITH_OPENSSL
+	if (ups->ssl) {
+		SSL_free(ups->ssl);
+		ups->ssl = NULL;
+	}
+#elif defined(WITH_NSS) /* WITH_OPENSSL */
+	/* this closes the fd as well */
+	if (ups->ssl) {
+		PR_Close(ups->ssl);
+		ups->ssl = NULL;
+		ups->fd = -1;
+	}
+#endif /* WITH_OPENSSL | WITH_NSS */
+
+	if (ups->fd >= 0) {
+		close(ups->fd);
+		ups->fd = -1;
+	}
+}
+
+/* internal: the connection is lost, fail all the requests with the error
+ * in upserror, then release it; the callbacks already see it closed */
+static int async_fail(UPSCONN_t *ups)
+{
+	struct upscli_async_s	*async = ups->async;
+	upscli_req_t	*req;
+	int	upserror = ups->upserror;
+
+	async_close(ups);
+
+	if (async->state != ASYNC_READY) {
+		async->callback(ups, async->arg, -1, 0, NULL);
+	}
+
+	while (((req = async->head) != NULL) && (!async->closing)) {
+		async->head = req->next;
+
+		ups->upserror = upserror;
+		req->callback(ups, req->arg, -1, 0, NULL);
+
+		free(req->query);
+		free(req);
+	}
+
+	async->busy = 0;
+	upscli_disconnect(ups);
+	ups->upserror = upserror;
+
+	return -1;
+}
+
+/* internal: send without blocking, through SSL once it is started;
+ * returns the bytes sent, 0 if it would block, or -1 with upserror set */
+static ssize_t async_send(UPSCONN_t *ups, const char *buf, size_t buflen)
+{
+	ssize_t	ret;
+
+#ifdef WITH_OPENSSL
+	if (ups->ssl) {
+		ret = SSL_write(ups->ssl, buf, buflen);
+
+		if (ret > 0) {
+			return ret;
+		}
+
+		switch (SSL_get_error(ups->ssl, ret))
+		{
+		case SSL_ERROR_WANT_READ:
+		case SSL_ERROR_WANT_WRITE:
+			return 0;
+		}
+
+		ups->upserror = UPSCLI_ERR_SSLERR;
+		return -1;
+	}
+#elif defined(WITH_NSS) /* WITH_OPENSSL */
+	if (ups->ssl) {
+		ret = PR_Write(ups->ssl, buf, buflen);
+
+		if (ret >= 0) {
+			return ret;
+		}
+
+		if (PR_GetError() == PR_WOULD_BLOCK_ERROR) {
+			return 0;
+		}
+
+		ups->upserror = UPSCLI_ERR_SSLERR;
+		return -1;
+	}
+#endif /* WITH_OPENSSL | WITH_NSS */
+
+	for (;;) {
+		ret = send(ups->fd, buf, buflen, ASYNC_SEND_FLAGS);
+
+		if (ret >= 0) {
+			return ret;
+		}
+
+		if (errno == EINTR) {
+			continue;
+		}
+
+		if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+			return 0;
+		}
+
+		ups->upserror = UPSCLI_ERR_WRITE;
+		ups->syserrno = errno;
+		return -1;
+	}
+}
+
+/* internal: read without blocking, through SSL once it is started;
+ * returns the bytes read, 0 if it would block, or -1 with upserror set,
+ * which includes upsd closing the connection */
+static ssize_t async_recv(UPSCONN_t *ups, char *buf, size_t buflen)
+{
+	ssize_t	ret;
+
+#ifdef WITH_OPENSSL
+	if (ups->ssl) {
+		ret = SSL_read(ups->ssl, buf, buflen);
+
+		if (ret > 0) {
+			return ret;
+		}
+
+		switch (SSL_get_error(ups->ssl, ret))
+		{
+		case SSL_ERROR_WANT_READ:
+		case SSL_ERROR_WANT_WRITE:
+			return 0;
+		case SSL_ERROR_ZERO_RETURN:
+			ups->upserror = UPSCLI_ERR_SRVDISC;
+			return -1;
+		}
+
+		ups->upserror = UPSCLI_ERR_SSLERR;
+		return -1;
+	}
+#elif defined(WITH_NSS) /* WITH_OPENSSL */
+	if (ups->ssl) {
+		ret = PR_Read(ups->ssl, buf, buflen);
+
+		if (ret > 0) {
+			return ret;
+		}
+
+		if (ret == 0) {
+			ups->upserror = UPSCLI_ERR_SRVDISC;
+			return -1;
+		}
+
+		if (PR_GetError() == PR_WOULD_BLOCK_ERROR) {
+			return 0;
+		}
+
+		ups->upserror = UPSCLI_ERR_SSLERR;
+		return -1;
+	}
+#endif /* WITH_OPENSSL | WITH_NSS */
+
+	for (;;) {
+		ret = read(ups->fd, buf, buflen);
+
+		if (ret > 0) {
+			return ret;
+		}
+
+		if (ret == 0) {
+			ups->upserror = UPSCLI_ERR_SRVDISC;
+			return -1;
+		}
+
+		if (errno == EINTR) {
+			continue;
+		}
+
+		if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+			return 0;
+		}
+
+		ups->upserror = UPSCLI_ERR_READ;
+		ups->syserrno = errno;
+		return -1;
+	}
+}
+
+/* internal: SSL may hold decrypted data that won't show up on the fd */
+static int async_pending(UPSCONN_t *ups)
+{
+#ifdef WITH_OPENSSL
+	if (ups->ssl) {
+		return SSL_pending(ups->ssl) > 0;
+	}
+#elif defined(WITH_NSS) /* WITH_OPENSSL */
+	if (ups->ssl) {
+		return SSL_DataPending(ups->ssl) > 0;
+	}
+#endif /* WITH_OPENSSL | WITH_NSS */
+
+	return 0;
+}
+
+/* internal: the connection is usable, once SSL was tried if asked and the
+ * attempt gave ret, as upscli_sslinit does */
+static int async_ready(UPSCONN_t *ups, int ret)
+{
+	struct upscli_async_s	*async = ups->async;
+
+	if (ssl_result(ups, async->flags, ret) < 0) {
+		return async_fail(ups);
+	}
+
+	async->state = ASYNC_READY;
+	ups->upserror = 0;
+	ups->syserrno = 0;
+
+	async->callback(ups, async->arg, 0, 0, NULL);
+
+	return 0;
+}
+
+#ifdef WITH_SSL
+
+/* internal: go on with the SSL handshake */
+static int async_handshake(UPSCONN_t *ups)
+{
+	int	ret;
+
+	ret = ssl_handshake(ups);
+
+	if (ret == 0) {
+		return 0;
+	}
+
+	return async_ready(ups, ret);
+}
+
+/* internal: send what we can of STARTTLS */
+static int async_starttls(UPSCONN_t *ups)
+{
+	struct upscli_async_s	*async = ups->async;
+	ssize_t	ret;
+
+	while (async->tlsidx < strlen(ASYNC_STARTTLS_CMD)) {
+		ret = async_send(ups, &ASYNC_STARTTLS_CMD[async->tlsidx],
+			strlen(ASYNC_STARTTLS_CMD) - async->tlsidx);
+
+		if (ret < 0) {
+			return async_fail(ups);
+		}
+
+		if (ret == 0) {
+			return 0;
+		}
+
+		async->tlsidx += ret;
+	}
+
+	return 0;
+}
+
+/* internal: read the answer to STARTTLS, then start the SSL handshake */
+static int async_starttls_answer(UPSCONN_t *ups)
+{
+	struct upscli_async_s	*async = ups->async;
+	char	*line;
+	ssize_t	ret;
+	int	certverify, forcessl, tryssl;
+#ifdef WITH_NSS
+	PRSocketOptionData	opt;
+#endif /* WITH_NSS */
+
+	if (readbuf_prepare(ups) != 0) {
+		return async_fail(ups);
+	}
+
+	ret = async_recv(ups, &ups->readbuf[ups->readlen], ups->readsize - ups->readlen);
+
+	if (ret < 0) {
+		return async_fail(ups);
+	}
+
+	ups->readlen += ret;
+
+	if ((line = readbuf_line(ups)) == NULL) {
+		return 0;
+	}
+
+	if (strncmp(line, "OK STARTTLS", 11) != 0) {
+		return async_ready(ups, 0);	/* not supported */
+	}
+
+	ssl_settings(ups->host, async->flags, &certverify, &forcessl, &tryssl);
+
+	ret = ssl_prepare(ups, certverify);
+
+	if (ret != 1) {
+		return async_ready(ups, ret);
+	}
+
+#ifdef WITH_OPENSSL
+	/* writebuf may move between the retries of a write */
+	SSL_set_mode(ups->ssl, SSL_MODE_ENABLE_PARTIAL_WRITE |
+		SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+#elif defined(WITH_NSS) /* WITH_OPENSSL */
+	opt.option = PR_SockOpt_Nonblocking;
+	opt.value.non_blocking = PR_TRUE;
+
+	if (PR_SetSocketOption(ups->ssl, &opt) != PR_SUCCESS) {
+		nss_error("async_starttls_answer / PR_SetSocketOption");
+		return async_ready(ups, -1);
+	}
+#endif /* WITH_OPENSSL | WITH_NSS */
+
+	async->state = ASYNC_HANDSHAKE;
+
+	return async_handshake(ups);
+}
+
+#endif /* WITH_SSL */
+
+/* internal: start connecting to the next address */
+static int async_connect_next(UPSCONN_t *ups)
+{
+	struct upscli_async_s	*async = ups->async;
+	long	fd_flags;
+	int	sock_fd;
+
+	for (; async->ai != NULL; async->ai = async->ai->ai_next) {
+
+		sock_fd = socket(async->ai->ai_family, async->ai->ai_socktype,
+			async->ai->ai_protocol);
+
+		if (sock_fd < 0) {
+			ups->upserror = UPSCLI_ERR_SOCKFAILURE;
+			ups->syserrno = errno;
+			continue;
+		}
+
+		fd_flags = fcntl(sock_fd, F_GETFL);
+		fcntl(sock_fd, F_SETFL, fd_flags | O_NONBLOCK);
+
+		/* completion (or failure) is seen when it becomes writable */
+		if ((connect(sock_fd, async->ai->ai_addr, async->ai->ai_addrlen) == 0) ||
+			(errno == EINPROGRESS) || (errno == EINTR)) {
+			ups->fd = sock_fd;
+			return 0;
+		}
+
+		ups->upserror = UPSCLI_ERR_CONNFAILURE;
+		ups->syserrno = errno;
+		close(sock_fd);
+	}
+
+	return -1;
+}
+
+/* internal: the connection attempt completed */
+static int async_connected(UPSCONN_t *ups)
+{
+	struct upscli_async_s	*async = ups->async;
+	int	error = 0;
+	socklen_t	error_size = sizeof(error);
+#ifdef WITH_SSL
+	int	certverify, forcessl, tryssl;
+#endif /* WITH_SSL */
+
+	if ((getsockopt(ups->fd, SOL_SOCKET, SO_ERROR, &error, &error_size) < 0) ||
+		(error != 0)) {
+		ups->upserror = UPSCLI_ERR_CONNFAILURE;
+		ups->syserrno = error ? error : errno;
+
+		close(ups->fd);
+		ups->fd = -1;
+
+		async->ai = async->ai->ai_next;
+
+		if (async_connect_next(ups) == 0) {
+			return 0;
+		}
+
+		return async_fail(ups);
+	}
+
+	freeaddrinfo(async->res);
+	async->res = async->ai = NULL;
+
+#ifdef WITH_SSL
+	ssl_settings(ups->host, async->flags, &certverify, &forcessl, &tryssl);
+
+	/* the queued requests wait for the end of the handshake */
+	if (tryssl || forcessl) {
+		ssl_check_init();
+		async->state = ASYNC_STARTTLS;
+		return async_starttls(ups);
+	}
+#endif /* WITH_SSL */
+
+	return async_ready(ups, 0);
+}
+
+/* internal: send what we can of the pending commands */
+static int async_write(UPSCONN_t *ups)
+{
+	struct upscli_async_s	*async = ups->async;
+	ssize_t	ret;
+
+	while (async->writeidx < async->writelen) {
+
+		ret = async_send(ups, &async->writebuf[async->writeidx],
+			async->writelen - async->writeidx);
+
+		if (ret < 0) {
+			return async_fail(ups);
+		}
+
+		if (ret == 0) {
+			return 0;
+		}
+
+		async->writeidx += ret;
+	}
+
+	async->writeidx = async->writelen = 0;
+	return 0;
+}
+
+/* internal: handle a line of answer for the oldest request; a non-zero
+ * return means the answers can't be matched to the requests anymore */
+static int async_answer(UPSCONN_t *ups, char *line)
+{
+	struct upscli_async_s	*async = ups->async;
+	upscli_req_t	*req = async->head;
+	int	status = 0;
+
+	if (!req) {
+		ups->upserror = UPSCLI_ERR_PROTOCOL;
+		return -1;
+	}
+
+	/* an ERR instead of the answer only fails this request */
+	if ((!req->started) && (upscli_errcheck(ups, line) != 0)) {
+		status = -1;
+	} else if (!upscli_splitline(ups, line)) {
+		ups->upserror = UPSCLI_ERR_PARSE;
+		return -1;
+	} else if (req->type == ASYNC_CMD) {
+
+		/* a: OK [...] */
+		if ((ups->numargs < 1) || (strcmp(ups->arglist[0], "OK") != 0)) {
+			ups->upserror = UPSCLI_ERR_PROTOCOL;
+			return -1;
+		}
+
+	} else if ((req->type == ASYNC_LIST) && !req->started) {
+
+		/* a: [BEGIN LIST] VAR <ups> */
+		if ((ups->numargs < req->numq + 2) ||
+			(strcasecmp(ups->arglist[0], "BEGIN") != 0) ||
+			(strcasecmp(ups->arglist[1], "LIST") != 0) ||
+			(!verify_resp(req->numq, (const char **)req->query, &ups->arglist[2]))) {
+			ups->upserror = UPSCLI_ERR_PROTOCOL;
+			return -1;
+		}
+
+		req->started = 1;
+		return 0;
+
+	} else if ((req->type == ASYNC_LIST) && (ups->numargs >= 2) &&
+		(!strcmp(ups->arglist[0], "END")) &&
+		(!strcmp(ups->arglist[1], "LIST"))) {
+		ups->numargs = 0;
+	} else {
+		/* a: VAR <ups> <var> <val> */
+		if ((ups->numargs < req->numq) ||
+			(!verify_resp(req->numq, (const char **)req->query, ups->arglist))) {
+			ups->upserror = UPSCLI_ERR_PROTOCOL;
+			return -1;
+		}
+
+		if (req->type == ASYNC_LIST) {
+			req->callback(ups, req->arg, 1, ups->numargs, ups->arglist);
+			return 0;
+		}
+	}
+
+	/* done with this one: unlink it first, the callback may queue more */
+	async->head = req->next;
+
+	if (!async->head) {
+		async->tail = NULL;
+	}
+
+	if (status == 0) {
+		req->callback(ups, req->arg, 0, ups->numargs, ups->numargs ? ups->arglist : NULL);
+	} else {
+		req->callback(ups, req->arg, -1, 0, NULL);
+	}
+
+	free(req->query);
+	free(req);
+
+	return 0;
+}
+
+/* internal: handle a NOTIFY line, which upsd may send between the answers
+ * once asked with SET NOTIFY ON */
+static int async_notify(UPSCONN_t *ups, char *line)
+{
+	struct upscli_async_s	*async = ups->async;
+
+	if (!upscli_splitline(ups, line)) {
+		ups->upserror = UPSCLI_ERR_PARSE;
+		return -1;
+	}
+
+	/* a: NOTIFY <event> [...] */
+	if (async->notify) {
+		async->notify(ups, async->notifyarg, 0, ups->numargs - 1, &ups->arglist[1]);
+	}
+
+	return 0;
+}
+
+/* internal: read what's available, and handle the complete lines */
+static int async_read(UPSCONN_t *ups)
+{
+	struct upscli_async_s	*async = ups->async;
+	char	*line;
+	ssize_t	ret;
+
+	do {
+		if (readbuf_prepare(ups) != 0) {
+			return async_fail(ups);
+		}
+
+		ret = async_recv(ups, &ups->readbuf[ups->readlen],
+			ups->readsize - ups->readlen);
+
+		if (ret < 0) {
+			return async_fail(ups);
+		}
+
+		if (ret == 0) {
+			return 0;
+		}
+
+		ups->readlen += ret;
+
+		while ((!async->closing) && ((line = readbuf_line(ups)) != NULL)) {
+			if (!strncmp(line, "NOTIFY ", 7)) {
+				ret = async_notify(ups, line);
+			} else {
+				ret = async_answer(ups, line);
+			}
+
+			if (ret != 0) {
+				return async_fail(ups);
+			}
+		}
+
+	} while ((!async->closing) && async_pending(ups));
+
+	return 0;
+}
+
+/* start connecting without waiting: the result is given to callback from
+ * upscli_async_process, once the fd is writable */
+int upscli_connect_async(UPSCONN_t *ups, const char *host, int port, int flags,
+		upscli_callback_t callback, void *arg)
+{
+	struct addrinfo	hints;
+	char	sport[NI_MAXSERV];
+	int	v;
+
+	if (!ups) {
+		return -1;
+	}
+
+	/* a connection used before keeps its buffers until disconnect */
+	if (ups->upsclient_magic == UPSCLIENT_MAGIC) {
+		pconf_finish(&ups->pc_ctx);
+		free(ups->readbuf);
+		free(ups->host);
+	}
+
+	/* clear out any lingering junk */
+	memset(ups, 0, sizeof(*ups));
+	ups->upsclient_magic = UPSCLIENT_MAGIC;
+	ups->fd = -1;
+
+	if (!host) {
+		ups->upserror = UPSCLI_ERR_NOSUCHHOST;
+		return -1;
+	}
+
+	if (!callback) {
+		ups->upserror = UPSCLI_ERR_INVALIDARG;
+		return -1;
+	}
+
+	ups->async = calloc(1, sizeof(*ups->async));
+
+	if (!ups->async) {
+		ups->upserror = UPSCLI_ERR_NOMEM;
+		return -1;
+	}
+
+	ups->async->state = ASYNC_CONNECTING;
+	ups->async->flags = flags;
+	ups->async->callback = callback;
+	ups->async->arg = arg;
+
+	snprintf(sport, sizeof(sport), "%hu", (unsigned short int)port);
+
+	memset(&hints, 0, sizeof(hints));
+
+	if (flags & UPSCLI_CONN_INET6) {
+		hints.ai_family = AF_INET6;
+	} else if (flags & UPSCLI_CONN_INET) {
+		hints.ai_family = AF_INET;
+	} else {
+		hints.ai_family = AF_UNSPEC;
+	}
+
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_protocol = IPPROTO_TCP;
+
+	/* FUTURE: name resolution still blocks, use numeric addresses to avoid it */
+	while ((v = getaddrinfo(host, sport, &hints, &ups->async->res)) != 0) {
+		switch (v)
+		{
+		case EAI_AGAIN:
+			continue;
+		case EAI_NONAME:
+			ups->upserror = UPSCLI_ERR_NOSUCHHOST;
+			break;
+		case EAI_MEMORY:
+			ups->upserror = UPSCLI_ERR_NOMEM;
+			break;
+		case EAI_SYSTEM:
+			ups->syserrno = errno;
+			/* fallthrough */
+		default:
+			ups->upserror = UPSCLI_ERR_UNKNOWN;
+		}
+
+		ups->async->res = NULL;
+		async_free(ups);
+		return -1;
+	}
+
+	ups->async->ai = ups->async->res;
+
+	pconf_init(&ups->pc_ctx, NULL);
+
+	ups->host = strdup(host);
+	ups->port = port;
+
+	if ((!ups->host) || (async_connect_next(ups) != 0)) {
+		if (!ups->host) {
+			ups->upserror = UPSCLI_ERR_NOMEM;
+		}
+
+		async_free(ups);
+		upscli_disconnect(ups);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* internal: queue a request on an asynchronous connection */
+static int async_request(UPSCONN_t *ups, int type, unsigned int numq,
+	const char **query, upscli_callback_t callback, void *arg)
+{
+	struct upscli_async_s	*async;
+	upscli_req_t	*req;
+	char	cmd[UPSCLI_NETBUF_LEN], *buf;
+	size_t	len;
+
+	if (!ups) {
+		return -1;
+	}
+
+	if ((!ups->async) || (ups->fd < 0)) {
+		ups->upserror = UPSCLI_ERR_DRVNOTCONN;
+		return -1;
+	}
+
+	if ((numq < 1) || (!query) || (!callback)) {
+		ups->upserror = UPSCLI_ERR_INVALIDARG;
+		return -1;
+	}
+
+	async = ups->async;
+
+	switch (type)
+	{
+	case ASYNC_GET:
+		build_cmd(cmd, sizeof(cmd), "GET", numq, query);
+		break;
+	case ASYNC_LIST:
+		build_cmd(cmd, sizeof(cmd), "LIST", numq, query);
+		break;
+	default:
+		build_cmd(cmd, sizeof(cmd), query[0], numq - 1, &query[1]);
+	}
+
+	len = strlen(cmd);
+
+	if (async->writelen + len > async->writesize) {
+		buf = realloc(async->writebuf, async->writelen + len + UPSCLI_NETBUF_LEN);
+
+		if (!buf) {
+			ups->upserror = UPSCLI_ERR_NOMEM;
+			return -1;
+		}
+
+		async->writebuf = buf;
+		async->writesize = async->writelen + len + UPSCLI_NETBUF_LEN;
+	}
+
+	req = calloc(1, sizeof(*req));
+
+	if (!req) {
+		ups->upserror = UPSCLI_ERR_NOMEM;
+		return -1;
+	}
+
+	req->query = multi_copy(numq, (char **)query);
+
+	if (!req->query) {
+		free(req);
+		ups->upserror = UPSCLI_ERR_NOMEM;
+		return -1;
+	}
+
+	req->type = type;
+	req->numq = numq;
+	req->callback = callback;
+	req->arg = arg;
+
+	memcpy(&async->writebuf[async->writelen], cmd, len);
+	async->writelen += len;
+
+	if (async->tail) {
+		async->tail->next = req;
+	} else {
+		async->head = req;
+	}
+
+	async->tail = req;
+
+	return 0;
+}
+
+int upscli_get_async(UPSCONN_t *ups, unsigned int numq, const char **query,
+		upscli_callback_t callback, void *arg)
+{
+	return async_request(ups, ASYNC_GET, numq, query, callback, arg);
+}
+
+int upscli_list_async(UPSCONN_t *ups, unsigned int numq, const char **query,
+		upscli_callback_t callback, void *arg)
+{
+	return async_request(ups, ASYNC_LIST, numq, query, callback, arg);
+}
+
+int upscli_cmd_async(UPSCONN_t *ups, unsigned int numq, const char **query,
+		upscli_callback_t callback, void *arg)
+{
+	return async_request(ups, ASYNC_CMD, numq, query, callback, arg);
+}
+
+int upscli_notify_async(UPSCONN_t *ups, upscli_callback_t callback, void *arg)
+{
+	if (!ups) {
+		return -1;
+	}
+
+	if ((!ups->async) || (ups->fd < 0)) {
+		ups->upserror = UPSCLI_ERR_DRVNOTCONN;
+		return -1;
+	}
+
+	ups->async->notify = callback;
+	ups->async->notifyarg = arg;
+
+	return 0;
+}
+
+/* what to wait for on upscli_fd() before calling upscli_async_process */
+int upscli_async_events(UPSCONN_t *ups)
+{
+	if ((!ups) || (!ups->async) || (ups->fd < 0)) {
+		return 0;
+	}
+
+	switch (ups->async->state)
+	{
+	case ASYNC_CONNECTING:
+		return UPSCLI_EV_WRITE;
+
+	case ASYNC_STARTTLS:
+		if (ups->async->tlsidx < strlen(ASYNC_STARTTLS_CMD)) {
+			return UPSCLI_EV_WRITE;
+		}
+
+		return UPSCLI_EV_READ;
+
+	case ASYNC_HANDSHAKE:
+#ifdef WITH_OPENSSL
+		if (SSL_want_write(ups->ssl)) {
+			return UPSCLI_EV_WRITE;
+		}
+#endif /* WITH_OPENSSL */
+		return UPSCLI_EV_READ;
 	}
 
-	if (upscli_errcheck(ups, tmp) != 0) {
-		return -1;
+	/* always read, to notice when upsd goes away */
+	if (ups->async->writeidx < ups->async->writelen) {
+		return UPSCLI_EV_READ | UPSCLI_EV_WRITE;
 	}
 
-	if (!pconf_line(&ups->pc_ctx, tmp)) {
-		ups->upserror = UPSCLI_ERR_PARSE;
+	return UPSCLI_EV_READ;
+}
+
+/* advance the connection with the events seen on upscli_fd(), calling
+ * back the completed connection and requests */
+int upscli_async_process(UPSCONN_t *ups, int events)
+{
+	struct upscli_async_s	*async;
+	int	ret = 0;
+
+	if (!ups) {
 		return -1;
 	}
 
-	if (ups->pc_ctx.numargs < 1) {
-		ups->upserror = UPSCLI_ERR_PROTOCOL;
+	if ((!ups->async) || (ups->fd < 0)) {
+		ups->upserror = UPSCLI_ERR_DRVNOTCONN;
 		return -1;
 	}
 
-	*numa = ups->pc_ctx.numargs;
-	*answer = ups->pc_ctx.arglist;
+	async = ups->async;
+	async->busy = 1;
 
-	/* see if this is the end */
-	if (ups->pc_ctx.numargs >= 2) {
-		if ((!strcmp(ups->pc_ctx.arglist[0], "END")) &&
-			(!strcmp(ups->pc_ctx.arglist[1], "LIST")))
-			return 0;
+	switch (async->state)
+	{
+	case ASYNC_CONNECTING:
+		if (events & UPSCLI_EV_WRITE) {
+			ret = async_connected(ups);
+		}
+		break;
+
+#ifdef WITH_SSL
+	case ASYNC_STARTTLS:
+		if (events & UPSCLI_EV_WRITE) {
+			ret = async_starttls(ups);
+		}
+
+		if ((ret == 0) && (events & UPSCLI_EV_READ) &&
+			(async->tlsidx == strlen(ASYNC_STARTTLS_CMD))) {
+			ret = async_starttls_answer(ups);
+		}
+		break;
+
+	case ASYNC_HANDSHAKE:
+		ret = async_handshake(ups);
+		break;
+#endif /* WITH_SSL */
+
+	default:
+		if (events & UPSCLI_EV_WRITE) {
+			ret = async_write(ups);
+		}
+
+		if ((ret == 0) && (events & UPSCLI_EV_READ)) {
+			ret = async_read(ups);
+		}
 	}
 
-	/* q: VAR <ups> */
-	/* a: VAR <ups> <val> */
+	/* async_fail already closed the connection */
+	if (ret != 0) {
+		return ret;
+	}
 
-	if (!verify_resp(numq, query, ups->pc_ctx.arglist)) {
-		ups->upserror = UPSCLI_ERR_PROTOCOL;
-		return -1;
+	async->busy = 0;
+
+	/* a callback asked for it while we were using the connection */
+	if (async->closing) {
+		upscli_disconnect(ups);
 	}
 
-	/* just another part of the list */
-	return 1;
+	return 0;
 }
 
 int upscli_sendline(UPSCONN_t *ups, const char *buf, size_t buflen)
@@ -1361,8 +2977,8 @@ int upscli_sendline(UPSCONN_t *ups, const char *buf, size_t buflen)
 
 int upscli_readline(UPSCONN_t *ups, char *buf, size_t buflen)
 {
-	int	ret;
-	size_t	recv;
+	char	*nl;
+	size_t	recv, len;
 
 	if (!ups) {
 		return -1;
@@ -1383,24 +2999,33 @@ int upscli_readline(UPSCONN_t *ups, char *buf, size_t buflen)
 		return -1;
 	}
 
-	for (recv = 0; recv < (buflen-1); recv++) {
+	for (recv = 0; recv < (buflen-1); recv += len) {
 
 		if (ups->readidx == ups->readlen) {
-
-			ret = net_read(ups, ups->readbuf, sizeof(ups->readbuf));
-
-			if (ret < 1) {
-				upscli_disconnect(ups);
+			if (readbuf_fill(ups) != 0) {
 				return -1;
 			}
+		}
+
+		/* copy up to the newline, or as much as fits */
+		len = ups->readlen - ups->readidx;
+
+		if (len > buflen - 1 - recv) {
+			len = buflen - 1 - recv;
+		}
+
+		nl = memchr(&ups->readbuf[ups->readidx], '\n', len);
 
-			ups->readlen = ret;
-			ups->readidx = 0;
+		if (nl) {
+			len = nl - &ups->readbuf[ups->readidx];
 		}
 
-		buf[recv] = ups->readbuf[ups->readidx++];
+		memcpy(&buf[recv], &ups->readbuf[ups->readidx], len);
+		ups->readidx += len;
 
-		if (buf[recv] == '\n') {
+		if (nl) {
+			recv += len;
+			ups->readidx++;		/* skip the newline */
 			break;
 		}
 	}
@@ -1409,6 +3034,47 @@ int upscli_readline(UPSCONN_t *ups, char *buf, size_t buflen)
 	return 0;
 }
 
+/* change the size of the receive buffer: big listings need fewer reads
+ * with a larger one */
+int upscli_set_readbuf_size(UPSCONN_t *ups, size_t size)
+{
+	char	*buf;
+
+	if (!ups) {
+		return -1;
+	}
+
+	if (ups->upsclient_magic != UPSCLIENT_MAGIC) {
+		ups->upserror = UPSCLI_ERR_INVALIDARG;
+		return -1;
+	}
+
+	/* a line must fit, and so must what's pending */
+	if ((size < UPSCLI_NETBUF_LEN) || (size < ups->readlen - ups->readidx)) {
+		ups->upserror = UPSCLI_ERR_INVALIDARG;
+		return -1;
+	}
+
+	if (ups->readbuf) {
+		memmove(ups->readbuf, &ups->readbuf[ups->readidx],
+			ups->readlen - ups->readidx);
+		ups->readlen -= ups->readidx;
+		ups->readidx = 0;
+
+		buf = realloc(ups->readbuf, size + 1);
+
+		if (!buf) {
+			ups->upserror = UPSCLI_ERR_NOMEM;
+			return -1;
+		}
+
+		ups->readbuf = buf;
+	}
+
+	ups->readsize = size;
+	return 0;
+}
+
 /* split upsname[@hostname[:port]] into separate components */
 int upscli_splitname(const char *buf, char **upsname, char **hostname, int *port)
 {
@@ -1509,11 +3175,24 @@ int upscli_disconnect(UPSCONN_t *ups)
 		return -1;
 	}
 
+	/* within upscli_async_process: it closes when done */
+	if (ups->async && ups->async->busy) {
+		ups->async->closing = 1;
+		return 0;
+	}
+
+	async_free(ups);
+
 	pconf_finish(&ups->pc_ctx);
 
 	free(ups->host);
 	ups->host = NULL;
 
+	free(ups->readbuf);
+	ups->readbuf = NULL;
+	ups->readlen = 0;
+	ups->readidx = 0;
+
 	if (ups->fd < 0) {
 		return 0;
 	}
@@ -1542,6 +3221,400 @@ int upscli_disconnect(UPSCONN_t *ups)
 	return 0;
 }
 
+/* the UPSes logged into over a shared connection */
+typedef struct upscli_login_s {
+	char	*upsname;
+	int	refs;
+	int	pending;		/* LOGIN sent, not answered yet */
+	int	done;			/* LOGIN accepted */
+	upscli_callback_t	callback;	/* for the answer to LOGIN */
+	void	*arg;
+	struct upscli_shared_s	*shared;
+	struct upscli_login_s	*next;
+} upscli_login_t;
+
+/* connections of upscli_connect_shared, keyed by server and credentials */
+typedef struct upscli_shared_s {
+	UPSCONN_t	conn;
+	char	*host;
+	int	port;
+	int	flags;
+	char	*username;
+	char	*password;
+	int	autherror;		/* USERNAME or PASSWORD refused */
+	int	single;			/* upsd takes one LOGIN per connection */
+	int	refs;
+	upscli_login_t	*logins;
+	struct upscli_shared_s	*next;
+} upscli_shared_t;
+
+static upscli_shared_t	*shared_list = NULL;
+
+/* closed from a callback: freed once upscli_async_process let go of them */
+static upscli_shared_t	*shared_dead = NULL;
+
+/* like strcmp, but NULL only matches NULL */
+static int shared_strcmp(const char *a, const char *b)
+{
+	if ((!a) || (!b)) {
+		return (a != b);
+	}
+
+	return strcmp(a, b);
+}
+
+static void shared_free(upscli_shared_t *shared)
+{
+	upscli_login_t	*login, *lnext;
+
+	for (login = shared->logins; login; login = lnext) {
+		lnext = login->next;
+		free(login->upsname);
+		free(login);
+	}
+
+	free(shared->host);
+	free(shared->username);
+	free(shared->password);
+	free(shared);
+}
+
+static void shared_sweep(void)
+{
+	upscli_shared_t	*shared, **pshared;
+
+	pshared = &shared_dead;
+
+	while ((shared = *pshared) != NULL) {
+		if (shared->conn.async) {
+			pshared = &shared->next;
+			continue;
+		}
+
+		*pshared = shared->next;
+		shared_free(shared);
+	}
+}
+
+static void shared_login_free(upscli_login_t *login)
+{
+	upscli_login_t	**plogin;
+
+	for (plogin = &login->shared->logins; *plogin; plogin = &(*plogin)->next) {
+		if (*plogin == login) {
+			*plogin = login->next;
+			break;
+		}
+	}
+
+	free(login->upsname);
+	free(login);
+}
+
+/* the connection is up and can take more requests */
+static int shared_usable(upscli_shared_t *shared)
+{
+	return (shared->conn.fd >= 0) && (shared->conn.async)
+		&& (!shared->conn.async->closing) && (!shared->autherror);
+}
+
+static void shared_connected(UPSCONN_t *ups, void *arg, int status,
+		unsigned int numa, char **answer)
+{
+	/* a failure is told to the LOGIN callbacks, or to the next request */
+}
+
+static void shared_ignore(UPSCONN_t *ups, void *arg, int status,
+		unsigned int numa, char **answer)
+{
+}
+
+/* USERNAME or PASSWORD answered: a refusal is told with the LOGINs */
+static void shared_auth_done(UPSCONN_t *ups, void *arg, int status,
+		unsigned int numa, char **answer)
+{
+	upscli_shared_t	*shared = arg;
+
+	if ((status == 0) || (ups->fd < 0) || (shared->autherror)) {
+		return;
+	}
+
+	shared->autherror = ups->upserror;
+}
+
+static void shared_login_done(UPSCONN_t *ups, void *arg, int status,
+		unsigned int numa, char **answer)
+{
+	upscli_login_t	*login = arg, *other;
+	upscli_shared_t	*shared = login->shared;
+	upscli_callback_t	callback = login->callback;
+	void	*cbarg = login->arg;
+	const char	*query[2];
+
+	login->pending = 0;
+	login->done = (status == 0);
+
+	if ((status < 0) && (ups->fd >= 0)) {
+
+		/* older upsd: another UPS is logged into over this connection */
+		if (ups->upserror == UPSCLI_ERR_LOGINTWICE) {
+			for (other = shared->logins; other; other = other->next) {
+				if (other->done) {
+					shared->single = 1;
+				}
+			}
+		}
+
+		/* the actual reason */
+		if (shared->autherror) {
+			ups->upserror = shared->autherror;
+		}
+	}
+
+	/* let go of while waiting for the answer */
+	if (login->refs < 1) {
+		if ((login->done) && (ups->fd >= 0) && (shared->refs > 0)) {
+			query[0] = "LOGOUT";
+			query[1] = login->upsname;
+			upscli_cmd_async(ups, 2, query, shared_ignore, NULL);
+		}
+
+		shared_login_free(login);
+	}
+
+	/* last, as it may connect or disconnect again */
+	callback(ups, cbarg, status, numa, answer);
+}
+
+/* LOGIN to upsname over a shared connection */
+static int shared_login(upscli_shared_t *shared, upscli_login_t *login,
+		const char *upsname, upscli_callback_t callback, void *arg)
+{
+	const char	*query[2];
+
+	if (!login) {
+		login = calloc(1, sizeof(*login));
+
+		if ((!login) || ((login->upsname = strdup(upsname)) == NULL)) {
+			free(login);
+			shared->conn.upserror = UPSCLI_ERR_NOMEM;
+			return -1;
+		}
+
+		login->shared = shared;
+		login->next = shared->logins;
+		shared->logins = login;
+	}
+
+	login->refs++;
+
+	query[0] = "LOGIN";
+	query[1] = upsname;
+
+	if (upscli_cmd_async(&shared->conn, 2, query, shared_login_done, login) < 0) {
+		return -1;
+	}
+
+	login->pending = 1;
+	login->callback = callback;
+	login->arg = arg;
+
+	return 0;
+}
+
+/* use a connection opened to the same upsd with the same credentials, or
+ * start one, then queue a LOGIN to upsname unless it is already (being)
+ * done over it; returns 1 in that case, as callback won't be called */
+int upscli_connect_shared(UPSCONN_t **ups, const char *host, int port, int flags,
+		const char *username, const char *password, const char *upsname,
+		upscli_callback_t callback, void *arg)
+{
+	upscli_shared_t	*shared, *found = NULL;
+	upscli_login_t	*login = NULL;
+	const char	*query[2];
+
+	if (!ups) {
+		return -1;
+	}
+
+	*ups = NULL;
+
+	if ((!host) || (upsname && !callback)) {
+		return -1;
+	}
+
+	shared_sweep();
+
+	/* first look for a connection already logged into upsname, then
+	 * for one which can take another LOGIN */
+	for (shared = shared_list; shared; shared = shared->next) {
+		if ((!shared_usable(shared))
+			|| (shared->port != port) || (shared->flags != flags)
+			|| strcmp(shared->host, host)
+			|| shared_strcmp(shared->username, username)
+			|| shared_strcmp(shared->password, password)) {
+			continue;
+		}
+
+		if (!upsname) {
+			found = shared;
+			break;
+		}
+
+		for (login = shared->logins; login; login = login->next) {
+			if (!strcmp(login->upsname, upsname)) {
+				break;
+			}
+		}
+
+		if (login) {
+			found = shared;
+			break;
+		}
+
+		if ((!found) && (!shared->single)) {
+			found = shared;
+		}
+	}
+
+	shared = found;
+
+	if (shared) {
+		shared->refs++;
+		*ups = &shared->conn;
+
+		if (!upsname) {
+			return 0;
+		}
+
+		if ((login) && ((login->pending) || (login->done))) {
+			login->refs++;
+			return 1;
+		}
+
+		return shared_login(shared, login, upsname, callback, arg);
+	}
+
+	shared = calloc(1, sizeof(*shared));
+
+	if (!shared) {
+		return -1;
+	}
+
+	shared->host = strdup(host);
+	shared->username = username ? strdup(username) : NULL;
+	shared->password = password ? strdup(password) : NULL;
+
+	if ((!shared->host) || (username && !shared->username)
+		|| (password && !shared->password)) {
+		shared_free(shared);
+		return -1;
+	}
+
+	shared->port = port;
+	shared->flags = flags;
+	shared->refs = 1;
+	shared->next = shared_list;
+	shared_list = shared;
+
+	*ups = &shared->conn;
+
+	if (upscli_connect_async(&shared->conn, host, port, flags, shared_connected, shared) < 0) {
+		return -1;
+	}
+
+	/* all sent as soon as it is connected */
+	if (username) {
+		query[0] = "USERNAME";
+		query[1] = username;
+
+		if (upscli_cmd_async(&shared->conn, 2, query, shared_auth_done, shared) < 0) {
+			return -1;
+		}
+	}
+
+	if (password) {
+		query[0] = "PASSWORD";
+		query[1] = password;
+
+		if (upscli_cmd_async(&shared->conn, 2, query, shared_auth_done, shared) < 0) {
+			return -1;
+		}
+	}
+
+	if (!upsname) {
+		return 0;
+	}
+
+	return shared_login(shared, NULL, upsname, callback, arg);
+}
+
+/* drop a reference taken by upscli_connect_shared, and the LOGIN to upsname
+ * with it; the connection is closed with its last reference */
+int upscli_disconnect_shared(UPSCONN_t *ups, const char *upsname)
+{
+	upscli_shared_t	*shared, **pshared;
+	upscli_login_t	*login;
+	const char	*query[2];
+
+	shared_sweep();
+
+	for (pshared = &shared_list; *pshared; pshared = &(*pshared)->next) {
+		if (&(*pshared)->conn == ups) {
+			break;
+		}
+	}
+
+	shared = *pshared;
+
+	if (!shared) {
+		return -1;
+	}
+
+	for (login = shared->logins; upsname && login; login = login->next) {
+		if (strcmp(login->upsname, upsname)) {
+			continue;
+		}
+
+		if (--login->refs > 0) {
+			break;
+		}
+
+		/* its callback still gets the answer, then it is freed */
+		if (login->pending) {
+			break;
+		}
+
+		/* other UPSes still use the connection */
+		if ((login->done) && (shared->refs > 1) && (shared_usable(shared))) {
+			query[0] = "LOGOUT";
+			query[1] = upsname;
+			upscli_cmd_async(&shared->conn, 2, query, shared_ignore, NULL);
+		}
+
+		shared_login_free(login);
+		break;
+	}
+
+	if (--shared->refs > 0) {
+		return 0;
+	}
+
+	*pshared = shared->next;
+	upscli_disconnect(&shared->conn);
+
+	/* within upscli_async_process: it still uses the connection */
+	if (shared->conn.async) {
+		shared->next = shared_dead;
+		shared_dead = shared;
+		return 0;
+	}
+
+	shared_free(shared);
+
+	return 0;
+}
+
 int upscli_fd(UPSCONN_t *ups)
 {
 	if (!ups) {
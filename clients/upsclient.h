@@ -36,9 +36,12 @@ extern "C" {
 
 #define UPSCLI_ERRBUF_LEN	256
 #define UPSCLI_NETBUF_LEN	512	/* network i/o buffer */
+#define UPSCLI_READBUF_LEN	16384	/* default receive buffer */
 
 #include "parseconf.h"
 
+struct upscli_async_s;		/* asynchronous connection state */
+
 typedef struct {
 	char	*host;
 	int	port;
@@ -60,12 +63,35 @@ typedef struct {
 	void *ssl;
 #endif /* WITH_OPENSSL | WITH_NSS */
 
-	char	readbuf[64];
+	char	*readbuf;		/* see upscli_set_readbuf_size */
+	size_t	readsize;
 	size_t	readlen;
 	size_t	readidx;
 
+	/* words of the last line read, either split in place in readbuf
+	 * or parsed into pc_ctx */
+	char	*fastarg[PCONF_DEFAULT_ARG_LIMIT];
+	char	**arglist;
+	size_t	numargs;
+
+	struct upscli_async_s	*async;	/* see upscli_connect_async */
+
 }	UPSCONN_t;
 
+/* completion of an asynchronous connection or request: status is 0 when
+ * done, 1 for each element of a list, or -1 with upscli_upserror() set */
+typedef void (*upscli_callback_t)(UPSCONN_t *ups, void *arg, int status,
+		unsigned int numa, char **answer);
+
+/* one request of a pipelined batch, see upscli_get_multi */
+typedef struct {
+	unsigned int	numq;		/* query, without the GET / LIST command */
+	const char	**query;
+	int		upserror;	/* 0 on success, or the UPSCLI_ERR_* of this request */
+	unsigned int	numa;		/* answer (GET only), valid until */
+	char		**answer;	/* upscli_free_multi() */
+}	UPSCLI_QUERY_t;
+
 const char *upscli_strerror(UPSCONN_t *ups);
 
 int upscli_init(int certverify, const char *certpath, const char *certname, const char *certpasswd);
@@ -86,6 +112,39 @@ int upscli_list_start(UPSCONN_t *ups, unsigned int numq, const char **query);
 int upscli_list_next(UPSCONN_t *ups, unsigned int numq, const char **query,
 		unsigned int *numa, char ***answer);
 
+int upscli_get_multi(UPSCONN_t *ups, unsigned int numreq, UPSCLI_QUERY_t *req);
+
+int upscli_list_multi(UPSCONN_t *ups, unsigned int numreq, UPSCLI_QUERY_t *req,
+		void (*callback)(void *arg, unsigned int idx, unsigned int numa, char **answer),
+		void *arg);
+
+void upscli_free_multi(unsigned int numreq, UPSCLI_QUERY_t *req);
+
+int upscli_list_var_start(UPSCONN_t *ups, const char *upsname);
+
+int upscli_list_var_next(UPSCONN_t *ups, const char *upsname,
+		const char **var, const char **val);
+
+int upscli_set_readbuf_size(UPSCONN_t *ups, size_t size);
+
+int upscli_connect_async(UPSCONN_t *ups, const char *host, int port, int flags,
+		upscli_callback_t callback, void *arg);
+
+int upscli_get_async(UPSCONN_t *ups, unsigned int numq, const char **query,
+		upscli_callback_t callback, void *arg);
+
+int upscli_list_async(UPSCONN_t *ups, unsigned int numq, const char **query,
+		upscli_callback_t callback, void *arg);
+
+int upscli_cmd_async(UPSCONN_t *ups, unsigned int numq, const char **query,
+		upscli_callback_t callback, void *arg);
+
+int upscli_notify_async(UPSCONN_t *ups, upscli_callback_t callback, void *arg);
+
+int upscli_async_events(UPSCONN_t *ups);
+
+int upscli_async_process(UPSCONN_t *ups, int events);
+
 int upscli_sendline(UPSCONN_t *ups, const char *buf, size_t buflen);
 
 int upscli_readline(UPSCONN_t *ups, char *buf, size_t buflen);
@@ -97,6 +156,12 @@ int upscli_splitaddr(const char *buf, char **hostname, int *port);
 
 int upscli_disconnect(UPSCONN_t *ups);
 
+int upscli_connect_shared(UPSCONN_t **ups, const char *host, int port, int flags,
+		const char *username, const char *password, const char *upsname,
+		upscli_callback_t callback, void *arg);
+
+int upscli_disconnect_shared(UPSCONN_t *ups, const char *upsname);
+
 /* these functions return elements from UPSCONN_t to avoid direct references */
 
 int upscli_fd(UPSCONN_t *ups);
@@ -167,6 +232,10 @@ int upscli_ssl(UPSCONN_t *ups);
 #define UPSCLI_CONN_INET6		0x0008	/* IPv6 only */
 #define UPSCLI_CONN_CERTVERIF	0x0010	/* Verify certificates for SSL	*/
 
+/* events of upscli_async_events / upscli_async_process */
+#define UPSCLI_EV_READ		0x0001	/* wait for the fd to be readable */
+#define UPSCLI_EV_WRITE		0x0002	/* wait for the fd to be writable */
+
 #ifdef __cplusplus
 /* *INDENT-OFF* */
 }
@@ -24,6 +24,7 @@
 #include <sys/stat.h>
 #include <sys/wait.h>
 #include <sys/socket.h>
+#include <poll.h>
 
 #include "upsclient.h"
 #include "upsmon.h"
@@ -77,6 +78,16 @@ static	int	userfsd = 0, use_pipe = 1, pipefd[2];
 
 static	utype_t	*firstups = NULL;
 
+	/* connections to upsd, see conn_open */
+static	upsconn_t	*firstconn = NULL;
+
+	/* the notifier process and the pipe to it, see notifier_start */
+static	pid_t	notifier_pid = -1;
+static	int	notifier_fd = -1;
+
+	/* in the notifier: SIGCHLD wakes up its poll() through this */
+static	int	sigchld_pipe[2] = { -1, -1 };
+
 static int 	opt_af = AF_UNSPEC;
 
 	/* signal handling things */
@@ -113,53 +124,324 @@ static void wall(const char *text)
 	pclose(wf);
 } 
 
-static void notify(const char *notice, int flags, const char *ntype, 
-			const char *upsname)
+/* in the notifier: run NOTIFYCMD itself, with the notice as its last
+ * argument, and without a shell in between */
+static void notifier_exec(const notice_t *notice)
 {
-	char	exec[LARGEBUF];
-	int	ret;
+	char	*cmd, *word, **argv;
+	int	argc = 0;
 
-	if (flag_isset(flags, NOTIFY_IGNORE))
-		return;
+	cmd = xstrdup(notifycmd);
+	argv = xcalloc(strlen(cmd) / 2 + 3, sizeof(*argv));
 
-	if (flag_isset(flags, NOTIFY_SYSLOG))
-		upslogx(LOG_NOTICE, "%s", notice);
+	/* the words of NOTIFYCMD, as in "/path/to/script --foo --bar" */
+	for (word = strtok(cmd, " \t"); word != NULL; word = strtok(NULL, " \t"))
+		argv[argc++] = word;
 
-	/* fork here so upsmon doesn't get wedged if the notifier is slow */
-	ret = fork();
+	argv[argc++] = (char *)notice->msg;
+	argv[argc] = NULL;
 
-	if (ret < 0) {
+	setenv("UPSNAME", notice->upsname, 1);
+	setenv("NOTIFYTYPE", notice->ntype, 1);
+
+	execvp(argv[0], argv);
+
+	upslog_with_errno(LOG_ERR, "Can't execute NOTIFYCMD %s", argv[0]);
+	_exit(EXIT_FAILURE);
+}
+
+/* in the notifier: start the child that handles one notice */
+static pid_t notifier_run(const notice_t *notice)
+{
+	pid_t	pid;
+
+	pid = fork();
+
+	if (pid < 0) {
 		upslog_with_errno(LOG_ERR, "Can't fork to notify");
-		return;
+		return -1;
 	}
 
-	if (ret != 0)	/* parent */
+	if (pid != 0)
+		return pid;
+
+	/* pclose in wall() waits for its own child */
+	signal(SIGCHLD, SIG_DFL);
+
+	if (flag_isset(notice->flags, NOTIFY_WALL))
+		wall(notice->msg);
+
+	if (flag_isset(notice->flags, NOTIFY_EXEC) && (notifycmd != NULL))
+		notifier_exec(notice);
+
+	_exit(EXIT_SUCCESS);
+}
+
+static void notifier_sigchld(int sig)
+{
+	int	save_errno = errno;
+
+	/* a byte already waiting does the job as well */
+	if (write(sigchld_pipe[1], "", 1) < 0)
+		errno = save_errno;
+}
+
+/* in the notifier: log how a child ended */
+static void notifier_reaped(const notice_t *notice, pid_t pid, int status)
+{
+	if (WIFEXITED(status) && (WEXITSTATUS(status) == 0)) {
+		upsdebugx(2, "Notifier: %s for [%s] done (pid %ld)",
+			notice->ntype, notice->upsname, (long)pid);
 		return;
+	}
+
+	if (WIFEXITED(status))
+		upslogx(LOG_WARNING, "Notifier: %s for [%s] exited with "
+			"status %d", notice->ntype, notice->upsname,
+			WEXITSTATUS(status));
+	else if (WIFSIGNALED(status))
+		upslogx(LOG_WARNING, "Notifier: %s for [%s] killed by "
+			"signal %d", notice->ntype, notice->upsname,
+			WTERMSIG(status));
+}
 
-	/* child continues and does all the work */
+/* the notifier: takes the notices from upsmon and handles them in order,
+ * NOTIFY_MAXPROC at a time, until upsmon closes the pipe */
+static void notifier_loop(int fd)
+{
+	notice_t	*queue, running[NOTIFY_MAXPROC], in;
+	pid_t	pids[NOTIFY_MAXPROC];
+	struct	pollfd	fds[2];
+	size_t	inlen = 0;
+	int	queued = 0, numrun = 0, eof = 0, i, status;
+	char	ch;
+	ssize_t	ret;
+	pid_t	pid;
 
-	if (flag_isset(flags, NOTIFY_WALL))
-		wall(notice);
+	queue = xcalloc(NOTIFY_MAXQUEUE, sizeof(*queue));
 
-	if (flag_isset(flags, NOTIFY_EXEC)) {
-		if (notifycmd != NULL) {
-			snprintf(exec, sizeof(exec), "%s \"%s\"", notifycmd, notice);
+	for (i = 0; i < NOTIFY_MAXPROC; i++)
+		pids[i] = -1;
 
-			if (upsname)
-				setenv("UPSNAME", upsname, 1);
-			else
-				setenv("UPSNAME", "", 1);
+	/* upsmon's signals are not for this process */
+	signal(SIGHUP, SIG_IGN);
+	signal(SIGCMD_FSD, SIG_IGN);
+	signal(SIGPIPE, SIG_IGN);
+	signal(SIGINT, SIG_DFL);
+	signal(SIGQUIT, SIG_DFL);
+	signal(SIGTERM, SIG_DFL);
+
+	if (pipe(sigchld_pipe))
+		fatal_with_errno(EXIT_FAILURE, "Notifier: pipe creation failed");
+
+	fcntl(sigchld_pipe[0], F_SETFL, O_NONBLOCK);
+	fcntl(sigchld_pipe[1], F_SETFL, O_NONBLOCK);
+
+	/* not for NOTIFYCMD */
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+	fcntl(sigchld_pipe[0], F_SETFD, FD_CLOEXEC);
+	fcntl(sigchld_pipe[1], F_SETFD, FD_CLOEXEC);
+
+	sa.sa_handler = notifier_sigchld;
+	sa.sa_flags = SA_RESTART;
+	sigaction(SIGCHLD, &sa, NULL);
+
+	while ((!eof) || (queued > 0) || (numrun > 0)) {
+
+		/* start the oldest notices while there is room */
+		while ((queued > 0) && (numrun < NOTIFY_MAXPROC)) {
+			for (i = 0; pids[i] != -1; i++)
+				;
+
+			running[i] = queue[0];
+			memmove(&queue[0], &queue[1], --queued * sizeof(*queue));
 
-			setenv("NOTIFYTYPE", ntype, 1);
-			if (system(exec) == -1) {
-				upslog_with_errno(LOG_ERR, "%s", __func__);
+			pids[i] = notifier_run(&running[i]);
+
+			if (pids[i] != -1)
+				numrun++;
+		}
+
+		fds[0].fd = sigchld_pipe[0];
+		fds[0].events = POLLIN;
+		fds[1].fd = fd;
+		fds[1].events = POLLIN;
+
+		if (poll(fds, eof ? 1 : 2, -1) < 0)
+			continue;
+
+		/* reap the children that exited */
+		while (read(sigchld_pipe[0], &ch, 1) > 0)
+			;
+
+		while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+			for (i = 0; i < NOTIFY_MAXPROC; i++) {
+				if (pids[i] != pid)
+					continue;
+
+				notifier_reaped(&running[i], pid, status);
+				pids[i] = -1;
+				numrun--;
 			}
 		}
+
+		if (eof || !(fds[1].revents & (POLLIN | POLLHUP)))
+			continue;
+
+		/* a notice may come in pieces: one upsmon couldn't finish
+		 * writing is left over at the end, and dropped */
+		ret = read(fd, (char *)&in + inlen, sizeof(in) - inlen);
+
+		if (ret <= 0) {
+			if ((ret == 0) || (errno != EINTR))
+				eof = 1;
+			continue;
+		}
+
+		inlen += ret;
+
+		if (inlen < sizeof(in))
+			continue;
+
+		inlen = 0;
+
+		/*
+		 * the same one still waiting to start says it all, but only
+		 * if it is the last one queued for this UPS: the last state
+		 * must come last (ONBATT, ONLINE, ONBATT isn't ONBATT, ONLINE)
+		 */
+		for (i = queued - 1; i >= 0; i--)
+			if (!strcmp(queue[i].upsname, in.upsname))
+				break;
+
+		if ((i >= 0) && (!memcmp(&queue[i], &in, sizeof(in)))) {
+			upsdebugx(2, "Notifier: %s for [%s] already queued",
+				in.ntype, in.upsname);
+			continue;
+		}
+
+		if (queued == NOTIFY_MAXQUEUE) {
+			upslogx(LOG_WARNING, "Notifier: too many notices waiting, "
+				"dropped: %s", in.msg);
+			continue;
+		}
+
+		queue[queued++] = in;
 	}
 
 	exit(EXIT_SUCCESS);
 }
 
+/* start the process which runs NOTIFYCMD and wall for upsmon, so that
+ * upsmon doesn't get wedged if the notifier is slow */
+static void notifier_start(void)
+{
+	int	fds[2];
+	upsconn_t	*conn;
+
+	if (pipe(fds)) {
+		upslog_with_errno(LOG_ERR, "Can't create the notifier pipe");
+		return;
+	}
+
+	notifier_pid = fork();
+
+	if (notifier_pid < 0) {
+		upslog_with_errno(LOG_ERR, "Can't fork the notifier");
+		close(fds[0]);
+		close(fds[1]);
+		return;
+	}
+
+	if (notifier_pid == 0) {
+		close(fds[1]);
+
+		/* upsd and the parent must see them close with upsmon */
+		for (conn = firstconn; conn != NULL; conn = conn->next)
+			if (upscli_fd(conn->conn) >= 0)
+				close(upscli_fd(conn->conn));
+
+		if (use_pipe)
+			close(pipefd[1]);
+
+		notifier_loop(fds[0]);
+	}
+
+	close(fds[0]);
+
+	/* never wait for the notifier, and keep it from SHUTDOWNCMD */
+	fcntl(fds[1], F_SETFL, O_NONBLOCK);
+	fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
+	notifier_fd = fds[1];
+}
+
+/* let the notifier finish what it has, and exit: started again when
+ * needed */
+static void notifier_stop(void)
+{
+	if (notifier_fd >= 0)
+		close(notifier_fd);
+
+	notifier_fd = -1;
+	notifier_pid = -1;
+}
+
+static void notify(const char *notice, int flags, const char *ntype, 
+			const char *upsname)
+{
+	notice_t	out;
+	ssize_t	ret;
+
+	if (flag_isset(flags, NOTIFY_IGNORE))
+		return;
+
+	if (flag_isset(flags, NOTIFY_SYSLOG))
+		upslogx(LOG_NOTICE, "%s", notice);
+
+	/* nothing else to do? */
+	if ((!flag_isset(flags, NOTIFY_WALL)) &&
+		((!flag_isset(flags, NOTIFY_EXEC)) || (notifycmd == NULL)))
+		return;
+
+	/* zeroed, as the notifier compares them to find the duplicates */
+	memset(&out, 0, sizeof(out));
+	out.flags = flags;
+	snprintf(out.ntype, sizeof(out.ntype), "%s", ntype);
+	snprintf(out.upsname, sizeof(out.upsname), "%s", upsname ? upsname : "");
+	snprintf(out.msg, sizeof(out.msg), "%s", notice);
+
+	if (notifier_fd < 0)
+		notifier_start();
+
+	ret = write(notifier_fd, &out, sizeof(out));
+
+	/*
+	 * it died, or only took a part of the notice (bigger than PIPE_BUF
+	 * on some systems), which would throw it off for all the next ones:
+	 * start a new one, the old one drops what is left over at its end
+	 */
+	if (((ret < 0) && (errno == EPIPE)) ||
+		((ret > 0) && (ret < (ssize_t)sizeof(out)))) {
+		notifier_stop();
+		notifier_start();
+
+		ret = write(notifier_fd, &out, sizeof(out));
+	}
+
+	if (ret == sizeof(out))
+		return;
+
+	/* not again with this one */
+	if (ret > 0)
+		notifier_stop();
+
+	if (ret < 0)
+		upslog_with_errno(LOG_ERR, "Can't notify: %s", notice);
+	else
+		upslogx(LOG_ERR, "Can't notify: %s", notice);
+}
+
 static void do_notify(const utype_t *ups, int ntype)
 {
 	int	i;
@@ -184,129 +466,232 @@ static void do_notify(const utype_t *ups, int ntype)
 	/* not found ?! */
 }
 
-/* check for master permissions on the server for this ups */
-static int checkmaster(utype_t *ups)
+/* seconds on a clock that doesn't follow changes of the time of day, for
+ * the polling schedule and the network timeouts */
+static double monotime(void)
 {
-	char	buf[SMALLBUF];
+#if defined(HAVE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+	struct timespec	ts;
 
-	/* don't bother if we're not configured as a master for this ups */
-	if (!flag_isset(ups->status, ST_MASTER))
-		return 1;
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+		return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+#endif
 
-	/* this shouldn't happen (LOGIN checks it earlier) */
-	if ((ups->upsname == NULL) || (strlen(ups->upsname) == 0)) {
-		upslogx(LOG_ERR, "Set master on UPS [%s] failed: empty upsname",
-			ups->sys);
-		return 0;
-	}
+	return time(NULL);
+}
 
-	snprintf(buf, sizeof(buf), "MASTER %s\n", ups->upsname);
+/* handles the answer to a request sent on a connection, for ups */
+typedef void (*upsdone_t)(upsconn_t *conn, utype_t *ups, int status,
+	unsigned int numa, char **answer);
 
-	if (upscli_sendline(&ups->conn, buf, strlen(buf)) < 0) {
-		upslogx(LOG_ALERT, "Can't set master mode on UPS [%s] - %s",
-			ups->sys, upscli_strerror(&ups->conn));
-		return 0;
-	}
+/* a request waiting for its answer: upsd answers in order */
+struct upsreq_s {
+	upsconn_t	*conn;
+	utype_t		*ups;		/* NULL once it let go of conn	*/
+	upsdone_t	done;
+	upsreq_t	*next;
+};
+
+/* the connection failed: conn_lost deals with its UPSes */
+static int conn_failed(upsconn_t *conn)
+{
+	return (upscli_fd(conn->conn) < 0);
+}
 
-	if (upscli_readline(&ups->conn, buf, sizeof(buf)) == 0) {
-		if (!strncmp(buf, "OK", 2))
-			return 1;
+/* a new request for ups (or the connection itself if NULL), which is
+ * queued by conn_queue once sent */
+static upsreq_t *conn_newreq(upsconn_t *conn, utype_t *ups, upsdone_t done)
+{
+	upsreq_t	*req;
 
-		/* not ERR, but not caught by readline either? */
+	req = xcalloc(1, sizeof(*req));
+	req->conn = conn;
+	req->ups = ups;
+	req->done = done;
 
-		upslogx(LOG_ALERT, "Master privileges unavailable on UPS [%s]", 
-			ups->sys);
-		upslogx(LOG_ALERT, "Response: [%s]", buf);
+	return req;
+}
+
+static void conn_queue(upsreq_t *req)
+{
+	upsconn_t	*conn = req->conn;
+
+	if (conn->tail)
+		conn->tail->next = req;
+	else
+		conn->head = req;
+
+	conn->tail = req;
+
+	/* upsd has NET_TIMEOUT seconds to answer from now on */
+	if (conn->pending++ == 0)
+		conn->waitsince = monotime();
+
+	if (req->ups)
+		req->ups->pending++;
+}
+
+/* upscli callback: pass the answer to its request, the oldest one */
+static void conn_answer(UPSCONN_t *upsconn, void *arg, int status,
+	unsigned int numa, char **answer)
+{
+	upsreq_t	*req = arg;
+	upsconn_t	*conn = req->conn;
+	utype_t	*ups;
+
+	conn->head = req->next;
+
+	if (!conn->head)
+		conn->tail = NULL;
+
+	conn->pending--;
+	conn->waitsince = monotime();
+
+	if (req->ups)
+		req->ups->pending--;
+
+	/* the first answer tells the connection (and SSL) is up */
+	if ((!conn->ready) && (!conn_failed(conn))) {
+		conn->ready = 1;
+
+		for (ups = firstups; ups != NULL; ups = ups->next)
+			if (ups->conn == conn)
+				setflag(&ups->status, ST_CONNECTED);
 	}
-	else {	/* something caught by readraw's parsing call */
-		upslogx(LOG_ALERT, "Master privileges unavailable on UPS [%s]", 
-			ups->sys);
-		upslogx(LOG_ALERT, "Reason: %s", upscli_strerror(&ups->conn));
+
+	req->done(conn, req->ups, status, numa, answer);
+	free(req);
+}
+
+/* queue a GET, or a command answered by OK, for ups (or the connection
+ * itself if NULL): done gets the answer later, from conn_poll */
+static int conn_request(upsconn_t *conn, utype_t *ups, int get,
+	unsigned int numq, const char **query, upsdone_t done)
+{
+	upsreq_t	*req;
+	int	ret;
+
+	req = conn_newreq(conn, ups, done);
+
+	if (get)
+		ret = upscli_get_async(conn->conn, numq, query, conn_answer, req);
+	else
+		ret = upscli_cmd_async(conn->conn, numq, query, conn_answer, req);
+
+	if (ret < 0) {
+		free(req);
+		return -1;
 	}
 
+	conn_queue(req);
+
 	return 0;
 }
 
-/* authenticate to upsd, plus do LOGIN and MASTER if applicable */
-static int do_upsd_auth(utype_t *ups)
+/* let go of the connection of a UPS, and of its LOGIN: upsclient closes
+ * the connection once unused */
+static void conn_release(utype_t *ups)
 {
-	char	buf[SMALLBUF];
+	upsconn_t	*conn = ups->conn;
+	upsreq_t	*req;
 
-	if (!ups->un) {
-		upslogx(LOG_ERR, "UPS [%s]: no username defined!", ups->sys);
-		return 0;
-	}
+	if (!conn)
+		return;
 
-	snprintf(buf, sizeof(buf), "USERNAME %s\n", ups->un);
-	if (upscli_sendline(&ups->conn, buf, strlen(buf)) < 0) {
-		upslogx(LOG_ERR, "Can't set username on [%s]: %s",
-			ups->sys, upscli_strerror(&ups->conn));
-			return 0;
-	}
+	/* the answers still to come are for nobody now */
+	for (req = conn->head; req != NULL; req = req->next)
+		if (req->ups == ups)
+			req->ups = NULL;
 
-	if (upscli_readline(&ups->conn, buf, sizeof(buf)) < 0) {
-		upslogx(LOG_ERR, "Set username on [%s] failed: %s",
-			ups->sys, upscli_strerror(&ups->conn));
-		return 0;
-	}
+	ups->pending = 0;
+	ups->conn = NULL;
 
-	/* authenticate first */
-	snprintf(buf, sizeof(buf), "PASSWORD %s\n", ups->pw);
+	upscli_disconnect_shared(conn->conn, ups->un ? ups->upsname : NULL);
 
-	if (upscli_sendline(&ups->conn, buf, strlen(buf)) < 0) {
-		upslogx(LOG_ERR, "Can't set password on [%s]: %s",
-			ups->sys, upscli_strerror(&ups->conn));
-			return 0;
+	/* gone with its last UPS: conn_sweep frees the rest */
+	if (--conn->refs < 1) {
+		conn->conn = NULL;
+		conn->broken = 1;
 	}
+}
 
-	if (upscli_readline(&ups->conn, buf, sizeof(buf)) < 0) {
-		upslogx(LOG_ERR, "Set password on [%s] failed: %s",
-			ups->sys, upscli_strerror(&ups->conn));
-		return 0;
-	}
+/* cleanly close the connection to a given UPS */
+static void drop_connection(utype_t *ups)
+{
+	upsdebugx(2, "Dropping connection to UPS [%s]", ups->sys);
 
-	/* catch insanity from the server - not ERR and not OK either */
-	if (strncmp(buf, "OK", 2) != 0) {
-		upslogx(LOG_ERR, "Set password on [%s] failed - got [%s]",
-			ups->sys, buf);
-		return 0;
-	}
+	ups->commstate = 0;
+	ups->linestate = 0;
+	/* other UPSes may still use this connection */
+	conn_release(ups);
 
-	/* we require a upsname now */
-	if ((ups->upsname == NULL) || (strlen(ups->upsname) == 0)) {
-		upslogx(LOG_ERR, "Login to UPS [%s] failed: empty upsname",
-			ups->sys);
-		return 0;
-	}
+	clearflag(&ups->status, ST_LOGIN);
+	clearflag(&ups->status, ST_CONNECTED);
+}
 
-	/* password is set, let's login */
-	snprintf(buf, sizeof(buf), "LOGIN %s\n", ups->upsname);
+static void login_done(upsconn_t *conn, utype_t *ups, int status,
+	unsigned int numa, char **answer)
+{
+	if ((!ups) || conn_failed(conn))
+		return;
 
-	if (upscli_sendline(&ups->conn, buf, strlen(buf)) < 0) {
-		upslogx(LOG_ERR, "Login to UPS [%s] failed: %s",
-			ups->sys, upscli_strerror(&ups->conn));
-		return 0;
+	if (status == 0) {
+		upsdebugx(1, "Logged into UPS %s", ups->sys);
+		setflag(&ups->status, ST_LOGIN);
+		return;
 	}
 
-	if (upscli_readline(&ups->conn, buf, sizeof(buf)) < 0) {
-		upslogx(LOG_ERR, "Can't login to UPS [%s]: %s",
-			ups->sys, upscli_strerror(&ups->conn));
-		return 0;
+	/* older upsd: upsclient gives this UPS a connection of its own */
+	if (upscli_upserror(conn->conn) == UPSCLI_ERR_LOGINTWICE) {
+		upsdebugx(2, "UPS [%s]: one login per connection on %s",
+			ups->sys, ups->hostname);
+
+		conn_release(ups);
+		clearflag(&ups->status, ST_CONNECTED);
+
+		/* reconnect right away */
+		ups->polltime = -1;
+		return;
 	}
 
-	/* catch insanity from the server - not ERR and not OK either */
-	if (strncmp(buf, "OK", 2) != 0) {
-		upslogx(LOG_ERR, "Login on UPS [%s] failed - got [%s]",
-			ups->sys, buf);
-		return 0;
+	/* a refused USERNAME or PASSWORD is told here too */
+	upslogx(LOG_ERR, "Login to UPS [%s] failed: %s",
+		ups->sys, upscli_strerror(conn->conn));
+}
+
+static void master_done(upsconn_t *conn, utype_t *ups, int status,
+	unsigned int numa, char **answer)
+{
+	if ((!ups) || conn_failed(conn) || (status == 0))
+		return;
+
+	upslogx(LOG_ALERT, "Master privileges unavailable on UPS [%s]",
+		ups->sys);
+	upslogx(LOG_ALERT, "Reason: %s", upscli_strerror(conn->conn));
+}
+
+/* check for master permissions on the server for this ups */
+static void checkmaster(utype_t *ups)
+{
+	const char	*query[2];
+
+	/* don't bother if we're not configured as a master for this ups */
+	if (!flag_isset(ups->status, ST_MASTER))
+		return;
+
+	/* this shouldn't happen (LOGIN checks it earlier) */
+	if ((ups->upsname == NULL) || (strlen(ups->upsname) == 0)) {
+		upslogx(LOG_ERR, "Set master on UPS [%s] failed: empty upsname",
+			ups->sys);
+		return;
 	}
 
-	/* finally - everything is OK */
-	upsdebugx(1, "Logged into UPS %s", ups->sys);
-	setflag(&ups->status, ST_LOGIN);
+	query[0] = "MASTER";
+	query[1] = ups->upsname;
 
-	/* now see if we also need to test master permissions */
-	return checkmaster(ups);
+	if (conn_request(ups->conn, ups, 0, 2, query, master_done) < 0)
+		upslogx(LOG_ALERT, "Can't set master mode on UPS [%s] - %s",
+			ups->sys, upscli_strerror(ups->conn->conn));
 }
 
 /* set flags and make announcements when a UPS has been checked successfully */
@@ -452,131 +837,264 @@ static void doshutdown(void)
 	exit(EXIT_SUCCESS);
 }
 
-/* set forced shutdown flag so other upsmons know what's going on here */
-static void setfsd(utype_t *ups)
+/* a connection failed or timed out: its UPSes are gone until they
+ * reconnect at their next poll */
+static void conn_lost(upsconn_t *conn, const char *why)
 {
-	char	buf[SMALLBUF];
-	int	ret;
+	utype_t	*ups;
+	char	reason[SMALLBUF];
 
-	/* this shouldn't happen */
-	if (!ups->upsname) {
-		upslogx(LOG_ERR, "setfsd: programming error: no UPS name set [%s]",
-			ups->sys);
-		return;
-	}
+	/* why may point in conn, which gets reset */
+	snprintf(reason, sizeof(reason), "%s", why);
 
-	upsdebugx(2, "Setting FSD on UPS %s", ups->sys);
+	conn->broken = 1;
+	conn->pending = 0;
 
-	snprintf(buf, sizeof(buf), "FSD %s\n", ups->upsname);
+	/* the requests still queued are dropped without an answer, and
+	 * upsclient doesn't share it anymore */
+	upscli_disconnect(conn->conn);
 
-	ret = upscli_sendline(&ups->conn, buf, strlen(buf));
+	for (ups = firstups; ups != NULL; ups = ups->next) {
+		if (ups->conn != conn)
+			continue;
 
-	if (ret < 0) {
-		upslogx(LOG_ERR, "FSD set on UPS %s failed: %s", ups->sys,
-			upscli_strerror(&ups->conn));
-		return;
+		if (conn->ready)
+			upslogx(LOG_ERR, "Poll UPS [%s] failed - %s",
+				ups->sys, reason);
+		else
+			upslogx(LOG_ERR, "UPS [%s]: connect failed: %s",
+				ups->sys, reason);
+
+		/* throw COMMBAD or NOCOMM as conditions may warrant */
+		ups_is_gone(ups);
+		drop_connection(ups);
 	}
+}
 
-	ret = upscli_readline(&ups->conn, buf, sizeof(buf));
+/* give up on the connections where upsd is late to answer */
+static void conn_timeouts(void)
+{
+	upsconn_t	*conn;
+	char	why[SMALLBUF];
+	double	now;
 
-	if (ret < 0) {
-		upslogx(LOG_ERR, "FSD set on UPS %s failed: %s", ups->sys,
-			upscli_strerror(&ups->conn));
-		return;
-	}
+	now = monotime();
 
-	if (!strncmp(buf, "OK", 2))
-		return;
+	for (conn = firstconn; conn != NULL; conn = conn->next) {
+		if ((conn->broken) || (conn->pending < 1))
+			continue;
 
-	/* protocol error: upsd said something other than "OK" */
-	upslogx(LOG_ERR, "FSD set on UPS %s failed: %s", ups->sys, buf);
-}
+		if (now - conn->waitsince < NET_TIMEOUT)
+			continue;
 
-static void set_alarm(void)
-{
-	alarm(NET_TIMEOUT);
+		snprintf(why, sizeof(why), "no answer from %s in %d seconds",
+			conn->hostname, NET_TIMEOUT);
+		conn_lost(conn, why);
+	}
 }
 
-static void clear_alarm(void)
+/* close the connections no UPS uses anymore */
+static void conn_sweep(void)
 {
-	signal(SIGALRM, SIG_IGN);
-	alarm(0);
+	upsconn_t	*conn, **pconn;
+	upsreq_t	*req;
+
+	pconn = &firstconn;
+
+	while ((conn = *pconn) != NULL) {
+		if (conn->refs > 0) {
+			pconn = &conn->next;
+			continue;
+		}
+
+		*pconn = conn->next;
+
+		while ((req = conn->head) != NULL) {
+			conn->head = req->next;
+			free(req);
+		}
+
+		free(conn->hostname);
+		free(conn);
+	}
 }
 
-static int get_var(utype_t *ups, const char *var, char *buf, size_t bufsize)
+/* wait up to timeout seconds for upsd on all the connections, and pass
+ * what arrives to the handlers of the requests */
+static void conn_poll(double timeout)
 {
-	int	ret;
-	unsigned int	numq, numa;
-	const	char	*query[4];
-	char	**answer;
+	static	struct	pollfd	*fds = NULL;
+	static	upsconn_t	**fdconn = NULL;
+	static	size_t	maxfds = 0;
+	size_t	i, nfds = 0;
+	upsconn_t	*conn;
+	int	events;
+
+	for (conn = firstconn; conn != NULL; conn = conn->next) {
+		if ((conn->broken) || (conn->refs < 1))
+			continue;
 
-	/* this shouldn't happen */
-	if (!ups->upsname) {
-		upslogx(LOG_ERR, "get_var: programming error: no UPS name set [%s]",
-			ups->sys);
-		return -1;
+		events = upscli_async_events(conn->conn);
+
+		if (events == 0)
+			continue;
+
+		if (nfds == maxfds) {
+			maxfds = maxfds ? maxfds * 2 : 16;
+			fds = xrealloc(fds, maxfds * sizeof(*fds));
+			fdconn = xrealloc(fdconn, maxfds * sizeof(*fdconn));
+		}
+
+		fds[nfds].fd = upscli_fd(conn->conn);
+		fds[nfds].events = 0;
+		fds[nfds].revents = 0;
+
+		if (events & UPSCLI_EV_READ)
+			fds[nfds].events |= POLLIN;
+		if (events & UPSCLI_EV_WRITE)
+			fds[nfds].events |= POLLOUT;
+
+		fdconn[nfds++] = conn;
 	}
 
-	numq = 0;
+	/* round up, to not wake up just before the time */
+	if (timeout < 0)
+		timeout = 0;
+
+	/* interrupted by a signal: the main loop checks the flags */
+	if (poll(fds, nfds, (int)(timeout * 1000) + (timeout > 0)) < 1)
+		return;
+
+	for (i = 0; i < nfds; i++) {
+		conn = fdconn[i];
+		events = 0;
+
+		if (fds[i].revents & POLLIN)
+			events |= UPSCLI_EV_READ;
+		if (fds[i].revents & POLLOUT)
+			events |= UPSCLI_EV_WRITE;
+
+		/* upsclient sees what went wrong when trying */
+		if (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL))
+			events |= UPSCLI_EV_READ | UPSCLI_EV_WRITE;
+
+		/* a handler may have let go of it meanwhile */
+		if ((events == 0) || (conn->broken) || (conn->refs < 1))
+			continue;
 
-	if (!strcmp(var, "numlogins")) {
-		query[0] = "NUMLOGINS";
-		query[1] = ups->upsname;
-		numq = 2;
+		if (upscli_async_process(conn->conn, events) < 0)
+			conn_lost(conn, upscli_strerror(conn->conn));
 	}
+}
+
+/* see if a request with this handler is still waiting for an answer */
+static int conn_waiting(upsdone_t done)
+{
+	upsconn_t	*conn;
+	upsreq_t	*req;
 
-	if (!strcmp(var, "status")) {
-		query[0] = "VAR";
-		query[1] = ups->upsname;
-		query[2] = "ups.status";
-		numq = 3;
+	for (conn = firstconn; conn != NULL; conn = conn->next) {
+		if (conn->broken)
+			continue;
+
+		for (req = conn->head; req != NULL; req = req->next)
+			if (req->done == done)
+				return 1;
 	}
 
-	if (numq == 0) {
-		upslogx(LOG_ERR, "get_var: programming error: var=%s", var);
-		return -1;
+	return 0;
+}
+
+/* handle the connections until the requests with this handler have been
+ * answered, for NET_TIMEOUT seconds at most: when shutting down */
+static void conn_wait(upsdone_t done)
+{
+	double	start, left;
+
+	start = monotime();
+
+	while (conn_waiting(done)) {
+		left = start + NET_TIMEOUT - monotime();
+
+		if (left <= 0)
+			return;
+
+		conn_poll(left);
+		conn_timeouts();
 	}
+}
 
-	upsdebugx(3, "%s: %s / %s", __func__, ups->sys, var);
+static void setfsd_done(upsconn_t *conn, utype_t *ups, int status,
+	unsigned int numa, char **answer)
+{
+	if ((!ups) || (status == 0))
+		return;
 
-	ret = upscli_get(&ups->conn, numq, query, &numa, &answer);
+	upslogx(LOG_ERR, "FSD set on UPS %s failed: %s", ups->sys,
+		upscli_strerror(conn->conn));
+}
 
-	if (ret < 0) {
+/* set forced shutdown flag so other upsmons know what's going on here */
+static void setfsd(utype_t *ups)
+{
+	const char	*query[2];
 
-		/* detect old upsd */
-		if (upscli_upserror(&ups->conn) == UPSCLI_ERR_UNKCOMMAND) {
+	/* this shouldn't happen */
+	if (!ups->upsname) {
+		upslogx(LOG_ERR, "setfsd: programming error: no UPS name set [%s]",
+			ups->sys);
+		return;
+	}
 
-			upslogx(LOG_ERR, "UPS [%s]: Too old to monitor",
-				ups->sys);
-			return -1;
-		}
+	upsdebugx(2, "Setting FSD on UPS %s", ups->sys);
 
-		/* some other error */
-		return -1;
+	if (!ups->conn) {
+		upslogx(LOG_ERR, "FSD set on UPS %s failed: not connected",
+			ups->sys);
+		return;
 	}
 
-	if (numa < numq) {
-		upslogx(LOG_ERR, "%s: Error: insufficient data "
-			"(got %d args, need at least %d)", 
-			var, numa, numq);
-		return -1;
+	query[0] = "FSD";
+	query[1] = ups->upsname;
+
+	/* the answer is waited for by forceshutdown */
+	if (conn_request(ups->conn, ups, 0, 2, query, setfsd_done) < 0)
+		upslogx(LOG_ERR, "FSD set on UPS %s failed: %s", ups->sys,
+			upscli_strerror(ups->conn->conn));
+}
+
+static void numlogins_done(upsconn_t *conn, utype_t *ups, int status,
+	unsigned int numa, char **answer)
+{
+	if (!ups)
+		return;
+
+	/* a: NUMLOGINS <ups> <num> */
+	if ((status < 0) || (numa < 3)) {
+		ups->numlogins = 0;	/* don't wait for this one */
+		return;
 	}
 
-	snprintf(buf, bufsize, "%s", answer[numq]);
-	return 0;
+	ups->numlogins = strtol(answer[2], (char **)NULL, 10);
 }
 
+/* wait for the slaves to log out of our masters: upsd tells whenever the
+ * number of logins changes, older versions are asked again every 250 ms */
 static void slavesync(void)
 {
 	utype_t	*ups;
-	char	temp[SMALLBUF];
-	time_t	start, now;
-	int	maxlogins, logins;
+	const	char	*query[2];
+	double	start, now, next, timeout;
+	int	maxlogins, unknown, asking;
 
-	time(&start);
+	start = next = monotime();
+
+	for (ups = firstups; ups != NULL; ups = ups->next)
+		ups->numlogins = -1;
 
 	for (;;) {
-		maxlogins = 0;
+		now = monotime();
+		maxlogins = unknown = asking = 0;
 
 		for (ups = firstups; ups != NULL; ups = ups->next) {
 
@@ -584,31 +1102,53 @@ static void slavesync(void)
 			if (!flag_isset(ups->status, ST_MASTER))
 				continue;
 
-			set_alarm();
-
-			if (get_var(ups, "numlogins", temp, sizeof(temp)) >= 0) {
-				logins = strtol(temp, (char **)NULL, 10);
+			if ((!ups->conn) || (!ups->upsname))
+				continue;
 
-				if (logins > maxlogins)
-					maxlogins = logins;
+			if (!ups->conn->notify)
+				asking = 1;
+
+			if ((ups->pending == 0) && ((ups->numlogins < 0) ||
+				((!ups->conn->notify) && (now >= next)))) {
+				query[0] = "NUMLOGINS";
+				query[1] = ups->upsname;
+
+				/* like a lost connection: nothing to wait for */
+				if (conn_request(ups->conn, ups, 1, 2, query,
+					numlogins_done) < 0) {
+					conn_lost(ups->conn,
+						upscli_strerror(ups->conn->conn));
+					continue;
+				}
 			}
 
-			clear_alarm();
+			if (ups->numlogins < 0)
+				unknown = 1;
+			else if (ups->numlogins > maxlogins)
+				maxlogins = ups->numlogins;
 		}
 
 		/* if no UPS has more than 1 login (us), then slaves are gone */
-		if (maxlogins <= 1)
+		if ((!unknown) && (maxlogins <= 1))
 			return;
 
 		/* after HOSTSYNC seconds, assume slaves are stuck and bail */
-		time(&now);
-
 		if ((now - start) > hostsync) {
 			upslogx(LOG_INFO, "Host sync timer expired, forcing shutdown");
 			return;
 		}
 
-		usleep(250000);
+		if (now >= next)
+			next = now + 0.25;
+
+		timeout = start + hostsync - now;
+
+		if ((asking) && (next - now < timeout))
+			timeout = next - now;
+
+		/* the answers and NOTIFY NUMLOGINS arrive meanwhile */
+		conn_poll(timeout);
+		conn_timeouts();
 	}
 }
 
@@ -630,6 +1170,9 @@ static void forceshutdown(void)
 	if (!isamaster)
 		doshutdown();
 
+	/* FSD is sent to all of them at once, wait for the answers */
+	conn_wait(setfsd_done);
+
 	/* must be the master now */
 	upsdebugx(1, "This system is a master... waiting for slave logout...");
 
@@ -756,19 +1299,6 @@ static void ups_fsd(utype_t *ups)
 	setflag(&ups->status, ST_FSD);
 }
 
-/* cleanly close the connection to a given UPS */
-static void drop_connection(utype_t *ups)
-{
-	upsdebugx(2, "Dropping connection to UPS [%s]", ups->sys);
-
-	ups->commstate = 0;
-	ups->linestate = 0;
-	clearflag(&ups->status, ST_LOGIN);
-	clearflag(&ups->status, ST_CONNECTED);
-
-	upscli_disconnect(&ups->conn);
-}
-
 /* change some UPS parameters during reloading */
 static void redefine_ups(utype_t *ups, int pv, const char *un, 
 		const char *pw, const char *master)
@@ -920,6 +1450,9 @@ static void addups(int reloading, const char *sys, const char *pvs,
 		tmp->un = NULL;
 
 	tmp->pw = xstrdup(pw);
+	tmp->conn = NULL;
+	tmp->pending = 0;
+	tmp->polltime = -1;
 	tmp->status = 0;
 	tmp->retain = 1;
 
@@ -1309,6 +1842,12 @@ static void upsmon_cleanup(void)
 		utmp = unext;
 	}
 
+	/* LOGOUT and close them all */
+	conn_sweep();
+
+	/* the notices sent already are still handled */
+	notifier_stop();
+
 	free(run_as_user);
 	free(shutdowncmd);
 	free(notifycmd);
@@ -1332,12 +1871,6 @@ static void set_reload_flag(int sig)
 	reload_flag = 1;
 }
 
-/* handler for alarm when getupsvarfd times out */
-static void read_timeout(int sig)
-{
-	/* don't do anything here, just return */
-}
-
 /* install handlers for a few signals */
 static void setup_signals(void)
 {
@@ -1353,11 +1886,6 @@ static void setup_signals(void)
 	sigaction(SIGQUIT, &sa, NULL);
 	sigaction(SIGTERM, &sa, NULL);
 
-	/* handle timeouts */
-
-	sa.sa_handler = read_timeout;
-	sigaction(SIGALRM, &sa, NULL);
-
 	/* deal with the ones from userspace as well */
 
 	sa.sa_handler = user_fsd;
@@ -1381,17 +1909,124 @@ static void update_crittimer(utype_t *ups)
 	/* fallthrough: let the timer age */
 }
 
-/* handle connecting to upsd, plus get SSL going too if possible */
+/* SET NOTIFY ON answered: older upsd don't know it, and are polled only */
+static void notify_done(upsconn_t *conn, utype_t *unused, int status,
+	unsigned int numa, char **answer)
+{
+	if (status == 0) {
+		conn->notify = 1;
+		return;
+	}
+
+	if (!conn_failed(conn))
+		upsdebugx(2, "upsd on %s doesn't send notifications",
+			conn->hostname);
+}
+
+/* upscli callback: upsd tells about one of the UPSes of this connection
+ * without being asked, instead of waiting for the next poll */
+static void conn_notify(UPSCONN_t *upsconn, void *arg, int status,
+	unsigned int numa, char **answer)
+{
+	upsconn_t	*conn = arg;
+	utype_t	*ups;
+
+	/* a: FSD <ups> | NUMLOGINS <ups> <num> */
+	if (numa < 2)
+		return;
+
+	for (ups = firstups; ups != NULL; ups = ups->next) {
+		if ((ups->conn != conn) || strcmp(ups->upsname, answer[1]))
+			continue;
+
+		if (!strcmp(answer[0], "FSD")) {
+			upsdebugx(2, "UPS [%s]: FSD notified by upsd", ups->sys);
+			ups_fsd(ups);
+		}
+
+		if ((!strcmp(answer[0], "NUMLOGINS")) && (numa >= 3))
+			ups->numlogins = strtol(answer[2], (char **)NULL, 10);
+	}
+}
+
+/* the connection to use for a UPS: upsclient picks one already opened to
+ * its upsd with the same credentials, or opens one, and queues the LOGIN */
+static upsconn_t *conn_open(utype_t *ups, int flags)
+{
+	UPSCONN_t	*upsconn;
+	upsconn_t	*conn;
+	upsreq_t	*req;
+	const	char	*query[3];
+	int	ret;
+
+	/* its upsconn_t is only known once upsclient returns */
+	req = conn_newreq(NULL, ups, login_done);
+
+	ret = upscli_connect_shared(&upsconn, ups->hostname, ups->port, flags,
+		ups->un, ups->pw, ups->un ? ups->upsname : NULL, conn_answer, req);
+
+	if (!upsconn) {
+		free(req);
+		return NULL;
+	}
+
+	for (conn = firstconn; conn != NULL; conn = conn->next)
+		if ((conn->conn == upsconn) && (!conn->broken))
+			break;
+
+	if (!conn) {
+		conn = xcalloc(1, sizeof(*conn));
+		conn->conn = upsconn;
+		conn->hostname = xstrdup(ups->hostname);
+
+		conn->next = firstconn;
+		firstconn = conn;
+	}
+
+	conn->refs++;
+
+	if (ret < 0) {
+		conn->broken = 1;
+		free(req);
+		return conn;
+	}
+
+	/* LOGIN queued: answered in order with the requests of conn */
+	if (ret == 0) {
+		req->conn = conn;
+		conn_queue(req);
+	} else {
+		free(req);
+	}
+
+	if (conn->refs > 1)
+		return conn;
+
+	upscli_notify_async(conn->conn, conn_notify, conn);
+
+	/* FSD and logouts are then told right away, see conn_notify */
+	if (ups->un) {
+		query[0] = "SET";
+		query[1] = "NOTIFY";
+		query[2] = "ON";
+		conn_request(conn, NULL, 0, 3, query, notify_done);
+	}
+
+	return conn;
+}
+
+/* start connecting to upsd, plus get SSL going too if possible: the
+ * LOGIN and MASTER are queued behind, without waiting */
 static int try_connect(utype_t *ups)
 {
-	int	flags = 0, ret;
+	int	flags = 0;
 
 	upsdebugx(1, "Trying to connect to UPS [%s]", ups->sys);
 
 	clearflag(&ups->status, ST_CONNECTED);
 
 	/* force it if configured that way, just try it otherwise */
-	if (forcessl == 1) 
+	if (forcessl == 1)
 		flags |= UPSCLI_CONN_REQSSL;
 	else
 		flags |= UPSCLI_CONN_TRYSSL;
@@ -1420,30 +2055,47 @@ static int try_connect(utype_t *ups)
 		flags |= UPSCLI_CONN_CERTVERIF;
 	}
 
-	ret = upscli_connect(&ups->conn, ups->hostname, ups->port, flags);
-
-	if (ret < 0) {
-		upslogx(LOG_ERR, "UPS [%s]: connect failed: %s",
-			ups->sys, upscli_strerror(&ups->conn));
+	if ((!ups->hostname) || (!ups->upsname)) {
+		upslogx(LOG_ERR, "UPS [%s]: connect failed: invalid UPS name",
+			ups->sys);
 		ups_is_gone(ups);
 		return 0;
 	}
 
-	/* we're definitely connected now */
-	setflag(&ups->status, ST_CONNECTED);
+	if (!ups->un)
+		upslogx(LOG_ERR, "UPS [%s]: no username defined!", ups->sys);
 
-	/* now try to authenticate to upsd */
+	/*
+	 * the UPSes monitored on the same upsd with the same credentials
+	 * share one connection
+	 */
+	ups->conn = conn_open(ups, flags);
+
+	if (!ups->conn) {
+		upslogx(LOG_ERR, "UPS [%s]: connect failed: %s",
+			ups->sys, strerror(ENOMEM));
+		ups_is_gone(ups);
+		return 0;
+	}
 
-	ret = do_upsd_auth(ups);
+	if (ups->conn->broken) {
+		upslogx(LOG_ERR, "UPS [%s]: connect failed: %s",
+			ups->sys, upscli_strerror(ups->conn->conn));
+		ups_is_gone(ups);
+		conn_release(ups);
+		return 0;
+	}
 
-	if (ret == 1)
-		return 1;		/* everything is happy */
+	if (ups->conn->ready)
+		setflag(&ups->status, ST_CONNECTED);
 
-	/* something failed in the auth so we may not be completely logged in */
+	if (!ups->un)
+		return 1;
 
-	/* FUTURE: do something beyond the error msgs from do_upsd_auth? */
+	/* now see if we also need to test master permissions */
+	checkmaster(ups);
 
-	return 0;
+	return 1;
 }
 
 /* deal with the contents of STATUS or ups.status for this ups */
@@ -1451,8 +2103,6 @@ static void parse_status(utype_t *ups, char *status)
 {
 	char	*statword, *ptr;
 
-	clear_alarm();
-
 	upsdebugx(2, "%s: [%s]", __func__, status);
 
 	/* empty response is the same as a dead ups */
@@ -1498,55 +2148,83 @@ static void parse_status(utype_t *ups, char *status)
 	} 
 }
 
-/* see what the status of the UPS is and handle any changes */
-static void pollups(utype_t *ups)
+/* the answer to a poll: handle any changes */
+static void poll_done(upsconn_t *conn, utype_t *ups, int status,
+	unsigned int numa, char **answer)
 {
-	char	status[SMALLBUF];
+	char	buf[SMALLBUF];
 
-	/* try a reconnect here */
-	if (!flag_isset(ups->status, ST_CONNECTED))
-		if (try_connect(ups) != 1)
-			return;
+	if ((!ups) || conn_failed(conn))
+		return;
 
-	if (upscli_ssl(&ups->conn) == 1)
-		upsdebugx(2, "%s: %s [SSL]", __func__, ups->sys);
-	else
-		upsdebugx(2, "%s: %s", __func__, ups->sys);
+	/* a: VAR <ups> ups.status <value> */
+	if (status == 0) {
+		if (numa >= 4) {
+			snprintf(buf, sizeof(buf), "%s", answer[3]);
+			parse_status(ups, buf);
+			return;
+		}
 
-	set_alarm();
+		upslogx(LOG_ERR, "status: Error: insufficient data "
+			"(got %d args, need at least %d)", numa, 4);
 
-	if (get_var(ups, "status", status, sizeof(status)) == 0) {
-		clear_alarm();
-		parse_status(ups, status);
+		ups_is_gone(ups);
 		return;
 	}
 
-	/* fallthrough: no communications */
-	clear_alarm();
-
 	/* try to make some of these a little friendlier */
 
-	switch (upscli_upserror(&ups->conn)) {
+	switch (upscli_upserror(conn->conn)) {
 
 		case UPSCLI_ERR_UNKNOWNUPS:
 			upslogx(LOG_ERR, "Poll UPS [%s] failed - [%s] "
-			"does not exist on server %s", 
+			"does not exist on server %s",
 			ups->sys, ups->upsname,	ups->hostname);
 
 			break;
+
+		/* detect old upsd */
+		case UPSCLI_ERR_UNKCOMMAND:
+			upslogx(LOG_ERR, "UPS [%s]: Too old to monitor",
+				ups->sys);
+
+			break;
 		default:
-			upslogx(LOG_ERR, "Poll UPS [%s] failed - %s", 
-				ups->sys, upscli_strerror(&ups->conn));
+			upslogx(LOG_ERR, "Poll UPS [%s] failed - %s",
+				ups->sys, upscli_strerror(conn->conn));
 			break;
 	}
 
 	/* throw COMMBAD or NOCOMM as conditions may warrant */
 	ups_is_gone(ups);
+}
+
+/* ask for the status of the UPS: poll_done gets it, without waiting */
+static void pollups(utype_t *ups)
+{
+	const	char	*query[3];
 
-	/* if upsclient lost the connection, clean up things on our side */
-	if (upscli_fd(&ups->conn) == -1) {
+	ups->polltime = monotime();
+
+	/* try a reconnect here */
+	if (!ups->conn)
+		if (try_connect(ups) != 1)
+			return;
+
+	if (upscli_ssl(ups->conn->conn) == 1)
+		upsdebugx(2, "%s: %s [SSL]", __func__, ups->sys);
+	else
+		upsdebugx(2, "%s: %s", __func__, ups->sys);
+
+	query[0] = "VAR";
+	query[1] = ups->upsname;
+	query[2] = "ups.status";
+
+	if (conn_request(ups->conn, ups, 1, 3, query, poll_done) < 0) {
+		upslogx(LOG_ERR, "Poll UPS [%s] failed - %s",
+			ups->sys, upscli_strerror(ups->conn->conn));
+		ups_is_gone(ups);
 		drop_connection(ups);
-		return;
 	}
 }
 
@@ -1817,6 +2495,9 @@ static void reload_conf(void)
 		fatalx(EXIT_FAILURE, "Impossible power configuation, unable to continue");
 	}
 
+	/* the next notice starts a notifier with the new NOTIFYCMD */
+	notifier_stop();
+
 	/* finally clear the flag */
 	reload_flag = 0;
 }
@@ -1996,8 +2677,14 @@ int main(int argc, char *argv[])
 	closelog();
 	open_syslog(prog);
 
+	/* before any connection, for it not to hold them */
+	notifier_start();
+
 	while (exit_flag == 0) {
 		utype_t	*ups;
+		upsconn_t	*conn;
+		double	now, timeout;
+		pid_t	pid;
 
 		/* check flags from signal handlers */
 		if (userfsd)
@@ -2006,8 +2693,34 @@ int main(int argc, char *argv[])
 		if (reload_flag)
 			reload_conf();
 
-		for (ups = firstups; ups != NULL; ups = ups->next)
-			pollups(ups);
+		/* send the polls that are due, each UPS on its own schedule */
+		now = monotime();
+		timeout = sleepval;
+
+		for (ups = firstups; ups != NULL; ups = ups->next) {
+			if (ups->pending > 0)
+				continue;
+
+			if ((ups->polltime < 0) || (now - ups->polltime >= sleepval))
+				pollups(ups);
+
+			if (ups->polltime < 0)
+				timeout = 0;
+			else if (ups->polltime + sleepval - now < timeout)
+				timeout = ups->polltime + sleepval - now;
+		}
+
+		/* also wake up when upsd is late */
+		for (conn = firstconn; conn != NULL; conn = conn->next)
+			if ((conn->pending > 0) &&
+				(conn->waitsince + NET_TIMEOUT - now < timeout))
+				timeout = conn->waitsince + NET_TIMEOUT - now;
+
+		conn_sweep();
+
+		/* the answers are handled as they arrive */
+		conn_poll(timeout);
+		conn_timeouts();
 
 		recalc();
 
@@ -2015,10 +2728,13 @@ int main(int argc, char *argv[])
 		if (use_pipe)
 			check_parent();
 
-		/* reap children that have exited */
-		waitpid(-1, NULL, WNOHANG);
-
-		sleep(sleepval);
+		/* reap children that have exited: a new notifier is started
+		 * when needed */
+		while ((pid = waitpid(-1, NULL, WNOHANG)) > 0)
+			if (pid == notifier_pid) {
+				upslogx(LOG_WARNING, "Notifier process exited");
+				notifier_stop();
+			}
 	}
 
 	upslogx(LOG_INFO, "Signal %d: exiting", exit_flag);
@@ -36,10 +36,36 @@ extern "C" {
 /* *INDENT-ON* */
 #endif
 
+/* connection to upsd, shared by the UPSes monitored on it with the */
+/* same credentials (see upscli_connect_shared), and driven by the   */
+/* main loop without blocking                                        */
+
+typedef struct upsreq_s	upsreq_t;
+
+typedef struct upsconn_s {
+	UPSCONN_t	*conn;		/* NULL once let go of		*/
+	char	*hostname;
+
+	int	ready;			/* connected, and SSL started	*/
+	int	broken;			/* failed, or timed out		*/
+	int	notify;			/* upsd sends NOTIFY lines	*/
+	int	refs;			/* UPSes using it		*/
+
+	upsreq_t	*head;		/* requests waiting for answers	*/
+	upsreq_t	*tail;
+	int	pending;		/* them				*/
+	double	waitsince;		/* monotonic, for NET_TIMEOUT	*/
+
+	struct upsconn_s	*next;
+}	upsconn_t;
+
 /* UPS tracking structure */
 
 typedef struct {
-	UPSCONN_t	conn;			/* upsclient state descriptor	*/
+	upsconn_t	*conn;			/* shared upsd connection	*/
+	int	pending;		/* our requests waiting on it	*/
+	double	polltime;		/* monotonic time of last poll	*/
+	int	numlogins;		/* as master, in slavesync	*/
 
 	char	*sys;			/* raw system name from .conf	*/
 	char	*upsname;		/* just upsname			*/
@@ -83,6 +109,16 @@ typedef struct {
 #define NOTIFY_WALL    (1 << 2)        /* send the msg to all users        */
 #define NOTIFY_EXEC    (1 << 3)        /* send the msg to NOTIFYCMD script */
 
+/* a notice sent to the notifier process: all of it is compared to	*/
+/* find the duplicates							*/
+
+typedef struct {
+	int	flags;
+	char	ntype[16];
+	char	upsname[SMALLBUF];
+	char	msg[SMALLBUF];
+}	notice_t;
+
 /* flags are set to NOTIFY_SYSLOG | NOTIFY_WALL at program init	*/
 /* the user can override with NOTIFYFLAGS in the upsmon.conf	*/
 
@@ -116,6 +152,8 @@ struct {
 /* various constants */
 
 #define NET_TIMEOUT 10		/* wait 10 seconds max for upsd to respond */
+#define NOTIFY_MAXPROC 4	/* NOTIFYCMD and wall running at once, at most */
+#define NOTIFY_MAXQUEUE 256	/* notices waiting for them, at most */
 
 #ifdef __cplusplus
 /* *INDENT-OFF* */
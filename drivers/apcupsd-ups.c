@@ -26,7 +26,7 @@
 #include "apcupsd-ups.h"
 
 #define DRIVER_NAME	"apcupsd network client UPS driver"
-#define DRIVER_VERSION	"0.04"
+#define DRIVER_VERSION	"0.05"
 
 /* driver description structure */
 upsdrv_info_t upsdrv_info = {
@@ -40,6 +40,21 @@ upsdrv_info_t upsdrv_info = {
 static int port=3551;
 static struct sockaddr_in host;
 
+/* NIS connection to apcupsd, kept open across polls */
+#define NIS_TIMEOUT	15000	/* ms to wait for apcupsd to answer */
+#define NIS_BACKOFF_MAX	60	/* max seconds between reconnect attempts */
+
+static int nis_fd=-1;
+static int nis_backoff=0;
+static time_t nis_retry=0;
+
+/* input buffer, holding what was read from nis_fd but not parsed yet */
+static char nis_buf[4096];
+static size_t nis_len=0;
+
+/* nut_data entries updated by the current reply */
+static char nut_seen[sizeof(nut_data)/sizeof(nut_data[0])];
+
 static void process(char *item,char *data)
 {
 	int i;
@@ -47,10 +62,15 @@ static void process(char *item,char *data)
 	char *p2;
 
 	for(i=0;nut_data[i].info_type;i++)if(!(nut_data[i].apcupsd_item))
+	{
 		dstate_setinfo(nut_data[i].info_type,"%s",
 			nut_data[i].default_value);
+		nut_seen[i]=1;
+	}
 	else if(!strcmp(nut_data[i].apcupsd_item,item))
-			switch(nut_data[i].drv_flags&~DU_FLAG_INIT)
+	{
+		/* only what gets a value is seen: the rest is deleted */
+		switch(nut_data[i].drv_flags&~DU_FLAG_INIT)
 	{
 	case DU_FLAG_STATUS:
 		status_init();
@@ -71,6 +91,7 @@ static void process(char *item,char *data)
 			else if(!strcmp(data,"NOBATT"))status_set("BYPASS");
 		}
 		status_commit();
+		nut_seen[i]=1;
 		break;
 
 	case DU_FLAG_DATE:
@@ -81,6 +102,7 @@ static void process(char *item,char *data)
 			*p1=' ';
 		}
 		else dstate_setinfo(nut_data[i].info_type,"%s",data);
+		nut_seen[i]=1;
 		break;
 
 	case DU_FLAG_TIME:
@@ -95,6 +117,7 @@ static void process(char *item,char *data)
 			}
 			else dstate_setinfo(nut_data[i].info_type,"%s",p1+1);
 			*p1=' ';
+			nut_seen[i]=1;
 		}
 		break;
 
@@ -111,14 +134,18 @@ static void process(char *item,char *data)
 			else dstate_setinfo(nut_data[i].info_type,"%s",data);
 		}
 		else dstate_setinfo(nut_data[i].info_type,"%s",data);
+		nut_seen[i]=1;
 		break;
 
 	case DU_FLAG_FW2:
 		if((p1=strchr(data,'/')))
 		{
 			for(;*p1;p1++)if(p1[1]!=' ')break;
-			if(*p1&&p1[1])dstate_setinfo(nut_data[i].info_type,"%s",
-				p1+1);
+			if(*p1&&p1[1])
+			{
+				dstate_setinfo(nut_data[i].info_type,"%s",p1+1);
+				nut_seen[i]=1;
+			}
 		}
 		break;
 
@@ -131,104 +158,215 @@ static void process(char *item,char *data)
 		else dstate_setinfo(nut_data[i].info_type,
 			nut_data[i].default_value,
 			atof(data)*nut_data[i].info_len);
+		nut_seen[i]=1;
 		break;
 	}
+	}
 }
 
-static int getdata(void)
+static void nis_disconnect(void)
 {
-	int x, fd_flags;
-	short n;
-	char *item;
-	char *data;
-	struct pollfd p;
-	char bfr[1024];
+	if(nis_fd==-1)return;
 
-	for(x=0;nut_data[x].info_type;x++)
-		if(!(nut_data[x].drv_flags&DU_FLAG_INIT))
-			dstate_delinfo(nut_data[x].info_type);
+	close(nis_fd);
+	nis_fd=-1;
+	nis_len=0;
+}
 
-	if((p.fd=socket(AF_INET,SOCK_STREAM,0))==-1)
+static int nis_connect(void)
+{
+	int fd_flags;
+	time_t now;
+
+	time(&now);
+
+	/* don't hammer an unreachable apcupsd, wait for the backoff delay */
+	if(nis_backoff&&now<nis_retry)
 	{
-		upsdebugx(1,"socket error");
+		upsdebugx(2,"next apcupsd connection attempt in %d seconds",
+			(int)(nis_retry-now));
 		return -1;
 	}
 
-	if(connect(p.fd,(struct sockaddr *)&host,sizeof(host)))
+	if((nis_fd=socket(AF_INET,SOCK_STREAM,0))==-1)
+	{
+		upsdebugx(1,"socket error");
+		goto fail;
+	}
+
+	if(connect(nis_fd,(struct sockaddr *)&host,sizeof(host)))
 	{
 		upsdebugx(1,"can't connect to apcupsd");
-		close(p.fd);
-		return -1;
+		goto fail;
 	}
 
-	fd_flags = fcntl(p.fd, F_GETFL);
+	fd_flags = fcntl(nis_fd, F_GETFL);
 	fd_flags |= O_NONBLOCK;
-	if(fcntl(p.fd, F_SETFL, fd_flags))
+	if(fcntl(nis_fd, F_SETFL, fd_flags))
 	{
 		upsdebugx(1,"unexpected fcntl(fd, F_SETFL, fd_flags|O_NONBLOCK) failure");
-		close(p.fd);
+		goto fail;
+	}
+
+	upsdebugx(2,"connected to apcupsd");
+	nis_backoff=0;
+	nis_len=0;
+	return 0;
+
+fail:
+	nis_disconnect();
+
+	nis_backoff=nis_backoff?nis_backoff*2:1;
+	if(nis_backoff>NIS_BACKOFF_MAX)nis_backoff=NIS_BACKOFF_MAX;
+	nis_retry=now+nis_backoff;
+	return -1;
+}
+
+/* read whatever apcupsd has for us, waiting at most NIS_TIMEOUT */
+static int nis_fill(void)
+{
+	struct pollfd p;
+	ssize_t ret;
+
+	if(nis_len==sizeof(nis_buf))
+	{
+		upsdebugx(1,"apcupsd communication error");
 		return -1;
 	}
 
+	p.fd=nis_fd;
 	p.events=POLLIN;
 
-	n=htons(6);
-	x=write(p.fd,&n,2);
-	x=write(p.fd,"status",6);
-
 	/* TODO: double-check for poll() in configure script */
-	while(poll(&p,1,15000)==1)
+	if(poll(&p,1,NIS_TIMEOUT)!=1)
 	{
-		if(read(p.fd,&n,2)!=2)
-		{
-			upsdebugx(1,"apcupsd communication error");
-			close(p.fd);
-			return -1;
-		}
+		upsdebugx(1,"apcupsd communication timeout");
+		return -1;
+	}
 
-		if(!(x=ntohs(n)))
-		{
-			close(p.fd);
-			return 0;
-		}
-		else if(x<0||x>=(int)sizeof(bfr))
-		{
-			upsdebugx(1,"apcupsd communication error");
-			close(p.fd);
-			return -1;
-		}
+	ret=read(nis_fd,nis_buf+nis_len,sizeof(nis_buf)-nis_len);
+	if(ret<0&&(errno==EAGAIN||errno==EINTR))return 0;
+	if(ret<=0)
+	{
+		upsdebugx(1,"unexpected connection close by apcupsd");
+		return -1;
+	}
 
-		if(poll(&p,1,15000)!=1)break;
+	nis_len+=ret;
+	return 0;
+}
 
-		if(read(p.fd,bfr,x)!=x)
-		{
-			upsdebugx(1,"apcupsd communication error");
-			close(p.fd);
-			return -1;
-		}
+/* get the next record out of the input buffer, as a NUL terminated
+   string in bfr: returns its length, 0 at the end of the reply, -1 on
+   error and -2 if more data is needed */
+static int nis_record(char *bfr,size_t bfrlen)
+{
+	int x;
+
+	if(nis_len<2)return -2;
+
+	x=((unsigned char)nis_buf[0]<<8)|(unsigned char)nis_buf[1];
+	if(x>=(int)bfrlen)
+	{
+		upsdebugx(1,"apcupsd communication error");
+		return -1;
+	}
+
+	if(nis_len<(size_t)x+2)return -2;
 
-		bfr[x]=0;
+	memcpy(bfr,nis_buf+2,x);
+	bfr[x]=0;
 
+	nis_len-=x+2;
+	memmove(nis_buf,nis_buf+x+2,nis_len);
+
+	return x;
+}
+
+static int nis_request(const char *cmd)
+{
+	unsigned char bfr[16];
+	size_t len=strlen(cmd);
+
+	bfr[0]=(len>>8)&0xff;
+	bfr[1]=len&0xff;
+	memcpy(bfr+2,cmd,len);
+
+	if(write(nis_fd,bfr,len+2)!=(ssize_t)(len+2))return -1;
+
+	return 0;
+}
+
+/* get the next complete record, reading more from apcupsd as needed */
+static int nis_next(char *bfr,size_t bfrlen)
+{
+	int x;
+
+	while((x=nis_record(bfr,bfrlen))==-2)
+		if(nis_fill())return -1;
+
+	return x;
+}
+
+static int getdata(void)
+{
+	int x, reused;
+	char *item;
+	char *data;
+	char bfr[1024];
+
+	memset(nut_seen,0,sizeof(nut_seen));
+
+	reused=(nis_fd!=-1);
+	if(!reused&&nis_connect())goto fail;
+
+	if(nis_request("status")||(x=nis_next(bfr,sizeof(bfr)))<0)
+	{
+		nis_disconnect();
+		if(!reused)goto fail;
+
+		/* apcupsd may have dropped our idle connection since the
+		   last poll: start over once on a fresh one */
+		upsdebugx(1,"apcupsd connection lost, reconnecting");
+		if(nis_connect())goto fail;
+		if(nis_request("status")||(x=nis_next(bfr,sizeof(bfr)))<0)
+			goto fail;
+	}
+
+	for(;x>0;x=nis_next(bfr,sizeof(bfr)))
+	{
 		if(!(item=strtok(bfr," \t:\r\n")))
 		{
 			upsdebugx(1,"apcupsd communication error");
-			close(p.fd);
-			return -1;
+			goto fail;
 		}
 
 		if(!(data=strtok(NULL,"\r\n")))
 		{
 			upsdebugx(1,"apcupsd communication error");
-			close(p.fd);
-			return -1;
+			goto fail;
 		}
 		while(*data==' '||*data=='\t'||*data==':')data++;
 
 		process(item,data);
 	}
 
-	upsdebugx(1,"unexpected connection close by apcupsd");
-	close(p.fd);
+	if(x<0)goto fail;
+
+	/* drop what apcupsd did not report this time */
+	for(x=0;nut_data[x].info_type;x++)
+		if(!(nut_data[x].drv_flags&DU_FLAG_INIT)&&!nut_seen[x])
+			dstate_delinfo(nut_data[x].info_type);
+
+	return 0;
+
+fail:
+	nis_disconnect();
+
+	for(x=0;nut_data[x].info_type;x++)
+		if(!(nut_data[x].drv_flags&DU_FLAG_INIT))
+			dstate_delinfo(nut_data[x].info_type);
+
 	return -1;
 }
 
@@ -237,14 +375,16 @@ void upsdrv_initinfo(void)
 	if(!port)fatalx(EXIT_FAILURE,"invalid host or port specified!");
 	if(getdata())fatalx(EXIT_FAILURE,"can't communicate with apcupsd!");
 	else dstate_dataok();
-	poll_interval=60;
 }
 
 void upsdrv_updateinfo(void)
 {
-	if(getdata())upslogx(LOG_ERR,"can't communicate with apcupsd!");
+	if(getdata())
+	{
+		upslogx(LOG_ERR,"can't communicate with apcupsd!");
+		dstate_datastale();
+	}
 	else dstate_dataok();
-	poll_interval=60;
 }
 
 void upsdrv_shutdown(void)
@@ -287,4 +427,5 @@ void upsdrv_initups(void)
 
 void upsdrv_cleanup(void)
 {
+	nis_disconnect();
 }
@@ -154,6 +154,8 @@ static void init_ups_meter_map(const unsigned char *map, unsigned char len);
 static void init_ups_alarm_map(const unsigned char *map, unsigned char len);
 static bool_t set_alarm_support_in_alarm_map(const unsigned char *map, const int mapIndex, const int bitmask, const int alarmMapIndex, const int alarmBlockIndex);
 static void decode_meter_map_entry(const unsigned char *entry, const unsigned char format, char* value);
+static bcmxcp_meter_decoder_t get_meter_decoder(const unsigned char format);
+static bool_t decode_meter_block(const unsigned char *data);
 static int init_outlet(unsigned char len);
 static void init_system_test_capabilities(void);
 static int instcmd(const char *cmdname, const char *extra);
@@ -240,6 +242,13 @@ BCMXCP_METER_MAP_ENTRY_t
 	bcmxcp_meter_map[BCMXCP_METER_MAP_MAX];
 BCMXCP_ALARM_MAP_ENTRY_t
 	bcmxcp_alarm_map[BCMXCP_ALARM_MAP_MAX];
+
+/* Dense list of the meters both offered by the UPS and known to NUT,
+ * built from the meter map by init_ups_meter_map() */
+static BCMXCP_METER_PLAN_ENTRY_t
+	bcmxcp_meter_plan[BCMXCP_METER_MAP_MAX];
+static int meter_plan_len = 0;
+
 BCMXCP_STATUS_t
 	bcmxcp_status;
 
@@ -814,10 +823,25 @@ bool_t init_command(int size)
 	}
 }
 
+static void meter_plan_add(const BCMXCP_METER_MAP_ENTRY_t *meter)
+{
+	BCMXCP_METER_PLAN_ENTRY_t *plan = &bcmxcp_meter_plan[meter_plan_len++];
+
+	plan->nut_entity = meter->nut_entity;
+	plan->format = meter->format;
+	plan->meter_block_index = meter->meter_block_index;
+	plan->decode = get_meter_decoder(meter->format);
+	plan->is_ups_load = !strcasecmp(meter->nut_entity, "ups.load");
+	plan->raw = 0;
+	plan->published = FALSE;
+}
+
 void init_ups_meter_map(const unsigned char *map, unsigned char len)
 {
 	unsigned int iIndex, iOffset = 0;
 
+	meter_plan_len = 0;
+
 	/* In case of debug - make explanation of values */
 	upsdebugx(2, "Index\tOffset\tFormat\tNUT");
 
@@ -834,19 +858,105 @@ void init_ups_meter_map(const unsigned char *map, unsigned char len)
 			upsdebugx(2, "%04d\t%04d\t%2x\t%s", iIndex, iOffset, bcmxcp_meter_map[iIndex].format,
 					(bcmxcp_meter_map[iIndex].nut_entity == NULL ? "None" :bcmxcp_meter_map[iIndex].nut_entity));
 
+			/* Add it to the decode plan, if NUT knows what to do with it */
+			if (bcmxcp_meter_map[iIndex].nut_entity != NULL)
+				meter_plan_add(&bcmxcp_meter_map[iIndex]);
+
 			iOffset += 4;
 		}
 	}
+	upsdebugx(2, "Meter decode plan: %d active entries", meter_plan_len);
 	upsdebugx(2, "\n");
 }
 
-void decode_meter_map_entry(const unsigned char *entry, const unsigned char format, char* value)
+/* Meter decoders, one per BCM/XCP meter format: each one writes the NUT
+ * value of the 4 bytes meter entry into value */
+static void decode_meter_long(const unsigned char *entry, const unsigned char format, char *value)
+{
+	/* Long integer, or seconds */
+	snprintf(value, 127, "%d", (int)get_long(entry));
+}
+
+static void decode_meter_fixed(const unsigned char *entry, const unsigned char format, char *value)
+{
+	/* Fixed point integer */
+	float fValue = get_long(entry) / ldexp(1, format & 0x0f);
+
+	snprintf(value, 127, "%.2f", fValue);
+}
+
+static void decode_meter_float(const unsigned char *entry, const unsigned char format, char *value)
 {
-	long lValue = 0;
 	char sFormat[32];
-	float fValue;
-	unsigned char dd, mm, yy, cc, hh, ss;
+	float fValue = get_float(entry);
+
+	/* Format is packed BCD */
+	snprintf(sFormat, 31, "%%%d.%df", ((format & 0xf0) >> 4), (format & 0x0f));
+	snprintf(value, 127, sFormat, fValue);
+}
+
+static void decode_meter_date(const unsigned char *entry, const unsigned char format, char *value)
+{
+	unsigned char dd, mm, yy, cc;
+
+	/* Format is packed BCD for each byte, and cc uses most signifcant bit to signal date format */
+	dd = entry[0];
+	mm = entry[1];
+	yy = entry[2];
+	cc = entry[3];
+
+	/* Check format type */
+	if (cc & 0x80) {
+		/* Month:Day format */
+		snprintf(value, 127, "%d%d/%d%d/%d%d%d%d", ((dd & 0xf0) >> 4), (dd & 0x0f), ((mm & 0xf0) >> 4), (mm & 0x0f), (((cc & 0x7f) & 0xf0) >> 4), ((cc & 0x7f) & 0x0f), ((yy & 0xf0) >> 4), (yy & 0x0f));
+	}
+	else {
+		/* Julian format */
+		/* TODO test this, unsure if the day part is correct, i.e. how we use the two bytes mm and dd to calculate the number of julian days */
+		snprintf(value, 127, "%d%d%d%d:%d%d%d", (((cc & 0x7f) & 0xf0) >> 4), ((cc & 0x7f) & 0x0f), ((yy & 0xf0) >> 4), (yy & 0x0f), (mm & 0x0f), ((dd & 0xf0) >> 4), (dd & 0x0f));
+	}
+}
+
+static void decode_meter_time(const unsigned char *entry, const unsigned char format, char *value)
+{
+	unsigned char hh, mm, ss, cc;
+
+	/* Format is packed BCD for each byte */
+	cc = entry[0];
+	ss = entry[1];
+	mm = entry[2];
+	hh = entry[3];
 
+	snprintf(value, 127, "%d%d:%d%d:%d%d.%d%d", ((hh & 0xf0) >> 4), (hh & 0x0f), ((mm & 0xf0) >> 4), (mm & 0x0f), ((ss & 0xf0) >> 4), (ss & 0x0f), ((cc & 0xf0) >> 4), (cc & 0x0f));
+}
+
+static void decode_meter_unknown(const unsigned char *entry, const unsigned char format, char *value)
+{
+	/* Unknown format */
+	snprintf(value, 127, "???");
+}
+
+/* Get the decoder for a (non null) meter format */
+static bcmxcp_meter_decoder_t get_meter_decoder(const unsigned char format)
+{
+	if (format == 0xf0)
+		return decode_meter_long;
+	if ((format & 0xf0) == 0xf0)
+		return decode_meter_fixed;
+	if (format <= 0x97)
+		return decode_meter_float;
+	if (format == 0xe2)
+		return decode_meter_long;
+	if (format == 0xe0)
+		return decode_meter_date;
+	if (format == 0xe1)
+		return decode_meter_time;
+
+	return decode_meter_unknown;
+}
+
+void decode_meter_map_entry(const unsigned char *entry, const unsigned char format, char* value)
+{
 	/* Paranoid input sanity checks */
 	if (value == NULL)
 		return;
@@ -854,66 +964,45 @@ void decode_meter_map_entry(const unsigned char *entry, const unsigned char form
 	if (entry == (unsigned char *)NULL || format == 0x00)
 		return;
 
-	/* Get data based on format */
-	if (format == 0xf0) {
-		/* Long integer */
-		lValue = get_long(entry);
-		snprintf(value, 127, "%d", (int)lValue);
-	}
-	else if ((format & 0xf0) == 0xf0) {
-		/* Fixed point integer */
-		fValue = get_long(entry) / ldexp(1, format & 0x0f);
-		snprintf(value, 127, "%.2f", fValue);
-	}
-	else if (format <= 0x97) {
-		/* Floating point */
-		fValue = get_float(entry);
-		/* Format is packed BCD */
-		snprintf(sFormat, 31, "%%%d.%df", ((format & 0xf0) >> 4), (format & 0x0f));
-		snprintf(value, 127, sFormat, fValue);
-	}
-	else if (format == 0xe2) {
-		/* Seconds */
-		lValue = get_long(entry);
-		snprintf(value, 127, "%d", (int)lValue);
-	}
-	else if (format == 0xe0) {
-		/* Date */
-		/* Format is packed BCD for each byte, and cc uses most signifcant bit to signal date format */
-		dd = entry[0];
-		mm = entry[1];
-		yy = entry[2];
-		cc = entry[3];
-
-		/* Check format type */
-		if (cc & 0x80) {
-			/* Month:Day format */
-			snprintf(value, 127, "%d%d/%d%d/%d%d%d%d", ((dd & 0xf0) >> 4), (dd & 0x0f), ((mm & 0xf0) >> 4), (mm & 0x0f), (((cc & 0x7f) & 0xf0) >> 4), ((cc & 0x7f) & 0x0f), ((yy & 0xf0) >> 4), (yy & 0x0f));
-		}
-		else {
-			/* Julian format */
-			/* TODO test this, unsure if the day part is correct, i.e. how we use the two bytes mm and dd to calculate the number of julian days */
-			snprintf(value, 127, "%d%d%d%d:%d%d%d", (((cc & 0x7f) & 0xf0) >> 4), ((cc & 0x7f) & 0x0f), ((yy & 0xf0) >> 4), (yy & 0x0f), (mm & 0x0f), ((dd & 0xf0) >> 4), (dd & 0x0f));
-		}
-	}
-	else if (format == 0xe1) {
-		/* Time */
-		/* Format is packed BCD for each byte */
-		cc = entry[0];
-		ss = entry[1];
-		mm = entry[2];
-		hh = entry[3];
+	get_meter_decoder(format)(entry, format, value);
+}
 
-		snprintf(value, 127, "%d%d:%d%d:%d%d.%d%d", ((hh & 0xf0) >> 4), (hh & 0x0f), ((mm & 0xf0) >> 4), (mm & 0x0f), ((ss & 0xf0) >> 4), (ss & 0x0f), ((cc & 0xf0) >> 4), (cc & 0x0f));
-	}
-	else {
-		/* Unknown format */
-		snprintf(value, 127, "???");
-		return;
+/* Walk the meter decode plan over a meter block, and publish the values.
+ * Return TRUE if the UPS reports ups.load */
+bool_t decode_meter_block(const unsigned char *data)
+{
+	BCMXCP_METER_PLAN_ENTRY_t *plan;
+	const unsigned char *entry;
+	char sValue[128];
+	bool_t has_ups_load = FALSE;
+	uint32_t raw;
+	int iIndex;
+
+	for (iIndex = 0; iIndex < meter_plan_len; iIndex++){
+		plan = &bcmxcp_meter_plan[iIndex];
+		entry = data + plan->meter_block_index;
+
+		/* Check if we read ups.load */
+		if (plan->is_ups_load)
+			has_ups_load = TRUE;
+
+		/* The value only depends on the 4 meter bytes, so skip
+		 * decoding it again if they did not change */
+		raw = ((uint32_t)entry[0] << 24) | ((uint32_t)entry[1] << 16) | ((uint32_t)entry[2] << 8) | (uint32_t)entry[3];
+		if (plan->published && plan->raw == raw)
+			continue;
+
+		plan->decode(entry, plan->format, sValue);
+
+		/* Set result */
+		dstate_setinfo(plan->nut_entity, "%s", sValue);
+
+		plan->raw = raw;
+		plan->published = TRUE;
 	}
-	return;
-}
 
+	return has_ups_load;
+}
 
 void init_ups_alarm_map(const unsigned char *map, unsigned char len)
 {
@@ -1522,7 +1611,6 @@ void upsdrv_updateinfo(void)
 {
 	unsigned char answer[PW_ANSWER_MAX_SIZE];
 	unsigned char status, topology;
-	char sValue[128];
 	int iIndex, res,value;
 	bool_t has_ups_load = FALSE;
 	int batt_status = 0;
@@ -1538,21 +1626,8 @@ void upsdrv_updateinfo(void)
 		return;
 	}
 
-	/* Loop thru meter map, get all data UPS is willing to offer */
-	for (iIndex = 0; iIndex < BCMXCP_METER_MAP_MAX; iIndex++){
-		if (bcmxcp_meter_map[iIndex].format != 0 && bcmxcp_meter_map[iIndex].nut_entity != NULL) {
-			decode_meter_map_entry(answer + bcmxcp_meter_map[iIndex].meter_block_index,
-						 bcmxcp_meter_map[iIndex].format, sValue);
-
-			/* Set result */
-			dstate_setinfo(bcmxcp_meter_map[iIndex].nut_entity, "%s", sValue);
-
-			/* Check if we read ups.load */
-			if(has_ups_load == FALSE && !strcasecmp(bcmxcp_meter_map[iIndex].nut_entity, "ups.load")) {
-				has_ups_load = TRUE;
-			}
-		}
-	}
+	/* Get all data UPS is willing to offer */
+	has_ups_load = decode_meter_block(answer);
 
 	/* Calculate ups.load if UPS does not report it directly */
 	if(has_ups_load == FALSE) {
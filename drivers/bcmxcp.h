@@ -6,6 +6,7 @@
 #define _POWERWARE_H
 
 #include "timehead.h"
+#include "nut_stdint.h"
 
 /* Have to wait at least 0,25 sec max 16 sec */
 /* 1 second is too short for PW9120 (leads to communication errors). So we set it to 2 seconds */
@@ -584,6 +585,19 @@ typedef struct { /* Entry in BCM/XCP - UPS - NUT mapping table */
 
 extern BCMXCP_METER_MAP_ENTRY_t bcmxcp_meter_map[BCMXCP_METER_MAP_MAX];
 
+/* Decodes one 4 bytes meter entry of the given format into a NUT value */
+typedef void (*bcmxcp_meter_decoder_t)(const unsigned char *entry, const unsigned char format, char *value);
+
+typedef struct { /* Entry in the meter decode plan, built from the meter map */
+	const char *nut_entity;         /* The NUT variable name */
+	unsigned char format;           /* The format of the data - float, long etc */
+	unsigned int meter_block_index; /* The position of this meter in the UPS meter block */
+	bcmxcp_meter_decoder_t decode;  /* The decoder matching format */
+	int is_ups_load;                /* TRUE if nut_entity is "ups.load" */
+	uint32_t raw;                   /* Raw reading last published */
+	int published;                  /* TRUE once raw has been published */
+} BCMXCP_METER_PLAN_ENTRY_t;
+
 typedef struct { /* Entry in BCM/XCP - UPS mapping table */
 	int alarm_block_index;  /* Index of this alarm in alarm block. -1 = not existing */
 	const char *alarm_desc; /* Description of this alarm */
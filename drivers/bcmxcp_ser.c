@@ -5,7 +5,7 @@
 
 
 #define SUBDRIVER_NAME    "RS-232 communication subdriver"
-#define SUBDRIVER_VERSION "0.20"
+#define SUBDRIVER_VERSION "0.21"
 
 /* communication driver description structure */
 upsdrv_info_t comm_upsdrv_info = {
@@ -33,6 +33,8 @@ struct pw_baud_rate {
 
 unsigned char AUT[4] = {0xCF, 0x69, 0xE8, 0xD5}; /* Autorisation command */
 
+static ser_frame_t *sf = NULL; /* answers: PW_COMMAND_START_BYTE, block number, length, sequence, data, checksum */
+
 static void send_command(unsigned char *command, int command_length)
 {
 	int retry = 0, sent;
@@ -75,42 +77,34 @@ void send_write_command(unsigned char *command, int command_length)
 	send_command(command, command_length);
 }
 
+/* frames with a wrong checksum are skipped by the framed input */
+static int frame_checksum(const unsigned char *frame, size_t len)
+{
+	return !checksum_test(frame);
+}
+
 /* get the answer of a command from the ups. And check that the answer is for this command */
 int get_answer(unsigned char *data, unsigned char command)
 {
-	unsigned char	my_buf[128]; /* packet has a maximum length of 121+5 bytes */
-	int		length, end_length = 0, res, endblock = 0, start = 0;
+	unsigned char	*frame; /* packet has a maximum length of 121+5 bytes, in the receive buffer */
+	int		length, end_length = 0, res, endblock = 0;
 	unsigned char	block_number, sequence, pre_sequence = 0;
 
 	while (endblock != 1){
 
-		do {
-			/* Read PW_COMMAND_START_BYTE byte */
-			res = ser_get_char(upsfd, my_buf, 1, 0);
-
-			if (res != 1) {
-				upsdebugx(1,"Receive error (PW_COMMAND_START_BYTE): %d, cmd=%x!!!\n", res, command);
-				return -1;
-			}
-
-			start++;
+		res = ser_frame_get(sf, &frame, 1, 0);
 
-		} while ((my_buf[0] != PW_COMMAND_START_BYTE) && (start < 128));
-		
-		if (start == 128) {
-			ser_comm_fail("Receive error (PW_COMMAND_START_BYTE): packet not on start!!%x\n", my_buf[0]);
-			return -1;
+		/* a long packet may take more than a second at low speeds */
+		if ((res == 0) && (sf->tail > sf->head)) {
+			res = ser_frame_get(sf, &frame, 1, 0);
 		}
 
-		/* Read block number byte */
-		res = ser_get_char(upsfd, my_buf+1, 1, 0);
-
-		if (res != 1) {
-			ser_comm_fail("Receive error (Block number): %d!!!\n", res);
+		if (res <= 0) {
+			upsdebugx(1,"Receive error (packet): %d, cmd=%x!!!\n", res, command);
 			return -1;
 		}
 
-		block_number = (unsigned char)my_buf[1];
+		block_number = (unsigned char)frame[1];
 
 		if (command <= 0x43) {
 			if ((command - 0x30) != block_number){
@@ -131,30 +125,14 @@ int get_answer(unsigned char *data, unsigned char command)
 			}
 		}
 
-		/* Read data length byte */
-		res = ser_get_char(upsfd, my_buf+2, 1, 0);
-
-		if (res != 1) {
-			ser_comm_fail("Receive error (length): %d!!!\n", res);
-			return -1;
-		}
-
-		length = (unsigned char)my_buf[2];
+		length = (unsigned char)frame[2];
 
 		if (length < 1) {
 			ser_comm_fail("Receive error (length): packet length %x!!!\n", length);
 			return -1;
 		}
 
-		/* Read sequence byte */
-		res = ser_get_char(upsfd, my_buf+3, 1, 0);
-
-		if (res != 1) {
-			ser_comm_fail("Receive error (sequence): %d!!!\n", res);
-			return -1;
-		}
-
-		sequence = (unsigned char)my_buf[3];
+		sequence = (unsigned char)frame[3];
 
 		if ((sequence & 0x80) == 0x80) {
 			endblock = 1;
@@ -167,29 +145,12 @@ int get_answer(unsigned char *data, unsigned char command)
 
 		pre_sequence = sequence;
 
-		/* Try to read all the remainig bytes */
-		res = ser_get_buf_len(upsfd, my_buf+4, length, 1, 0);
-
-		if (res != length) {
-			ser_comm_fail("Receive error (data): got %d bytes instead of %d!!!\n", res, length);
-			return -1;
-		}
-
-		/* Get the checksum byte */
-		res = ser_get_char(upsfd, my_buf+(4+length), 1, 0);
-
-		if (res != 1) {
-			ser_comm_fail("Receive error (checksum): %x!!!\n", res);
+		if (end_length + length > PW_ANSWER_MAX_SIZE) {
+			ser_comm_fail("Receive error (data): answer longer than %d bytes!!!\n", PW_ANSWER_MAX_SIZE);
 			return -1;
 		}
 
-		/* now we have the whole answer from the ups, we can checksum it */
-		if (!checksum_test(my_buf)) {
-			ser_comm_fail("checksum error! ");
-			return -1;
-		}
-
-		memcpy(data+end_length, my_buf+4, length);
+		memcpy(data+end_length, frame+4, length);
 		end_length += length;
 
 	}
@@ -208,6 +169,7 @@ static int command_sequence(unsigned char *command, int command_length, unsigned
 
 		if (retry == PW_MAX_TRY) {
 			ser_flush_in(upsfd, "", 0);
+			ser_frame_flush(sf);
 		}
 
 		send_write_command(command, command_length);
@@ -325,12 +287,18 @@ void pw_comm_setup(const char *port)
 void upsdrv_initups(void)
 {
 	upsfd = ser_open(device_path);
+
+	/* length at byte 2, not counting the 4 header bytes and the checksum */
+	sf = ser_frame_init(upsfd, LARGEBUF);
+	ser_frame_set_length(sf, PW_COMMAND_START_BYTE, 2, 5, frame_checksum);
+
 	pw_comm_setup(device_path);
 }
 
 void upsdrv_cleanup(void)
 {
 	/* free(dynamic_mem); */
+	ser_frame_free(sf);
 	ser_close(upsfd, device_path);
 }
 
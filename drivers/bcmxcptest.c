@@ -0,0 +1,314 @@
+/* bcmxcptest - check the bcmxcp meter decode plan against the former decoder
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/* the meter maps, the decode plan and the decoders are static */
+#include "bcmxcp.c"
+
+/* what bcmxcp.c takes from main.c and bcmxcp_ser.c: there is no UPS */
+int	do_synchronous = 0;
+
+upsdrv_info_t	comm_upsdrv_info = {
+	"bcmxcptest",
+	DRIVER_VERSION,
+	NULL,
+	DRV_STABLE,
+	{ NULL }
+};
+
+char *getval(const char *var)
+{
+	return NULL;
+}
+
+void addvar(int vartype, const char *name, const char *desc)
+{
+}
+
+void send_write_command(unsigned char *command, int command_length)
+{
+}
+
+int command_read_sequence(unsigned char command, unsigned char *data)
+{
+	memset(data, 0, PW_ANSWER_MAX_SIZE);
+
+	return -1;
+}
+
+int command_write_sequence(unsigned char *command, int command_length, unsigned char *answer)
+{
+	memset(answer, 0, PW_ANSWER_MAX_SIZE);
+
+	return -1;
+}
+
+void upsdrv_comm_good(void)
+{
+}
+
+/* number of meter blocks decoded with each map */
+#define NUM_BLOCKS	64
+
+/* BCM/XCP meter formats: long, fixed point, floating point (packed BCD
+ * width and precision), date, time, seconds, and unknown ones; 0 means
+ * that the UPS does not offer the meter */
+static const unsigned char formats[] = {
+	0xf0, 0x41, 0x00, 0xf4, 0x52, 0xe2, 0x00, 0x30, 0xfa, 0x97,
+	0x00, 0xe0, 0x61, 0xe1, 0x00, 0x98, 0x10, 0xff, 0x00, 0xe3
+};
+
+/* the meter decoder as it was before the decode plan, verbatim */
+static void decode_meter_map_entry_old(const unsigned char *entry, const unsigned char format, char* value)
+{
+	long lValue = 0;
+	char sFormat[32];
+	float fValue;
+	unsigned char dd, mm, yy, cc, hh, ss;
+
+	/* Paranoid input sanity checks */
+	if (value == NULL)
+		return;
+	*value = '\0';
+	if (entry == (unsigned char *)NULL || format == 0x00)
+		return;
+
+	/* Get data based on format */
+	if (format == 0xf0) {
+		/* Long integer */
+		lValue = get_long(entry);
+		snprintf(value, 127, "%d", (int)lValue);
+	}
+	else if ((format & 0xf0) == 0xf0) {
+		/* Fixed point integer */
+		fValue = get_long(entry) / ldexp(1, format & 0x0f);
+		snprintf(value, 127, "%.2f", fValue);
+	}
+	else if (format <= 0x97) {
+		/* Floating point */
+		fValue = get_float(entry);
+		/* Format is packed BCD */
+		snprintf(sFormat, 31, "%%%d.%df", ((format & 0xf0) >> 4), (format & 0x0f));
+		snprintf(value, 127, sFormat, fValue);
+	}
+	else if (format == 0xe2) {
+		/* Seconds */
+		lValue = get_long(entry);
+		snprintf(value, 127, "%d", (int)lValue);
+	}
+	else if (format == 0xe0) {
+		/* Date */
+		/* Format is packed BCD for each byte, and cc uses most signifcant bit to signal date format */
+		dd = entry[0];
+		mm = entry[1];
+		yy = entry[2];
+		cc = entry[3];
+
+		/* Check format type */
+		if (cc & 0x80) {
+			/* Month:Day format */
+			snprintf(value, 127, "%d%d/%d%d/%d%d%d%d", ((dd & 0xf0) >> 4), (dd & 0x0f), ((mm & 0xf0) >> 4), (mm & 0x0f), (((cc & 0x7f) & 0xf0) >> 4), ((cc & 0x7f) & 0x0f), ((yy & 0xf0) >> 4), (yy & 0x0f));
+		}
+		else {
+			/* Julian format */
+			/* TODO test this, unsure if the day part is correct, i.e. how we use the two bytes mm and dd to calculate the number of julian days */
+			snprintf(value, 127, "%d%d%d%d:%d%d%d", (((cc & 0x7f) & 0xf0) >> 4), ((cc & 0x7f) & 0x0f), ((yy & 0xf0) >> 4), (yy & 0x0f), (mm & 0x0f), ((dd & 0xf0) >> 4), (dd & 0x0f));
+		}
+	}
+	else if (format == 0xe1) {
+		/* Time */
+		/* Format is packed BCD for each byte */
+		cc = entry[0];
+		ss = entry[1];
+		mm = entry[2];
+		hh = entry[3];
+
+		snprintf(value, 127, "%d%d:%d%d:%d%d.%d%d", ((hh & 0xf0) >> 4), (hh & 0x0f), ((mm & 0xf0) >> 4), (mm & 0x0f), ((ss & 0xf0) >> 4), (ss & 0x0f), ((cc & 0xf0) >> 4), (cc & 0x0f));
+	}
+	else {
+		/* Unknown format */
+		snprintf(value, 127, "???");
+		return;
+	}
+	return;
+}
+
+/* the same pseudo-random sequence on every run */
+static unsigned long	seed = 1;
+
+static unsigned char random_byte(void)
+{
+	seed = seed * 1103515245 + 12345;
+
+	return (seed >> 16) & 0xff;
+}
+
+/* a meter map offering every meter known to NUT (as many as fit in a meter
+ * block), in floating point but for the date, time and runtime ones */
+static int nut_meter_map(unsigned char *map)
+{
+	const char	*var;
+	int	i, meters = 0;
+
+	memset(map, 0, BCMXCP_METER_MAP_MAX);
+
+	for (i = 0; (i < BCMXCP_METER_MAP_MAX) && (meters < PW_ANSWER_MAX_SIZE / 4); i++) {
+
+		var = bcmxcp_meter_map[i].nut_entity;
+
+		if (!var) {
+			continue;
+		}
+
+		if (strstr(var, "runtime")) {
+			map[i] = 0xe2;
+		} else if (strstr(var, "date")) {
+			map[i] = 0xe0;
+		} else if (strstr(var, "time")) {
+			map[i] = 0xe1;
+		} else {
+			map[i] = 0x41;
+		}
+
+		meters++;
+	}
+
+	return meters;
+}
+
+/* a meter map cycling through the formats, from the given one */
+static int formats_meter_map(unsigned char *map, int first)
+{
+	int	i, meters = 0;
+
+	for (i = 0; i < BCMXCP_METER_MAP_MAX; i++) {
+
+		map[i] = formats[(first + i) % sizeof(formats)];
+
+		/* the meter block can't hold more */
+		if (meters == PW_ANSWER_MAX_SIZE / 4) {
+			map[i] = 0;
+		}
+
+		if (map[i]) {
+			meters++;
+		}
+	}
+
+	return meters;
+}
+
+/* check what the decode plan published from the meter block against what
+ * the former decoder gives for every meter of the map, the last one
+ * winning when several meters have the same NUT variable */
+static void check_meter_block(const unsigned char *block, int mapnum, int blocknum)
+{
+	char	expected[BCMXCP_METER_MAP_MAX][128];
+	const char	*var, *value;
+	bool_t	has_ups_load = FALSE;
+	int	i, j;
+
+	for (i = 0; i < BCMXCP_METER_MAP_MAX; i++) {
+
+		var = bcmxcp_meter_map[i].nut_entity;
+
+		if ((bcmxcp_meter_map[i].format == 0) || (var == NULL)) {
+			continue;
+		}
+
+		decode_meter_map_entry_old(block + bcmxcp_meter_map[i].meter_block_index,
+			bcmxcp_meter_map[i].format, expected[i]);
+
+		if (!strcasecmp(var, "ups.load")) {
+			has_ups_load = TRUE;
+		}
+	}
+
+	if (decode_meter_block(block) != has_ups_load) {
+		fatalx(EXIT_FAILURE, "map %d, block %d: ups.load %sfound", mapnum, blocknum,
+			has_ups_load ? "not " : "");
+	}
+
+	for (i = 0; i < BCMXCP_METER_MAP_MAX; i++) {
+
+		var = bcmxcp_meter_map[i].nut_entity;
+
+		if ((bcmxcp_meter_map[i].format == 0) || (var == NULL)) {
+			continue;
+		}
+
+		/* overridden by a later meter */
+		for (j = i + 1; j < BCMXCP_METER_MAP_MAX; j++) {
+			if (bcmxcp_meter_map[j].format && bcmxcp_meter_map[j].nut_entity
+				&& !strcasecmp(bcmxcp_meter_map[j].nut_entity, var)) {
+				break;
+			}
+		}
+
+		if (j < BCMXCP_METER_MAP_MAX) {
+			continue;
+		}
+
+		value = dstate_getinfo(var);
+
+		if (!value || strcmp(value, expected[i])) {
+			fatalx(EXIT_FAILURE, "map %d, block %d: %s (meter %d, format %02x) is '%s', expected '%s'",
+				mapnum, blocknum, var, i, bcmxcp_meter_map[i].format,
+				value ? value : "(none)", expected[i]);
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	unsigned char	map[BCMXCP_METER_MAP_MAX], block[PW_ANSWER_MAX_SIZE];
+	int	mapnum, blocknum, meters, i;
+
+	for (mapnum = 0; mapnum <= (int)sizeof(formats); mapnum++) {
+
+		init_meter_map();
+
+		if (mapnum == 0) {
+			meters = nut_meter_map(map);
+		} else {
+			meters = formats_meter_map(map, mapnum - 1);
+		}
+
+		init_ups_meter_map(map, BCMXCP_METER_MAP_MAX);
+
+		for (i = 0; i < (int)sizeof(block); i++) {
+			block[i] = random_byte();
+		}
+
+		/* then change a few meters from one block to the next, as a
+		 * UPS does, so that the unchanged ones are skipped */
+		for (blocknum = 0; blocknum < NUM_BLOCKS; blocknum++) {
+
+			if (blocknum > 0) {
+				for (i = 0; i < meters / 8 + 1; i++) {
+					block[4 * (random_byte() % meters) + random_byte() % 4] = random_byte();
+				}
+			}
+
+			check_meter_block(block, mapnum, blocknum);
+		}
+
+		printf("map %d: %d meters, %d in the decode plan, %d blocks: OK\n",
+			mapnum, meters, meter_plan_len, NUM_BLOCKS);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -26,7 +26,7 @@
 #include "blazer.h"
 
 #define DRIVER_NAME	"Megatec/Q1 protocol serial driver"
-#define DRIVER_VERSION	"1.57"
+#define DRIVER_VERSION	"1.58"
 
 /* driver description structure */
 upsdrv_info_t upsdrv_info = {
@@ -39,6 +39,10 @@ upsdrv_info_t upsdrv_info = {
 
 #define SER_WAIT_SEC	1 /* 3 seconds for Best UPS */
 
+#ifndef TESTING
+static ser_frame_t	*sf = NULL;	/* replies, up to the '\r' */
+#endif
+
 /*
  * Generic command processing function. Send a command and read a reply.
  * Returns < 0 on error, 0 on timeout and the number of bytes read on
@@ -47,9 +51,11 @@ upsdrv_info_t upsdrv_info = {
 int blazer_command(const char *cmd, char *buf, size_t buflen)
 {
 #ifndef TESTING
-	int	ret;
+	int		ret;
+	unsigned char	*reply;
 
 	ser_flush_io(upsfd);
+	ser_frame_flush(sf);
 
 	ret = ser_send(upsfd, "%s", cmd);
 
@@ -60,15 +66,19 @@ int blazer_command(const char *cmd, char *buf, size_t buflen)
 
 	upsdebugx(3, "send: '%.*s'", (int)strcspn(cmd, "\r"), cmd);
 
-	ret = ser_get_buf(upsfd, buf, buflen, SER_WAIT_SEC, 0);
+	ret = ser_frame_get(sf, &reply, SER_WAIT_SEC, 0);
 
 	if (ret <= 0) {
 		upsdebugx(3, "read: %s", ret ? strerror(errno) : "timeout");
 		return ret;
 	}
 
-	upsdebugx(3, "read: '%.*s'", (int)strcspn(buf, "\r"), buf);
-	return ret;
+	upsdebugx(3, "read: '%s'", reply);
+
+	/* blazer.c expects the reply with its '\r', as it came */
+	ret = snprintf(buf, buflen, "%s\r", reply);
+
+	return ((size_t)ret < buflen) ? ret : (int)buflen - 1;
 #else
 	const struct {
 		const char	*cmd;
@@ -177,6 +187,12 @@ void upsdrv_initups(void)
 	ser_set_dtr(upsfd, cablepower[i].dtr);
 	ser_set_rts(upsfd, cablepower[i].rts);
 
+	/*
+	 * Replies end with a '\r', sometimes followed by a '\n'
+	 */
+	sf = ser_frame_init(upsfd, SMALLBUF);
+	ser_frame_set_term(sf, '\r', "\n");
+
 	/*
 	 * Allow some time to settle for the cablepower
 	 */
@@ -196,6 +212,7 @@ void upsdrv_cleanup(void)
 {
 #ifndef TESTING
 	ser_set_dtr(upsfd, 0);
+	ser_frame_free(sf);
 	ser_close(upsfd, device_path);
 #endif
 }
@@ -35,12 +35,13 @@
 #include <string.h>
 
 #include "main.h"
+#include "nut_stdint.h"
 #include "parseconf.h"
 #include "upsclient.h"
 #include "dummy-ups.h"
 
 #define DRIVER_NAME	"Device simulation and repeater driver"
-#define DRIVER_VERSION	"0.14"
+#define DRIVER_VERSION	"0.16"
 
 /* driver description structure */
 upsdrv_info_t upsdrv_info =
@@ -73,17 +74,76 @@ static int is_valid_data(const char* varname);
 static int is_valid_value(const char* varname, const char *value);
 /* libupsclient update */
 static int upsclient_update_vars(void);
+/* pre-parsed replay of the definition file */
+static int replay_load(void);
+static void replay_free(void);
+static int replay_run(const struct timeval *now);
+static void replay_updateinfo(void);
+
+typedef struct {
+	char	*var;		/* variable name, NULL for a TIMER */
+	char	*value;		/* joined value, empty to remove var */
+	char	**status;	/* split ups.status flags */
+	int		nstatus;
+	double	delay;		/* TIMER: scaled delay, in seconds */
+	dummy_info_t	*item;	/* nut_data entry of var, if any */
+} replay_step_t;
+
+static struct {
+	replay_step_t	*steps;
+	size_t	count, alloc;
+	size_t	pos;			/* next step to apply */
+	int		timed;			/* at least one TIMER in the timeline */
+	double	speed;			/* TIMER speed factor */
+	struct timeval	due;	/* time at which steps[pos] is due */
+	unsigned long	applied, loops;
+} replay;
+
+/* simulated dynamics, for a fleet of devices */
+static void sim_init(void);
+static void sim_update(void);
+
+#define SIM_RECHARGE_TIME	3600	/* seconds for a full recharge */
+
+static struct {
+	int		enabled;
+	uint32_t	seed, state;	/* per device random sequence */
+	double	load, load_mean, load_step;	/* in % */
+	double	runtime;		/* battery runtime at full load */
+	double	charge;			/* battery charge, in % */
+	double	voltage;		/* nominal input/output voltage */
+	uint32_t	group;		/* outage group */
+	long	outage_period, outage_length;
+	int		outlets;
+	time_t	last;
+} sim;
+
+static int upsclient_update_status(void);
+static void upsclient_update(void);
 
 /* connection information */
 static char		*client_upsname = NULL, *hostname = NULL;
 static UPSCONN_t	*ups = NULL;
 static int	port;
 
+/* repeater pacing: the full variables list is only fetched again after
+ * "interval" seconds, doubling while nothing changes (up to maxinterval),
+ * with a cheap ups.status check on the other updates */
+static struct {
+	int		connected;
+	time_t	next_list, next_connect;
+	int		interval, maxinterval;
+	int		backoff;		/* reconnection delay */
+	char	**vars;			/* variables got from the last list */
+	size_t	numvars;
+} repeater = { 1, 0, 0, 0, 60, 0, NULL, 0 };
+
 /* Driver functions */
 
 void upsdrv_initinfo(void)
 {
 	dummy_info_t *item;
+	struct timeval now;
 
 	switch (mode)
 	{
@@ -103,9 +163,25 @@ void upsdrv_initinfo(void)
 			}
 
 			/* Now get user's defined variables */
-			if (parse_data_file(upsfd) < 0)
+			if (testvar("replay"))
+			{
+				if (replay_load() < 0)
+					upslogx(LOG_NOTICE, "Unable to parse the definition file %s", device_path);
+
+				/* apply everything up to the first TIMER */
+				gettimeofday(&now, NULL);
+				replay.due = now;
+				replay_run(&now);
+			}
+			else if (parse_data_file(upsfd) < 0)
 				upslogx(LOG_NOTICE, "Unable to parse the definition file %s", device_path);
 
+			if (sim.enabled)
+			{
+				sim_init();
+				sim_update();
+			}
+
 			/* Initialize handler */
 			upsh.setvar = setvar;
 
@@ -153,6 +229,19 @@ void upsdrv_updateinfo(void)
 {
 	upsdebugx(1, "upsdrv_updateinfo...");
 
+	if (mode == MODE_DUMMY && sim.enabled)
+	{
+		/* the definition file was only a template */
+		sim_update();
+		return;
+	}
+
+	if (mode == MODE_DUMMY && testvar("replay"))
+	{
+		replay_updateinfo();
+		return;
+	}
+
 	sleep(1);
 
 	switch (mode)
@@ -164,23 +253,7 @@ void upsdrv_updateinfo(void)
 			break;
 		case MODE_META:
 		case MODE_REPEATER:
-			if (upsclient_update_vars() > 0)
-			{
-				dstate_dataok();
-			}
-			else
-			{
-				/* try to reconnect */
-				upscli_disconnect(ups);
-				if (upscli_connect(ups, hostname, port, UPSCLI_CONN_TRYSSL) < 0)
-				{
-					upsdebugx(1, "Error reconnecting: %s", upscli_strerror(ups));
-				}
-				else
-				{
-					upsdebugx(1, "Reconnected");
-				}
-			}
+			upsclient_update();
 			break;
 		case MODE_NONE:
 		default:
@@ -216,6 +289,19 @@ void upsdrv_help(void)
 
 void upsdrv_makevartable(void)
 {
+	addvar(VAR_VALUE, "maxinterval", "Repeater: max delay between full variable updates, in seconds (default: 60)");
+	addvar(VAR_FLAG, "replay", "Load the definition file once and replay it as a timeline");
+	addvar(VAR_VALUE, "speed", "Replay speed factor applied to TIMER delays (default: 1)");
+
+	addvar(VAR_FLAG, "sim", "Use the definition file as a template, and simulate the dynamic data");
+	addvar(VAR_VALUE, "sim_seed", "Seed of the simulated data (default: derived from the UPS name)");
+	addvar(VAR_VALUE, "sim_load", "Simulated mean load, in % (default: 40)");
+	addvar(VAR_VALUE, "sim_load_step", "Simulated load random walk step, in % (default: 2)");
+	addvar(VAR_VALUE, "sim_runtime", "Simulated battery runtime at full load, in seconds (default: 600)");
+	addvar(VAR_VALUE, "sim_group", "Simulated outage group (default: 0)");
+	addvar(VAR_VALUE, "sim_outage_period", "One outage per group every this many seconds, 0 for none (default: 3600)");
+	addvar(VAR_VALUE, "sim_outage_length", "Simulated outages length, in seconds (default: 300)");
+	addvar(VAR_VALUE, "sim_outlets", "Number of simulated outlets (default: 0)");
 }
 
 void upsdrv_initups(void)
@@ -226,6 +312,9 @@ void upsdrv_initups(void)
 		upsdebugx(1, "Repeater mode");
 		mode = MODE_REPEATER;
 		dstate_setinfo("driver.parameter.mode", "repeater");
+
+		if (getval("maxinterval"))
+			repeater.maxinterval = atoi(getval("maxinterval"));
 		/* FIXME: if there is at least one more => MODE_META... */
 	}
 	else
@@ -233,11 +322,29 @@ void upsdrv_initups(void)
 		upsdebugx(1, "Dummy (simulation) mode");
 		mode = MODE_DUMMY;
 		dstate_setinfo("driver.parameter.mode", "dummy");
+
+		sim.enabled = testvar("sim");
+
+		/* both would drive the same data */
+		if (sim.enabled && testvar("replay"))
+			fatalx(EXIT_FAILURE, "The 'sim' and 'replay' flags can't be used together");
+
+		replay.speed = 1.0;
+		if (getval("speed"))
+		{
+			replay.speed = atof(getval("speed"));
+			if (replay.speed <= 0)
+				fatalx(EXIT_FAILURE, "Invalid speed factor: %s", getval("speed"));
+		}
 	}
 }
 
 void upsdrv_cleanup(void)
 {
+	size_t	i;
+
+	replay_free();
+
 	if ( (mode == MODE_META) || (mode == MODE_REPEATER) )
 	{
 		if (ups)
@@ -254,6 +361,10 @@ void upsdrv_cleanup(void)
 		free(client_upsname);
 		free(hostname);
 		free(ups);
+
+		for (i = 0; i < repeater.numvars; i++)
+			free(repeater.vars[i]);
+		free(repeater.vars);
 	}
 }
 
@@ -323,12 +434,17 @@ static int setvar(const char *varname, const char *val)
 /*               Support functions               */
 /*************************************************/
 
+/* get the full variables list of the remote UPS, and apply it: return
+ * the number of variables added, changed or removed, or -1 on error */
 static int upsclient_update_vars(void)
 {
-	int		ret;
+	int		ret, changes = 0;
 	unsigned int	numq, numa;
 	const char	*query[4];
 	char		**answer;
+	const char	*val;
+	char		**vars = NULL;
+	size_t		numvars = 0, i, j;
 
 	query[0] = "VAR";
 	query[1] = client_upsname;
@@ -342,22 +458,175 @@ static int upsclient_update_vars(void)
 		return ret;
 	}
 
-	while (upscli_list_next(ups, numq, query, &numa, &answer) == 1)
+	while ((ret = upscli_list_next(ups, numq, query, &numa, &answer)) == 1)
 	{
 		/* VAR <upsname> <varname> <val> */
 		if (numa < 4)
 		{
 			upsdebugx(1, "Error: insufficient data (got %d args, need at least 4)", numa);
+			continue;
 		}
 
 		upsdebugx(5, "Received: %s %s %s %s",
 				answer[0], answer[1], answer[2], answer[3]);
 
 		/* do not override the driver collection */
-		if (strncmp(answer[2], "driver.", 7))
-			setvar(answer[2], answer[3]);
+		if (!strncmp(answer[2], "driver.", 7))
+			continue;
+
+		vars = xrealloc(vars, (numvars + 1) * sizeof(*vars));
+		vars[numvars++] = xstrdup(answer[2]);
+
+		/* only apply what changed */
+		val = dstate_getinfo(answer[2]);
+		if (val && !strcmp(val, answer[3]))
+			continue;
+
+		setvar(answer[2], answer[3]);
+		changes++;
 	}
-	return 1;
+
+	/* cut short: what didn't come yet is not gone */
+	if (ret < 0)
+	{
+		upsdebugx(1, "Error: %s (%i)", upscli_strerror(ups), upscli_upserror(ups));
+
+		for (i = 0; i < numvars; i++)
+			free(vars[i]);
+
+		free(vars);
+		return ret;
+	}
+
+	/* remove what is gone from the remote UPS */
+	for (i = 0; i < repeater.numvars; i++)
+	{
+		for (j = 0; j < numvars; j++)
+		{
+			if (!strcmp(repeater.vars[i], vars[j]))
+				break;
+		}
+
+		if (j == numvars)
+		{
+			upsdebugx(2, "%s is gone, removing it", repeater.vars[i]);
+			dstate_delinfo(repeater.vars[i]);
+			changes++;
+		}
+
+		free(repeater.vars[i]);
+	}
+
+	free(repeater.vars);
+	repeater.vars = vars;
+	repeater.numvars = numvars;
+
+	upsdebugx(3, "%d changes out of %u variables", changes, (unsigned int)numvars);
+
+	return changes;
+}
+
+/* get ups.status only: return 1 if it changed, 0 if not, -1 on error */
+static int upsclient_update_status(void)
+{
+	unsigned int	numq, numa;
+	const char	*query[4];
+	char		**answer;
+	const char	*val;
+
+	query[0] = "VAR";
+	query[1] = client_upsname;
+	query[2] = "ups.status";
+	numq = 3;
+
+	if (upscli_get(ups, numq, query, &numa, &answer) < 0)
+	{
+		upsdebugx(1, "Error: %s (%i)", upscli_strerror(ups), upscli_upserror(ups));
+		return -1;
+	}
+
+	if (numa < 4)
+	{
+		upsdebugx(1, "Error: insufficient data (got %d args, need at least 4)", numa);
+		return -1;
+	}
+
+	val = dstate_getinfo("ups.status");
+
+	return (val && !strcmp(val, answer[3])) ? 0 : 1;
+}
+
+/* repeater mode update: full list when due or when ups.status changed,
+ * with reconnection (and backoff) on errors */
+static void upsclient_update(void)
+{
+	int		ret;
+	time_t	now;
+
+	time(&now);
+
+	if (!repeater.connected)
+	{
+		if (now < repeater.next_connect)
+			return;
+
+		if (upscli_connect(ups, hostname, port, UPSCLI_CONN_TRYSSL) < 0)
+		{
+			upsdebugx(1, "Error reconnecting: %s", upscli_strerror(ups));
+
+			repeater.backoff = repeater.backoff ? repeater.backoff * 2 : 1;
+			if (repeater.backoff > 60)
+				repeater.backoff = 60;
+			repeater.next_connect = now + repeater.backoff;
+			return;
+		}
+
+		upsdebugx(1, "Reconnected");
+		repeater.connected = 1;
+		repeater.backoff = 0;
+		/* what we have may be outdated */
+		repeater.next_list = 0;
+	}
+
+	ret = 0;
+	if (now < repeater.next_list)
+	{
+		ret = upsclient_update_status();
+		if (ret > 0)
+			upsdebugx(2, "ups.status changed, getting all variables");
+	}
+
+	if (ret >= 0 && (ret > 0 || now >= repeater.next_list))
+	{
+		ret = upsclient_update_vars();
+
+		if (ret > 0)
+		{
+			repeater.interval = 0;
+		}
+		else if (ret == 0)
+		{
+			/* nothing changed, so back off */
+			repeater.interval = repeater.interval ? repeater.interval * 2 : (int)poll_interval;
+			if (repeater.interval > repeater.maxinterval)
+				repeater.interval = repeater.maxinterval;
+		}
+
+		repeater.next_list = now + repeater.interval;
+		upsdebugx(3, "next full update in %d seconds", repeater.interval);
+	}
+
+	if (ret >= 0)
+	{
+		dstate_dataok();
+		return;
+	}
+
+	/* try to reconnect on the next update */
+	upscli_disconnect(ups);
+	repeater.connected = 0;
+	repeater.next_connect = now;
+	dstate_datastale();
 }
 
 /* find info element definition in info array */
@@ -547,3 +816,433 @@ static int parse_data_file(int upsfd)
 	}
 	return 1;
 }
+
+/* for dummy mode, with the "replay" flag
+ * the definition file is parsed only once, into a timeline of steps
+ * that is then replayed (and looped) at "speed" times the TIMER pace
+ */
+static int replay_load(void)
+{
+	char	fn[SMALLBUF];
+	char	*ptr, var_value[MAX_STRING_SIZE];
+	int		counter;
+	PCONF_CTX_t	rctx;
+	replay_step_t	*step;
+
+	if (device_path[0] == '/')
+		snprintf(fn, sizeof(fn), "%s", device_path);
+	else
+		snprintf(fn, sizeof(fn), "%s/%s", confpath(), device_path);
+
+	pconf_init(&rctx, upsconf_err);
+
+	if (!pconf_file_begin(&rctx, fn))
+		fatalx(EXIT_FAILURE, "Can't open dummy-ups definition file %s: %s",
+			fn, rctx.errmsg);
+
+	while (pconf_file_next(&rctx))
+	{
+		if (pconf_parse_error(&rctx))
+		{
+			upsdebugx(2, "Parse error: %s:%d: %s",
+				fn, rctx.linenum, rctx.errmsg);
+			continue;
+		}
+
+		if (rctx.numargs < 1)
+			continue;
+
+		if (replay.count == replay.alloc)
+		{
+			replay.alloc = replay.alloc ? replay.alloc * 2 : 64;
+			replay.steps = xrealloc(replay.steps, replay.alloc * sizeof(*replay.steps));
+		}
+
+		step = &replay.steps[replay.count];
+		memset(step, 0, sizeof(*step));
+
+		/* TIMER <seconds> (fractions allowed) delays the next steps */
+		if (!strncmp(rctx.arglist[0], "TIMER", 5))
+		{
+			if (rctx.numargs > 1)
+				step->delay = atof(rctx.arglist[1]) / replay.speed;
+
+			if (step->delay < 0)
+			{
+				upslogx(LOG_WARNING, "%s:%d: ignoring negative TIMER %s",
+					fn, rctx.linenum, rctx.arglist[1]);
+				continue;
+			}
+
+			/* time must go on, even for 0 or a high speed */
+			if (step->delay < 0.000001)
+				step->delay = 0.000001;
+
+			replay.timed = 1;
+			replay.count++;
+			continue;
+		}
+
+		/* Remove ":" suffix, after the variable name */
+		if ((ptr = strchr(rctx.arglist[0], ':')) != NULL)
+			*ptr = '\0';
+
+		/* Skip the driver.* collection data */
+		if (!strncmp(rctx.arglist[0], "driver.", 7))
+		{
+			upsdebugx(2, "replay_load: skipping %s", rctx.arglist[0]);
+			continue;
+		}
+
+		step->var = xstrdup(rctx.arglist[0]);
+
+		if (!strncmp(step->var, "ups.status", 10))
+		{
+			/* keep the status flags split, ready for status_set() */
+			step->nstatus = rctx.numargs - 1;
+			step->status = xcalloc(step->nstatus + 1, sizeof(*step->status));
+			for (counter = 1 ; counter < (int)rctx.numargs ; counter++)
+				step->status[counter - 1] = xstrdup(rctx.arglist[counter]);
+		}
+		else
+		{
+			var_value[0] = '\0';
+			for (counter = 1 ; counter < (int)rctx.numargs ; counter++)
+			{
+				if (counter == 1) /* don't append the first space separator */
+					snprintf(var_value, sizeof(var_value), "%s", rctx.arglist[counter]);
+				else
+					snprintfcat(var_value, sizeof(var_value), " %s", rctx.arglist[counter]);
+			}
+			step->value = xstrdup(var_value);
+			step->item = find_info(step->var);
+		}
+
+		replay.count++;
+	}
+
+	pconf_finish(&rctx);
+
+	upsdebugx(1, "replay_load: %u steps loaded from %s", (unsigned int)replay.count, fn);
+
+	return replay.count ? 1 : -1;
+}
+
+static void replay_free(void)
+{
+	size_t	i;
+	int		j;
+
+	for (i = 0; i < replay.count; i++)
+	{
+		free(replay.steps[i].var);
+		free(replay.steps[i].value);
+		for (j = 0; j < replay.steps[i].nstatus; j++)
+			free(replay.steps[i].status[j]);
+		free(replay.steps[i].status);
+	}
+
+	free(replay.steps);
+	memset(&replay, 0, sizeof(replay));
+}
+
+/* same as setvar(), with the variable lookup already done */
+static void replay_apply(const replay_step_t *step)
+{
+	int	i;
+
+	if (step->status)
+	{
+		status_init();
+		for (i = 0; i < step->nstatus; i++)
+			status_set(step->status[i]);
+		status_commit();
+		return;
+	}
+
+	if (step->value[0] == '\0')
+	{
+		dstate_delinfo(step->var);
+		return;
+	}
+
+	dstate_setinfo(step->var, "%s", step->value);
+
+	if (step->item)
+	{
+		dstate_setflags(step->item->info_type, step->item->info_flags);
+
+		/* Set max length for strings, if needed */
+		if (step->item->info_flags & ST_FLAG_STRING)
+			dstate_setaux(step->item->info_type, step->item->info_len);
+	}
+	else
+	{
+		dstate_setflags(step->var, ST_FLAG_STRING | ST_FLAG_RW);
+		dstate_setaux(step->var, 32);
+	}
+}
+
+static void tv_add(struct timeval *tv, double sec)
+{
+	long	usec = (long)(sec * 1000000.0);
+
+	tv->tv_sec += usec / 1000000;
+	tv->tv_usec += usec % 1000000;
+
+	if (tv->tv_usec >= 1000000)
+	{
+		tv->tv_sec++;
+		tv->tv_usec -= 1000000;
+	}
+}
+
+static int tv_before(const struct timeval *a, const struct timeval *b)
+{
+	if (a->tv_sec != b->tv_sec)
+		return a->tv_sec < b->tv_sec;
+
+	return a->tv_usec < b->tv_usec;
+}
+
+/* apply all the steps due by now: return 1 if the timeline is waiting for
+ * its next due time, 0 if it ran up to its end without any TIMER */
+static int replay_run(const struct timeval *now)
+{
+	replay_step_t	*step;
+	int		passes = 0;
+
+	while (!tv_before(now, &replay.due))
+	{
+		if (replay.pos == replay.count)
+		{
+			replay.pos = 0;
+			replay.loops++;
+
+			if (!replay.timed)
+			{
+				/* nothing to pace it, so wait for the next update */
+				return 0;
+			}
+
+			/* faster than we can go: take it up from now, after
+			 * serving upsd, rather than running to catch up */
+			if (++passes > 1)
+			{
+				replay.due = *now;
+				return 1;
+			}
+		}
+
+		step = &replay.steps[replay.pos++];
+
+		if (!step->var)
+		{
+			tv_add(&replay.due, step->delay);
+			continue;
+		}
+
+		replay_apply(step);
+		replay.applied++;
+	}
+
+	return 1;
+}
+
+/* replay the timeline for one poll_interval, serving upsd in between steps */
+static void replay_updateinfo(void)
+{
+	struct timeval	now, end;
+
+	gettimeofday(&now, NULL);
+	end = now;
+	end.tv_sec += poll_interval ? poll_interval : 1;
+
+	while (replay_run(&now) && tv_before(&replay.due, &end))
+	{
+		/* serve the clients until the next step is due */
+		while (!dstate_poll_fds(replay.due, -1))
+		{
+			/* repeat until time is up */
+		}
+
+		gettimeofday(&now, NULL);
+	}
+
+	upsdebugx(2, "replay: %lu steps applied, %lu loops", replay.applied, replay.loops);
+
+	dstate_dataok();
+}
+
+/* for dummy mode, with the "sim" flag
+ * the definition file is only a template, and the dynamic data are
+ * simulated: load random walk, battery discharge on outages shared by
+ * all the devices of the same group, and outlets
+ */
+
+/* xorshift32, so that each device has its own reproducible sequence */
+static uint32_t sim_rand(uint32_t *state)
+{
+	uint32_t	x = *state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+
+	return *state = x;
+}
+
+/* stateless mix, for the outage schedule of a group */
+static uint32_t sim_hash(uint32_t a, uint32_t b)
+{
+	uint32_t	x = a * 0x9e3779b1U ^ b;
+
+	x ^= x >> 16;
+	x *= 0x85ebca6bU;
+	x ^= x >> 13;
+	x *= 0xc2b2ae35U;
+	x ^= x >> 16;
+
+	return x;
+}
+
+/* each group gets one outage per period, at a time derived from the
+ * group and the period number only, so that all the devices of a group
+ * (ie all the driver processes) agree on it without talking together */
+static int sim_outage(time_t now)
+{
+	long	slot, start, range;
+
+	if (sim.outage_period <= 0 || sim.outage_length <= 0)
+		return 0;
+
+	slot = now / sim.outage_period;
+	range = sim.outage_period - sim.outage_length;
+	start = slot * sim.outage_period;
+
+	if (range > 0)
+		start += sim_hash(sim.group, (uint32_t)slot) % range;
+
+	return (now >= start) && (now < start + sim.outage_length);
+}
+
+static void sim_init(void)
+{
+	const char	*val;
+	int		i;
+	char	var[SMALLBUF];
+
+	sim.seed = getval("sim_seed") ? strtoul(getval("sim_seed"), NULL, 10) : 0;
+	if (sim.seed == 0)
+	{
+		/* default to a seed derived from the UPS name */
+		for (val = upsname; val && *val; val++)
+			sim.seed = sim.seed * 31 + (unsigned char)*val;
+	}
+	sim.state = sim_hash(sim.seed, 0) | 1;
+
+	sim.load_mean = getval("sim_load") ? atof(getval("sim_load")) : 40;
+	sim.load_step = getval("sim_load_step") ? atof(getval("sim_load_step")) : 2;
+	sim.runtime = getval("sim_runtime") ? atof(getval("sim_runtime")) : 600;
+	sim.group = getval("sim_group") ? strtoul(getval("sim_group"), NULL, 10) : 0;
+	sim.outage_period = getval("sim_outage_period") ? atol(getval("sim_outage_period")) : 3600;
+	sim.outage_length = getval("sim_outage_length") ? atol(getval("sim_outage_length")) : 300;
+	sim.outlets = getval("sim_outlets") ? atoi(getval("sim_outlets")) : 0;
+
+	if (sim.runtime <= 0)
+		fatalx(EXIT_FAILURE, "Invalid sim_runtime: %s", getval("sim_runtime"));
+
+	sim.load = sim.load_mean;
+	sim.charge = 100;
+
+	val = dstate_getinfo("input.voltage.nominal");
+	if (!val)
+		val = dstate_getinfo("input.voltage");
+	sim.voltage = val ? atof(val) : 230;
+
+	if (sim.outlets > 0)
+	{
+		dstate_setinfo("outlet.count", "%d", sim.outlets);
+
+		for (i = 1; i <= sim.outlets; i++)
+		{
+			snprintf(var, sizeof(var), "outlet.%d.id", i);
+			dstate_setinfo(var, "%d", i);
+			snprintf(var, sizeof(var), "outlet.%d.desc", i);
+			dstate_setinfo(var, "Outlet %d", i);
+			snprintf(var, sizeof(var), "outlet.%d.switchable", i);
+			dstate_setinfo(var, "yes");
+		}
+	}
+
+	upsdebugx(1, "sim: seed %u, group %u, load %.1f%%, runtime %.0fs, %d outlets",
+		sim.seed, sim.group, sim.load_mean, sim.runtime, sim.outlets);
+}
+
+static void sim_update(void)
+{
+	time_t	now;
+	double	dt, u, runtime, low = 20;
+	int		outage, i;
+	const char	*val;
+	char	var[SMALLBUF];
+
+	time(&now);
+	dt = sim.last ? difftime(now, sim.last) : 0;
+	sim.last = now;
+
+	/* mean reverting random walk of the load */
+	u = (double)sim_rand(&sim.state) / 4294967295.0;
+	sim.load += sim.load_step * (2 * u - 1) + (sim.load_mean - sim.load) / 10;
+	if (sim.load < 0)
+		sim.load = 0;
+	if (sim.load > 100)
+		sim.load = 100;
+
+	/* runtime at the current load, from the full load one */
+	runtime = sim.runtime * 100 / (sim.load > 1 ? sim.load : 1);
+
+	outage = sim_outage(now);
+	if (outage)
+		sim.charge -= dt * 100 / runtime;
+	else
+		sim.charge += dt * 100 / SIM_RECHARGE_TIME;
+
+	if (sim.charge < 0)
+		sim.charge = 0;
+	if (sim.charge > 100)
+		sim.charge = 100;
+
+	if ((val = dstate_getinfo("battery.charge.low")) != NULL)
+		low = atof(val);
+
+	dstate_setinfo("ups.load", "%.1f", sim.load);
+	dstate_setinfo("battery.charge", "%.0f", sim.charge);
+	dstate_setinfo("battery.runtime", "%.0f", runtime * sim.charge / 100);
+	dstate_setinfo("input.voltage", "%.1f", outage ? 0 : sim.voltage);
+	dstate_setinfo("output.voltage", "%.1f", (sim.charge > 0 || !outage) ? sim.voltage : 0);
+
+	status_init();
+	if (outage)
+	{
+		status_set("OB");
+		status_set("DISCHRG");
+		if (sim.charge <= low)
+			status_set("LB");
+	}
+	else
+	{
+		status_set("OL");
+		if (sim.charge < 100)
+			status_set("CHRG");
+	}
+	status_commit();
+
+	for (i = 1; i <= sim.outlets; i++)
+	{
+		snprintf(var, sizeof(var), "outlet.%d.status", i);
+		dstate_setinfo(var, "%s", (sim.charge > 0 || !outage) ? "on" : "off");
+	}
+
+	dstate_dataok();
+}
@@ -270,12 +270,14 @@ static struct {
  * since it's used to produce sub-drivers "stub" using
  * scripts/subdriver/gen-usbhid-subdriver.sh
  */
-void HIDDumpTree(hid_dev_handle_t udev, usage_tables_t *utab)
+void HIDDumpTree(hid_dev_handle_t udev, HIDDevice_t *hd, usage_tables_t *utab)
 {
 	int	i;
 #ifndef SHUT_MODE
-	/* extract the VendorId for further testing */
-	int vendorID = usb_device((struct usb_dev_handle *)udev)->descriptor.idVendor;
+	/* extract the VendorId for further testing (use the device
+	 * description rather than the handle, which may not be a real
+	 * libusb handle when replaying a recorded session) */
+	int vendorID = hd->VendorID;
 #endif
 
 	/* Do not go further if we already know nothing will be displayed.
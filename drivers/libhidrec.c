@@ -0,0 +1,741 @@
+/*!
+ * @file libhidrec.c
+ * @brief HID Library - record / replay communication sub driver
+ *
+ *      This program is free software; you can redistribute it and/or modify
+ *      it under the terms of the GNU General Public License as published by
+ *      the Free Software Foundation; either version 2 of the License, or
+ *      (at your option) any later version.
+ *
+ *      This program is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *      GNU General Public License for more details.
+ *
+ *      You should have received a copy of the GNU General Public License
+ *      along with this program; if not, write to the Free Software
+ *      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * -------------------------------------------------------------------------- */
+
+/* A session file is a text file, one exchange per line, all numbers in
+ * decimal and all binary data (including strings) in hexadecimal, "-"
+ * standing for no data. <t> is the time of the exchange in seconds since
+ * the start of the session, <lat> the time it took, in microseconds:
+ *
+ *   D <t> <vendorid> <productid> <bcddevice> <vendor> <product> <serial> <bus>
+ *   R <t> <report descriptor>
+ *   G <t> <lat> <report id> <ret> <data>	(get_report)
+ *   S <t> <lat> <report id> <ret> <data>	(set_report)
+ *   T <t> <lat> <string idx> <ret> <string>	(get_string)
+ *   I <t> <lat> <ret> <data>			(get_interrupt)
+ *
+ * The last D and R lines describe the device that has been opened. Lines
+ * starting with '#' are comments.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <ctype.h>
+
+#include "common.h"
+#include "libhidrec.h"
+
+#define HIDREC_DRIVER_NAME	"HID record/replay communication driver"
+#define HIDREC_DRIVER_VERSION	"0.01"
+
+/* ---------------------------------------------------------------------- */
+/* common helpers */
+
+static struct timeval	session_start;
+
+/* what the driver cost to the device */
+typedef struct {
+	unsigned long	reports;	/* get_report + set_report */
+	unsigned long	strings;
+	unsigned long	interrupts;
+	double		latency;	/* total, in seconds */
+} hidrec_stats_t;
+
+static struct {
+	int		active;		/* recording or replaying */
+	int		started;	/* the first cycle has begun */
+	unsigned long	cycles;
+	hidrec_stats_t	init;		/* until the first cycle */
+	hidrec_stats_t	cycle;		/* the current one */
+	hidrec_stats_t	total;		/* of all the cycles */
+	unsigned long	maxreports;
+	double		maxlatency;
+} stats;
+
+static double elapsed(const struct timeval *since)
+{
+	struct timeval	now;
+
+	gettimeofday(&now, NULL);
+
+	return (now.tv_sec - since->tv_sec) + (now.tv_usec - since->tv_usec) / 1000000.0;
+}
+
+/* account for an exchange in the current cycle */
+static void stats_add(unsigned long *counter, double latency)
+{
+	(*counter)++;
+	stats.cycle.latency += latency;
+}
+
+void hidrec_cycle(void)
+{
+	hidrec_stats_t	*cycle = &stats.cycle;
+
+	if (!stats.active) {
+		return;
+	}
+
+	/* what was exchanged before the first cycle opened the device */
+	if (!stats.started) {
+		stats.started = 1;
+		stats.init = *cycle;
+		memset(cycle, 0, sizeof(*cycle));
+		return;
+	}
+
+	stats.cycles++;
+
+	upslogx(LOG_INFO, "hidrec: cycle %lu: %lu reports, %lu strings, %lu interrupts, %.3f ms",
+		stats.cycles, cycle->reports, cycle->strings, cycle->interrupts, cycle->latency * 1000);
+
+	stats.total.reports += cycle->reports;
+	stats.total.strings += cycle->strings;
+	stats.total.interrupts += cycle->interrupts;
+	stats.total.latency += cycle->latency;
+
+	if (cycle->reports > stats.maxreports) {
+		stats.maxreports = cycle->reports;
+	}
+
+	if (cycle->latency > stats.maxlatency) {
+		stats.maxlatency = cycle->latency;
+	}
+
+	memset(cycle, 0, sizeof(*cycle));
+}
+
+void hidrec_summary(void)
+{
+	if (!stats.active) {
+		return;
+	}
+
+	/* the last cycle is over too */
+	hidrec_cycle();
+
+	upslogx(LOG_INFO, "hidrec: init: %lu reports, %lu strings, %.3f ms",
+		stats.init.reports, stats.init.strings, stats.init.latency * 1000);
+
+	if (stats.cycles < 1) {
+		return;
+	}
+
+	upslogx(LOG_INFO, "hidrec: %lu cycles: %.2f reports (max %lu), %.2f strings, "
+		"%.2f interrupts, %.3f ms (max %.3f) per cycle", stats.cycles,
+		(double)stats.total.reports / stats.cycles, stats.maxreports,
+		(double)stats.total.strings / stats.cycles,
+		(double)stats.total.interrupts / stats.cycles,
+		stats.total.latency * 1000 / stats.cycles, stats.maxlatency * 1000);
+}
+
+static void hex_write(FILE *fp, const unsigned char *buf, int len)
+{
+	int	i;
+
+	if (len <= 0) {
+		fputs(" -", fp);
+		return;
+	}
+
+	fputc(' ', fp);
+
+	for (i = 0; i < len; i++) {
+		fprintf(fp, "%02x", buf[i]);
+	}
+}
+
+/* decode an hexadecimal string in a newly allocated buffer, which is
+ * always NUL terminated so that it can hold a string too */
+static unsigned char *hex_read(const char *hex, int *len)
+{
+	unsigned char	*buf;
+	unsigned int	byte;
+	int		i;
+
+	if (!strcmp(hex, "-")) {
+		*len = 0;
+		return xcalloc(1, 1);
+	}
+
+	*len = strlen(hex) / 2;
+	buf = xcalloc(*len + 1, 1);
+
+	for (i = 0; i < *len; i++) {
+		if (sscanf(hex + 2 * i, "%2x", &byte) != 1) {
+			break;
+		}
+		buf[i] = byte;
+	}
+
+	*len = i;
+
+	return buf;
+}
+
+/* ---------------------------------------------------------------------- */
+/* recording */
+
+static struct {
+	communication_subdriver_t	*real;
+	FILE				*fp;
+	int (*callback)(hid_dev_handle_t udev, HIDDevice_t *hd, unsigned char *rdbuf, int rdlen);
+} rec;
+
+static void rec_string(const char *str)
+{
+	hex_write(rec.fp, (const unsigned char *)str, str ? strlen(str) : 0);
+}
+
+static int rec_callback(hid_dev_handle_t udev, HIDDevice_t *hd, unsigned char *rdbuf, int rdlen)
+{
+	fprintf(rec.fp, "D %.6f %u %u %u", elapsed(&session_start),
+		hd->VendorID, hd->ProductID, hd->bcdDevice);
+	rec_string(hd->Vendor);
+	rec_string(hd->Product);
+	rec_string(hd->Serial);
+	rec_string(hd->Bus);
+	fprintf(rec.fp, "\nR %.6f", elapsed(&session_start));
+	hex_write(rec.fp, rdbuf, rdlen);
+	fputc('\n', rec.fp);
+	fflush(rec.fp);
+
+	return rec.callback(udev, hd, rdbuf, rdlen);
+}
+
+static int rec_open(hid_dev_handle_t *udevp, HIDDevice_t *hd, HIDDeviceMatcher_t *matcher,
+	int (*callback)(hid_dev_handle_t udev, HIDDevice_t *hd, unsigned char *rdbuf, int rdlen))
+{
+	rec.callback = callback;
+
+	return rec.real->open(udevp, hd, matcher, callback ? &rec_callback : NULL);
+}
+
+static void rec_close(hid_dev_handle_t udev)
+{
+	rec.real->close(udev);
+}
+
+static int rec_get_report(hid_dev_handle_t udev, int ReportId, unsigned char *raw_buf, int ReportSize)
+{
+	struct timeval	start;
+	double		latency;
+	int		ret;
+
+	gettimeofday(&start, NULL);
+	ret = rec.real->get_report(udev, ReportId, raw_buf, ReportSize);
+	latency = elapsed(&start);
+
+	fprintf(rec.fp, "G %.6f %ld %d %d", elapsed(&session_start), (long)(latency * 1000000), ReportId, ret);
+	hex_write(rec.fp, raw_buf, ret);
+	fputc('\n', rec.fp);
+	fflush(rec.fp);
+
+	stats_add(&stats.cycle.reports, latency);
+
+	return ret;
+}
+
+static int rec_set_report(hid_dev_handle_t udev, int ReportId, unsigned char *raw_buf, int ReportSize)
+{
+	struct timeval	start;
+	double		latency;
+	int		ret;
+
+	gettimeofday(&start, NULL);
+	ret = rec.real->set_report(udev, ReportId, raw_buf, ReportSize);
+	latency = elapsed(&start);
+
+	fprintf(rec.fp, "S %.6f %ld %d %d", elapsed(&session_start), (long)(latency * 1000000), ReportId, ret);
+	hex_write(rec.fp, raw_buf, ReportSize);
+	fputc('\n', rec.fp);
+	fflush(rec.fp);
+
+	stats_add(&stats.cycle.reports, latency);
+
+	return ret;
+}
+
+static int rec_get_string(hid_dev_handle_t udev, int StringIdx, char *buf, size_t buflen)
+{
+	struct timeval	start;
+	double		latency;
+	int		ret;
+
+	gettimeofday(&start, NULL);
+	ret = rec.real->get_string(udev, StringIdx, buf, buflen);
+	latency = elapsed(&start);
+
+	fprintf(rec.fp, "T %.6f %ld %d %d", elapsed(&session_start), (long)(latency * 1000000), StringIdx, ret);
+	rec_string(ret > 0 ? buf : NULL);
+	fputc('\n', rec.fp);
+	fflush(rec.fp);
+
+	stats_add(&stats.cycle.strings, latency);
+
+	return ret;
+}
+
+static int rec_get_interrupt(hid_dev_handle_t udev, unsigned char *buf, int bufsize, int timeout)
+{
+	struct timeval	start;
+	int		ret;
+
+	gettimeofday(&start, NULL);
+	ret = rec.real->get_interrupt(udev, buf, bufsize, timeout);
+
+	/* timeouts and errors are not events, only record what was read */
+	if (ret <= 0) {
+		return ret;
+	}
+
+	fprintf(rec.fp, "I %.6f %ld %d", elapsed(&session_start), (long)(elapsed(&start) * 1000000), ret);
+	hex_write(rec.fp, buf, ret);
+	fputc('\n', rec.fp);
+	fflush(rec.fp);
+
+	stats_add(&stats.cycle.interrupts, 0);
+
+	return ret;
+}
+
+static communication_subdriver_t rec_subdriver = {
+	HIDREC_DRIVER_NAME,
+	HIDREC_DRIVER_VERSION,
+	rec_open,
+	rec_close,
+	rec_get_report,
+	rec_set_report,
+	rec_get_string,
+	rec_get_interrupt
+};
+
+communication_subdriver_t *hidrec_record(communication_subdriver_t *real, const char *filename)
+{
+	rec.real = real;
+	rec.fp = fopen(filename, "w");
+
+	if (!rec.fp) {
+		fatal_with_errno(EXIT_FAILURE, "Can't open %s", filename);
+	}
+
+	upslogx(LOG_INFO, "Recording HID session to %s", filename);
+	gettimeofday(&session_start, NULL);
+	stats.active = 1;
+
+	return &rec_subdriver;
+}
+
+/* ---------------------------------------------------------------------- */
+/* replay */
+
+typedef struct {
+	double		t;
+	long		lat;
+	int		ret;
+	int		len;
+	unsigned char	*data;
+} hidrec_event_t;
+
+/* the exchanges of one kind (and report id), in time order */
+typedef struct {
+	hidrec_event_t	*event;
+	int		num;
+	int		alloc;
+	int		cur;
+} hidrec_track_t;
+
+static struct {
+	double		speed;
+	double		length;		/* of the session, in seconds */
+	HIDDevice_t	device;
+	unsigned char	*rdbuf;
+	int		rdlen;
+	hidrec_track_t	report[256];
+	hidrec_track_t	setreport[256];
+	hidrec_track_t	string[256];
+	hidrec_track_t	interrupt;
+} play;
+
+static void track_add(hidrec_track_t *track, double t, long lat, int ret, const char *hex)
+{
+	hidrec_event_t	*ev;
+
+	if (track->num == track->alloc) {
+		track->alloc = track->alloc ? 2 * track->alloc : 16;
+		track->event = xrealloc(track->event, track->alloc * sizeof(*track->event));
+	}
+
+	ev = &track->event[track->num++];
+	ev->t = t;
+	ev->lat = lat;
+	ev->ret = ret;
+	ev->data = hex_read(hex, &ev->len);
+}
+
+/* the exchange that was the last one at the time of the session clock
+ * (or the first one, if the clock is earlier) */
+static hidrec_event_t *track_at(hidrec_track_t *track, double clock)
+{
+	if (track->num < 1) {
+		return NULL;
+	}
+
+	while ((track->cur + 1 < track->num) && (track->event[track->cur + 1].t <= clock)) {
+		track->cur++;
+	}
+
+	return &track->event[track->cur];
+}
+
+static char *play_string(const char *hex)
+{
+	int	len;
+
+	if (!strcmp(hex, "-")) {
+		return NULL;
+	}
+
+	return (char *)hex_read(hex, &len);
+}
+
+static void play_load(const char *filename)
+{
+	FILE	*fp;
+	char	*line = NULL, *ptr, *arg[9];
+	size_t	size = 0;
+	int	linenum = 0, narg, id;
+	double	t;
+
+	fp = fopen(filename, "r");
+
+	if (!fp) {
+		fatal_with_errno(EXIT_FAILURE, "Can't open %s", filename);
+	}
+
+	for (;;) {
+		size_t	len = 0;
+
+		/* lines hold whole report descriptors, so they can be long */
+		do {
+			if (size - len < 2) {
+				size = size ? 2 * size : LARGEBUF;
+				line = xrealloc(line, size);
+			}
+
+			if (!fgets(line + len, size - len, fp)) {
+				break;
+			}
+
+			len += strlen(line + len);
+		} while ((len > 0) && (line[len - 1] != '\n'));
+
+		if (len == 0) {
+			break;
+		}
+
+		linenum++;
+
+		if (line[0] == '#') {
+			continue;
+		}
+
+		narg = 0;
+		for (ptr = strtok(line, " \t\r\n"); ptr && (narg < 9); ptr = strtok(NULL, " \t\r\n")) {
+			arg[narg++] = ptr;
+		}
+
+		if ((narg < 3) || (strlen(arg[0]) != 1)) {
+			upslogx(LOG_WARNING, "%s:%d: ignoring malformed line", filename, linenum);
+			continue;
+		}
+
+		t = strtod(arg[1], NULL);
+
+		if (t > play.length) {
+			play.length = t;
+		}
+
+		switch (arg[0][0])
+		{
+		case 'D':
+			if (narg < 9) {
+				break;
+			}
+			free(play.device.Vendor);
+			free(play.device.Product);
+			free(play.device.Serial);
+			free(play.device.Bus);
+			play.device.VendorID = strtol(arg[2], NULL, 10);
+			play.device.ProductID = strtol(arg[3], NULL, 10);
+			play.device.bcdDevice = strtol(arg[4], NULL, 10);
+			play.device.Vendor = play_string(arg[5]);
+			play.device.Product = play_string(arg[6]);
+			play.device.Serial = play_string(arg[7]);
+			play.device.Bus = play_string(arg[8]);
+			continue;
+
+		case 'R':
+			free(play.rdbuf);
+			play.rdbuf = hex_read(arg[2], &play.rdlen);
+			continue;
+
+		case 'G':
+		case 'S':
+		case 'T':
+			if (narg < 6) {
+				break;
+			}
+			id = atoi(arg[3]);
+			if ((id < 0) || (id > 255)) {
+				break;
+			}
+			track_add(arg[0][0] == 'G' ? &play.report[id] : arg[0][0] == 'S' ? &play.setreport[id] : &play.string[id],
+				t, atol(arg[2]), atoi(arg[4]), arg[5]);
+			continue;
+
+		case 'I':
+			if (narg < 5) {
+				break;
+			}
+			track_add(&play.interrupt, t, atol(arg[2]), atoi(arg[3]), arg[4]);
+			continue;
+		}
+
+		upslogx(LOG_WARNING, "%s:%d: ignoring malformed line", filename, linenum);
+	}
+
+	free(line);
+	fclose(fp);
+
+	if (!play.rdbuf) {
+		fatalx(EXIT_FAILURE, "%s: no device found in session", filename);
+	}
+
+	upsdebugx(1, "Loaded %d lines (%.0f seconds) of HID session from %s", linenum, play.length, filename);
+}
+
+/* the session clock, in recorded seconds */
+static double play_clock(void)
+{
+	double	clock;
+	int	i;
+
+	clock = elapsed(&session_start) * play.speed;
+
+	if ((play.length <= 0) || (clock < play.length)) {
+		return clock;
+	}
+
+	upsdebugx(2, "End of HID session reached, starting over");
+
+	gettimeofday(&session_start, NULL);
+
+	for (i = 0; i < 256; i++) {
+		play.report[i].cur = 0;
+		play.setreport[i].cur = 0;
+		play.string[i].cur = 0;
+	}
+
+	play.interrupt.cur = 0;
+
+	return 0;
+}
+
+/* make the driver wait as long as the device did (scaled to the replay
+ * speed), so that its timing stays realistic, and return the recorded
+ * latency, which is what the statistics compare */
+static double play_latency(const hidrec_event_t *ev)
+{
+	double	latency = ev->lat / 1000000.0;
+
+	if (latency / play.speed >= 0.000001) {
+		usleep(latency / play.speed * 1000000);
+	}
+
+	return latency;
+}
+
+static int play_open(hid_dev_handle_t *udevp, HIDDevice_t *hd, HIDDeviceMatcher_t *matcher,
+	int (*callback)(hid_dev_handle_t udev, HIDDevice_t *hd, unsigned char *rdbuf, int rdlen))
+{
+	/* there is nothing to match against, the device is the recorded one */
+#ifdef SHUT_MODE
+	*udevp = 0;
+#else
+	/* never dereferenced, only needs not to be NULL */
+	*udevp = (hid_dev_handle_t)&play;
+#endif
+
+	free(hd->Vendor);
+	free(hd->Product);
+	free(hd->Serial);
+	free(hd->Bus);
+
+	hd->VendorID = play.device.VendorID;
+	hd->ProductID = play.device.ProductID;
+	hd->bcdDevice = play.device.bcdDevice;
+	hd->Vendor = play.device.Vendor ? xstrdup(play.device.Vendor) : NULL;
+	hd->Product = play.device.Product ? xstrdup(play.device.Product) : NULL;
+	hd->Serial = play.device.Serial ? xstrdup(play.device.Serial) : NULL;
+	hd->Bus = play.device.Bus ? xstrdup(play.device.Bus) : NULL;
+
+	if (!callback) {
+		return 1;
+	}
+
+	return callback(*udevp, hd, play.rdbuf, play.rdlen);
+}
+
+static void play_close(hid_dev_handle_t udev)
+{
+}
+
+static int play_get_report(hid_dev_handle_t udev, int ReportId, unsigned char *raw_buf, int ReportSize)
+{
+	hidrec_event_t	*ev;
+	int		len;
+
+	if ((ReportId < 0) || (ReportId > 255)) {
+		return 0;
+	}
+
+	ev = track_at(&play.report[ReportId], play_clock());
+
+	/* never asked for while recording: unknown failure, ignored */
+	if (!ev) {
+		upsdebugx(3, "%s: report %d not in session", __func__, ReportId);
+		return 0;
+	}
+
+	stats_add(&stats.cycle.reports, play_latency(ev));
+
+	len = (ev->len < ReportSize) ? ev->len : ReportSize;
+	memcpy(raw_buf, ev->data, len);
+
+	return (ev->ret > len) ? len : ev->ret;
+}
+
+static int play_set_report(hid_dev_handle_t udev, int ReportId, unsigned char *raw_buf, int ReportSize)
+{
+	hidrec_event_t	*ev;
+
+	if ((ReportId < 0) || (ReportId > 255)) {
+		return 0;
+	}
+
+	ev = track_at(&play.setreport[ReportId], play_clock());
+
+	/* writes change nothing in the session, assume the device accepts
+	 * them unless it did not while recording */
+	if (!ev) {
+		return ReportSize;
+	}
+
+	stats_add(&stats.cycle.reports, play_latency(ev));
+
+	return ev->ret;
+}
+
+static int play_get_string(hid_dev_handle_t udev, int StringIdx, char *buf, size_t buflen)
+{
+	hidrec_event_t	*ev;
+
+	if ((StringIdx < 0) || (StringIdx > 255) || (buflen < 1)) {
+		return -1;
+	}
+
+	ev = track_at(&play.string[StringIdx], play_clock());
+
+	if (!ev) {
+		return -1;
+	}
+
+	stats_add(&stats.cycle.strings, play_latency(ev));
+
+	if (ev->ret > 0) {
+		snprintf(buf, buflen, "%s", (char *)ev->data);
+	}
+
+	return ev->ret;
+}
+
+static int play_get_interrupt(hid_dev_handle_t udev, unsigned char *buf, int bufsize, int timeout)
+{
+	hidrec_event_t	*ev;
+	double		wait;
+	int		len;
+
+	if (play.interrupt.cur >= play.interrupt.num) {
+		usleep(timeout * 1000);
+		play_clock();
+		return 0;
+	}
+
+	ev = &play.interrupt.event[play.interrupt.cur];
+
+	/* wait for the next event, as the device would */
+	wait = (ev->t - play_clock()) / play.speed;
+
+	if (wait * 1000 > timeout) {
+		usleep(timeout * 1000);
+		return 0;
+	}
+
+	if (wait > 0) {
+		usleep(wait * 1000000);
+	}
+
+	play.interrupt.cur++;
+	stats_add(&stats.cycle.interrupts, 0);
+
+	len = (ev->len < bufsize) ? ev->len : bufsize;
+	memcpy(buf, ev->data, len);
+
+	return len;
+}
+
+static communication_subdriver_t play_subdriver = {
+	HIDREC_DRIVER_NAME,
+	HIDREC_DRIVER_VERSION,
+	play_open,
+	play_close,
+	play_get_report,
+	play_set_report,
+	play_get_string,
+	play_get_interrupt
+};
+
+communication_subdriver_t *hidrec_replay(const char *filename, double speed)
+{
+	if (speed <= 0) {
+		fatalx(EXIT_FAILURE, "Invalid replay speed %g", speed);
+	}
+
+	play.speed = speed;
+	play_load(filename);
+
+	upslogx(LOG_INFO, "Replaying HID session from %s (speed x%g)", filename, speed);
+	gettimeofday(&session_start, NULL);
+	stats.active = 1;
+
+	return &play_subdriver;
+}
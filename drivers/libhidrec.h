@@ -0,0 +1,53 @@
+/*!
+ * @file libhidrec.h
+ * @brief HID Library - record / replay communication sub driver
+ *
+ *      This program is free software; you can redistribute it and/or modify
+ *      it under the terms of the GNU General Public License as published by
+ *      the Free Software Foundation; either version 2 of the License, or
+ *      (at your option) any later version.
+ *
+ *      This program is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *      GNU General Public License for more details.
+ *
+ *      You should have received a copy of the GNU General Public License
+ *      along with this program; if not, write to the Free Software
+ *      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef LIBHIDREC_H
+#define LIBHIDREC_H
+
+#include "libhid.h"
+
+/*!
+ * Record every exchange of the real communication sub driver (USB or
+ * SHUT) to a session file. Returns a sub driver wrapping @real, that
+ * must be used in place of it.
+ */
+communication_subdriver_t *hidrec_record(communication_subdriver_t *real, const char *filename);
+
+/*!
+ * Load a session file recorded by hidrec_record(), and return a sub
+ * driver that plays it back instead of talking to a device.
+ * The session clock runs @speed times faster than the recording, and
+ * loops over when reaching its end.
+ */
+communication_subdriver_t *hidrec_replay(const char *filename, double speed);
+
+/*!
+ * Mark the start of a driver poll cycle: log the report requests,
+ * strings, interrupts and device latency of the cycle that just ended.
+ * Does nothing unless recording or replaying.
+ */
+void hidrec_cycle(void);
+
+/*!
+ * Log the statistics of all the poll cycles, and of the initialization.
+ */
+void hidrec_summary(void);
+
+#endif /* LIBHIDREC_H */
@@ -22,6 +22,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 
 #include <ne_xml.h>
 
@@ -1077,6 +1078,71 @@ static xml_info_t mge_xml2nut[] = {
 	{ NULL, 0, 0, NULL, 0, 0, NULL }
 };
 
+/* Hash table of the mge_xml2nut entries, indexed by XML variable name
+ * (case insensitive), built on first use: mge_xml_info_find() replaces
+ * a walk through the whole table for every object we parse */
+#define MGE_XML_HASH_SIZE	1024	/* power of 2, at least twice the entries of mge_xml2nut */
+
+static xml_info_t	*mge_xml_hash[MGE_XML_HASH_SIZE];
+static int		mge_xml_hash_ready = 0;
+
+static unsigned int mge_xml_hash_name(const char *name)
+{
+	unsigned int	hash = 5381;
+
+	while (*name) {
+		hash = hash * 33 + tolower((unsigned char)*name++);
+	}
+
+	return hash & (MGE_XML_HASH_SIZE - 1);
+}
+
+static void mge_xml_hash_init(void)
+{
+	xml_info_t	*info;
+	unsigned int	i, count = 0;
+
+	for (info = mge_xml2nut; info->xmlname != NULL; info++) {
+
+		for (i = mge_xml_hash_name(info->xmlname); mge_xml_hash[i] != NULL; i = (i + 1) & (MGE_XML_HASH_SIZE - 1)) {
+			if (!strcasecmp(mge_xml_hash[i]->xmlname, info->xmlname)) {
+				break;
+			}
+		}
+
+		/* as in the table, the first entry for a given XML variable wins */
+		if (mge_xml_hash[i] != NULL) {
+			continue;
+		}
+
+		if (++count > MGE_XML_HASH_SIZE / 2) {
+			fatalx(EXIT_FAILURE, "%s: too many entries, increase MGE_XML_HASH_SIZE", __func__);
+		}
+
+		mge_xml_hash[i] = info;
+	}
+
+	mge_xml_hash_ready = 1;
+}
+
+/* Find the mge_xml2nut entry of a XML variable, or return NULL if there's none */
+static xml_info_t *mge_xml_info_find(const char *xmlname)
+{
+	unsigned int	i;
+
+	if (!mge_xml_hash_ready) {
+		mge_xml_hash_init();
+	}
+
+	for (i = mge_xml_hash_name(xmlname); mge_xml_hash[i] != NULL; i = (i + 1) & (MGE_XML_HASH_SIZE - 1)) {
+		if (!strcasecmp(mge_xml_hash[i]->xmlname, xmlname)) {
+			return mge_xml_hash[i];
+		}
+	}
+
+	return NULL;
+}
+
 /* A start-element callback for element with given namespace/name. */
 static int mge_xml_startelm_cb(void *userdata, int parent, const char *nspace, const char *name, const char **atts)
 {
@@ -1391,32 +1457,30 @@ static int mge_xml_endelm_cb(void *userdata, int state, const char *nspace, cons
 	case ALARM:
 	case SU_OBJECT:
 	case GO_OBJECT:
-		for (info = mge_xml2nut; info->xmlname != NULL; info++) {
-			if (strcasecmp(var, info->xmlname)) {
-				continue;
-			}
+		info = mge_xml_info_find(var);
 
-			upsdebugx(3, "-> XML variable %s [%s] maps to NUT variable %s", var, val, info->nutname);
+		if (info == NULL) {
+			upsdebugx(3, "-> XML variable %s [%s] doesn't map to any NUT variable", var, val);
+			break;
+		}
 
-			if ((info->nutflags & ST_FLAG_STATIC) && dstate_getinfo(info->nutname)) {
-				return 0;
-			}
+		upsdebugx(3, "-> XML variable %s [%s] maps to NUT variable %s", var, val, info->nutname);
 
-			if (info->convert) {
-				value = info->convert(val);
-			} else {
-				value = val;
-			}
+		if ((info->nutflags & ST_FLAG_STATIC) && dstate_getinfo(info->nutname)) {
+			return 0;
+		}
 
-			if (value != NULL) {
-				dstate_setinfo(info->nutname, "%s", value);
-			}
+		if (info->convert) {
+			value = info->convert(val);
+		} else {
+			value = val;
+		}
 
-			return 0;
+		if (value != NULL) {
+			dstate_setinfo(info->nutname, "%s", value);
 		}
 
-		upsdebugx(3, "-> XML variable %s [%s] doesn't map to any NUT variable", var, val);
-		break;
+		return 0;
 	}
 
 	return 0;
@@ -1455,15 +1519,10 @@ const char *vname_nut2mge_xml(const char *name) {
 const char *vname_mge_xml2nut(const char *name) {
 	assert(NULL != name);
 
-	size_t i = 0;
-
-	for (; i < sizeof(mge_xml2nut) / sizeof(xml_info_t); ++i) {
-		xml_info_t *info = mge_xml2nut + i;
+	xml_info_t *info = mge_xml_info_find(name);
 
-		if (NULL != info->xmlname)
-			if (0 == strcasecmp(name, info->xmlname))
-				return info->nutname;
-	}
+	if (NULL != info)
+		return info->nutname;
 
 	return NULL;
 }
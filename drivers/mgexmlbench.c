@@ -0,0 +1,298 @@
+/* mgexmlbench - measure the parsing of netxml-ups pages by mge-xml
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/* the callbacks, the lookup and the mge_xml2nut table are static */
+#include "mge-xml.c"
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* what mge-xml.c takes from netxml-ups.c and dstate.c: the values are
+ * dropped, only the parsing and the lookups are measured */
+int		shutdown_duration = 120;
+uint32_t	ups_status = 0;
+
+const char *dstate_getinfo(const char *var)
+{
+	return NULL;
+}
+
+int dstate_setinfo(const char *var, const char *fmt, ...)
+{
+	return 0;
+}
+
+void dstate_setflags(const char *var, int flags)
+{
+}
+
+typedef struct {
+	const char	*path;
+	char	*buf;
+	size_t	len;
+	unsigned int	callbacks;
+	unsigned int	lookups;
+} page_t;
+
+static unsigned int	callbacks = 0;
+
+/* the XML variables looked up while parsing, in order, when recording */
+static char	**lookup = NULL;
+static unsigned int	lookups = 0, recording = 0;
+
+static void usage(const char *prog)
+{
+	printf("Network UPS Tools mgexmlbench %s\n\n", UPS_VERSION);
+
+	printf("usage: %s [-n <count>] <page> [<page> ...]\n", prog);
+
+	printf("\nParse the XML pages <count> times with the mge-xml callbacks of\n");
+	printf("netxml-ups, and report the callbacks and the time taken per page.\n");
+	printf("Then replay the lookups of XML variables made while parsing, by walking\n");
+	printf("the mge_xml2nut table (as netxml-ups used to), then through its hash\n");
+	printf("table, and check that both find the same entries.\n\n");
+
+	printf("  -n <count> - number of times each page is parsed (default: 1000)\n");
+	printf("  <page>     - XML page, such as data/mge-xml-*.xml\n");
+}
+
+/* the lookup as it was: the first entry of the table for the variable */
+static xml_info_t *mge_xml_info_walk(const char *xmlname)
+{
+	xml_info_t	*info;
+
+	for (info = mge_xml2nut; info->xmlname != NULL; info++) {
+		if (!strcasecmp(info->xmlname, xmlname)) {
+			return info;
+		}
+	}
+
+	return NULL;
+}
+
+static double cputime(void)
+{
+	struct rusage	ru;
+
+	getrusage(RUSAGE_SELF, &ru);
+
+	return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1000000.0
+		+ ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1000000.0;
+}
+
+static int bench_startelm_cb(void *userdata, int parent, const char *nspace, const char *name, const char **atts)
+{
+	callbacks++;
+
+	return mge_xml_startelm_cb(userdata, parent, nspace, name, atts);
+}
+
+static int bench_cdata_cb(void *userdata, int state, const char *cdata, size_t len)
+{
+	callbacks++;
+
+	return mge_xml_cdata_cb(userdata, state, cdata, len);
+}
+
+static int bench_endelm_cb(void *userdata, int state, const char *nspace, const char *name)
+{
+	callbacks++;
+
+	/* what mge_xml_endelm_cb looks up */
+	if (recording && (strlen(val) > 0)) {
+
+		switch (state)
+		{
+		case ALARM:
+		case SU_OBJECT:
+		case GO_OBJECT:
+			lookup = xrealloc(lookup, (lookups + 1) * sizeof(*lookup));
+			lookup[lookups++] = xstrdup(var);
+			break;
+		}
+	}
+
+	return mge_xml_endelm_cb(userdata, state, nspace, name);
+}
+
+static void parse_page(const page_t *page)
+{
+	ne_xml_parser	*parser;
+
+	parser = ne_xml_create();
+
+	ne_xml_push_handler(parser, bench_startelm_cb, bench_cdata_cb, bench_endelm_cb, NULL);
+
+	ne_xml_parse(parser, page->buf, page->len);
+	ne_xml_parse(parser, "", 0);
+
+	if (ne_xml_failed(parser)) {
+		fatalx(EXIT_FAILURE, "%s: %s", page->path, ne_xml_get_error(parser));
+	}
+
+	ne_xml_destroy(parser);
+}
+
+static void read_page(page_t *page, const char *path)
+{
+	struct stat	st;
+	FILE	*fp;
+
+	fp = fopen(path, "r");
+
+	if (!fp || (fstat(fileno(fp), &st) < 0)) {
+		fatal_with_errno(EXIT_FAILURE, "%s", path);
+	}
+
+	page->path = path;
+	page->len = st.st_size;
+	page->buf = xmalloc(page->len + 1);
+
+	if (fread(page->buf, 1, page->len, fp) != page->len) {
+		fatal_with_errno(EXIT_FAILURE, "%s", path);
+	}
+
+	fclose(fp);
+}
+
+int main(int argc, char **argv)
+{
+	page_t	*pages;
+	xml_info_t	*info;
+	unsigned int	count = 1000, numpages, i, j, walkfound, hashfound;
+	unsigned int	totalcb = 0, totallookups = 0;
+	int	opt;
+	double	start, cpu, walk, hash;
+
+	while ((opt = getopt(argc, argv, "hn:")) != -1) {
+		switch (opt)
+		{
+		case 'n':
+			count = atoi(optarg);
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+		}
+	}
+
+	if ((count < 1) || (optind >= argc)) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	numpages = argc - optind;
+	pages = xcalloc(numpages, sizeof(*pages));
+
+	/* a first parse of every page, recording the lookups */
+	recording = 1;
+
+	for (i = 0; i < numpages; i++) {
+		read_page(&pages[i], argv[optind + i]);
+
+		callbacks = 0;
+		j = lookups;
+
+		parse_page(&pages[i]);
+
+		pages[i].callbacks = callbacks;
+		pages[i].lookups = lookups - j;
+	}
+
+	recording = 0;
+
+	printf("%-24s %8s %10s %8s %10s %10s\n", "page", "bytes", "callbacks", "lookups", "ms/parse", "ns/cb");
+
+	for (i = 0; i < numpages; i++) {
+
+		start = cputime();
+
+		for (j = 0; j < count; j++) {
+			parse_page(&pages[i]);
+		}
+
+		cpu = cputime() - start;
+
+		printf("%-24s %8lu %10u %8u %10.3f %10.0f\n", xbasename(pages[i].path),
+			(unsigned long)pages[i].len, pages[i].callbacks, pages[i].lookups,
+			cpu * 1000 / count, cpu * 1000000000.0 / count / pages[i].callbacks);
+
+		totalcb += pages[i].callbacks;
+		totallookups += pages[i].lookups;
+	}
+
+	if (lookups == 0) {
+		fatalx(EXIT_FAILURE, "No XML variable was looked up in these pages");
+	}
+
+	/* both must find the same entry for every name */
+	for (i = 0; i < lookups; i++) {
+		info = mge_xml_info_find(lookup[i]);
+
+		if (info != mge_xml_info_walk(lookup[i])) {
+			fatalx(EXIT_FAILURE, "%s: the lookups disagree", lookup[i]);
+		}
+	}
+
+	start = cputime();
+
+	for (j = 0, walkfound = 0; j < count; j++) {
+		for (i = 0; i < lookups; i++) {
+			if (mge_xml_info_walk(lookup[i])) {
+				walkfound++;
+			}
+		}
+	}
+
+	walk = cputime() - start;
+
+	start = cputime();
+
+	for (j = 0, hashfound = 0; j < count; j++) {
+		for (i = 0; i < lookups; i++) {
+			if (mge_xml_info_find(lookup[i])) {
+				hashfound++;
+			}
+		}
+	}
+
+	hash = cputime() - start;
+
+	printf("\n%u callbacks and %u lookups per pass over the pages\n\n", totalcb, totallookups);
+
+	printf("%-12s %10s %10s %10s %10s\n", "lookup", "names", "found", "ms/pass", "ns/lookup");
+	printf("%-12s %10u %10u %10.3f %10.0f\n", "walk", lookups, walkfound / count,
+		walk * 1000 / count, walk * 1000000000.0 / count / lookups);
+	printf("%-12s %10u %10u %10.3f %10.0f\n", "hash", lookups, hashfound / count,
+		hash * 1000 / count, hash * 1000000000.0 / count / lookups);
+
+	for (i = 0; i < lookups; i++) {
+		free(lookup[i]);
+	}
+
+	free(lookup);
+
+	for (i = 0; i < numpages; i++) {
+		free(pages[i].buf);
+	}
+
+	free(pages);
+
+	return EXIT_SUCCESS;
+}
@@ -45,6 +45,11 @@
 /** *_OBJECT query multi-part body boundary */
 #define FORM_POST_BOUNDARY "NUT-NETXML-UPS-OBJECTS"
 
+/* Reads on the NSM socket: bigger than neon's own read buffer (4 KB), so that
+ * ne_sock_read() hands them to the socket and keeps nothing that select()
+ * on the fd can't see */
+#define NETXML_SOCKBUF	8192
+
 /* driver description structure */
 upsdrv_info_t	upsdrv_info = {
 	DRIVER_NAME,
@@ -231,22 +236,37 @@ static int		timeout = 5;
 int			shutdown_duration = 120;
 static int		shutdown_timer = 0;
 static time_t		lastheard = 0;
+static time_t		lastpoll = 0;
 static subdriver_t	*subdriver = &mge_xml_subdriver;
 static ne_session	*session = NULL;
 static ne_socket	*sock = NULL;
+static ne_xml_parser	*alarm_parser = NULL;	/* parser of the NSM message being received */
 static ne_uri		uri;
 
+/* Validators (ETag, Last-Modified) of the pages we got, for conditional requests */
+typedef struct {
+	char	*page;
+	char	*etag;
+	char	*lastmod;
+} netxml_validator_t;
+
+static netxml_validator_t	*validator = NULL;
+static int			validators = 0;
+
 /* Support functions */
 static void netxml_alarm_set(void);
 static void netxml_status_set(void);
 static int netxml_authenticate(void *userdata, const char *realm, int attempt, char *username, char *password);
 static int netxml_dispatch_request(ne_request *request, ne_xml_parser *parser);
 static int netxml_get_page(const char *page);
+static netxml_validator_t *netxml_get_validator(const char *page);
 
 static int instcmd(const char *cmdname, const char *extra);
 static int setvar(const char *varname, const char *val);
 
 static int netxml_alarm_subscribe(const char *page);
+static int netxml_alarm_read(void);
+static void netxml_alarm_parse(const char *buf, size_t len);
 
 #if HAVE_NE_SET_CONNECT_TIMEOUT && HAVE_NE_SOCK_CONNECT_TIMEOUT
 	/* we don't need to use alarm() */
@@ -293,38 +313,25 @@ void upsdrv_initinfo(void)
 void upsdrv_updateinfo(void)
 {
 	int	ret, errors = 0;
+	time_t	now;
+
+	time(&now);
 
-	/* We really should be dealing with alarms through a separate callback, so that we can keep the
-	 * processing of alarms and polling for data separated. Currently, this isn't supported by the
-	 * driver main body, so we'll have to revert to polling each time we're called, unless the
-	 * socket indicates we're no longer connected.
+	/* The subscription socket is our extrafd, so we're called as soon as the NMC sends
+	 * an alarm. Process everything it sent so far, then only poll for data if it's time to.
 	 */
 	if (testvar("subscribe")) {
-		char	buf[LARGEBUF];
-
-		ret = ne_sock_read(sock, buf, sizeof(buf));
-
-		if (ret > 0) {
-			/* alarm message received */
 
-			ne_xml_parser	*parser = ne_xml_create();
-			upsdebugx(2, "%s: ne_sock_read(%d bytes) => %s", __func__, ret, buf);
-			ne_xml_push_handler(parser, subdriver->startelm_cb, subdriver->cdata_cb, subdriver->endelm_cb, NULL);
-			ne_xml_parse(parser, buf, strlen(buf));
-			ne_xml_destroy(parser);
-			time(&lastheard);
-
-		} else if ((ret == NE_SOCK_TIMEOUT) && (difftime(time(NULL), lastheard) < 180)) {
-			/* timed out */
-
-			upsdebugx(2, "%s: ne_sock_read(timeout)", __func__);
-
-		} else {
+		if (netxml_alarm_read() != NE_OK) {
 			/* connection closed or unknown error */
 
 			upslogx(LOG_ERR, "NSM connection with '%s' lost", uri.host);
 
-			upsdebugx(2, "%s: ne_sock_read(%d) => %s", __func__, ret, ne_sock_error(sock));
+			if (alarm_parser) {
+				ne_xml_destroy(alarm_parser);
+				alarm_parser = NULL;
+			}
+
 			ne_sock_close(sock);
 
 			if (netxml_alarm_subscribe(subdriver->subscribe) == NE_OK) {
@@ -337,8 +344,23 @@ void upsdrv_updateinfo(void)
 			extrafd = -1;
 			return;
 		}
+
+		if (difftime(now, lastpoll) < poll_interval) {
+			status_init();
+
+			alarm_init();
+			netxml_alarm_set();
+			alarm_commit();
+
+			netxml_status_set();
+			status_commit();
+
+			return;
+		}
 	}
 
+	lastpoll = now;
+
 	/* get additional data */
 	ret = netxml_get_page(subdriver->getobject);
 	if (ret != NE_OK) {
@@ -500,6 +522,8 @@ void upsdrv_makevartable(void)
 
 	addvar(VAR_FLAG, "subscribe", "authenticated subscription on NMC");
 
+	addvar(VAR_FLAG, "noconditional", "don't use conditional requests (ETag/If-Modified-Since) when polling");
+
 	addvar(VAR_VALUE | VAR_SENSITIVE, "login", "login value for authenticated mode");
 	addvar(VAR_VALUE | VAR_SENSITIVE, "password", "password value for authenticated mode");
 
@@ -604,6 +628,11 @@ void upsdrv_initups(void)
 
 	ne_set_server_auth(session, netxml_authenticate, NULL);
 
+#ifdef HAVE_NE_SET_SESSION_FLAG
+	/* keep the connection to the NMC open between polls */
+	ne_set_session_flag(session, NE_SESSFLAG_PERSIST, 1);
+#endif
+
 	/* if debug level is set, direct output to stderr */
 	if (!nut_debug_level) {
 		fp = fopen("/dev/null", "w");
@@ -633,12 +662,26 @@ void upsdrv_initups(void)
 
 void upsdrv_cleanup(void)
 {
+	int	i;
+
 	free(subdriver->configure);
 	free(subdriver->subscribe);
 	free(subdriver->summary);
 	free(subdriver->getobject);
 	free(subdriver->setobject);
 
+	for (i = 0; i < validators; i++) {
+		free(validator[i].page);
+		free(validator[i].etag);
+		free(validator[i].lastmod);
+	}
+
+	free(validator);
+
+	if (alarm_parser) {
+		ne_xml_destroy(alarm_parser);
+	}
+
 	if (sock) {
 		ne_sock_close(sock);
 	}
@@ -659,11 +702,26 @@ static int netxml_get_page(const char *page)
 	int		ret;
 	ne_request	*request;
 	ne_xml_parser	*parser;
+	netxml_validator_t	*cache = NULL;
 
 	upsdebugx(2, "%s: %s", __func__, page);
 
 	request = ne_request_create(session, "GET", page);
 
+	/* only get the page if it changed since the last time */
+	if (!testvar("noconditional")) {
+
+		cache = netxml_get_validator(page);
+
+		if (cache->etag) {
+			ne_add_request_header(request, "If-None-Match", cache->etag);
+		}
+
+		if (cache->lastmod) {
+			ne_add_request_header(request, "If-Modified-Since", cache->lastmod);
+		}
+	}
+
 	parser = ne_xml_create();
 
 	ne_xml_push_handler(parser, subdriver->startelm_cb, subdriver->cdata_cb, subdriver->endelm_cb, NULL);
@@ -672,6 +730,24 @@ static int netxml_get_page(const char *page)
 
 	if (ret) {
 		upsdebugx(2, "%s: %s", __func__, ne_get_error(session));
+	} else if (ne_get_status(request)->code == 304) {
+		upsdebugx(3, "%s: %s not modified", __func__, page);
+	} else if (ne_get_status(request)->code != 200) {
+		/* the validators of an error page must not stand for the page */
+		upsdebugx(2, "%s: %s: %d %s", __func__, page,
+			ne_get_status(request)->code, ne_get_status(request)->reason_phrase);
+	} else if (cache) {
+#ifdef HAVE_NE_GET_RESPONSE_HEADER
+		const char	*val;
+
+		free(cache->etag);
+		val = ne_get_response_header(request, "ETag");
+		cache->etag = val ? xstrdup(val) : NULL;
+
+		free(cache->lastmod);
+		val = ne_get_response_header(request, "Last-Modified");
+		cache->lastmod = val ? xstrdup(val) : NULL;
+#endif
 	}
 
 	ne_xml_destroy(parser);
@@ -680,10 +756,32 @@ static int netxml_get_page(const char *page)
 	return ret;
 }
 
+/* Find the validators of a page (adding them, empty, if needed) */
+static netxml_validator_t *netxml_get_validator(const char *page)
+{
+	int	i;
+
+	for (i = 0; i < validators; i++) {
+		if (!strcmp(validator[i].page, page)) {
+			return &validator[i];
+		}
+	}
+
+	validator = xrealloc(validator, (validators + 1) * sizeof(*validator));
+
+	validator[validators].page = xstrdup(page);
+	validator[validators].etag = NULL;
+	validator[validators].lastmod = NULL;
+
+	return &validator[validators++];
+}
+
 static int netxml_alarm_subscribe(const char *page)
 {
 	int	ret, port = -1, secret = -1;
+	size_t	len;
 	char	buf[LARGEBUF], *s;
+	char	sockbuf[NETXML_SOCKBUF];
 	ne_request	*request;
 	ne_sock_addr	*addr;
 	const ne_inet_addr	*ai;
@@ -821,22 +919,125 @@ static int netxml_alarm_subscribe(const char *page)
 		return NE_RETRY;
 	}
 
-	ret = ne_sock_read(sock, buf, sizeof(buf));
+	ret = ne_sock_read(sock, sockbuf, sizeof(sockbuf) - 1);
 
 	if (ret < 1) {
 		upsdebugx(2, "%s: read failed: %s", __func__, ne_sock_error(sock));
 		return NE_RETRY;
 	}
 
-	if (strcasecmp(buf, "<Subscription Answer=\"ok\"></Subscription>")) {
+	sockbuf[ret] = '\0';
+
+	if (strcasecmp(sockbuf, "<Subscription Answer=\"ok\"></Subscription>")) {
 		upsdebugx(2, "%s: subscription rejected", __func__);
 		return NE_RETRY;
 	}
 
 	upslogx(LOG_INFO, "NSM connection to '%s' established", uri.host);
+
+	/* alarms sent right after the answer came in the same read */
+	len = strlen(sockbuf) + 1;
+
+	if ((size_t)ret > len) {
+		netxml_alarm_parse(sockbuf + len, ret - len);
+	}
+
 	return NE_OK;
 }
 
+/* Read (without blocking) and parse whatever the NMC sent on the subscription socket.
+ * Return NE_ERROR if the connection is lost, NE_OK otherwise. */
+static int netxml_alarm_read(void)
+{
+	int		i;
+	ssize_t		ret;
+	char		buf[NETXML_SOCKBUF];
+	fd_set		fds;
+	struct timeval	tv;
+
+	if (extrafd == -1) {
+		return NE_ERROR;
+	}
+
+	/* don't let a flood of alarms hold us here: we'll be called again right away */
+	for (i = 0; i < 16; i++) {
+
+		FD_ZERO(&fds);
+		FD_SET(extrafd, &fds);
+
+		tv.tv_sec = 0;
+		tv.tv_usec = 0;
+
+		if (select(extrafd + 1, &fds, NULL, NULL, &tv) < 1) {
+			break;
+		}
+
+		/* NETXML_SOCKBUF leaves nothing in neon's buffer, so select() tells the truth */
+		ret = ne_sock_read(sock, buf, sizeof(buf));
+
+		if (ret < 1) {
+			upsdebugx(2, "%s: ne_sock_read(%d) => %s", __func__, (int)ret, ne_sock_error(sock));
+			return NE_ERROR;
+		}
+
+		upsdebugx(2, "%s: ne_sock_read(%d bytes) => %.*s", __func__, (int)ret, (int)ret, buf);
+
+		netxml_alarm_parse(buf, ret);
+		time(&lastheard);
+	}
+
+	if (difftime(time(NULL), lastheard) >= 180) {
+		upsdebugx(2, "%s: nothing heard from the NMC for too long", __func__);
+		return NE_ERROR;
+	}
+
+	return NE_OK;
+}
+
+/* NSM messages are XML documents terminated by a '\0': feed them to a parser as they
+ * come, whatever the way they're split or coalesced by the reads, one parser per message */
+static void netxml_alarm_parse(const char *buf, size_t len)
+{
+	const char	*end;
+	size_t		n;
+
+	while (len > 0) {
+
+		end = memchr(buf, '\0', len);
+		n = end ? (size_t)(end - buf) : len;
+
+		if (n > 0) {
+
+			if (!alarm_parser) {
+				alarm_parser = ne_xml_create();
+				ne_xml_push_handler(alarm_parser, subdriver->startelm_cb, subdriver->cdata_cb, subdriver->endelm_cb, NULL);
+			}
+
+			ne_xml_parse(alarm_parser, buf, n);
+		}
+
+		if (end) {
+
+			if (alarm_parser) {
+				/* end of the document */
+				ne_xml_parse(alarm_parser, "", 0);
+
+				if (ne_xml_failed(alarm_parser)) {
+					upsdebugx(2, "%s: %s", __func__, ne_xml_get_error(alarm_parser));
+				}
+
+				ne_xml_destroy(alarm_parser);
+				alarm_parser = NULL;
+			}
+
+			n++;
+		}
+
+		buf += n;
+		len -= n;
+	}
+}
+
 static int netxml_dispatch_request(ne_request *request, ne_xml_parser *parser)
 {
 	int ret;
@@ -860,6 +1061,17 @@ static int netxml_dispatch_request(ne_request *request, ne_xml_parser *parser)
 			break;
 		}
 
+		/* Not modified: nothing to parse, keep what we got last time */
+		if (ne_get_status(request)->code == 304) {
+			ret = ne_discard_response(request);
+
+			if (ret == NE_OK) {
+				ret = ne_end_request(request);
+			}
+
+			continue;
+		}
+
 		ret = ne_xml_parse_response(request, parser);
 
 		if (ret == NE_OK) {
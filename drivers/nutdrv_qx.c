@@ -135,6 +135,19 @@ static struct {
 	char	answer[SMALLBUF];	/* Answer from the UPS, filled at runtime */
 } previous_item = { "", "" };	/* Hold the values of the item processed just before the actual one */
 
+/* Runtime buffers of the items */
+typedef struct {
+	char	answer[QX_BUFLEN];
+	char	value[QX_BUFLEN];
+} item_buf_t;
+
+static struct {
+	item_t		*qx2nut;	/* Table the buffers have been allocated for */
+	item_buf_t	*buf;		/* Array of buffers, one for every item that may talk to the UPS */
+	size_t		size;		/* Number of buffers in the array */
+	size_t		used;		/* Number of buffers already handed out to the items */
+} item_bufs = { NULL, NULL, 0, 0 };
+
 
 /* == Support functions == */
 static int	subdriver_matcher(void);
@@ -144,6 +157,8 @@ static bool_t	qx_ups_walk(walkmode_t mode);
 static void	ups_status_set(void);
 static void	ups_alarm_set(void);
 static void	qx_set_var(item_t *item);
+static void	qx_item_buf_get(item_t *item);
+static void	qx_item_buf_free(void);
 
 
 /* == Struct & data for status processing == */
@@ -2011,6 +2026,7 @@ void	upsdrv_cleanup(void)
 
 #endif	/* TESTING */
 
+	qx_item_buf_free();
 }
 
 
@@ -2448,10 +2464,13 @@ static bool_t	qx_ups_walk(walkmode_t mode)
 
 		}
 
+		/* Make sure the item has got its runtime buffers */
+		qx_item_buf_get(item);
+
 		/* Check whether the previous item uses the same command and then use its answer, if available.. */
 		if (strlen(previous_item.command) > 0 && strlen(previous_item.answer) > 0 && !strcasecmp(previous_item.command, item->command)) {
 
-			snprintf(item->answer, sizeof(item->answer), "%s", previous_item.answer);
+			snprintf(item->answer, QX_BUFLEN, "%s", previous_item.answer);
 
 			/* Process the answer */
 			retcode = qx_process_answer(item, strlen(item->answer));
@@ -2470,8 +2489,8 @@ static bool_t	qx_ups_walk(walkmode_t mode)
 		if (retcode) {
 
 			/* Clear data from the item */
-			memset(item->answer, 0, sizeof(item->answer));
-			memset(item->value, 0, sizeof(item->value));
+			memset(item->answer, 0, QX_BUFLEN);
+			memset(item->value, 0, QX_BUFLEN);
 
 			if (item->qxflags & QX_FLAG_QUICK_POLL)
 				return FALSE;
@@ -2489,8 +2508,8 @@ static bool_t	qx_ups_walk(walkmode_t mode)
 		retcode = ups_infoval_set(item);
 
 		/* Clear data from the item */
-		memset(item->answer, 0, sizeof(item->answer));
-		memset(item->value, 0, sizeof(item->value));
+		memset(item->answer, 0, QX_BUFLEN);
+		memset(item->value, 0, QX_BUFLEN);
 
 		/* Uh-oh! Some error! */
 		if (retcode == -1) {
@@ -2631,6 +2650,61 @@ item_t	*find_nut_info(const char *varname, const unsigned long flag, const unsig
 	return NULL;
 }
 
+/* Point item's answer and value to a free slot of the runtime buffers, if not already done.
+ * Buffers are allocated only when first needed, and only for the items of the current qx2nut table that may talk to the UPS (i.e. items not flagged as QX_FLAG_ABSENT):
+ * this way the tables themselves stay small and only the slots actually used get touched. */
+static void	qx_item_buf_get(item_t *item)
+{
+	item_t	*it;
+
+	if (item->answer && item->value)
+		return;
+
+	/* The subdriver changed (e.g. while trying to claim a device): start over with the new table */
+	if (item_bufs.qx2nut != subdriver->qx2nut) {
+
+		qx_item_buf_free();
+
+		for (it = subdriver->qx2nut; it->info_type != NULL; it++) {
+			if (!(it->qxflags & QX_FLAG_ABSENT))
+				item_bufs.size++;
+		}
+
+		item_bufs.buf = xcalloc(item_bufs.size ? item_bufs.size : 1, sizeof(*item_bufs.buf));
+		item_bufs.qx2nut = subdriver->qx2nut;
+
+		upsdebugx(4, "%s: allocated %d runtime buffers for the items of subdriver %s", __func__, (int)item_bufs.size, subdriver->name);
+
+	}
+
+	if (item_bufs.used >= item_bufs.size)
+		fatalx(EXIT_FAILURE, "%s: no runtime buffer available for %s", __func__, item->info_type);
+
+	item->answer = item_bufs.buf[item_bufs.used].answer;
+	item->value = item_bufs.buf[item_bufs.used].value;
+	item_bufs.used++;
+}
+
+/* Release the runtime buffers of the items, detaching them from the table they belong to */
+static void	qx_item_buf_free(void)
+{
+	item_t	*it;
+
+	if (item_bufs.qx2nut) {
+		for (it = item_bufs.qx2nut; it->info_type != NULL; it++) {
+			it->answer = NULL;
+			it->value = NULL;
+		}
+	}
+
+	free(item_bufs.buf);
+
+	item_bufs.qx2nut = NULL;
+	item_bufs.buf = NULL;
+	item_bufs.size = 0;
+	item_bufs.used = 0;
+}
+
 /* Process the answer we got back from the UPS
  * Return -1 on errors, 0 on success */
 static int	qx_process_answer(item_t *item, const int len)
@@ -2661,9 +2735,9 @@ static int	qx_process_answer(item_t *item, const int len)
 
 	/* Get value */
 	if (strlen(item->answer)) {
-		snprintf(item->value, sizeof(item->value), "%.*s", item->to ? 1 + item->to - item->from : (int)strcspn(item->answer, "\r") - item->from, item->answer + item->from);
+		snprintf(item->value, QX_BUFLEN, "%.*s", item->to ? 1 + item->to - item->from : (int)strcspn(item->answer, "\r") - item->from, item->answer + item->from);
 	} else {
-		snprintf(item->value, sizeof(item->value), "%s", "");
+		snprintf(item->value, QX_BUFLEN, "%s", "");
 	}
 
 	return 0;
@@ -2672,10 +2746,13 @@ static int	qx_process_answer(item_t *item, const int len)
 /* See header file for details. */
 int	qx_process(item_t *item, const char *command)
 {
-	char	buf[sizeof(item->answer) - 1] = "",
+	char	buf[QX_BUFLEN - 1] = "",
 		cmd[command ? (strlen(command) >= SMALLBUF ? strlen(command) + 1 : SMALLBUF) : (item->command && strlen(item->command) >= SMALLBUF ? strlen(item->command) + 1 : SMALLBUF)];
 	int	len;
 
+	/* Make sure the item has got its runtime buffers */
+	qx_item_buf_get(item);
+
 	/* Prepare the command to be used */
 	memset(cmd, 0, sizeof(cmd));
 	snprintf(cmd, sizeof(cmd), "%s", command ? command : item->command);
@@ -2692,7 +2769,7 @@ int	qx_process(item_t *item, const char *command)
 	/* Send the command */
 	len = qx_command(cmd, buf, sizeof(buf));
 
-	memset(item->answer, 0, sizeof(item->answer));
+	memset(item->answer, 0, QX_BUFLEN);
 	memcpy(item->answer, buf, sizeof(buf));
 
 	/* Preprocess the answer */
@@ -2701,7 +2778,7 @@ int	qx_process(item_t *item, const char *command)
 		if (len == -1) {
 			upsdebugx(4, "%s: failed to preprocess answer [%s]", __func__, item->info_type);
 			/* Clear answer, preventing it from being reused by next items with same command */
-			memset(item->answer, 0, sizeof(item->answer));
+			memset(item->answer, 0, QX_BUFLEN);
 			return -1;
 		}
 	}
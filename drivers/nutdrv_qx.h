@@ -71,12 +71,12 @@ typedef struct item_t {
 						 * If QX_FLAG_SETVAR is set the value given by the user will be checked against these infos. */
 	const char	*command;		/* Command sent to the UPS to get answer/to execute an instant command/to set a variable */
 
-	char		answer[SMALLBUF];	/* Answer from the UPS, filled at runtime.
+	char		*answer;		/* Answer from the UPS, filled at runtime: set it to NULL in the qx2nut table, the driver will point it to a QX_BUFLEN bytes buffer the first time the item is processed.
 						 * If you expect a nonvalid C string (e.g.: inner '\0's) or need to perform actions before the answer is used (and treated as a null-terminated string), you should set a preprocess_answer() function */
 	const int	answer_len;		/* Expected min length of the answer. Set it to 0 if there’s no minimum length to look after. */
 	const char	leading;		/* Expected leading character of the answer (optional) */
 
-	char		value[SMALLBUF];	/* Value from the answer, filled at runtime (i.e. answer between from and to) */
+	char		*value;			/* Value from the answer, filled at runtime (i.e. answer between from and to): set it to NULL in the qx2nut table, the driver will point it to a QX_BUFLEN bytes buffer the first time the item is processed */
 	const int	from;			/* Position of the starting character of the info (i.e. 'value') we're after in the answer */
 	const int	to;			/* Position of the ending character of the info (i.e. 'value') we're after in the answer: use 0 if all the remaining of the line is needed */
 
@@ -124,6 +124,8 @@ typedef struct item_t {
 
 #define MAXTRIES		3	/* Max number of retries */
 
+#define QX_BUFLEN		SMALLBUF	/* Size of the runtime buffers (answer/value) of an item */
+
 #ifdef TESTING
 /* Testing struct */
 typedef struct {
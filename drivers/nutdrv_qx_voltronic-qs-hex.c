@@ -71,7 +71,7 @@ static item_t	voltronic_qs_hex_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "ups.firmware.aux",		0,	NULL,	"M\r",	"",	2,	0,	"",	0,	0,	"PM-%s",	QX_FLAG_STATIC,	NULL,	NULL,	voltronic_qs_hex_protocol },
+	{ "ups.firmware.aux",		0,	NULL,	"M\r",	NULL,	2,	0,	NULL,	0,	0,	"PM-%s",	QX_FLAG_STATIC,	NULL,	NULL,	voltronic_qs_hex_protocol },
 
 	/* Query UPS for status
 	 * > [QS\r]
@@ -81,42 +81,42 @@ static item_t	voltronic_qs_hex_qx2nut[] = {
 	 *    0         1         2         3         4         5
 	 */
 
-	{ "input.voltage",		0,	NULL,	"QS\r",	"",	47,	'#',	"",	1,	7,	"%.1f",	0,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_input_output_voltage },
-	{ "output.voltage",		0,	NULL,	"QS\r",	"",	47,	'#',	"",	9,	15,	"%.1f",	0,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_input_output_voltage },
-	{ "ups.load",			0,	NULL,	"QS\r",	"",	47,	'#',	"",	17,	18,	"%d",	0,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_load },
-	{ "output.frequency",		0,	NULL,	"QS\r",	"",	47,	'#',	"",	20,	30,	"%.1f",	0,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_frequency },
-	{ "battery.voltage",		0,	NULL,	"QS\r",	"",	47,	'#',	"",	32,	36,	"%.2f",	0,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_battery_voltage },
+	{ "input.voltage",		0,	NULL,	"QS\r",	NULL,	47,	'#',	NULL,	1,	7,	"%.1f",	0,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_input_output_voltage },
+	{ "output.voltage",		0,	NULL,	"QS\r",	NULL,	47,	'#',	NULL,	9,	15,	"%.1f",	0,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_input_output_voltage },
+	{ "ups.load",			0,	NULL,	"QS\r",	NULL,	47,	'#',	NULL,	17,	18,	"%d",	0,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_load },
+	{ "output.frequency",		0,	NULL,	"QS\r",	NULL,	47,	'#',	NULL,	20,	30,	"%.1f",	0,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_frequency },
+	{ "battery.voltage",		0,	NULL,	"QS\r",	NULL,	47,	'#',	NULL,	32,	36,	"%.2f",	0,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_battery_voltage },
 	/* Status bits */
-	{ "ups.status",			0,	NULL,	"QS\r",	"",	47,	'#',	"",	38,	38,	NULL,	QX_FLAG_QUICK_POLL,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	blazer_process_status_bits },	/* Utility Fail (Immediate) */
-	{ "ups.status",			0,	NULL,	"QS\r",	"",	47,	'#',	"",	39,	39,	NULL,	QX_FLAG_QUICK_POLL,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	blazer_process_status_bits },	/* Battery Low */
-	{ "ups.status",			0,	NULL,	"QS\r",	"",	47,	'#',	"",	40,	40,	NULL,	QX_FLAG_QUICK_POLL,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	blazer_process_status_bits },	/* Bypass/Boost or Buck Active */
-	{ "ups.alarm",			0,	NULL,	"QS\r",	"",	47,	'#',	"",	41,	41,	NULL,	0,			NULL,	voltronic_qs_hex_preprocess_qs_answer,	blazer_process_status_bits },	/* UPS Failed */
-	{ "ups.type",			0,	NULL,	"QS\r",	"",	47,	'#',	"",	42,	42,	"%s",	QX_FLAG_STATIC,		NULL,	voltronic_qs_hex_preprocess_qs_answer,	blazer_process_status_bits },	/* UPS Type */
-	{ "ups.status",			0,	NULL,	"QS\r",	"",	47,	'#',	"",	43,	43,	NULL,	QX_FLAG_QUICK_POLL,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	blazer_process_status_bits },	/* Test in Progress */
-	{ "ups.status",			0,	NULL,	"QS\r",	"",	47,	'#',	"",	44,	44,	NULL,	QX_FLAG_QUICK_POLL,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	blazer_process_status_bits },	/* Shutdown Active */
-	{ "ups.beeper.status",		0,	NULL,	"QS\r",	"",	47,	'#',	"",	45,	45,	"%s",	0,			NULL,	voltronic_qs_hex_preprocess_qs_answer,	blazer_process_status_bits },	/* Beeper status */
+	{ "ups.status",			0,	NULL,	"QS\r",	NULL,	47,	'#',	NULL,	38,	38,	NULL,	QX_FLAG_QUICK_POLL,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	blazer_process_status_bits },	/* Utility Fail (Immediate) */
+	{ "ups.status",			0,	NULL,	"QS\r",	NULL,	47,	'#',	NULL,	39,	39,	NULL,	QX_FLAG_QUICK_POLL,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	blazer_process_status_bits },	/* Battery Low */
+	{ "ups.status",			0,	NULL,	"QS\r",	NULL,	47,	'#',	NULL,	40,	40,	NULL,	QX_FLAG_QUICK_POLL,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	blazer_process_status_bits },	/* Bypass/Boost or Buck Active */
+	{ "ups.alarm",			0,	NULL,	"QS\r",	NULL,	47,	'#',	NULL,	41,	41,	NULL,	0,			NULL,	voltronic_qs_hex_preprocess_qs_answer,	blazer_process_status_bits },	/* UPS Failed */
+	{ "ups.type",			0,	NULL,	"QS\r",	NULL,	47,	'#',	NULL,	42,	42,	"%s",	QX_FLAG_STATIC,		NULL,	voltronic_qs_hex_preprocess_qs_answer,	blazer_process_status_bits },	/* UPS Type */
+	{ "ups.status",			0,	NULL,	"QS\r",	NULL,	47,	'#',	NULL,	43,	43,	NULL,	QX_FLAG_QUICK_POLL,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	blazer_process_status_bits },	/* Test in Progress */
+	{ "ups.status",			0,	NULL,	"QS\r",	NULL,	47,	'#',	NULL,	44,	44,	NULL,	QX_FLAG_QUICK_POLL,	NULL,	voltronic_qs_hex_preprocess_qs_answer,	blazer_process_status_bits },	/* Shutdown Active */
+	{ "ups.beeper.status",		0,	NULL,	"QS\r",	NULL,	47,	'#',	NULL,	45,	45,	"%s",	0,			NULL,	voltronic_qs_hex_preprocess_qs_answer,	blazer_process_status_bits },	/* Beeper status */
 	/* Ratings bits */
-	{ "output.frequency.nominal",	0,	NULL,	"QS\r",	"",	56,	'#',	"",	47,	47,	"%.1f",	QX_FLAG_SKIP,		NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_process_ratings_bits },
-	{ "battery.voltage.nominal",	0,	NULL,	"QS\r",	"",	56,	'#',	"",	48,	49,	"%.1f",	QX_FLAG_SKIP,		NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_process_ratings_bits },
-/*	{ "reserved.1",			0,	NULL,	"QS\r",	"",	56,	'#',	"",	50,	50,	"%s",	QX_FLAG_SKIP,		NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_process_ratings_bits },	*//* Reserved */
-/*	{ "reserved.2",			0,	NULL,	"QS\r",	"",	56,	'#',	"",	51,	51,	"%s",	QX_FLAG_SKIP,		NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_process_ratings_bits },	*//* Reserved */
-	{ "output.voltage.nominal",	0,	NULL,	"QS\r",	"",	56,	'#',	"",	52,	54,	"%.1f",	QX_FLAG_SKIP,		NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_process_ratings_bits },
+	{ "output.frequency.nominal",	0,	NULL,	"QS\r",	NULL,	56,	'#',	NULL,	47,	47,	"%.1f",	QX_FLAG_SKIP,		NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_process_ratings_bits },
+	{ "battery.voltage.nominal",	0,	NULL,	"QS\r",	NULL,	56,	'#',	NULL,	48,	49,	"%.1f",	QX_FLAG_SKIP,		NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_process_ratings_bits },
+/*	{ "reserved.1",			0,	NULL,	"QS\r",	NULL,	56,	'#',	NULL,	50,	50,	"%s",	QX_FLAG_SKIP,		NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_process_ratings_bits },	*//* Reserved */
+/*	{ "reserved.2",			0,	NULL,	"QS\r",	NULL,	56,	'#',	NULL,	51,	51,	"%s",	QX_FLAG_SKIP,		NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_process_ratings_bits },	*//* Reserved */
+	{ "output.voltage.nominal",	0,	NULL,	"QS\r",	NULL,	56,	'#',	NULL,	52,	54,	"%.1f",	QX_FLAG_SKIP,		NULL,	voltronic_qs_hex_preprocess_qs_answer,	voltronic_qs_hex_process_ratings_bits },
 
 	/* Instant commands */
-	{ "beeper.toggle",		0,	NULL,	"Q\r",		"",	0,	0,	"",	0,	0,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
-	{ "load.off",			0,	NULL,	"S00R0000\r",	"",	0,	0,	"",	0,	0,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
-	{ "load.on",			0,	NULL,	"C\r",		"",	0,	0,	"",	0,	0,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
-	{ "shutdown.return",		0,	NULL,	"S%s\r",	"",	0,	0,	"",	0,	0,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	blazer_process_command },
-	{ "shutdown.stayoff",		0,	NULL,	"S%sR0000\r",	"",	0,	0,	"",	0,	0,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	blazer_process_command },
-	{ "shutdown.stop",		0,	NULL,	"C\r",		"",	0,	0,	"",	0,	0,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
-	{ "test.battery.start.quick",	0,	NULL,	"T\r",		"",	0,	0,	"",	0,	0,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "beeper.toggle",		0,	NULL,	"Q\r",		NULL,	0,	0,	NULL,	0,	0,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
+	{ "load.off",			0,	NULL,	"S00R0000\r",	NULL,	0,	0,	NULL,	0,	0,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
+	{ "load.on",			0,	NULL,	"C\r",		NULL,	0,	0,	NULL,	0,	0,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
+	{ "shutdown.return",		0,	NULL,	"S%s\r",	NULL,	0,	0,	NULL,	0,	0,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	blazer_process_command },
+	{ "shutdown.stayoff",		0,	NULL,	"S%sR0000\r",	NULL,	0,	0,	NULL,	0,	0,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	blazer_process_command },
+	{ "shutdown.stop",		0,	NULL,	"C\r",		NULL,	0,	0,	NULL,	0,	0,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
+	{ "test.battery.start.quick",	0,	NULL,	"T\r",		NULL,	0,	0,	NULL,	0,	0,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
 
 	/* Server-side settable vars */
-	{ "ups.delay.start",		ST_FLAG_RW,	voltronic_qs_hex_r_ondelay,	NULL,	"",	0,	0,	"",	0,	0,	DEFAULT_ONDELAY,	QX_FLAG_ABSENT | QX_FLAG_SETVAR | QX_FLAG_RANGE,	NULL,	NULL,	blazer_process_setvar },
-	{ "ups.delay.shutdown",		ST_FLAG_RW,	voltronic_qs_hex_r_offdelay,	NULL,	"",	0,	0,	"",	0,	0,	DEFAULT_OFFDELAY,	QX_FLAG_ABSENT | QX_FLAG_SETVAR | QX_FLAG_RANGE,	NULL,	NULL,	blazer_process_setvar },
+	{ "ups.delay.start",		ST_FLAG_RW,	voltronic_qs_hex_r_ondelay,	NULL,	NULL,	0,	0,	NULL,	0,	0,	DEFAULT_ONDELAY,	QX_FLAG_ABSENT | QX_FLAG_SETVAR | QX_FLAG_RANGE,	NULL,	NULL,	blazer_process_setvar },
+	{ "ups.delay.shutdown",		ST_FLAG_RW,	voltronic_qs_hex_r_offdelay,	NULL,	NULL,	0,	0,	NULL,	0,	0,	DEFAULT_OFFDELAY,	QX_FLAG_ABSENT | QX_FLAG_SETVAR | QX_FLAG_RANGE,	NULL,	NULL,	blazer_process_setvar },
 
 	/* End of structure. */
-	{ NULL,				0,	NULL,	NULL,		"",	0,	0,	"",	0,	0,	NULL,	0,	NULL,	NULL,	NULL }
+	{ NULL,				0,	NULL,	NULL,		NULL,	0,	0,	NULL,	0,	0,	NULL,	0,	NULL,	NULL,	NULL }
 };
 
 
@@ -275,7 +275,7 @@ static int	voltronic_qs_hex_preprocess_qs_answer(item_t *item, const int len)
 	upsdebugx(4, "read: %s", refined);
 
 	/* e.g.: item->answer = "#6C01 35 6C01 35 03 519A 1312D0 E6 1E 00001001" */
-	return snprintf(item->answer, sizeof(item->answer), "%s\r", refined);
+	return snprintf(item->answer, QX_BUFLEN, "%s\r", refined);
 }
 
 /* Transform a char into its binary form (as an int) */
@@ -972,7 +972,7 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "ups.firmware.aux",		0,	NULL,	"QPI\r",	"",	6,	'(',	"",	1,	4,	"%s",	QX_FLAG_STATIC,	NULL,	NULL,	voltronic_protocol },
+	{ "ups.firmware.aux",		0,	NULL,	"QPI\r",	NULL,	6,	'(',	NULL,	1,	4,	"%s",	QX_FLAG_STATIC,	NULL,	NULL,	voltronic_protocol },
 
 	/* Query UPS for ratings
 	 * > [QRI\r]
@@ -981,10 +981,10 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0         1         2
 	 */
 
-	{ "output.voltage.nominal",	0,	NULL,	"QRI\r",	"",	22,	'(',	"",	1,	5,	"%.1f",	QX_FLAG_STATIC,		NULL,	NULL,	NULL },
-	{ "output.current.nominal",	0,	NULL,	"QRI\r",	"",	22,	'(',	"",	7,	9,	"%.0f",	QX_FLAG_STATIC,		NULL,	NULL,	NULL },
-	{ "battery.voltage.nominal",	0,	NULL,	"QRI\r",	"",	22,	'(',	"",	11,	15,	"%.1f",	QX_FLAG_SEMI_STATIC,	NULL,	NULL,	NULL },	/* as *per battery pack*: the value will change when the number of batteries is changed (battery_number through BATNn) */
-	{ "output.frequency.nominal",	0,	NULL,	"QRI\r",	"",	22,	'(',	"",	17,	20,	"%.1f",	QX_FLAG_STATIC,		NULL,	NULL,	NULL },
+	{ "output.voltage.nominal",	0,	NULL,	"QRI\r",	NULL,	22,	'(',	NULL,	1,	5,	"%.1f",	QX_FLAG_STATIC,		NULL,	NULL,	NULL },
+	{ "output.current.nominal",	0,	NULL,	"QRI\r",	NULL,	22,	'(',	NULL,	7,	9,	"%.0f",	QX_FLAG_STATIC,		NULL,	NULL,	NULL },
+	{ "battery.voltage.nominal",	0,	NULL,	"QRI\r",	NULL,	22,	'(',	NULL,	11,	15,	"%.1f",	QX_FLAG_SEMI_STATIC,	NULL,	NULL,	NULL },	/* as *per battery pack*: the value will change when the number of batteries is changed (battery_number through BATNn) */
+	{ "output.frequency.nominal",	0,	NULL,	"QRI\r",	NULL,	22,	'(',	NULL,	17,	20,	"%.1f",	QX_FLAG_STATIC,		NULL,	NULL,	NULL },
 
 	/* Query UPS for ratings
 	 * > [QMD\r]
@@ -993,15 +993,15 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0         1         2         3         4
 	 */
 
-	{ "device.model",		0,	NULL,	"QMD\r",	"",	48,	'(',	"",	1,	15,	"%s",	QX_FLAG_STATIC | QX_FLAG_TRIM,	NULL,	NULL,	NULL },
-	{ "ups.power.nominal",		0,	NULL,	"QMD\r",	"",	48,	'(',	"",	17,	23,	"%s",	QX_FLAG_STATIC | QX_FLAG_TRIM,	NULL,	NULL,	NULL },
-	{ "output.powerfactor",		0,	NULL,	"QMD\r",	"",	48,	'(',	"",	25,	26,	"%.1f",	QX_FLAG_STATIC,	NULL,	NULL,	voltronic_output_powerfactor },
-	{ "input.phases",		0,	NULL,	"QMD\r",	"",	48,	'(',	"",	28,	28,	"%.0f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },
-	{ "output.phases",		0,	NULL,	"QMD\r",	"",	48,	'(',	"",	30,	30,	"%.0f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },
-	{ "input.voltage.nominal",	0,	NULL,	"QMD\r",	"",	48,	'(',	"",	32,	34,	"%.1f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },
-	{ "output.voltage.nominal",	0,	NULL,	"QMD\r",	"",	48,	'(',	"",	36,	38,	"%.1f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },	/* redundant with value from QRI */
-/*	{ "battery_number",		ST_FLAG_RW,	voltronic_r_batt_numb,	"QMD\r",	"",	48,	'(',	"",	40,	41,	"%d",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_batt_numb },	*//* redundant with value from QBV */
-/*	{ "battery.voltage.nominal",	0,	NULL,	"QMD\r",	"",	48,	'(',	"",	43,	46,	"%.1f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },	*//* as *per battery* vs *per pack* reported by QRI */
+	{ "device.model",		0,	NULL,	"QMD\r",	NULL,	48,	'(',	NULL,	1,	15,	"%s",	QX_FLAG_STATIC | QX_FLAG_TRIM,	NULL,	NULL,	NULL },
+	{ "ups.power.nominal",		0,	NULL,	"QMD\r",	NULL,	48,	'(',	NULL,	17,	23,	"%s",	QX_FLAG_STATIC | QX_FLAG_TRIM,	NULL,	NULL,	NULL },
+	{ "output.powerfactor",		0,	NULL,	"QMD\r",	NULL,	48,	'(',	NULL,	25,	26,	"%.1f",	QX_FLAG_STATIC,	NULL,	NULL,	voltronic_output_powerfactor },
+	{ "input.phases",		0,	NULL,	"QMD\r",	NULL,	48,	'(',	NULL,	28,	28,	"%.0f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },
+	{ "output.phases",		0,	NULL,	"QMD\r",	NULL,	48,	'(',	NULL,	30,	30,	"%.0f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },
+	{ "input.voltage.nominal",	0,	NULL,	"QMD\r",	NULL,	48,	'(',	NULL,	32,	34,	"%.1f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },
+	{ "output.voltage.nominal",	0,	NULL,	"QMD\r",	NULL,	48,	'(',	NULL,	36,	38,	"%.1f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },	/* redundant with value from QRI */
+/*	{ "battery_number",		ST_FLAG_RW,	voltronic_r_batt_numb,	"QMD\r",	NULL,	48,	'(',	NULL,	40,	41,	"%d",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_batt_numb },	*//* redundant with value from QBV */
+/*	{ "battery.voltage.nominal",	0,	NULL,	"QMD\r",	NULL,	48,	'(',	NULL,	43,	46,	"%.1f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },	*//* as *per battery* vs *per pack* reported by QRI */
 
 	/* Query UPS for ratings
 	 * > [F\r]
@@ -1010,10 +1010,10 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0         1         2
 	 */
 
-	{ "input.voltage.nominal",	0,	NULL,	"F\r",	"",	22,	'#',	"",	1,	5,	"%.1f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },
-	{ "input.current.nominal",	0,	NULL,	"F\r",	"",	22,	'#',	"",	7,	9,	"%.1f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },
-	{ "battery.voltage.nominal",	0,	NULL,	"F\r",	"",	22,	'#',	"",	11,	15,	"%.1f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },
-	{ "input.frequency.nominal",	0,	NULL,	"F\r",	"",	22,	'#',	"",	17,	20,	"%.1f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },
+	{ "input.voltage.nominal",	0,	NULL,	"F\r",	NULL,	22,	'#',	NULL,	1,	5,	"%.1f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },
+	{ "input.current.nominal",	0,	NULL,	"F\r",	NULL,	22,	'#',	NULL,	7,	9,	"%.1f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },
+	{ "battery.voltage.nominal",	0,	NULL,	"F\r",	NULL,	22,	'#',	NULL,	11,	15,	"%.1f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },
+	{ "input.frequency.nominal",	0,	NULL,	"F\r",	NULL,	22,	'#',	NULL,	17,	20,	"%.1f",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },
 
 	/* Query UPS for manufacturer
 	 * > [QMF\r]
@@ -1022,7 +1022,7 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0         1
 	 */
 
-	{ "device.mfr",		0,	NULL,	"QMF\r",	"",	2,	'(',	"",	1,	0,	"%s",	QX_FLAG_STATIC | QX_FLAG_TRIM,	NULL,	NULL,	NULL },
+	{ "device.mfr",		0,	NULL,	"QMF\r",	NULL,	2,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_STATIC | QX_FLAG_TRIM,	NULL,	NULL,	NULL },
 
 	/* Query UPS for firmware version
 	 * > [QVFW\r]
@@ -1031,7 +1031,7 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0         1
 	 */
 
-	{ "ups.firmware",	0,	NULL,	"QVFW\r",	"",	16,	'(',	"",	7,	14,	"%s",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },
+	{ "ups.firmware",	0,	NULL,	"QVFW\r",	NULL,	16,	'(',	NULL,	7,	14,	"%s",	QX_FLAG_STATIC,	NULL,	NULL,	NULL },
 
 	/* Query UPS for serial number
 	 * > [QID\r]
@@ -1040,7 +1040,7 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0         1
 	 */
 
-	{ "device.serial",	0,	NULL,	"QID\r",	"",	2,	'(',	"",	1,	0,	"%s",	QX_FLAG_STATIC,	NULL,	NULL,	voltronic_serial_numb },
+	{ "device.serial",	0,	NULL,	"QID\r",	NULL,	2,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_STATIC,	NULL,	NULL,	voltronic_serial_numb },
 
 	/* Query UPS for vendor infos
 	 * > [I\r]
@@ -1049,9 +1049,9 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0         1         2         3
 	 */
 
-	{ "device.mfr",		0,	NULL,	"I\r",	"",	39,	'#',	"",	1,	15,	"%s",	QX_FLAG_STATIC | QX_FLAG_TRIM,	NULL,	NULL,	NULL },
-	{ "device.model",	0,	NULL,	"I\r",	"",	39,	'#',	"",	17,	26,	"%s",	QX_FLAG_STATIC | QX_FLAG_TRIM,	NULL,	NULL,	NULL },
-	{ "ups.firmware",	0,	NULL,	"I\r",	"",	39,	'#',	"",	28,	37,	"%s",	QX_FLAG_STATIC | QX_FLAG_TRIM,	NULL,	NULL,	NULL },
+	{ "device.mfr",		0,	NULL,	"I\r",	NULL,	39,	'#',	NULL,	1,	15,	"%s",	QX_FLAG_STATIC | QX_FLAG_TRIM,	NULL,	NULL,	NULL },
+	{ "device.model",	0,	NULL,	"I\r",	NULL,	39,	'#',	NULL,	17,	26,	"%s",	QX_FLAG_STATIC | QX_FLAG_TRIM,	NULL,	NULL,	NULL },
+	{ "ups.firmware",	0,	NULL,	"I\r",	NULL,	39,	'#',	NULL,	28,	37,	"%s",	QX_FLAG_STATIC | QX_FLAG_TRIM,	NULL,	NULL,	NULL },
 
 	/* Query UPS for status
 	 * > [QGS\r]
@@ -1060,29 +1060,29 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0         1         2         3         4         5         6         7
 	 */
 
-	{ "input.voltage",	0,	NULL,	"QGS\r",	"",	76,	'(',	"",	1,	5,	"%.1f",	0,	NULL,	NULL,	NULL },
-	{ "input.frequency",	0,	NULL,	"QGS\r",	"",	76,	'(',	"",	7,	10,	"%.1f",	0,	NULL,	NULL,	NULL },
-	{ "output.voltage",	0,	NULL,	"QGS\r",	"",	76,	'(',	"",	12,	16,	"%.1f",	0,	NULL,	NULL,	NULL },
-	{ "output.frequency",	0,	NULL,	"QGS\r",	"",	76,	'(',	"",	18,	21,	"%.1f",	0,	NULL,	NULL,	NULL },
-	{ "output.current",	0,	NULL,	"QGS\r",	"",	76,	'(',	"",	23,	27,	"%.1f",	0,	NULL,	NULL,	NULL },
-	{ "ups.load",		0,	NULL,	"QGS\r",	"",	76,	'(',	"",	29,	31,	"%.0f",	0,	NULL,	NULL,	NULL },
-/*	{ "unknown.1",		0,	NULL,	"QGS\r",	"",	76,	'(',	"",	33,	37,	"%.1f",	0,	NULL,	NULL,	NULL },	*//* Unknown */
-/*	{ "unknown.2",		0,	NULL,	"QGS\r",	"",	76,	'(',	"",	39,	43,	"%.1f",	0,	NULL,	NULL,	NULL },	*//* Unknown */
-	{ "battery.voltage",	0,	NULL,	"QGS\r",	"",	76,	'(',	"",	45,	49,	"%.2f",	0,	NULL,	NULL,	NULL },
-/*	{ "unknown.3",		0,	NULL,	"QGS\r",	"",	76,	'(',	"",	51,	55,	"%.1f",	0,	NULL,	NULL,	NULL },	*//* Unknown */
-	{ "ups.temperature",	0,	NULL,	"QGS\r",	"",	76,	'(',	"",	57,	61,	"%.1f",	0,	NULL,	NULL,	NULL },
-	{ "ups.type",		0,	NULL,	"QGS\r",	"",	76,	'(',	"",	63,	64,	"%s",	QX_FLAG_SEMI_STATIC,	NULL,	NULL,	voltronic_status },
-	{ "ups.status",		0,	NULL,	"QGS\r",	"",	76,	'(',	"",	65,	65,	"%s",	QX_FLAG_QUICK_POLL,	NULL,	NULL,	voltronic_status },	/* Utility Fail (Immediate) */
-	{ "ups.status",		0,	NULL,	"QGS\r",	"",	76,	'(',	"",	66,	66,	"%s",	QX_FLAG_QUICK_POLL,	NULL,	NULL,	voltronic_status },	/* Battery Low */
-	{ "ups.status",		0,	NULL,	"QGS\r",	"",	76,	'(',	"",	67,	67,	"%s",	QX_FLAG_QUICK_POLL,	NULL,	NULL,	voltronic_status },	/* Bypass/Boost or Buck Active */
-	{ "ups.alarm",		0,	NULL,	"QGS\r",	"",	76,	'(',	"",	67,	67,	"%s",	0,			NULL,	NULL,	voltronic_status },	/* Bypass/Boost or Buck Active */
-	{ "ups.alarm",		0,	NULL,	"QGS\r",	"",	76,	'(',	"",	68,	68,	"%s",	0,			NULL,	NULL,	voltronic_status },	/* UPS Fault */
-/*	{ "unknown.4",		0,	NULL,	"QGS\r",	"",	76,	'(',	"",	69,	69,	"%s",	0,			NULL,	NULL,	voltronic_status },	*//* Unknown */
-	{ "ups.status",		0,	NULL,	"QGS\r",	"",	76,	'(',	"",	70,	70,	"%s",	QX_FLAG_QUICK_POLL,	NULL,	NULL,	voltronic_status },	/* Test in Progress */
-	{ "ups.status",		0,	NULL,	"QGS\r",	"",	76,	'(',	"",	71,	71,	"%s",	QX_FLAG_QUICK_POLL,	NULL,	NULL,	voltronic_status },	/* Shutdown Active */
-	{ "ups.beeper.status",	0,	NULL,	"QGS\r",	"",	76,	'(',	"",	72,	72,	"%s",	0,			NULL,	NULL,	voltronic_status },	/* Beeper status - ups.beeper.status */
-/*	{ "unknown.5",		0,	NULL,	"QGS\r",	"",	76,	'(',	"",	73,	73,	"%s",	0,			NULL,	NULL,	voltronic_status },	*//* Unknown */
-/*	{ "unknown.6",		0,	NULL,	"QGS\r",	"",	76,	'(',	"",	74,	74,	"%s",	0,			NULL,	NULL,	voltronic_status },	*//* Unknown */
+	{ "input.voltage",	0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	1,	5,	"%.1f",	0,	NULL,	NULL,	NULL },
+	{ "input.frequency",	0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	7,	10,	"%.1f",	0,	NULL,	NULL,	NULL },
+	{ "output.voltage",	0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	12,	16,	"%.1f",	0,	NULL,	NULL,	NULL },
+	{ "output.frequency",	0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	18,	21,	"%.1f",	0,	NULL,	NULL,	NULL },
+	{ "output.current",	0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	23,	27,	"%.1f",	0,	NULL,	NULL,	NULL },
+	{ "ups.load",		0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	29,	31,	"%.0f",	0,	NULL,	NULL,	NULL },
+/*	{ "unknown.1",		0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	33,	37,	"%.1f",	0,	NULL,	NULL,	NULL },	*//* Unknown */
+/*	{ "unknown.2",		0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	39,	43,	"%.1f",	0,	NULL,	NULL,	NULL },	*//* Unknown */
+	{ "battery.voltage",	0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	45,	49,	"%.2f",	0,	NULL,	NULL,	NULL },
+/*	{ "unknown.3",		0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	51,	55,	"%.1f",	0,	NULL,	NULL,	NULL },	*//* Unknown */
+	{ "ups.temperature",	0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	57,	61,	"%.1f",	0,	NULL,	NULL,	NULL },
+	{ "ups.type",		0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	63,	64,	"%s",	QX_FLAG_SEMI_STATIC,	NULL,	NULL,	voltronic_status },
+	{ "ups.status",		0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	65,	65,	"%s",	QX_FLAG_QUICK_POLL,	NULL,	NULL,	voltronic_status },	/* Utility Fail (Immediate) */
+	{ "ups.status",		0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	66,	66,	"%s",	QX_FLAG_QUICK_POLL,	NULL,	NULL,	voltronic_status },	/* Battery Low */
+	{ "ups.status",		0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	67,	67,	"%s",	QX_FLAG_QUICK_POLL,	NULL,	NULL,	voltronic_status },	/* Bypass/Boost or Buck Active */
+	{ "ups.alarm",		0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	67,	67,	"%s",	0,			NULL,	NULL,	voltronic_status },	/* Bypass/Boost or Buck Active */
+	{ "ups.alarm",		0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	68,	68,	"%s",	0,			NULL,	NULL,	voltronic_status },	/* UPS Fault */
+/*	{ "unknown.4",		0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	69,	69,	"%s",	0,			NULL,	NULL,	voltronic_status },	*//* Unknown */
+	{ "ups.status",		0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	70,	70,	"%s",	QX_FLAG_QUICK_POLL,	NULL,	NULL,	voltronic_status },	/* Test in Progress */
+	{ "ups.status",		0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	71,	71,	"%s",	QX_FLAG_QUICK_POLL,	NULL,	NULL,	voltronic_status },	/* Shutdown Active */
+	{ "ups.beeper.status",	0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	72,	72,	"%s",	0,			NULL,	NULL,	voltronic_status },	/* Beeper status - ups.beeper.status */
+/*	{ "unknown.5",		0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	73,	73,	"%s",	0,			NULL,	NULL,	voltronic_status },	*//* Unknown */
+/*	{ "unknown.6",		0,	NULL,	"QGS\r",	NULL,	76,	'(',	NULL,	74,	74,	"%s",	0,			NULL,	NULL,	voltronic_status },	*//* Unknown */
 
 	/* Query UPS for actual working mode
 	 * > [QMOD\r]
@@ -1091,8 +1091,8 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "ups.alarm",		0,	NULL,	"QMOD\r",	"",	3,	'(',	"",	1,	1,	"%s",	0,	NULL,	NULL,	voltronic_mode },
-	{ "ups.status",		0,	NULL,	"QMOD\r",	"",	3,	'(',	"",	1,	1,	"%s",	0,	NULL,	NULL,	voltronic_mode },
+	{ "ups.alarm",		0,	NULL,	"QMOD\r",	NULL,	3,	'(',	NULL,	1,	1,	"%s",	0,	NULL,	NULL,	voltronic_mode },
+	{ "ups.status",		0,	NULL,	"QMOD\r",	NULL,	3,	'(',	NULL,	1,	1,	"%s",	0,	NULL,	NULL,	voltronic_mode },
 
 	/* Query UPS for faults and their type. Unskipped when a fault is found in 12bit flag of QGS, otherwise you'll get a fake reply.
 	 * > [QFS\r]
@@ -1104,7 +1104,7 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0         1         2         3         4         5         6
 	 */
 
-	{ "ups.alarm",		0,	NULL,	"QFS\r",	"",	4,	'(',	"",	1,	2,	"%s",	QX_FLAG_SKIP,	NULL,	NULL,	voltronic_fault },
+	{ "ups.alarm",		0,	NULL,	"QFS\r",	NULL,	4,	'(',	NULL,	1,	2,	"%s",	QX_FLAG_SKIP,	NULL,	NULL,	voltronic_fault },
 
 	/* Query UPS for warnings and their type
 	 * > [QWS\r]
@@ -1113,7 +1113,7 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0         1         2         3         4         5         6
 	 */
 
-	{ "ups.alarm",		0,	NULL,	"QWS\r",	"",	66,	'(',	"",	1,	64,	"%s",	0,	NULL,	NULL,	voltronic_warning },
+	{ "ups.alarm",		0,	NULL,	"QWS\r",	NULL,	66,	'(',	NULL,	1,	64,	"%s",	0,	NULL,	NULL,	voltronic_warning },
 
 	/* Query UPS for actual infos about battery
 	 * > [QBV\r]
@@ -1122,11 +1122,11 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0         1         2
 	 */
 
-	{ "battery.voltage",	0,		NULL,			"QBV\r",	"",	21,	'(',	"",	1,	5,	"%.2f",	0,	NULL,	NULL,	NULL },
-	{ "battery_number",	ST_FLAG_RW,	voltronic_r_batt_numb,	"QBV\r",	"",	21,	'(',	"",	7,	9,	"%d",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_batt_numb },	/* Number of batteries that make a pack */
-	{ "battery.packs",	ST_FLAG_RW,	voltronic_r_batt_packs,	"QBV\r",	"",	21,	'(',	"",	10,	11,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE,	NULL,	NULL,	NULL },	/* Number of battery packs in parallel */
-	{ "battery.charge",	0,		NULL,			"QBV\r",	"",	21,	'(',	"",	13,	15,	"%.0f",	0,	NULL,	NULL,	NULL },
-	{ "battery.runtime",	0,		NULL,			"QBV\r",	"",	21,	'(',	"",	17,	19,	"%.0f",	0,	NULL,	NULL,	voltronic_batt_runtime },
+	{ "battery.voltage",	0,		NULL,			"QBV\r",	NULL,	21,	'(',	NULL,	1,	5,	"%.2f",	0,	NULL,	NULL,	NULL },
+	{ "battery_number",	ST_FLAG_RW,	voltronic_r_batt_numb,	"QBV\r",	NULL,	21,	'(',	NULL,	7,	9,	"%d",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_batt_numb },	/* Number of batteries that make a pack */
+	{ "battery.packs",	ST_FLAG_RW,	voltronic_r_batt_packs,	"QBV\r",	NULL,	21,	'(',	NULL,	10,	11,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE,	NULL,	NULL,	NULL },	/* Number of battery packs in parallel */
+	{ "battery.charge",	0,		NULL,			"QBV\r",	NULL,	21,	'(',	NULL,	13,	15,	"%.0f",	0,	NULL,	NULL,	NULL },
+	{ "battery.runtime",	0,		NULL,			"QBV\r",	NULL,	21,	'(',	NULL,	17,	19,	"%.0f",	0,	NULL,	NULL,	voltronic_batt_runtime },
 
 	/* Query UPS for last seen min/max load level
 	 * > [QLDL\r]
@@ -1135,8 +1135,8 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "output.power.minimum.percent",	0,	NULL,	"QLDL\r",	"",	9,	'(',	"",	1,	3,	"%.0f",	0,	NULL,	NULL,	NULL },
-	{ "output.power.maximum.percent",	0,	NULL,	"QLDL\r",	"",	9,	'(',	"",	5,	7,	"%.0f",	0,	NULL,	NULL,	NULL },
+	{ "output.power.minimum.percent",	0,	NULL,	"QLDL\r",	NULL,	9,	'(',	NULL,	1,	3,	"%.0f",	0,	NULL,	NULL,	NULL },
+	{ "output.power.maximum.percent",	0,	NULL,	"QLDL\r",	NULL,	9,	'(',	NULL,	5,	7,	"%.0f",	0,	NULL,	NULL,	NULL },
 
 	/* Query UPS for multi-phase voltages/frequencies
 	 * > [Q3**\r]
@@ -1169,50 +1169,50 @@ static item_t	voltronic_qx2nut[] = {
 	 */
 
 	/*	From Q3PV	*/
-	{ "input.L1-N.voltage",			0,	NULL,	"Q3PV\r",	"",	37,	'(',	"",	1,	5,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "input.L2-N.voltage",			0,	NULL,	"Q3PV\r",	"",	37,	'(',	"",	7,	11,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "input.L3-N.voltage",			0,	NULL,	"Q3PV\r",	"",	37,	'(',	"",	13,	17,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "input.L1-L2.voltage",		0,	NULL,	"Q3PV\r",	"",	37,	'(',	"",	19,	23,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "input.L2-L3.voltage",		0,	NULL,	"Q3PV\r",	"",	37,	'(',	"",	25,	29,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "input.L1-L3.voltage",		0,	NULL,	"Q3PV\r",	"",	37,	'(',	"",	31,	35,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-/*	{ "input.L1-L3.voltage",		0,	NULL,	"Q3PV\r",	"",	37,	'(',	"",	25,	29,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },	*//* P09 *//* Commented out because P09 should be two-phase input/output UPSes */
-/*	{ "input.L2-L3.voltage",		0,	NULL,	"Q3PV\r",	"",	37,	'(',	"",	31,	35,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },	*//* P09 *//* Commented out because P09 should be two-phase input/output UPSes */
+	{ "input.L1-N.voltage",			0,	NULL,	"Q3PV\r",	NULL,	37,	'(',	NULL,	1,	5,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "input.L2-N.voltage",			0,	NULL,	"Q3PV\r",	NULL,	37,	'(',	NULL,	7,	11,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "input.L3-N.voltage",			0,	NULL,	"Q3PV\r",	NULL,	37,	'(',	NULL,	13,	17,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "input.L1-L2.voltage",		0,	NULL,	"Q3PV\r",	NULL,	37,	'(',	NULL,	19,	23,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "input.L2-L3.voltage",		0,	NULL,	"Q3PV\r",	NULL,	37,	'(',	NULL,	25,	29,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "input.L1-L3.voltage",		0,	NULL,	"Q3PV\r",	NULL,	37,	'(',	NULL,	31,	35,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+/*	{ "input.L1-L3.voltage",		0,	NULL,	"Q3PV\r",	NULL,	37,	'(',	NULL,	25,	29,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },	*//* P09 *//* Commented out because P09 should be two-phase input/output UPSes */
+/*	{ "input.L2-L3.voltage",		0,	NULL,	"Q3PV\r",	NULL,	37,	'(',	NULL,	31,	35,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },	*//* P09 *//* Commented out because P09 should be two-phase input/output UPSes */
 
 	/*	From Q3PC	*/
-	{ "input.L1.current",			0,	NULL,	"Q3PC\r",	"",	13,	'(',	"",	1,	3,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "input.L2.current",			0,	NULL,	"Q3PC\r",	"",	13,	'(',	"",	5,	7,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "input.L3.current",			0,	NULL,	"Q3PC\r",	"",	13,	'(',	"",	9,	11,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "input.L1.current",			0,	NULL,	"Q3PC\r",	NULL,	13,	'(',	NULL,	1,	3,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "input.L2.current",			0,	NULL,	"Q3PC\r",	NULL,	13,	'(',	NULL,	5,	7,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "input.L3.current",			0,	NULL,	"Q3PC\r",	NULL,	13,	'(',	NULL,	9,	11,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
 
 	/*	From Q3OV	*/
-	{ "output.L1-N.voltage",		0,	NULL,	"Q3OV\r",	"",	37,	'(',	"",	1,	5,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "output.L2-N.voltage",		0,	NULL,	"Q3OV\r",	"",	37,	'(',	"",	7,	11,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "output.L3-N.voltage",		0,	NULL,	"Q3OV\r",	"",	37,	'(',	"",	13,	17,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "output.L1-L2.voltage",		0,	NULL,	"Q3OV\r",	"",	37,	'(',	"",	19,	23,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "output.L2-L3.voltage",		0,	NULL,	"Q3OV\r",	"",	37,	'(',	"",	25,	29,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "output.L1-L3.voltage",		0,	NULL,	"Q3OV\r",	"",	37,	'(',	"",	31,	35,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-/*	{ "output.L1-L3.voltage",		0,	NULL,	"Q3OV\r",	"",	37,	'(',	"",	25,	29,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },	*//* P09 *//* Commented out because P09 should be two-phase input/output UPSes */
-/*	{ "output.L2-L3.voltage",		0,	NULL,	"Q3OV\r",	"",	37,	'(',	"",	31,	35,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },	*//* P09 *//* Commented out because P09 should be two-phase input/output UPSes */
+	{ "output.L1-N.voltage",		0,	NULL,	"Q3OV\r",	NULL,	37,	'(',	NULL,	1,	5,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "output.L2-N.voltage",		0,	NULL,	"Q3OV\r",	NULL,	37,	'(',	NULL,	7,	11,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "output.L3-N.voltage",		0,	NULL,	"Q3OV\r",	NULL,	37,	'(',	NULL,	13,	17,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "output.L1-L2.voltage",		0,	NULL,	"Q3OV\r",	NULL,	37,	'(',	NULL,	19,	23,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "output.L2-L3.voltage",		0,	NULL,	"Q3OV\r",	NULL,	37,	'(',	NULL,	25,	29,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "output.L1-L3.voltage",		0,	NULL,	"Q3OV\r",	NULL,	37,	'(',	NULL,	31,	35,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+/*	{ "output.L1-L3.voltage",		0,	NULL,	"Q3OV\r",	NULL,	37,	'(',	NULL,	25,	29,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },	*//* P09 *//* Commented out because P09 should be two-phase input/output UPSes */
+/*	{ "output.L2-L3.voltage",		0,	NULL,	"Q3OV\r",	NULL,	37,	'(',	NULL,	31,	35,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },	*//* P09 *//* Commented out because P09 should be two-phase input/output UPSes */
 
 	/*	From Q3OC	*/
-	{ "output.L1.current",			0,	NULL,	"Q3OC\r",	"",	13,	'(',	"",	1,	3,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "output.L2.current",			0,	NULL,	"Q3OC\r",	"",	13,	'(',	"",	5,	7,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "output.L3.current",			0,	NULL,	"Q3OC\r",	"",	13,	'(',	"",	9,	11,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "output.L1.current",			0,	NULL,	"Q3OC\r",	NULL,	13,	'(',	NULL,	1,	3,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "output.L2.current",			0,	NULL,	"Q3OC\r",	NULL,	13,	'(',	NULL,	5,	7,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "output.L3.current",			0,	NULL,	"Q3OC\r",	NULL,	13,	'(',	NULL,	9,	11,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
 
 	/*	From Q3LD	*/
-	{ "output.L1.power.percent",		0,	NULL,	"Q3LD\r",	"",	13,	'(',	"",	1,	3,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "output.L2.power.percent",		0,	NULL,	"Q3LD\r",	"",	13,	'(',	"",	5,	7,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "output.L3.power.percent",		0,	NULL,	"Q3LD\r",	"",	13,	'(',	"",	9,	11,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "output.L1.power.percent",		0,	NULL,	"Q3LD\r",	NULL,	13,	'(',	NULL,	1,	3,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "output.L2.power.percent",		0,	NULL,	"Q3LD\r",	NULL,	13,	'(',	NULL,	5,	7,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "output.L3.power.percent",		0,	NULL,	"Q3LD\r",	NULL,	13,	'(',	NULL,	9,	11,	"%.0f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
 
 	/*	From Q3YV	*/
-	{ "output.bypass.L1-N.voltage",		0,	NULL,	"Q3YV\r",	"",	37,	'(',	"",	1,	5,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "output.bypass.L2-N.voltage",		0,	NULL,	"Q3YV\r",	"",	37,	'(',	"",	7,	11,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "output.bypass.L3-N.voltage",		0,	NULL,	"Q3YV\r",	"",	37,	'(',	"",	13,	17,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "output.bypass.L1-N.voltage",		0,	NULL,	"Q3YV\r",	"",	19,	'(',	"",	1,	5,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },	/* P09 */
-	{ "output.bypass.L2-N.voltage",		0,	NULL,	"Q3YV\r",	"",	19,	'(',	"",	7,	11,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },	/* P09 */
-/*	{ "output.bypass.L3-N.voltage",		0,	NULL,	"Q3YV\r",	"",	19,	'(',	"",	13,	17,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },	*//* P09 *//* Commented out because P09 should be two-phase input/output UPSes */
-	{ "output.bypass.L1-L2.voltage",	0,	NULL,	"Q3YV\r",	"",	37,	'(',	"",	19,	23,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "output.bypass.L2-L3.voltage",	0,	NULL,	"Q3YV\r",	"",	37,	'(',	"",	25,	29,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "output.bypass.L1-L3.voltage",	0,	NULL,	"Q3YV\r",	"",	37,	'(',	"",	31,	35,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "output.bypass.L1-N.voltage",		0,	NULL,	"Q3YV\r",	NULL,	37,	'(',	NULL,	1,	5,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "output.bypass.L2-N.voltage",		0,	NULL,	"Q3YV\r",	NULL,	37,	'(',	NULL,	7,	11,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "output.bypass.L3-N.voltage",		0,	NULL,	"Q3YV\r",	NULL,	37,	'(',	NULL,	13,	17,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "output.bypass.L1-N.voltage",		0,	NULL,	"Q3YV\r",	NULL,	19,	'(',	NULL,	1,	5,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },	/* P09 */
+	{ "output.bypass.L2-N.voltage",		0,	NULL,	"Q3YV\r",	NULL,	19,	'(',	NULL,	7,	11,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },	/* P09 */
+/*	{ "output.bypass.L3-N.voltage",		0,	NULL,	"Q3YV\r",	NULL,	19,	'(',	NULL,	13,	17,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },	*//* P09 *//* Commented out because P09 should be two-phase input/output UPSes */
+	{ "output.bypass.L1-L2.voltage",	0,	NULL,	"Q3YV\r",	NULL,	37,	'(',	NULL,	19,	23,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "output.bypass.L2-L3.voltage",	0,	NULL,	"Q3YV\r",	NULL,	37,	'(',	NULL,	25,	29,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "output.bypass.L1-L3.voltage",	0,	NULL,	"Q3YV\r",	NULL,	37,	'(',	NULL,	31,	35,	"%.1f",	QX_FLAG_SKIP,	NULL,	NULL,	NULL },
 
 	/* Query UPS for capability - total options available: 23; only those whom the UPS is capable of are reported as Enabled or Disabled
 	 * > [QFLAG\r]
@@ -1221,24 +1221,24 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0         1	* min length = ( + E + D + \r = 4
 	 */
 
-	{ "ups.start.auto",		ST_FLAG_RW,	voltronic_e_cap,	"QFLAG\r",	"",	4,	'(',	"",	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_ENUM,	NULL,	NULL,	voltronic_capability },
-	{ "battery.protection",		ST_FLAG_RW,	voltronic_e_cap,	"QFLAG\r",	"",	4,	'(',	"",	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_ENUM,	NULL,	NULL,	voltronic_capability },
-	{ "battery.energysave",		ST_FLAG_RW,	voltronic_e_cap,	"QFLAG\r",	"",	4,	'(',	"",	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_ENUM,	NULL,	NULL,	voltronic_capability },
-	{ "ups.start.battery",		ST_FLAG_RW,	voltronic_e_cap,	"QFLAG\r",	"",	4,	'(',	"",	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_ENUM,	NULL,	NULL,	voltronic_capability },
-	{ "outlet.0.switchable",	ST_FLAG_RW,	voltronic_e_cap,	"QFLAG\r",	"",	4,	'(',	"",	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_ENUM,	NULL,	NULL,	voltronic_capability },
+	{ "ups.start.auto",		ST_FLAG_RW,	voltronic_e_cap,	"QFLAG\r",	NULL,	4,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_ENUM,	NULL,	NULL,	voltronic_capability },
+	{ "battery.protection",		ST_FLAG_RW,	voltronic_e_cap,	"QFLAG\r",	NULL,	4,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_ENUM,	NULL,	NULL,	voltronic_capability },
+	{ "battery.energysave",		ST_FLAG_RW,	voltronic_e_cap,	"QFLAG\r",	NULL,	4,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_ENUM,	NULL,	NULL,	voltronic_capability },
+	{ "ups.start.battery",		ST_FLAG_RW,	voltronic_e_cap,	"QFLAG\r",	NULL,	4,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_ENUM,	NULL,	NULL,	voltronic_capability },
+	{ "outlet.0.switchable",	ST_FLAG_RW,	voltronic_e_cap,	"QFLAG\r",	NULL,	4,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_ENUM,	NULL,	NULL,	voltronic_capability },
 	/* Not available in NUT */
-	{ "bypass_alarm",		0,	NULL,	"QFLAG\r",	"",	4,	'(',	"",	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
-	{ "battery_alarm",		0,	NULL,	"QFLAG\r",	"",	4,	'(',	"",	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
-	{ "bypass_when_off",		0,	NULL,	"QFLAG\r",	"",	4,	'(',	"",	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
-	{ "alarm_control",		0,	NULL,	"QFLAG\r",	"",	4,	'(',	"",	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
-	{ "converter_mode",		0,	NULL,	"QFLAG\r",	"",	4,	'(',	"",	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
-	{ "eco_mode",			0,	NULL,	"QFLAG\r",	"",	4,	'(',	"",	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
-	{ "battery_open_status_check",	0,	NULL,	"QFLAG\r",	"",	4,	'(',	"",	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
-	{ "bypass_forbidding",		0,	NULL,	"QFLAG\r",	"",	4,	'(',	"",	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
-	{ "site_fault_detection",	0,	NULL,	"QFLAG\r",	"",	4,	'(',	"",	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
-	{ "advanced_eco_mode",		0,	NULL,	"QFLAG\r",	"",	4,	'(',	"",	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
-	{ "constant_phase_angle",	0,	NULL,	"QFLAG\r",	"",	4,	'(',	"",	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
-	{ "limited_runtime_on_battery",	0,	NULL,	"QFLAG\r",	"",	4,	'(',	"",	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
+	{ "bypass_alarm",		0,	NULL,	"QFLAG\r",	NULL,	4,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
+	{ "battery_alarm",		0,	NULL,	"QFLAG\r",	NULL,	4,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
+	{ "bypass_when_off",		0,	NULL,	"QFLAG\r",	NULL,	4,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
+	{ "alarm_control",		0,	NULL,	"QFLAG\r",	NULL,	4,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
+	{ "converter_mode",		0,	NULL,	"QFLAG\r",	NULL,	4,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
+	{ "eco_mode",			0,	NULL,	"QFLAG\r",	NULL,	4,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
+	{ "battery_open_status_check",	0,	NULL,	"QFLAG\r",	NULL,	4,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
+	{ "bypass_forbidding",		0,	NULL,	"QFLAG\r",	NULL,	4,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
+	{ "site_fault_detection",	0,	NULL,	"QFLAG\r",	NULL,	4,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
+	{ "advanced_eco_mode",		0,	NULL,	"QFLAG\r",	NULL,	4,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
+	{ "constant_phase_angle",	0,	NULL,	"QFLAG\r",	NULL,	4,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
+	{ "limited_runtime_on_battery",	0,	NULL,	"QFLAG\r",	NULL,	4,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_capability },
 
 	/*   Enable	or	  Disable	or	Reset to safe default values	capability options
 	 * > [PEX\r]		> [PDX\r]		> [PF\r]
@@ -1247,25 +1247,25 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0			   0			   0
 	 */
 
-	{ "ups.start.auto",		0,	voltronic_e_cap,	"P%sR\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set },
-	{ "battery.protection",		0,	voltronic_e_cap,	"P%sS\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set },
-	{ "battery.energysave",		0,	voltronic_e_cap,	"P%sG\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set },
-	{ "ups.start.battery",		0,	voltronic_e_cap,	"P%sC\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set },
-	{ "outlet.0.switchable",	0,	voltronic_e_cap,	"P%sJ\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set },
+	{ "ups.start.auto",		0,	voltronic_e_cap,	"P%sR\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set },
+	{ "battery.protection",		0,	voltronic_e_cap,	"P%sS\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set },
+	{ "battery.energysave",		0,	voltronic_e_cap,	"P%sG\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set },
+	{ "ups.start.battery",		0,	voltronic_e_cap,	"P%sC\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set },
+	{ "outlet.0.switchable",	0,	voltronic_e_cap,	"P%sJ\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set },
 	/* Not available in NUT */
-	{ "reset_to_default",		0,	NULL,			"PF\r",		"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_reset },
-	{ "bypass_alarm",		0,	voltronic_e_cap_nonut,	"P%sP\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
-	{ "battery_alarm",		0,	voltronic_e_cap_nonut,	"P%sB\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
-	{ "bypass_when_off",		0,	voltronic_e_cap_nonut,	"P%sO\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
-	{ "alarm_control",		0,	voltronic_e_cap_nonut,	"P%sA\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
-	{ "converter_mode",		0,	voltronic_e_cap_nonut,	"P%sV\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
-	{ "eco_mode",			0,	voltronic_e_cap_nonut,	"P%sE\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
-	{ "battery_open_status_check",	0,	voltronic_e_cap_nonut,	"P%sD\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
-	{ "bypass_forbidding",		0,	voltronic_e_cap_nonut,	"P%sF\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
-	{ "site_fault_detection",	0,	voltronic_e_cap_nonut,	"P%sL\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
-	{ "advanced_eco_mode",		0,	voltronic_e_cap_nonut,	"P%sN\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
-	{ "constant_phase_angle",	0,	voltronic_e_cap_nonut,	"P%sQ\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
-	{ "limited_runtime_on_battery",	0,	voltronic_e_cap_nonut,	"P%sW\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
+	{ "reset_to_default",		0,	NULL,			"PF\r",		NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_reset },
+	{ "bypass_alarm",		0,	voltronic_e_cap_nonut,	"P%sP\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
+	{ "battery_alarm",		0,	voltronic_e_cap_nonut,	"P%sB\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
+	{ "bypass_when_off",		0,	voltronic_e_cap_nonut,	"P%sO\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
+	{ "alarm_control",		0,	voltronic_e_cap_nonut,	"P%sA\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
+	{ "converter_mode",		0,	voltronic_e_cap_nonut,	"P%sV\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
+	{ "eco_mode",			0,	voltronic_e_cap_nonut,	"P%sE\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
+	{ "battery_open_status_check",	0,	voltronic_e_cap_nonut,	"P%sD\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
+	{ "bypass_forbidding",		0,	voltronic_e_cap_nonut,	"P%sF\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
+	{ "site_fault_detection",	0,	voltronic_e_cap_nonut,	"P%sL\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
+	{ "advanced_eco_mode",		0,	voltronic_e_cap_nonut,	"P%sN\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
+	{ "constant_phase_angle",	0,	voltronic_e_cap_nonut,	"P%sQ\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
+	{ "limited_runtime_on_battery",	0,	voltronic_e_cap_nonut,	"P%sW\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_capability_set_nonut },
 
 	/* Query UPS for programmable outlet (1-4) status
 	 * > [QSK1\r]
@@ -1274,14 +1274,14 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "outlet.1.switchable",	0,	NULL,	"QSK1\r",	"",	3,	'(',	"",	1,	1,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet },
-	{ "outlet.1.status",		0,	NULL,	"QSK1\r",	"",	3,	'(',	"",	1,	1,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet },
-	{ "outlet.2.switchable",	0,	NULL,	"QSK2\r",	"",	3,	'(',	"",	1,	1,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet },
-	{ "outlet.2.status",		0,	NULL,	"QSK2\r",	"",	3,	'(',	"",	1,	1,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet },
-	{ "outlet.3.switchable",	0,	NULL,	"QSK3\r",	"",	3,	'(',	"",	1,	1,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet },
-	{ "outlet.3.status",		0,	NULL,	"QSK3\r",	"",	3,	'(',	"",	1,	1,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet },
-	{ "outlet.4.switchable",	0,	NULL,	"QSK4\r",	"",	3,	'(',	"",	1,	1,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet },
-	{ "outlet.4.status",		0,	NULL,	"QSK4\r",	"",	3,	'(',	"",	1,	1,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet },
+	{ "outlet.1.switchable",	0,	NULL,	"QSK1\r",	NULL,	3,	'(',	NULL,	1,	1,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet },
+	{ "outlet.1.status",		0,	NULL,	"QSK1\r",	NULL,	3,	'(',	NULL,	1,	1,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet },
+	{ "outlet.2.switchable",	0,	NULL,	"QSK2\r",	NULL,	3,	'(',	NULL,	1,	1,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet },
+	{ "outlet.2.status",		0,	NULL,	"QSK2\r",	NULL,	3,	'(',	NULL,	1,	1,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet },
+	{ "outlet.3.switchable",	0,	NULL,	"QSK3\r",	NULL,	3,	'(',	NULL,	1,	1,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet },
+	{ "outlet.3.status",		0,	NULL,	"QSK3\r",	NULL,	3,	'(',	NULL,	1,	1,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet },
+	{ "outlet.4.switchable",	0,	NULL,	"QSK4\r",	NULL,	3,	'(',	NULL,	1,	1,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet },
+	{ "outlet.4.status",		0,	NULL,	"QSK4\r",	NULL,	3,	'(',	NULL,	1,	1,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet },
 
 	/* Query UPS for programmable outlet n (1-4) delay time before it shuts down the load when on battery mode
 	 * > [QSKT1\r]
@@ -1290,10 +1290,10 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "outlet.1.delay.shutdown",	ST_FLAG_RW,	voltronic_r_outlet_delay,	"QSKT1\r",	"",	5,	'(',	"",	1,	3,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet_delay },
-	{ "outlet.2.delay.shutdown",	ST_FLAG_RW,	voltronic_r_outlet_delay,	"QSKT2\r",	"",	5,	'(',	"",	1,	3,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet_delay },
-	{ "outlet.3.delay.shutdown",	ST_FLAG_RW,	voltronic_r_outlet_delay,	"QSKT3\r",	"",	5,	'(',	"",	1,	3,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet_delay },
-	{ "outlet.4.delay.shutdown",	ST_FLAG_RW,	voltronic_r_outlet_delay,	"QSKT4\r",	"",	5,	'(',	"",	1,	3,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet_delay },
+	{ "outlet.1.delay.shutdown",	ST_FLAG_RW,	voltronic_r_outlet_delay,	"QSKT1\r",	NULL,	5,	'(',	NULL,	1,	3,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet_delay },
+	{ "outlet.2.delay.shutdown",	ST_FLAG_RW,	voltronic_r_outlet_delay,	"QSKT2\r",	NULL,	5,	'(',	NULL,	1,	3,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet_delay },
+	{ "outlet.3.delay.shutdown",	ST_FLAG_RW,	voltronic_r_outlet_delay,	"QSKT3\r",	NULL,	5,	'(',	NULL,	1,	3,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet_delay },
+	{ "outlet.4.delay.shutdown",	ST_FLAG_RW,	voltronic_r_outlet_delay,	"QSKT4\r",	NULL,	5,	'(',	NULL,	1,	3,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet_delay },
 
 	/* Set delay time for programmable outlets
 	 * > [PSK1nnn\r]	n = 0..9
@@ -1302,10 +1302,10 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "outlet.1.delay.shutdown",	0,	voltronic_r_outlet_delay,	"PSK1%03d\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet_delay_set },
-	{ "outlet.2.delay.shutdown",	0,	voltronic_r_outlet_delay,	"PSK2%03d\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet_delay_set },
-	{ "outlet.3.delay.shutdown",	0,	voltronic_r_outlet_delay,	"PSK3%03d\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet_delay_set },
-	{ "outlet.4.delay.shutdown",	0,	voltronic_r_outlet_delay,	"PSK4%03d\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet_delay_set },
+	{ "outlet.1.delay.shutdown",	0,	voltronic_r_outlet_delay,	"PSK1%03d\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet_delay_set },
+	{ "outlet.2.delay.shutdown",	0,	voltronic_r_outlet_delay,	"PSK2%03d\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet_delay_set },
+	{ "outlet.3.delay.shutdown",	0,	voltronic_r_outlet_delay,	"PSK3%03d\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet_delay_set },
+	{ "outlet.4.delay.shutdown",	0,	voltronic_r_outlet_delay,	"PSK4%03d\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_outlet_delay_set },
 
 	/* Query UPS for ECO Mode voltage limits
 	 * > [QHE\r]
@@ -1314,12 +1314,12 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "input.transfer.high",	ST_FLAG_RW,	voltronic_r_eco_volt_max,	"QHE\r",	"",	9,	'(',	"",	1,	3,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_eco_volt },
-	{ "input.transfer.low",		ST_FLAG_RW,	voltronic_r_eco_volt_min,	"QHE\r",	"",	9,	'(',	"",	5,	7,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_eco_volt },
-	{ "input.transfer.low.min",	0,		NULL,				"QHE\r",	"",	9,	'(',	"",	5,	7,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,			NULL,	NULL,	voltronic_eco_volt_range },
-	{ "input.transfer.low.max",	0,		NULL,				"QHE\r",	"",	9,	'(',	"",	5,	7,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,			NULL,	NULL,	voltronic_eco_volt_range },
-	{ "input.transfer.high.min",	0,		NULL,				"QHE\r",	"",	9,	'(',	"",	1,	3,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,			NULL,	NULL,	voltronic_eco_volt_range },
-	{ "input.transfer.high.max",	0,		NULL,				"QHE\r",	"",	9,	'(',	"",	1,	3,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,			NULL,	NULL,	voltronic_eco_volt_range },
+	{ "input.transfer.high",	ST_FLAG_RW,	voltronic_r_eco_volt_max,	"QHE\r",	NULL,	9,	'(',	NULL,	1,	3,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_eco_volt },
+	{ "input.transfer.low",		ST_FLAG_RW,	voltronic_r_eco_volt_min,	"QHE\r",	NULL,	9,	'(',	NULL,	5,	7,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_eco_volt },
+	{ "input.transfer.low.min",	0,		NULL,				"QHE\r",	NULL,	9,	'(',	NULL,	5,	7,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,			NULL,	NULL,	voltronic_eco_volt_range },
+	{ "input.transfer.low.max",	0,		NULL,				"QHE\r",	NULL,	9,	'(',	NULL,	5,	7,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,			NULL,	NULL,	voltronic_eco_volt_range },
+	{ "input.transfer.high.min",	0,		NULL,				"QHE\r",	NULL,	9,	'(',	NULL,	1,	3,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,			NULL,	NULL,	voltronic_eco_volt_range },
+	{ "input.transfer.high.max",	0,		NULL,				"QHE\r",	NULL,	9,	'(',	NULL,	1,	3,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_SKIP,			NULL,	NULL,	voltronic_eco_volt_range },
 
 	/* Set ECO Mode voltage limits
 	 * > [HEHnnn\r]		> [HELnnn\r]		n = 0..9
@@ -1328,8 +1328,8 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0			   0
 	 */
 
-	{ "input.transfer.high",	0,	voltronic_r_eco_volt_max,	"HEH%03.0f\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_process_setvar },
-	{ "input.transfer.low",		0,	voltronic_r_eco_volt_min,	"HEL%03.0f\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_process_setvar },
+	{ "input.transfer.high",	0,	voltronic_r_eco_volt_max,	"HEH%03.0f\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_process_setvar },
+	{ "input.transfer.low",		0,	voltronic_r_eco_volt_min,	"HEL%03.0f\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_process_setvar },
 
 	/* Query UPS for ECO Mode frequency limits
 	 * > [QFRE\r]
@@ -1338,8 +1338,8 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0         1
 	 */
 
-	{ "input.frequency.high",	ST_FLAG_RW,	voltronic_r_eco_freq_max,	"QFRE\r",	"",	11,	'(',	"",	1,	4,	"%.1f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_eco_freq },
-	{ "input.frequency.low",	ST_FLAG_RW,	voltronic_r_eco_freq_min,	"QFRE\r",	"",	11,	'(',	"",	6,	9,	"%.1f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_eco_freq },
+	{ "input.frequency.high",	ST_FLAG_RW,	voltronic_r_eco_freq_max,	"QFRE\r",	NULL,	11,	'(',	NULL,	1,	4,	"%.1f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_eco_freq },
+	{ "input.frequency.low",	ST_FLAG_RW,	voltronic_r_eco_freq_min,	"QFRE\r",	NULL,	11,	'(',	NULL,	6,	9,	"%.1f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_eco_freq },
 
 	/* Set ECO Mode frequency limits
 	 * > [FREHnn.n\r]	> [FRELnn.n\r]		n = 0..9
@@ -1348,8 +1348,8 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0			   0
 	 */
 
-	{ "input.frequency.high",	0,	voltronic_r_eco_freq_max,	"FREH%04.1f\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_process_setvar },
-	{ "input.frequency.low",	0,	voltronic_r_eco_freq_min,	"FREL%04.1f\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_process_setvar },
+	{ "input.frequency.high",	0,	voltronic_r_eco_freq_max,	"FREH%04.1f\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_process_setvar },
+	{ "input.frequency.low",	0,	voltronic_r_eco_freq_min,	"FREL%04.1f\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_process_setvar },
 
 	/* Query UPS for Bypass Mode voltage limits
 	 * > [QBYV\r]
@@ -1358,8 +1358,8 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "max_bypass_volt",	ST_FLAG_RW,	voltronic_r_bypass_volt_max,	"QBYV\r",	"",	9,	'(',	"",	1,	3,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_bypass },
-	{ "min_bypass_volt",	ST_FLAG_RW,	voltronic_r_bypass_volt_min,	"QBYV\r",	"",	9,	'(',	"",	5,	7,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_bypass },
+	{ "max_bypass_volt",	ST_FLAG_RW,	voltronic_r_bypass_volt_max,	"QBYV\r",	NULL,	9,	'(',	NULL,	1,	3,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_bypass },
+	{ "min_bypass_volt",	ST_FLAG_RW,	voltronic_r_bypass_volt_min,	"QBYV\r",	NULL,	9,	'(',	NULL,	5,	7,	"%.0f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_bypass },
 
 	/* Set Bypass Mode voltage limits
 	 * > [PHVnnn\r]		> [PLVnnn\r]		n = 0..9
@@ -1368,8 +1368,8 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0			   0
 	 */
 
-	{ "max_bypass_volt",	0,	voltronic_r_bypass_volt_max,	"PHV%03.0f\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_process_setvar },
-	{ "min_bypass_volt",	0,	voltronic_r_bypass_volt_min,	"PLV%03.0f\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_process_setvar },
+	{ "max_bypass_volt",	0,	voltronic_r_bypass_volt_max,	"PHV%03.0f\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_process_setvar },
+	{ "min_bypass_volt",	0,	voltronic_r_bypass_volt_min,	"PLV%03.0f\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_process_setvar },
 
 	/* Query UPS for Bypass Mode frequency limits
 	 * > [QBYF\r]
@@ -1378,8 +1378,8 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0         1
 	 */
 
-	{ "max_bypass_freq",	ST_FLAG_RW,	voltronic_r_bypass_freq_max,	"QBYF\r",	"",	11,	'(',	"",	1,	4,	"%.1f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_bypass },
-	{ "min_bypass_freq",	ST_FLAG_RW,	voltronic_r_bypass_freq_min,	"QBYF\r",	"",	11,	'(',	"",	6,	9,	"%.1f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_bypass },
+	{ "max_bypass_freq",	ST_FLAG_RW,	voltronic_r_bypass_freq_max,	"QBYF\r",	NULL,	11,	'(',	NULL,	1,	4,	"%.1f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_bypass },
+	{ "min_bypass_freq",	ST_FLAG_RW,	voltronic_r_bypass_freq_min,	"QBYF\r",	NULL,	11,	'(',	NULL,	6,	9,	"%.1f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_bypass },
 
 	/* Set Bypass Mode frequency limits
 	 * > [PGFnn.n\r]	> [PSFnn.n\r]		n = 0..9
@@ -1388,8 +1388,8 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0			   0
 	 */
 
-	{ "max_bypass_freq",	0,	voltronic_r_bypass_freq_max,	"PGF%04.1f\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_process_setvar },
-	{ "min_bypass_freq",	0,	voltronic_r_bypass_freq_min,	"PSF%04.1f\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_process_setvar },
+	{ "max_bypass_freq",	0,	voltronic_r_bypass_freq_max,	"PGF%04.1f\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_process_setvar },
+	{ "min_bypass_freq",	0,	voltronic_r_bypass_freq_min,	"PSF%04.1f\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_process_setvar },
 
 	/* Set number of batteries that make a pack to n (integer, 1-9). NOTE: changing the number of batteries will change the UPS's estimation on battery charge/runtime
 	 * > [BATNn\r]
@@ -1398,7 +1398,7 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "battery_number",	0,	voltronic_r_batt_numb,	"BATN%1.0f\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_process_setvar },
+	{ "battery_number",	0,	voltronic_r_batt_numb,	"BATN%1.0f\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_process_setvar },
 
 	/* Set number of battery packs in parallel to n (integer, 01-99). NOTE: changing the number of battery packs will change the UPS's estimation on battery charge/runtime
 	 * > [BATGNn\r]
@@ -1407,7 +1407,7 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "battery.packs",	0,	voltronic_r_batt_packs,	"BATGN%02.0f\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE,	NULL,	NULL,	voltronic_process_setvar },
+	{ "battery.packs",	0,	voltronic_r_batt_packs,	"BATGN%02.0f\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE,	NULL,	NULL,	voltronic_process_setvar },
 
 	/* Query UPS for battery type (Only P31)
 	 * > [QBT\r]
@@ -1416,7 +1416,7 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "battery.type",	ST_FLAG_RW,	voltronic_e_batt_type,	"QBT\r",	"",	4,	'(',	"",	1,	2,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_ENUM | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_p31b },
+	{ "battery.type",	ST_FLAG_RW,	voltronic_e_batt_type,	"QBT\r",	NULL,	4,	'(',	NULL,	1,	2,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_ENUM | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_p31b },
 
 	/* Set battery type (Only P31)
 	 * > [PBTnn\r]		nn = 00/01/02
@@ -1425,7 +1425,7 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "battery.type",	0,	voltronic_e_batt_type,	"PBT%02.0f\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_p31b_set },
+	{ "battery.type",	0,	voltronic_e_batt_type,	"PBT%02.0f\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_p31b_set },
 
 	/* Query UPS for device grid working range (Only P31)
 	 * > [QGR\r]
@@ -1434,7 +1434,7 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "work_range_type",	ST_FLAG_RW,	voltronic_e_work_range,	"QGR\r",	"",	4,	'(',	"",	1,	2,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_p31g },
+	{ "work_range_type",	ST_FLAG_RW,	voltronic_e_work_range,	"QGR\r",	NULL,	4,	'(',	NULL,	1,	2,	"%s",	QX_FLAG_SEMI_STATIC | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_p31g },
 
 	/* Set device grid working range type (Only P31)
 	 * > [PBTnn\r]		nn = 00/01
@@ -1443,7 +1443,7 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "work_range_type",	0,	voltronic_e_work_range,	"PGR%02.0f\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_p31g_set },
+	{ "work_range_type",	0,	voltronic_e_work_range,	"PGR%02.0f\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_p31g_set },
 
 	/* Query UPS for battery low voltage
 	 * > [RE0\r]
@@ -1452,7 +1452,7 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "battery.voltage.low",	ST_FLAG_RW,	voltronic_r_batt_low,	"RE0\r",	"",	3,	'#',	"",	1,	2,	"%.1f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE,	NULL,	NULL,	NULL },
+	{ "battery.voltage.low",	ST_FLAG_RW,	voltronic_r_batt_low,	"RE0\r",	NULL,	3,	'#',	NULL,	1,	2,	"%.1f",	QX_FLAG_SEMI_STATIC | QX_FLAG_RANGE,	NULL,	NULL,	NULL },
 
 	/* Set voltage for battery low to n (integer, 20..24/20..28). NOTE: changing the battery low voltage will change the UPS's estimation on battery charge/runtime
 	 * > [W0En\r]
@@ -1461,7 +1461,7 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "battery.voltage.low",	0,	voltronic_r_batt_low,	"W0E%02.0f\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE,	NULL,	NULL,	voltronic_process_setvar },
+	{ "battery.voltage.low",	0,	voltronic_r_batt_low,	"W0E%02.0f\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_RANGE,	NULL,	NULL,	voltronic_process_setvar },
 
 	/* Query UPS for Phase Angle
 	 * > [QPD\r]
@@ -1470,8 +1470,8 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "input_phase_angle",		0,		NULL,			"QPD\r",	"",	9,	'(',	"",	1,	3,	"%03d",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,			NULL,	NULL,	voltronic_phase },
-	{ "output_phase_angle",		ST_FLAG_RW,	voltronic_e_phase,	"QPD\r",	"",	9,	'(',	"",	5,	7,	"%03d",	QX_FLAG_SEMI_STATIC | QX_FLAG_ENUM | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_phase },
+	{ "input_phase_angle",		0,		NULL,			"QPD\r",	NULL,	9,	'(',	NULL,	1,	3,	"%03d",	QX_FLAG_SEMI_STATIC | QX_FLAG_NONUT,			NULL,	NULL,	voltronic_phase },
+	{ "output_phase_angle",		ST_FLAG_RW,	voltronic_e_phase,	"QPD\r",	NULL,	9,	'(',	NULL,	5,	7,	"%03d",	QX_FLAG_SEMI_STATIC | QX_FLAG_ENUM | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_phase },
 
 	/* Set output phase angle
 	 * > [PPDn\r]		n = (000, 120, 180 or 240)
@@ -1480,7 +1480,7 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "output_phase_angle",		0,	voltronic_e_phase,	"PPD%03.0f\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_phase_set },
+	{ "output_phase_angle",		0,	voltronic_e_phase,	"PPD%03.0f\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_SETVAR | QX_FLAG_ENUM | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	voltronic_phase_set },
 
 	/* Query UPS for master/slave for a system of UPSes in parallel
 	 * > [QPAR\r]
@@ -1489,7 +1489,7 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "voltronic_parallel",		0,	NULL,	"QPAR\r",	"",	5,	'(',	"",	1,	3,	"%s",	QX_FLAG_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_parallel },
+	{ "voltronic_parallel",		0,	NULL,	"QPAR\r",	NULL,	5,	'(',	NULL,	1,	3,	"%s",	QX_FLAG_STATIC | QX_FLAG_NONUT,	NULL,	NULL,	voltronic_parallel },
 
 	/* Query UPS for ??
 	 * > [QBDR\r]
@@ -1498,46 +1498,46 @@ static item_t	voltronic_qx2nut[] = {
 	 *    0
 	 */
 
-	{ "unknown.7",		0,	NULL,	"QBDR\r",	"",	5,	'(',	"",	1,	0,	"%s",	QX_FLAG_STATIC | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "unknown.7",		0,	NULL,	"QBDR\r",	NULL,	5,	'(',	NULL,	1,	0,	"%s",	QX_FLAG_STATIC | QX_FLAG_NONUT | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
 
 	/* Instant commands */
-	{ "load.off",			0,	NULL,	"SOFF\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
-	{ "load.on",			0,	NULL,	"SON\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
+	{ "load.off",			0,	NULL,	"SOFF\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
+	{ "load.on",			0,	NULL,	"SON\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
 
-	{ "shutdown.return",		0,	NULL,	"S%s\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	voltronic_process_command },
-	{ "shutdown.stayoff",		0,	NULL,	"S%sR0000\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	voltronic_process_command },
-	{ "shutdown.stop",		0,	NULL,	"CS\r",		"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
+	{ "shutdown.return",		0,	NULL,	"S%s\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	voltronic_process_command },
+	{ "shutdown.stayoff",		0,	NULL,	"S%sR0000\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	voltronic_process_command },
+	{ "shutdown.stop",		0,	NULL,	"CS\r",		NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
 
-	{ "test.battery.start",		0,	NULL,	"T%s\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	voltronic_process_command },
-	{ "test.battery.start.deep",	0,	NULL,	"TL\r",		"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
-	{ "test.battery.start.quick",	0,	NULL,	"T\r",		"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
-	{ "test.battery.stop",		0,	NULL,	"CT\r",		"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
+	{ "test.battery.start",		0,	NULL,	"T%s\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	voltronic_process_command },
+	{ "test.battery.start.deep",	0,	NULL,	"TL\r",		NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
+	{ "test.battery.start.quick",	0,	NULL,	"T\r",		NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
+	{ "test.battery.stop",		0,	NULL,	"CT\r",		NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	NULL },
 
-	{ "beeper.toggle",		0,	NULL,	"BZ%s\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	voltronic_process_command },
+	{ "beeper.toggle",		0,	NULL,	"BZ%s\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD,	NULL,	NULL,	voltronic_process_command },
 	/* Enable/disable beeper: unskipped if the UPS can control alarm (capability) */
-	{ "beeper.enable",		0,	NULL,	"PEA\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "beeper.disable",		0,	NULL,	"PDA\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "beeper.enable",		0,	NULL,	"PEA\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "beeper.disable",		0,	NULL,	"PDA\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
 
 	/* Outlet control: unskipped if the outlets are manageable */
-	{ "outlet.1.load.off",		0,	NULL,	"SKOFF1\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "outlet.1.load.on",		0,	NULL,	"SKON1\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "outlet.2.load.off",		0,	NULL,	"SKOFF2\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "outlet.2.load.on",		0,	NULL,	"SKON2\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "outlet.3.load.off",		0,	NULL,	"SKOFF3\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "outlet.3.load.on",		0,	NULL,	"SKON3\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "outlet.4.load.off",		0,	NULL,	"SKOFF4\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "outlet.4.load.on",		0,	NULL,	"SKON4\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "outlet.1.load.off",		0,	NULL,	"SKOFF1\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "outlet.1.load.on",		0,	NULL,	"SKON1\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "outlet.2.load.off",		0,	NULL,	"SKOFF2\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "outlet.2.load.on",		0,	NULL,	"SKON2\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "outlet.3.load.off",		0,	NULL,	"SKOFF3\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "outlet.3.load.on",		0,	NULL,	"SKON3\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "outlet.4.load.off",		0,	NULL,	"SKOFF4\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "outlet.4.load.on",		0,	NULL,	"SKON4\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
 
 	/* Bypass: unskipped if the UPS is capable of ECO Mode */
-	{ "bypass.start",		0,	NULL,	"PEE\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
-	{ "bypass.stop",		0,	NULL,	"PDE\r",	"",	5,	'(',	"",	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "bypass.start",		0,	NULL,	"PEE\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
+	{ "bypass.stop",		0,	NULL,	"PDE\r",	NULL,	5,	'(',	NULL,	1,	3,	NULL,	QX_FLAG_CMD | QX_FLAG_SKIP,	NULL,	NULL,	NULL },
 
 	/* Server-side settable vars */
-	{ "ups.delay.start",		ST_FLAG_RW,	voltronic_r_ondelay,	NULL,		"",	0,	0,	"",	0,	0,	DEFAULT_ONDELAY,	QX_FLAG_ABSENT | QX_FLAG_SETVAR | QX_FLAG_RANGE,	NULL,	NULL,	voltronic_process_setvar },
-	{ "ups.delay.shutdown",		ST_FLAG_RW,	voltronic_r_offdelay,	NULL,		"",	0,	0,	"",	0,	0,	DEFAULT_OFFDELAY,	QX_FLAG_ABSENT | QX_FLAG_SETVAR | QX_FLAG_RANGE,	NULL,	NULL,	voltronic_process_setvar },
+	{ "ups.delay.start",		ST_FLAG_RW,	voltronic_r_ondelay,	NULL,		NULL,	0,	0,	NULL,	0,	0,	DEFAULT_ONDELAY,	QX_FLAG_ABSENT | QX_FLAG_SETVAR | QX_FLAG_RANGE,	NULL,	NULL,	voltronic_process_setvar },
+	{ "ups.delay.shutdown",		ST_FLAG_RW,	voltronic_r_offdelay,	NULL,		NULL,	0,	0,	NULL,	0,	0,	DEFAULT_OFFDELAY,	QX_FLAG_ABSENT | QX_FLAG_SETVAR | QX_FLAG_RANGE,	NULL,	NULL,	voltronic_process_setvar },
 
 	/* End of structure. */
-	{ NULL,		0,	NULL,	NULL,	"",	0,	0,	"",	0,	0,	NULL,	0,	NULL,	NULL,	NULL }
+	{ NULL,		0,	NULL,	NULL,	NULL,	0,	0,	NULL,	0,	0,	NULL,	0,	NULL,	NULL,	NULL }
 };
 
 
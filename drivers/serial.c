@@ -443,6 +443,230 @@ int ser_flush_in(int fd, const char *ignset, int verbose)
 	return extra;
 }
 
+/* attach a receive buffer of bufsize bytes to fd */
+ser_frame_t *ser_frame_init(int fd, size_t bufsize)
+{
+	ser_frame_t	*sf;
+
+	sf = xcalloc(1, sizeof(*sf));
+
+	sf->fd = fd;
+	sf->size = (bufsize > 1) ? bufsize : LARGEBUF;
+	sf->buf = xmalloc(sf->size);
+
+	ser_frame_set_term(sf, '\r', "");
+
+	return sf;
+}
+
+void ser_frame_free(ser_frame_t *sf)
+{
+	if (!sf)
+		return;
+
+	free(sf->buf);
+	free(sf);
+}
+
+void ser_frame_set_term(ser_frame_t *sf, char term, const char *ignset)
+{
+	sf->type = SER_FRAME_TERM;
+	sf->term = term;
+	sf->ignset = ignset ? ignset : "";
+	sf->scan = sf->head;
+}
+
+void ser_frame_set_length(ser_frame_t *sf, unsigned char sync, size_t len_pos,
+	size_t len_extra, int (*checksum)(const unsigned char *frame, size_t len))
+{
+	sf->type = checksum ? SER_FRAME_CHECKSUM : SER_FRAME_LEN;
+	sf->sync = sync;
+	sf->len_pos = len_pos;
+	sf->len_extra = len_extra;
+	sf->checksum = checksum;
+}
+
+void ser_frame_flush(ser_frame_t *sf)
+{
+	sf->head = sf->tail = sf->scan = 0;
+}
+
+/* read whatever is available on the port without blocking: returns the
+   number of bytes added to the buffer, 0 if none and -1 on failure */
+int ser_frame_fill(ser_frame_t *sf)
+{
+	ssize_t	ret;
+
+	/* make room at the end of the buffer */
+	if (sf->head == sf->tail) {
+		sf->head = sf->tail = sf->scan = 0;
+	} else if (sf->head > 0 && (sf->tail == sf->size || sf->head > sf->size / 2)) {
+		memmove(sf->buf, &sf->buf[sf->head], sf->tail - sf->head);
+		sf->tail -= sf->head;
+		sf->scan = (sf->scan > sf->head) ? sf->scan - sf->head : 0;
+		sf->head = 0;
+	}
+
+	/* no complete frame in a full buffer: garbage, throw it away */
+	if (sf->tail == sf->size) {
+		upsdebugx(3, "%s: buffer full without a complete frame, discarding %d bytes", __func__, (int)sf->size);
+		ser_frame_flush(sf);
+	}
+
+	ret = read(sf->fd, &sf->buf[sf->tail], sf->size - sf->tail);
+
+	if (ret < 0) {
+		if (errno == EAGAIN || errno == EINTR)
+			return 0;
+
+		return -1;
+	}
+
+	/* end of file: the other end went away */
+	if (ret == 0)
+		return -1;
+
+	sf->tail += ret;
+
+	return ret;
+}
+
+/* strip the ignset characters from the len bytes at frame, in place */
+static size_t ser_frame_strip(unsigned char *frame, size_t len, const char *ignset)
+{
+	size_t	i, j;
+
+	if (!*ignset)
+		return len;
+
+	for (i = j = 0; i < len; i++) {
+
+		if (frame[i] != '\0' && strchr(ignset, frame[i]))
+			continue;
+
+		frame[j++] = frame[i];
+	}
+
+	return j;
+}
+
+/* hand out the next complete frame: returns its length and points frame to
+   it, inside the receive buffer (valid until the next ser_frame_fill() or
+   ser_frame_get() call), or returns 0 if there is no complete frame yet.
+   SER_FRAME_TERM frames are null-terminated, and empty ones are skipped. */
+int ser_frame_next(ser_frame_t *sf, unsigned char **frame)
+{
+	unsigned char	*start, *end;
+	size_t		len;
+
+	while (sf->head < sf->tail) {
+
+		start = &sf->buf[sf->head];
+
+		if (sf->type == SER_FRAME_TERM) {
+
+			end = memchr(&sf->buf[sf->scan], sf->term, sf->tail - sf->scan);
+
+			if (!end) {
+				sf->scan = sf->tail;
+				return 0;
+			}
+
+			len = ser_frame_strip(start, end - start, sf->ignset);
+			start[len] = '\0';
+
+			sf->head = sf->scan = (end - sf->buf) + 1;
+
+			if (len == 0)
+				continue;
+
+			*frame = start;
+			return len;
+		}
+
+		/* SER_FRAME_LEN, SER_FRAME_CHECKSUM: look for the sync byte */
+		if (*start != sf->sync) {
+			end = memchr(start, sf->sync, sf->tail - sf->head);
+			upsdebugx(4, "%s: skipping %d bytes while looking for a frame", __func__,
+				end ? (int)(end - start) : (int)(sf->tail - sf->head));
+			sf->head = end ? (size_t)(end - sf->buf) : sf->tail;
+			continue;
+		}
+
+		if (sf->tail - sf->head <= sf->len_pos)
+			return 0;
+
+		len = start[sf->len_pos] + sf->len_extra;
+
+		if (len <= sf->len_pos || len > sf->size) {
+			upsdebugx(4, "%s: invalid frame length %d", __func__, (int)len);
+			sf->head++;
+			continue;
+		}
+
+		if (sf->tail - sf->head < len)
+			return 0;
+
+		if (sf->checksum && sf->checksum(start, len)) {
+			upsdebugx(4, "%s: checksum mismatch, skipping frame", __func__);
+			sf->head++;
+			continue;
+		}
+
+		sf->head += len;
+
+		*frame = start;
+		return len;
+	}
+
+	return 0;
+}
+
+/* wait up to d_sec + d_usec for the next complete frame: returns its length
+   as ser_frame_next() does, 0 on timeout and -1 on failure */
+int ser_frame_get(ser_frame_t *sf, unsigned char **frame, long d_sec, long d_usec)
+{
+	int		ret;
+	fd_set		fds;
+	struct timeval	now, stop, tv;
+
+	gettimeofday(&stop, NULL);
+	stop.tv_sec += d_sec + (stop.tv_usec + d_usec) / 1000000;
+	stop.tv_usec = (stop.tv_usec + d_usec) % 1000000;
+
+	while ((ret = ser_frame_next(sf, frame)) == 0) {
+
+		gettimeofday(&now, NULL);
+
+		if (now.tv_sec > stop.tv_sec || (now.tv_sec == stop.tv_sec && now.tv_usec >= stop.tv_usec))
+			return 0;
+
+		tv.tv_sec = stop.tv_sec - now.tv_sec;
+		tv.tv_usec = stop.tv_usec - now.tv_usec;
+
+		if (tv.tv_usec < 0) {
+			tv.tv_sec--;
+			tv.tv_usec += 1000000;
+		}
+
+		FD_ZERO(&fds);
+		FD_SET(sf->fd, &fds);
+
+		ret = select(sf->fd + 1, &fds, NULL, NULL, &tv);
+
+		if (ret < 0 && errno != EINTR)
+			return -1;
+
+		if (ret < 1)
+			continue;
+
+		if (ser_frame_fill(sf) < 0)
+			return -1;
+	}
+
+	return ret;
+}
+
 void ser_comm_fail(const char *fmt, ...)
 {
 	int	ret;
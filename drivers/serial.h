@@ -70,6 +70,62 @@ int ser_get_line(int fd, void *buf, size_t buflen, char endchar,
 
 int ser_flush_in(int fd, const char *ignset, int verbose);
 
+/* framed input: a receive buffer attached to a port that splits the
+   incoming data in complete frames, for drivers that read whatever the
+   UPS sends as soon as it is available (e.g. with extrafd = fd) */
+typedef enum {
+	SER_FRAME_TERM = 0,	/* frames end with a terminator character */
+	SER_FRAME_LEN,		/* frames start with a sync byte and carry their length */
+	SER_FRAME_CHECKSUM	/* as SER_FRAME_LEN, plus a checksum that must match */
+} ser_frame_type_t;
+
+typedef struct {
+	int			fd;
+	ser_frame_type_t	type;
+
+	/* SER_FRAME_TERM */
+	char		term;		/* terminator, replaced by a '\0' in the frame */
+	const char	*ignset;	/* characters to drop from the frame */
+
+	/* SER_FRAME_LEN, SER_FRAME_CHECKSUM */
+	unsigned char	sync;		/* first byte of every frame */
+	size_t		len_pos;	/* position of the length byte in the frame */
+	size_t		len_extra;	/* bytes of the frame not counted by the length byte */
+	int		(*checksum)(const unsigned char *frame, size_t len);
+					/* return 0 if frame is valid (SER_FRAME_CHECKSUM) */
+
+	unsigned char	*buf;		/* receive buffer */
+	size_t		size;		/* size of buf */
+	size_t		head;		/* start of the data not yet handed out */
+	size_t		tail;		/* end of the data received so far */
+	size_t		scan;		/* where to resume looking for a terminator */
+} ser_frame_t;
+
+/* attach a receive buffer of bufsize bytes to fd; frames are terminated
+   by '\r' until one of ser_frame_set_* is called */
+ser_frame_t *ser_frame_init(int fd, size_t bufsize);
+void ser_frame_free(ser_frame_t *sf);
+
+/* frames end with term; characters matching ignset are dropped */
+void ser_frame_set_term(ser_frame_t *sf, char term, const char *ignset);
+
+/* frames start with sync and are (frame[len_pos] + len_extra) bytes
+   long; if checksum is not NULL, frames it rejects are skipped */
+void ser_frame_set_length(ser_frame_t *sf, unsigned char sync, size_t len_pos,
+	size_t len_extra, int (*checksum)(const unsigned char *frame, size_t len));
+
+/* read whatever is available on the port without blocking */
+int ser_frame_fill(ser_frame_t *sf);
+
+/* hand out the next complete frame already in the buffer, if any */
+int ser_frame_next(ser_frame_t *sf, unsigned char **frame);
+
+/* wait up to d_sec + d_usec for the next complete frame */
+int ser_frame_get(ser_frame_t *sf, unsigned char **frame, long d_sec, long d_usec);
+
+/* discard everything received so far */
+void ser_frame_flush(ser_frame_t *sf);
+
 /* unified failure reporting: call these often */
 void ser_comm_fail(const char *fmt, ...)
 	__attribute__ ((__format__ (__printf__, 1, 2)));
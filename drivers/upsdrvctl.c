@@ -28,6 +28,7 @@
 #include "proto.h"
 #include "common.h"
 #include "upsconf.h"
+#include "timehead.h"
 
 typedef struct {
 	char	*upsname;
@@ -51,6 +52,9 @@ static int	maxretry = 1;
 	/* timer - delay between each restart attempt of the driver(s) */
 static int	retrydelay = 5;
 
+	/* counter - how many drivers to start or shutdown at once */
+static int	maxparallel = 1;
+
 	/* Directory where driver executables live */
 static char	*driverpath = NULL;
 
@@ -77,6 +81,9 @@ void do_upsconf_args(char *upsname, char *var, char *val)
 		if (!strcmp(var, "retrydelay"))
 			retrydelay = atoi(val);
 
+		if (!strcmp(var, "maxparallel"))
+			maxparallel = atoi(val);
+
 		/* ignore anything else - it's probably for main */
 
 		return;
@@ -189,137 +196,233 @@ static void debugcmdline(int level, const char *msg, char *const argv[])
 	upsdebugx(level, "%s", cmdline);
 }
 
-static void forkexec(char *const argv[], const ups_t *ups)
+/* one driver invocation (start or shutdown) */
+typedef struct {
+	const ups_t	*ups;
+	char	dfn[SMALLBUF];
+	char	*argv[10];
+	int	attempts;	/* attempts left */
+	time_t	notbefore;	/* retry delay */
+	time_t	deadline;	/* when we stop waiting for the driver */
+	pid_t	pid;	/* running if nonzero */
+	int	done;
+}	job_t;
+
+static void job_init(job_t *job, const ups_t *ups, int shutdown)
 {
-	int	ret;
-	pid_t	pid;
+	int	arg = 0;
 
-	pid = fork();
+	memset(job, 0, sizeof(*job));
 
-	if (pid < 0)
-		fatal_with_errno(EXIT_FAILURE, "fork");
+	job->ups = ups;
+	job->attempts = shutdown ? 1 : maxretry;
 
-	if (pid != 0) {			/* parent */
-		int	wstat;
-		struct sigaction	sa;
+	snprintf(job->dfn, sizeof(job->dfn), "%s/%s", driverpath, ups->driver);
 
-		sigemptyset(&sa.sa_mask);
-		sa.sa_flags = 0;
-		sa.sa_handler = waitpid_timeout;
-		sigaction(SIGALRM, &sa, NULL);
+	job->argv[arg++] = job->dfn;
+	job->argv[arg++] = (char *)"-a";		/* FIXME: cast away const */
+	job->argv[arg++] = ups->upsname;
 
-		if (ups->maxstartdelay != -1)
-			alarm(ups->maxstartdelay);
-		else
-			alarm(maxstartdelay);
+	if (shutdown)
+		job->argv[arg++] = (char *)"-k";	/* FIXME: cast away const */
 
-		ret = waitpid(pid, &wstat, 0);
+	/* stick on the chroot / user args if given to us */
+	if (pt_root) {
+		job->argv[arg++] = (char *)"-r";	/* FIXME: cast away const */
+		job->argv[arg++] = pt_root;
+	}
 
-		alarm(0);
+	if (pt_user) {
+		job->argv[arg++] = (char *)"-u";	/* FIXME: cast away const */
+		job->argv[arg++] = pt_user;
+	}
 
-		if (ret == -1) {
-			upslogx(LOG_WARNING, "Startup timer elapsed, continuing...");
-			exec_error++;
-			return;
-		}
+	/* tie it off */
+	job->argv[arg++] = NULL;
+}
 
-		if (WIFEXITED(wstat) == 0) {
-			upslogx(LOG_WARNING, "Driver exited abnormally");
-			exec_error++;
-			return;
-		}
+static void job_exec(job_t *job)
+{
+	pid_t	pid;
 
-		if (WEXITSTATUS(wstat) != 0) {
-			upslogx(LOG_WARNING, "Driver failed to start"
-			" (exit status=%d)", WEXITSTATUS(wstat));
-			exec_error++;
-			return;
-		}
+	upsdebugx(2, "%s: %i remaining attempts", job->ups->upsname, job->attempts);
+	debugcmdline(2, "exec: ", job->argv);
+	job->attempts--;
 
-		/* the rest only work when WIFEXITED is nonzero */
+	if (testmode) {
+		job->done = 1;
+		return;
+	}
 
-		if (WIFSIGNALED(wstat)) {
-			upslog_with_errno(LOG_WARNING, "Driver died after signal %d",
-				WTERMSIG(wstat));
-			exec_error++;
-		}
+	pid = fork();
 
+	if (pid < 0)
+		fatal_with_errno(EXIT_FAILURE, "fork");
+
+	if (pid == 0) {			/* child */
+		execv(job->argv[0], job->argv);
+
+		/* shouldn't get here */
+		fatal_with_errno(EXIT_FAILURE, "execv");
+	}
+
+	job->pid = pid;
+	job->deadline = time(NULL) +
+		((job->ups->maxstartdelay != -1) ? job->ups->maxstartdelay : maxstartdelay);
+}
+
+/* the driver failed (or timed out): retry it later, or give up */
+static void job_failed(job_t *job)
+{
+	job->pid = 0;
+
+	if (job->attempts > 0) {
+		job->notbefore = time(NULL) + retrydelay;
 		return;
 	}
 
-	/* child */
+	job->done = 1;
+	exec_error++;
+}
+
+/* check how the driver exited, same as for a sequential start */
+static void job_reaped(job_t *job, int wstat)
+{
+	if (WIFEXITED(wstat) == 0) {
+		upslogx(LOG_WARNING, "%s: driver exited abnormally", job->ups->upsname);
+		job_failed(job);
+		return;
+	}
 
-	ret = execv(argv[0], argv);
+	if (WEXITSTATUS(wstat) != 0) {
+		upslogx(LOG_WARNING, "%s: driver failed to start"
+		" (exit status=%d)", job->ups->upsname, WEXITSTATUS(wstat));
+		job_failed(job);
+		return;
+	}
 
-	/* shouldn't get here */
-	fatal_with_errno(EXIT_FAILURE, "execv");
+	job->pid = 0;
+	job->done = 1;
 }
 
-static void start_driver(const ups_t *ups)
+/* run the jobs, at most maxparallel at a time, and wait for all of them
+ * to complete: drivers exit once backgrounded (start) or done (shutdown) */
+static void run_jobs(job_t *jobs, int numjobs)
 {
-	char	*argv[8];
-	char	dfn[SMALLBUF];
-	int	ret, arg = 0;
-	int	initial_exec_error = exec_error, drv_maxretry = maxretry;
-	struct stat	fs;
+	int	i, running = 0, left = numjobs, wstat;
+	time_t	now, next;
+	pid_t	pid;
+	struct sigaction	sa;
 
-	upsdebugx(1, "Starting UPS: %s", ups->upsname);
+	sigemptyset(&sa.sa_mask);
+	sa.sa_flags = 0;
+	sa.sa_handler = waitpid_timeout;
+	sigaction(SIGALRM, &sa, NULL);
 
-	snprintf(dfn, sizeof(dfn), "%s/%s", driverpath, ups->driver);
-	ret = stat(dfn, &fs);
+	while (left > 0) {
+		now = time(NULL);
+		next = 0;
 
-	if (ret < 0)
-		fatal_with_errno(EXIT_FAILURE, "Can't start %s", dfn);
+		/* launch what we can */
+		for (i = 0; i < numjobs; i++) {
+			job_t	*job = &jobs[i];
 
-	argv[arg++] = dfn;
-	argv[arg++] = (char *)"-a";		/* FIXME: cast away const */
-	argv[arg++] = ups->upsname;
+			if (job->done || job->pid)
+				continue;
 
-	/* stick on the chroot / user args if given to us */
-	if (pt_root) {
-		argv[arg++] = (char *)"-r";	/* FIXME: cast away const */
-		argv[arg++] = pt_root;
-	}
+			if (job->notbefore > now) {
+				if (!next || job->notbefore < next)
+					next = job->notbefore;
+				continue;
+			}
 
-	if (pt_user) {
-		argv[arg++] = (char *)"-u";	/* FIXME: cast away const */
-		argv[arg++] = pt_user;
-	}
+			if (running >= maxparallel)
+				continue;
 
-	/* tie it off */
-	argv[arg++] = NULL;
+			job_exec(job);
 
+			if (job->done)
+				left--;
+			else
+				running++;
+		}
 
-	while (drv_maxretry > 0) {
-		int cur_exec_error = exec_error;
+		if (left == 0)
+			break;
 
-		upsdebugx(2, "%i remaining attempts", drv_maxretry);
-		debugcmdline(2, "exec: ", argv);
-		drv_maxretry--;
+		/* the nearest of the drivers timeouts and retries */
+		for (i = 0; i < numjobs; i++) {
+			if (jobs[i].pid && (!next || jobs[i].deadline < next))
+				next = jobs[i].deadline;
+		}
 
-		if (!testmode) {
-			forkexec(argv, ups);
+		if (!running) {
+			sleep(next > now ? next - now : 1);
+			continue;
 		}
 
-		/* driver command succeeded */
-		if (cur_exec_error == exec_error) {
-			drv_maxretry = 0;
-			exec_error = initial_exec_error;
+		alarm(next > now ? next - now : 1);
+		pid = waitpid(-1, &wstat, 0);
+		alarm(0);
+
+		if (pid > 0) {
+			for (i = 0; i < numjobs; i++) {
+				if (jobs[i].pid != pid)
+					continue;
+
+				running--;
+				job_reaped(&jobs[i], wstat);
+				if (jobs[i].done)
+					left--;
+				break;
+			}
+
+			/* else a driver we already gave up on */
+			continue;
 		}
-		else {
-		/* otherwise, retry if still needed */
-			if (drv_maxretry > 0)
-				sleep (retrydelay);
+
+		/* timer elapsed: stop waiting for the late ones */
+		now = time(NULL);
+
+		for (i = 0; i < numjobs; i++) {
+			if (!jobs[i].pid || jobs[i].deadline > now)
+				continue;
+
+			upslogx(LOG_WARNING, "%s: startup timer elapsed, continuing...",
+				jobs[i].ups->upsname);
+			running--;
+			job_failed(&jobs[i]);
+			if (jobs[i].done)
+				left--;
 		}
 	}
 }
 
+static void start_driver(const ups_t *ups)
+{
+	job_t	job;
+	int	ret;
+	struct stat	fs;
+
+	upsdebugx(1, "Starting UPS: %s", ups->upsname);
+
+	job_init(&job, ups, 0);
+
+	ret = stat(job.dfn, &fs);
+
+	if (ret < 0)
+		fatal_with_errno(EXIT_FAILURE, "Can't start %s", job.dfn);
+
+	run_jobs(&job, 1);
+}
+
 static void help(const char *progname)
 {
 	printf("Starts and stops UPS drivers via ups.conf.\n\n");
 	printf("usage: %s [OPTIONS] (start | stop | shutdown) [<ups>]\n\n", progname);
 
 	printf("  -h			display this help\n");
+	printf("  -j <n>			start or shutdown up to <n> drivers at once\n");
 	printf("  -r <path>		drivers will chroot to <path>\n");
 	printf("  -t			testing mode - prints actions without doing them\n");
 	printf("  -u <user>		drivers started will switch from root to <user>\n");
@@ -336,37 +439,12 @@ static void help(const char *progname)
 
 static void shutdown_driver(const ups_t *ups)
 {
-	char	*argv[9];
-	char	dfn[SMALLBUF];
-	int	arg = 0;
+	job_t	job;
 
 	upsdebugx(1, "Shutdown UPS: %s", ups->upsname);
 
-	snprintf(dfn, sizeof(dfn), "%s/%s", driverpath, ups->driver);
-
-	argv[arg++] = dfn;
-	argv[arg++] = (char *)"-a";		/* FIXME: cast away const */
-	argv[arg++] = ups->upsname;
-	argv[arg++] = (char *)"-k";		/* FIXME: cast away const */
-
-	/* stick on the chroot / user args if given to us */
-	if (pt_root) {
-		argv[arg++] = (char *)"-r";	/* FIXME: cast away const */
-		argv[arg++] = pt_root;
-	}
-
-	if (pt_user) {
-		argv[arg++] = (char *)"-u";	/* FIXME: cast away const */
-		argv[arg++] = pt_user;
-	}
-
-	argv[arg++] = NULL;
-
-	debugcmdline(2, "exec: ", argv);
-
-	if (!testmode) {
-		forkexec(argv, ups);
-	}
+	job_init(&job, ups, 1);
+	run_jobs(&job, 1);
 }
 
 static void send_one_driver(void (*command)(const ups_t *), const char *upsname)
@@ -392,12 +470,15 @@ static void send_one_driver(void (*command)(const ups_t *), const char *upsname)
 static void send_all_drivers(void (*command)(const ups_t *))
 {
 	ups_t	*ups;
-	int	i;
+	job_t	*jobs;
+	int	i, numjobs, numups = 0, errors = exec_error;
+	struct timeval	start, end;
+	struct stat	fs;
 
 	if (!upstable)
 		fatalx(EXIT_FAILURE, "Error: no UPS definitions found in ups.conf");
 
-	if (command != &shutdown_driver) {
+	if (command == &stop_driver) {
 		ups = upstable;
 
 		while (ups) {
@@ -409,16 +490,55 @@ static void send_all_drivers(void (*command)(const ups_t *))
 		return;
 	}
 
-	for (i = 0; i <= maxsdorder; i++) {
-		ups = upstable;
+	for (ups = upstable; ups; ups = ups->next)
+		numups++;
 
-		while (ups) {
-			if (ups->sdorder == i)
-				command(ups);
-			
-			ups = ups->next;
+	jobs = xcalloc(numups, sizeof(*jobs));
+
+	gettimeofday(&start, NULL);
+
+	if (command == &start_driver) {
+		numjobs = 0;
+
+		for (ups = upstable; ups; ups = ups->next) {
+			upsdebugx(1, "Starting UPS: %s", ups->upsname);
+
+			job_init(&jobs[numjobs], ups, 0);
+
+			if (stat(jobs[numjobs].dfn, &fs) < 0)
+				fatal_with_errno(EXIT_FAILURE, "Can't start %s", jobs[numjobs].dfn);
+
+			numjobs++;
+		}
+
+		run_jobs(jobs, numjobs);
+	}
+	else {
+		/* all drivers of a given sdorder form a wave, that must be
+		 * complete before the next one starts */
+		for (i = 0; i <= maxsdorder; i++) {
+			numjobs = 0;
+
+			for (ups = upstable; ups; ups = ups->next) {
+				if (ups->sdorder != i)
+					continue;
+
+				upsdebugx(1, "Shutdown UPS: %s", ups->upsname);
+				job_init(&jobs[numjobs++], ups, 1);
+			}
+
+			run_jobs(jobs, numjobs);
 		}
 	}
+
+	free(jobs);
+
+	gettimeofday(&end, NULL);
+
+	upsdebugx(1, "%s: %d drivers, %d failed, in %.3f seconds",
+		(command == &start_driver) ? "start" : "shutdown",
+		numups, exec_error - errors,
+		(end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1000000.0);
 }
 
 static void exit_cleanup(void)
@@ -443,7 +563,7 @@ static void exit_cleanup(void)
 
 int main(int argc, char **argv)
 {
-	int	i;
+	int	i, opt_maxparallel = 0;
 	char	*prog;
 	void	(*command)(const ups_t *) = NULL;
 
@@ -451,8 +571,12 @@ int main(int argc, char **argv)
 		UPS_VERSION);
 
 	prog = argv[0];
-	while ((i = getopt(argc, argv, "+htu:r:DV")) != -1) {
+	while ((i = getopt(argc, argv, "+hj:tu:r:DV")) != -1) {
 		switch(i) {
+			case 'j':
+				opt_maxparallel = atoi(optarg);
+				break;
+
 			case 'r':
 				pt_root = optarg;
 				break;
@@ -519,6 +643,13 @@ int main(int argc, char **argv)
 
 	read_upsconf();
 
+	/* command line overrides ups.conf */
+	if (opt_maxparallel > 0)
+		maxparallel = opt_maxparallel;
+
+	if (maxparallel < 1)
+		maxparallel = 1;
+
 	if (argc == 1)
 		send_all_drivers(command);
 	else
@@ -27,10 +27,11 @@
  */
 
 #define DRIVER_NAME	"Generic HID driver"
-#define DRIVER_VERSION		"0.41"
+#define DRIVER_VERSION		"0.42"
 
 #include "main.h"
 #include "libhid.h"
+#include "libhidrec.h"
 #include "usbhid-ups.h"
 #include "hidparser.h"
 #include "hidtypes.h"
@@ -735,6 +736,10 @@ void upsdrv_makevartable(void)
 
 	addvar(VAR_FLAG, "pollonly", "Don't use interrupt pipe, only use polling");
 
+	addvar(VAR_VALUE, "record", "Record the HID session with the device to this file");
+	addvar(VAR_VALUE, "replay", "Replay a recorded HID session instead of using a device");
+	addvar(VAR_VALUE, "replayspeed", "Speed factor of the session replay (default=1)");
+
 #ifndef SHUT_MODE
 	/* allow -x vendor=X, vendorid=X, product=X, productid=X, serial=X */
 	nut_usb_addvars();
@@ -760,6 +765,9 @@ void upsdrv_updateinfo(void)
 
 	upsdebugx(1, "upsdrv_updateinfo...");
 
+	/* account for the device exchanges per cycle, on record or replay */
+	hidrec_cycle();
+
 	time(&now);
 
 	/* check for device availability to set datastale! */
@@ -959,6 +967,14 @@ void upsdrv_initups(void)
 	subdriver_matcher->next = regex_matcher;
 #endif /* SHUT_MODE */
 
+	/* Record the session with the device, or replay a recorded one */
+	val = getval("replay");
+	if (val) {
+		comm_driver = hidrec_replay(val, getval("replayspeed") ? atof(getval("replayspeed")) : 1);
+	} else if (getval("record")) {
+		comm_driver = hidrec_record(comm_driver, getval("record"));
+	}
+
 	/* Search for the first supported UPS matching the
 	   regular expression (USB) or device_path (SHUT) */
 	ret = comm_driver->open(&udev, &curDevice, subdriver_matcher, &callback);
@@ -1028,6 +1044,8 @@ void upsdrv_cleanup(void)
 {
 	upsdebugx(1, "upsdrv_cleanup...");
 
+	hidrec_summary();
+
 	comm_driver->close(udev);
 	Free_ReportDesc(pDesc);
 	free_report_buffer(reportbuf);
@@ -1130,7 +1148,7 @@ static int callback(hid_dev_handle_t udev, HIDDevice_t *hd, unsigned char *rdbuf
 
 	upslogx(2, "Using subdriver: %s", subdriver->name);
 
-	HIDDumpTree(udev, subdriver->utab);
+	HIDDumpTree(udev, hd, subdriver->utab);
 
 #ifndef SHUT_MODE
 	/* create a new matcher for later matching */
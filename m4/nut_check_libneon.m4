@@ -57,6 +57,8 @@ if test -z "${nut_have_neon_seen}"; then
 	if test "${nut_have_neon}" = "yes"; then
 		dnl Check for connect timeout support in library (optional)
 		AC_CHECK_FUNCS(ne_set_connect_timeout ne_sock_connect_timeout)
+		dnl Check for response headers and session flags access (optional)
+		AC_CHECK_FUNCS(ne_get_response_header ne_set_session_flag)
 		LIBNEON_CFLAGS="${CFLAGS}"
 		LIBNEON_LIBS="${LIBS}"
 	fi
@@ -0,0 +1,68 @@
+dnl Check for the compiler and linker flags needed by POSIX threads. On
+dnl success, set nut_have_pthread="yes" and set PTHREAD_CFLAGS and
+dnl PTHREAD_LIBS. On failure, set nut_have_pthread="no". This macro can be
+dnl run multiple times, but will do the checking only once.
+
+AC_DEFUN([NUT_CHECK_PTHREAD],
+[
+if test -z "${nut_have_pthread_seen}"; then
+	nut_have_pthread_seen=yes
+
+	dnl save CFLAGS and LIBS
+	CFLAGS_ORIG="${CFLAGS}"
+	LIBS_ORIG="${LIBS}"
+
+	nut_have_pthread=no
+
+	dnl -pthread first, since it also sets the compiler up for threads
+	AC_MSG_CHECKING(for the flags needed by pthread)
+	for nut_pthread_flags in -pthread -lpthread none; do
+		case "${nut_pthread_flags}" in
+		-pthread)
+			PTHREAD_CFLAGS="-pthread"
+			PTHREAD_LIBS="-pthread"
+			;;
+		-lpthread)
+			PTHREAD_CFLAGS=""
+			PTHREAD_LIBS="-lpthread"
+			;;
+		*)
+			PTHREAD_CFLAGS=""
+			PTHREAD_LIBS=""
+			;;
+		esac
+
+		CFLAGS="${CFLAGS_ORIG} ${PTHREAD_CFLAGS}"
+		LIBS="${PTHREAD_LIBS}"
+
+		AC_LINK_IFELSE([AC_LANG_PROGRAM([[
+#include <pthread.h>
+static void *start(void *arg) { return arg; }
+		]], [[
+pthread_t th;
+pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+pthread_create(&th, 0, start, 0);
+pthread_join(th, 0);
+pthread_mutex_lock(&mutex);
+pthread_cond_signal(&cond);
+pthread_mutex_unlock(&mutex);
+		]])], [
+			nut_have_pthread=yes
+			break
+		])
+	done
+
+	if test "${nut_have_pthread}" = "yes"; then
+		AC_MSG_RESULT(${nut_pthread_flags})
+	else
+		AC_MSG_RESULT(no)
+		PTHREAD_CFLAGS=""
+		PTHREAD_LIBS=""
+	fi
+
+	dnl restore original CFLAGS and LIBS
+	CFLAGS="${CFLAGS_ORIG}"
+	LIBS="${LIBS_ORIG}"
+fi
+])
@@ -34,6 +34,7 @@ let ups_global   = "chroot"
                  | "driverpath"
                  | "maxstartdelay"
                  | "maxretry"
+                 | "maxparallel"
                  | "retrydelay"
                  | "pollinterval"
                  | "synchronous"
@@ -274,8 +274,8 @@ static void list_clients(nut_ctype_t *client, const char *upsname)
 		int	ret;
 		/* show connected clients */
 		for (c = firstclient; c; c = cnext) {
-			if (c->loginups && (!ups || !strcasecmp(c->loginups, ups->name))) {
-				ret = sendback(client, "CLIENT %s %s\n", c->loginups, c->addr);
+			if (client_login_index(c, ups->name) >= 0) {
+				ret = sendback(client, "CLIENT %s %s\n", ups->name, c->addr);
 				if (!ret)
 					return;
 			}
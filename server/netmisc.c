@@ -87,6 +87,8 @@ void net_fsd(nut_ctype_t *client, int numarg, const char **arg)
 		client->username, client->addr, ups->name);
 
 	ups->fsd = 1;
+	notify_fsd(ups);
+
 	sendback(client, "OK FSD-SET\n");
 }
 
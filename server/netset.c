@@ -149,8 +149,29 @@ static void set_var(nut_ctype_t *client, const char *upsname, const char *var,
 	sendback(client, "OK\n");
 }
 
+/* SET NOTIFY ON|OFF */
+static void set_notify(nut_ctype_t *client, const char *val)
+{
+	if (!strcasecmp(val, "ON")) {
+		client->notify = 1;
+	} else if (!strcasecmp(val, "OFF")) {
+		client->notify = 0;
+	} else {
+		send_err(client, NUT_ERR_INVALID_ARGUMENT);
+		return;
+	}
+
+	sendback(client, "OK\n");
+}
+
 void net_set(nut_ctype_t *client, int numarg, const char **arg)
 {
+	/* SET NOTIFY ON|OFF */
+	if ((numarg == 2) && (!strcasecmp(arg[0], "NOTIFY"))) {
+		set_notify(client, arg[1]);
+		return;
+	}
+
 	if (numarg < 4) {
 		send_err(client, NUT_ERR_INVALID_ARGUMENT);
 		return;
@@ -37,12 +37,6 @@ void net_login(nut_ctype_t *client, int numarg, const char **arg)
 		return;
 	}
 
-	if (client->loginups != NULL) {
-		upslogx(LOG_INFO, "Client %s@%s tried to login twice", client->username, client->addr);
-		send_err(client, NUT_ERR_ALREADY_LOGGED_IN);
-		return;
-	}
-
 	/* make sure we got a valid UPS name */
 	ups = get_ups_ptr(arg[0]);
 
@@ -51,6 +45,13 @@ void net_login(nut_ctype_t *client, int numarg, const char **arg)
 		return;
 	}
 
+	/* several UPSes may share a connection, but only once each */
+	if (client_login_index(client, ups->name) >= 0) {
+		upslogx(LOG_INFO, "Client %s@%s tried to login twice", client->username, client->addr);
+		send_err(client, NUT_ERR_ALREADY_LOGGED_IN);
+		return;
+	}
+
 	/* make sure this is a valid user */
 	if (!user_checkaction(client->username, client->password, "LOGIN")) {
 		send_err(client, NUT_ERR_ACCESS_DENIED);
@@ -58,23 +59,62 @@ void net_login(nut_ctype_t *client, int numarg, const char **arg)
 	}
 
 	ups->numlogins++;
-	client->loginups = xstrdup(ups->name);
+	client->loginups = xrealloc(client->loginups, (client->numlogins + 1) * sizeof(*client->loginups));
+	client->loginups[client->numlogins++] = xstrdup(ups->name);
 
 	upslogx(LOG_INFO, "User %s@%s logged into UPS [%s]%s", client->username, client->addr,
-		client->loginups, client->ssl ? " (SSL)" : "");
+		ups->name, client->ssl ? " (SSL)" : "");
+	sendback(client, "OK\n");
+
+	/* too late for notify_fsd */
+	if ((client->notify) && (ups->fsd)) {
+		sendback(client, "NOTIFY FSD %s\n", ups->name);
+	}
+
+	notify_numlogins(ups);
+}
+
+/* LOGOUT <ups>: end one LOGIN of a shared connection, and keep it open */
+static void net_logout_ups(nut_ctype_t *client, const char *upsname)
+{
+	int	i;
+
+	i = client_login_index(client, upsname);
+
+	if (i < 0) {
+		send_err(client, NUT_ERR_INVALID_ARGUMENT);
+		return;
+	}
+
+	upslogx(LOG_INFO, "User %s@%s logged out from UPS [%s]%s", client->username, client->addr,
+		client->loginups[i], client->ssl ? " (SSL)" : "");
+
+	declogins(client->loginups[i]);
+	free(client->loginups[i]);
+
+	client->numlogins--;
+	client->loginups[i] = client->loginups[client->numlogins];
+
 	sendback(client, "OK\n");
 }
 
 void net_logout(nut_ctype_t *client, int numarg, const char **arg)
 {
+	int	i;
+
+	if (numarg == 1) {
+		net_logout_ups(client, arg[0]);
+		return;
+	}
+
 	if (numarg != 0) {
 		send_err(client, NUT_ERR_INVALID_ARGUMENT);
 		return;
 	}
 
-	if (client->loginups != NULL) {
+	for (i = 0; i < client->numlogins; i++) {
 		upslogx(LOG_INFO, "User %s@%s logged out from UPS [%s]%s", client->username, client->addr,
-			client->loginups, client->ssl ? " (SSL)" : "");
+			client->loginups[i], client->ssl ? " (SSL)" : "");
 	}
 
 	sendback(client, "OK Goodbye\n");
@@ -105,7 +145,13 @@ void net_master(nut_ctype_t *client, int numarg, const char **arg)
 		return;
 	}
 
-	/* this is just an access level check */
+	/* mostly an access level check, but this client now also gets the
+	 * NOTIFY NUMLOGINS of this UPS */
+	if (client_master_index(client, ups->name) < 0) {
+		client->masterups = xrealloc(client->masterups, (client->nummasters + 1) * sizeof(*client->masterups));
+		client->masterups[client->nummasters++] = xstrdup(ups->name);
+	}
+
 	sendback(client, "OK MASTER-GRANTED\n");
 }
 
@@ -42,7 +42,11 @@ typedef struct nut_ctype_s {
 	char	*addr;
 	int	sock_fd;
 	time_t	last_heard;
-	char	*loginups;
+	char	**loginups;		/* UPSes this client did LOGIN to */
+	int	numlogins;
+	char	**masterups;		/* UPSes this client did MASTER on */
+	int	nummasters;
+	int	notify;			/* SET NOTIFY ON: send NOTIFY lines */
 	char	*password;
 	char	*username;
 
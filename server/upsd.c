@@ -29,6 +29,8 @@
 
 #include <sys/un.h>
 #include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <netdb.h>
 #include <poll.h>
 
@@ -247,7 +249,7 @@ static void setuptcp(stype_t *server)
 }
 
 /* decrement the login counter for this ups */
-static void declogins(const char *upsname)
+void declogins(const char *upsname)
 {
 	upstype_t	*ups;
 
@@ -263,11 +265,15 @@ static void declogins(const char *upsname)
 	if (ups->numlogins < 0) {
 		upslogx(LOG_ERR, "Programming error: UPS [%s] has numlogins=%d", ups->name, ups->numlogins);
 	}
+
+	notify_numlogins(ups);
 }
 
 /* disconnect a client connection and free all related memory */
 static void client_disconnect(nut_ctype_t *client)
 {
+	int	i;
+
 	if (!client) {
 		return;
 	}
@@ -277,8 +283,11 @@ static void client_disconnect(nut_ctype_t *client)
 	shutdown(client->sock_fd, 2);
 	close(client->sock_fd);
 
-	if (client->loginups) {
-		declogins(client->loginups);
+	/* not to itself, about its own logins */
+	client->notify = 0;
+
+	for (i = 0; i < client->numlogins; i++) {
+		declogins(client->loginups[i]);
 	}
 
 	ssl_finish(client);
@@ -300,7 +309,18 @@ static void client_disconnect(nut_ctype_t *client)
 	}
 
 	free(client->addr);
+
+	for (i = 0; i < client->numlogins; i++) {
+		free(client->loginups[i]);
+	}
+
 	free(client->loginups);
+
+	for (i = 0; i < client->nummasters; i++) {
+		free(client->masterups[i]);
+	}
+
+	free(client->masterups);
 	free(client->password);
 	free(client->username);
 	free(client);
@@ -366,15 +386,70 @@ void kick_login_clients(const char *upsname)
 
 		cnext = client->next;
 
-		/* if it's not logged in, don't check it */
-		if (!client->loginups) {
+		if (client_login_index(client, upsname) >= 0) {
+			upslogx(LOG_INFO, "Kicking client %s (was on UPS [%s])\n", client->addr, upsname);
+			client_disconnect(client);
+		}
+	}
+}
+
+/* position of upsname in the LOGINs of this client, or -1 */
+int client_login_index(const nut_ctype_t *client, const char *upsname)
+{
+	int	i;
+
+	for (i = 0; i < client->numlogins; i++) {
+		if (!strcasecmp(client->loginups[i], upsname)) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/* position of upsname in the MASTERs of this client, or -1 */
+int client_master_index(const nut_ctype_t *client, const char *upsname)
+{
+	int	i;
+
+	for (i = 0; i < client->nummasters; i++) {
+		if (!strcasecmp(client->masterups[i], upsname)) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/* tell the clients logged into this UPS that FSD was set on it, so they
+ * don't have to wait for their next poll */
+void notify_fsd(const upstype_t *ups)
+{
+	nut_ctype_t	*client;
+
+	for (client = firstclient; client; client = client->next) {
+
+		if ((!client->notify) || (client_login_index(client, ups->name) < 0)) {
 			continue;
 		}
 
-		if (!strcmp(client->loginups, upsname)) {
-			upslogx(LOG_INFO, "Kicking client %s (was on UPS [%s])\n", client->addr, upsname);
-			client_disconnect(client);
+		sendback(client, "NOTIFY FSD %s\n", ups->name);
+	}
+}
+
+/* tell the masters of this UPS that its number of logins changed, so they
+ * don't have to ask again and again while waiting for the slaves */
+void notify_numlogins(const upstype_t *ups)
+{
+	nut_ctype_t	*client;
+
+	for (client = firstclient; client; client = client->next) {
+
+		if ((!client->notify) || (client_master_index(client, ups->name) < 0)) {
+			continue;
 		}
+
+		sendback(client, "NOTIFY NUMLOGINS %s %d\n", ups->name, ups->numlogins);
 	}
 }
 
@@ -462,7 +537,7 @@ static void client_connect(stype_t *server)
 #else
 	socklen_t	clen;
 #endif
-	int		fd;
+	int		fd, one = 1;
 	nut_ctype_t		*client;
 
 	clen = sizeof(csock);
@@ -472,6 +547,12 @@ static void client_connect(stype_t *server)
 		return;
 	}
 
+	/* answers are written one by one as the commands arrive, so don't let
+	 * Nagle hold them back while a client pipelines its requests */
+	if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) < 0) {
+		upsdebug_with_errno(2, "Can't set TCP_NODELAY");
+	}
+
 	client = xcalloc(1, sizeof(*client));
 
 	client->sock_fd = fd;
@@ -59,6 +59,11 @@ int ups_available(const upstype_t *ups, nut_ctype_t *client);
 void listen_add(const char *addr, const char *port);
 
 void kick_login_clients(const char *upsname);
+int client_login_index(const nut_ctype_t *client, const char *upsname);
+int client_master_index(const nut_ctype_t *client, const char *upsname);
+void declogins(const char *upsname);
+void notify_fsd(const upstype_t *ups);
+void notify_numlogins(const upstype_t *ups);
 int sendback(nut_ctype_t *client, const char *fmt, ...)
 	__attribute__ ((__format__ (__printf__, 2, 3)));
 int send_err(nut_ctype_t *client, const char *errtype);
@@ -0,0 +1,72 @@
+#!/bin/sh
+################################################################################
+#
+# nut-fleet
+#   An utility to generate the ups.conf sections of a fleet of simulated
+#   devices, for upsd capacity planning and benchmarking.
+#   Each device is a 'dummy-ups' driver instance in simulation mode ("sim"),
+#   using the same definition file as a template, with its own random load
+#   and battery, and sharing the power outages of its group.
+#   Every fourth device is a PDU, with 8, 16 or 24 outlets.
+#
+#   Append the output to ups.conf, then start the fleet with 'upsdrvctl start'.
+#   For thousands of devices, raise the open files limit (ulimit -n) of upsd
+#   accordingly, since it keeps one socket open per driver.
+#
+################################################################################
+
+strUsage="Usage: nut-fleet <count> [template] [groups] [prefix]"
+
+# definition file used as a template, relative to the NUT sysconfig directory
+DEFAULT_TEMPLATE="evolution500.seq"
+
+# number of outage groups
+DEFAULT_GROUPS=10
+
+# devices are named <prefix><number>
+DEFAULT_PREFIX="fleet"
+
+# Process command line parameters
+if [ -z "$1" ]; then
+	echo "$strUsage"
+	exit 1
+else
+	devCount=$1
+fi
+
+devTemplate=${2:-$DEFAULT_TEMPLATE}
+devGroups=${3:-$DEFAULT_GROUPS}
+devPrefix=${4:-$DEFAULT_PREFIX}
+
+# both must be positive numbers
+for num in "$devCount" "$devGroups"; do
+	case "$num" in
+	""|*[!0-9]*)
+		num=0
+		;;
+	esac
+
+	if [ "$num" -lt 1 ]; then
+		echo "$strUsage"
+		exit 1
+	fi
+done
+
+awk -v count="$devCount" -v template="$devTemplate" -v groups="$devGroups" \
+	-v prefix="$devPrefix" 'BEGIN {
+	srand(count);
+	for (i = 1; i <= count; i++) {
+		printf("[%s%05d]\n", prefix, i);
+		printf("\tdriver = dummy-ups\n");
+		printf("\tport = %s\n", template);
+		printf("\tdesc = \"simulated device %d\"\n", i);
+		printf("\tsim\n");
+		printf("\tsim_seed = %d\n", i);
+		printf("\tsim_group = %d\n", i % groups);
+		printf("\tsim_load = %d\n", 10 + int(rand() * 70));
+		printf("\tsim_runtime = %d\n", 300 + int(rand() * 1500));
+		if (i % 4 == 0)
+			printf("\tsim_outlets = %d\n", 8 * (1 + int(rand() * 3)));
+		printf("\n");
+	}
+}'
@@ -0,0 +1,141 @@
+#!/bin/sh
+################################################################################
+#
+# nut-hidbench
+#   An utility to benchmark the HID drivers (usbhid-ups, mge-shut) on a
+#   session recorded with their 'record' option, and to check the replay.
+#   The driver replays the session once, at the given speed, and the report
+#   requests, strings, interrupts and device latency it logs for each poll
+#   cycle are summed up: this is how two versions of the driver logic are
+#   compared on the same device.
+#   Meanwhile, ups.status is read through upsd every second; the sequence of
+#   its values is printed, and compared with the expected one when given
+#   (one status per line, such as data/mge-shut-sim.status).
+#
+#   The driver is guessed from the session (mge-shut for a serial device,
+#   usbhid-ups otherwise), unless set by the DRIVER environment variable.
+#   upsc is taken from the build tree of the drivers if there, else from
+#   the PATH, unless set by the UPSC environment variable.
+#
+################################################################################
+
+strUsage="Usage: nut-hidbench <drivers directory> <upsd path> <session> [speed] [expected status]"
+
+DRIVERDIR="$1"
+UPSD="$2"
+SESSION="$3"
+SPEED="${4:-4}"
+EXPECTED="$5"
+POLLINTERVAL="${POLLINTERVAL:-2}"
+POLLFREQ="${POLLFREQ:-10}"
+PORT="${PORT:-34960}"
+USER="`id -un`"
+
+if [ -z "$DRIVERDIR" -o ! -d "$DRIVERDIR" -o -z "$UPSD" -o ! -x "$UPSD" -o -z "$SESSION" ]; then
+	echo "$strUsage"
+	echo "  drivers directory: where the driver binaries are"
+	echo "  upsd path: the server binary, to read the UPS status"
+	echo "  session: recorded with the 'record' driver option (such as data/mge-shut-sim.session)"
+	echo "  speed: of the replay (default: 4)"
+	echo "  expected status: the ups.status values the replay must go through"
+	exit 1
+fi
+
+if [ ! -r "$SESSION" ]; then
+	echo "Can't read $SESSION"
+	exit 1
+fi
+
+# the bus is the last field of the device line, in hexadecimal ("serial")
+if [ -z "$DRIVER" ]; then
+	if grep -q '^D .* 73657269616c$' "$SESSION"; then
+		DRIVER=mge-shut
+	else
+		DRIVER=usbhid-ups
+	fi
+fi
+
+if [ -z "$UPSC" ]; then
+	UPSC=upsc
+	[ -x "$DRIVERDIR/../clients/upsc" ] && UPSC="$DRIVERDIR/../clients/upsc"
+fi
+
+# replay the session once: its length is the time of its last exchange
+LENGTH="`awk -v speed="$SPEED" '!/^#/ && ($2 > end) { end = $2 } END { printf "%d", end / speed + 1 }' "$SESSION"`"
+
+# the driver runs from its state path
+case "$SESSION" in
+/*)	;;
+*)	SESSION="`pwd`/$SESSION" ;;
+esac
+
+WORKDIR="`mktemp -d /tmp/nut-hidbench.XXXXXX`" || exit 1
+PIDS=""
+trap 'kill $PIDS 2>/dev/null; rm -rf "$WORKDIR"' 0
+
+cat > "$WORKDIR/ups.conf" <<EOF
+[bench]
+	driver = $DRIVER
+	port = auto
+	pollinterval = $POLLINTERVAL
+	pollfreq = $POLLFREQ
+	replay = $SESSION
+	replayspeed = $SPEED
+EOF
+
+echo "LISTEN 127.0.0.1 $PORT" > "$WORKDIR/upsd.conf"
+: > "$WORKDIR/upsd.users"
+chmod 600 "$WORKDIR/upsd.users"
+
+NUT_CONFPATH="$WORKDIR" NUT_STATEPATH="$WORKDIR" \
+	"$DRIVERDIR/$DRIVER" -a bench -u "$USER" -D > "$WORKDIR/driver.log" 2>&1 &
+PIDS="$PIDS $!"
+
+NUT_CONFPATH="$WORKDIR" NUT_STATEPATH="$WORKDIR" \
+	"$UPSD" -u "$USER" -D > "$WORKDIR/upsd.log" 2>&1 &
+PIDS="$PIDS $!"
+
+# the distinct successive values of ups.status
+i=0
+while [ $i -lt $LENGTH ]; do
+	"$UPSC" bench@127.0.0.1:$PORT ups.status 2>/dev/null
+	sleep 1
+	i=`expr $i + 1`
+done | uniq > "$WORKDIR/status"
+
+kill $PIDS 2>/dev/null
+wait $PIDS 2>/dev/null
+PIDS=""
+
+printf "%-24s %6s %8s %10s %8s %10s %10s %10s %10s\n" "session" "speed" "cycles" "rep/cyc" "max" "str/cyc" "int/cyc" "ms/cyc" "max ms"
+
+# hidrec: cycle <n>: <reports> reports, <strings> strings, <interrupts> interrupts, <latency> ms
+awk -v session="`basename $SESSION`" -v speed="$SPEED" '
+	$2 == "hidrec:" && $3 == "cycle" {
+		cycles++
+		r += $5; s += $7; i += $9; l += $11
+		if ($5 > maxr) maxr = $5
+		if ($11 > maxl) maxl = $11
+	}
+	END {
+		if (!cycles) {
+			print session ": no poll cycle"
+			exit
+		}
+		printf "%-24s %6s %8d %10.2f %8d %10.2f %10.2f %10.3f %10.3f\n", session, speed, cycles,
+			r / cycles, maxr, s / cycles, i / cycles, l / cycles, maxl
+	}' "$WORKDIR/driver.log"
+
+echo
+echo "ups.status:"
+sed 's/^/	/' "$WORKDIR/status"
+
+if [ -n "$EXPECTED" ]; then
+	if grep -v '^#' "$EXPECTED" | cmp -s - "$WORKDIR/status"; then
+		echo "Replay check: OK"
+	else
+		echo "Replay check: FAILED, expected:"
+		grep -v '^#' "$EXPECTED" | sed 's/^/	/'
+		exit 1
+	fi
+fi
@@ -0,0 +1,147 @@
+#!/bin/sh
+################################################################################
+#
+# nut-repeaterbench
+#   An utility to measure the network traffic of dummy-ups in repeater mode,
+#   as between the tiers of a multi-site hierarchy of upsd servers.
+#   An upstream upsd serves <count> simulated UPSes, each replaying the same
+#   definition file, and as many dummy-ups repeaters relay them.
+#
+#   The traffic of the repeater connections is read from the kernel TCP
+#   counters (ss -ti, Linux only) after a warm-up, and reported per hour,
+#   first with 'maxinterval = 0' (a full LIST VAR on each update, as the
+#   repeater used to do), then with 'maxinterval' as set by the MAXINTERVAL
+#   environment variable (default: 60).  The wire bytes add 52 bytes of
+#   IPv4 and TCP headers (with timestamps) per segment, pure ACKs included.
+#
+################################################################################
+
+strUsage="Usage: nut-repeaterbench <dummy-ups path> <upsd path> [duration] [count] [definition file]"
+
+DRIVER="$1"
+UPSD="$2"
+DURATION="${3:-600}"
+COUNT="${4:-100}"
+DEVFILE="$5"
+POLLINTERVAL="${POLLINTERVAL:-2}"
+MAXINTERVAL="${MAXINTERVAL:-60}"
+WARMUP="${WARMUP:-10}"
+PORT="${PORT:-34950}"
+TOOLSDIR="`dirname $0`"
+USER="`id -un`"
+
+if [ -z "$DRIVER" -o ! -x "$DRIVER" -o -z "$UPSD" -o ! -x "$UPSD" ]; then
+	echo "$strUsage"
+	echo "  dummy-ups path: the driver binary, used for both tiers"
+	echo "  upsd path: the upstream server binary"
+	echo "  duration: of each measurement, in seconds (default: 600)"
+	echo "  count: number of UPSes (default: 100)"
+	echo "  definition file: replayed by each UPS (default: data/evolution500.seq)"
+	exit 1
+fi
+
+[ -z "$DEVFILE" ] && DEVFILE="$TOOLSDIR/../data/evolution500.seq"
+
+if [ ! -r "$DEVFILE" ]; then
+	echo "Can't read $DEVFILE"
+	exit 1
+fi
+
+WORKDIR="`mktemp -d /tmp/nut-repeaterbench.XXXXXX`" || exit 1
+PIDS=""
+trap 'kill $PIDS 2>/dev/null; rm -rf "$WORKDIR"' 0
+
+mkdir "$WORKDIR/up" "$WORKDIR/down"
+cp "$DEVFILE" "$WORKDIR/up/ups.dev"
+
+# TCP counters of the repeater connections: port, payload and segments
+tcpstats()
+{
+	ss -tinH state established "( dport = :$PORT )" | awk '
+		/^ *[0-9]/ { split($3, a, ":"); port = a[length(a)]; next }
+		{
+			sent = recv = segs = 0
+			for (i = 1; i <= NF; i++) {
+				split($i, kv, ":")
+				if (kv[1] == "bytes_sent") sent = kv[2]
+				if (kv[1] == "bytes_received") recv = kv[2]
+				if ((kv[1] == "segs_out") || (kv[1] == "segs_in")) segs += kv[2]
+			}
+			print port, sent, recv, segs
+		}'
+}
+
+# start the upstream upsd and its simulated UPSes
+i=1
+while [ $i -le $COUNT ]; do
+	printf "[u%d]\n\tdriver = dummy-ups\n\tport = ups.dev\n" $i
+	i=`expr $i + 1`
+done > "$WORKDIR/up/ups.conf"
+
+echo "LISTEN 127.0.0.1 $PORT" > "$WORKDIR/up/upsd.conf"
+: > "$WORKDIR/up/upsd.users"
+chmod 600 "$WORKDIR/up/upsd.users"
+
+i=1
+while [ $i -le $COUNT ]; do
+	NUT_CONFPATH="$WORKDIR/up" NUT_STATEPATH="$WORKDIR/up" \
+		"$DRIVER" -a u$i -u "$USER" -D > /dev/null 2>&1 &
+	PIDS="$PIDS $!"
+	i=`expr $i + 1`
+done
+sleep 2
+
+NUT_CONFPATH="$WORKDIR/up" NUT_STATEPATH="$WORKDIR/up" \
+	"$UPSD" -u "$USER" -D > "$WORKDIR/upsd.log" 2>&1 &
+PIDS="$PIDS $!"
+sleep 2
+
+printf "%-12s %6s %10s %10s %10s %12s %12s %12s\n" "maxinterval" "ups" "conns" "sent/h" "recv/h" "wire/h" "wire/h/ups" "segs/h"
+
+for maxinterval in 0 $MAXINTERVAL; do
+	i=1
+	while [ $i -le $COUNT ]; do
+		printf "[r%d]\n\tdriver = dummy-ups\n\tport = u%d@127.0.0.1:%d\n\tpollinterval = %d\n\tmaxinterval = %d\n" \
+			$i $i $PORT $POLLINTERVAL $maxinterval
+		i=`expr $i + 1`
+	done > "$WORKDIR/down/ups.conf"
+
+	RPIDS=""
+	i=1
+	while [ $i -le $COUNT ]; do
+		NUT_CONFPATH="$WORKDIR/down" NUT_STATEPATH="$WORKDIR/down" \
+			"$DRIVER" -a r$i -u "$USER" -D > /dev/null 2>&1 &
+		RPIDS="$RPIDS $!"
+		i=`expr $i + 1`
+	done
+	PIDS="$PIDS $RPIDS"
+
+	# leave out the first full lists, which don't depend on maxinterval
+	sleep $WARMUP
+	tcpstats > "$WORKDIR/start"
+	sleep $DURATION
+	tcpstats > "$WORKDIR/end"
+
+	kill $RPIDS 2>/dev/null
+	wait $RPIDS 2>/dev/null
+
+	# connections which were reopened meanwhile are not counted
+	awk -v mi="$maxinterval" -v count="$COUNT" -v duration="$DURATION" '
+		NR == FNR { sent[$1] = $2; recv[$1] = $3; segs[$1] = $4; next }
+		($1 in sent) {
+			conns++
+			s += $2 - sent[$1]
+			r += $3 - recv[$1]
+			g += $4 - segs[$1]
+		}
+		END {
+			if (!conns) {
+				print mi ": no repeater connection"
+				exit
+			}
+			h = 3600 / duration
+			printf "%-12s %6d %10d %10.0f %10.0f %12.0f %12.0f %12.0f\n", mi, count, conns, s * h, r * h, (s + r + 52 * g) * h, (s + r + 52 * g) * h / conns, g * h
+		}' "$WORKDIR/start" "$WORKDIR/end"
+
+	sleep 1
+done
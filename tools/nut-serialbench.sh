@@ -0,0 +1,97 @@
+#!/bin/sh
+################################################################################
+#
+# nut-serialbench
+#   An utility to benchmark the serial drivers against the serial UPS
+#   simulator (nut-serialsim.py), to quantify how many transactions a poll
+#   costs and how long a cycle takes at a given line speed, without a real
+#   device.
+#   Each driver polls the simulator during the given duration, and the
+#   transactions per poll cycle, the cycle time and the CPU time used by
+#   the driver are reported.
+#
+#   Drivers are given as 'driver:protocol', protocol being one of the
+#   simulator ones (megatec, voltronic, apcsmart). The simulator options
+#   (baud rate, latency, state script) are passed through the SERIALSIM_OPTS
+#   environment variable, for example: SERIALSIM_OPTS="-b 2400 -d 50"
+#
+################################################################################
+
+strUsage="Usage: nut-serialbench <drivers directory> [duration] [driver:protocol ...]"
+
+DRIVERDIR="$1"
+DURATION="${2:-60}"
+POLLINTERVAL="${POLLINTERVAL:-2}"
+TOOLSDIR="`dirname $0`"
+
+if [ -z "$DRIVERDIR" -o ! -d "$DRIVERDIR" ]; then
+	echo "$strUsage"
+	echo "  drivers directory: where the driver binaries to benchmark are"
+	echo "  duration: of each run, in seconds (default: 60)"
+	echo "  drivers: default to 'blazer_ser:megatec nutdrv_qx:megatec nutdrv_qx:voltronic apcsmart:apcsmart'"
+	exit 1
+fi
+
+shift
+[ $# -gt 0 ] && shift
+DRIVERS="${*:-blazer_ser:megatec nutdrv_qx:megatec nutdrv_qx:voltronic apcsmart:apcsmart}"
+
+WORKDIR="`mktemp -d /tmp/nut-serialbench.XXXXXX`" || exit 1
+trap 'rm -rf "$WORKDIR"' 0
+
+# CPU time (user + system) of a process, in clock ticks
+cputicks()
+{
+	awk '{ print $14 + $15 }' /proc/$1/stat 2>/dev/null || echo 0
+}
+
+printf "%-22s %8s %10s %10s %10s %10s\n" "driver" "cycles" "trans/cyc" "cycle(s)" "cpu(s)" "cpu/cycle"
+
+for spec in $DRIVERS; do
+	driver="${spec%%:*}"
+	protocol="${spec#*:}"
+	name="$driver:$protocol"
+
+	python "$TOOLSDIR/nut-serialsim.py" -l "$WORKDIR/tty" -o "$WORKDIR/stats" $SERIALSIM_OPTS $protocol 2>/dev/null &
+	simpid=$!
+	sleep 1
+
+	cat > "$WORKDIR/ups.conf" <<EOF
+[bench]
+	driver = $driver
+	port = $WORKDIR/tty
+	pollinterval = $POLLINTERVAL
+EOF
+
+	# nutdrv_qx would otherwise try the other protocols first
+	if [ "$driver" = "nutdrv_qx" ]; then
+		echo "	protocol = $protocol" >> "$WORKDIR/ups.conf"
+	fi
+
+	rm -f "$WORKDIR/stats"
+	NUT_CONFPATH="$WORKDIR" NUT_STATEPATH="$WORKDIR" \
+		"$DRIVERDIR/$driver" -a bench -u "`id -un`" -D > "$WORKDIR/$driver.log" 2>&1 &
+	driverpid=$!
+	sleep $DURATION
+
+	ticks=`cputicks $driverpid`
+	kill $driverpid 2>/dev/null
+	wait $driverpid 2>/dev/null
+	kill $simpid
+	wait $simpid 2>/dev/null
+
+	if [ ! -s "$WORKDIR/stats" ]; then
+		echo "$name: no statistics, see the driver output:"
+		tail -5 "$WORKDIR/$driver.log"
+		continue
+	fi
+
+	awk -v name="$name" -v ticks="$ticks" -v hz="`getconf CLK_TCK`" -F ': *' '
+		$1 == "cycles" { cycles = $2 }
+		$1 == "transactions/cycle" { trans = $2 }
+		$1 == "cycle time" { time = $2 + 0 }
+		END {
+			cpu = ticks / hz
+			printf "%-22s %8d %10.1f %10.3f %10.2f %10.3f\n", name, cycles, trans, time, cpu, cycles ? cpu / cycles : 0
+		}' "$WORKDIR/stats"
+done
@@ -0,0 +1,736 @@
+#!/usr/bin/env python
+#
+#   This program is free software; you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation; either version 2 of the License, or
+#   (at your option) any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program; if not, write to the Free Software
+#   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+# This program emulates a serial UPS on a pseudo-terminal, to exercise and
+# benchmark the serial drivers without a real device:
+#  - megatec: Megatec/Q1 protocol (blazer_ser, nutdrv_qx),
+#  - voltronic: Voltronic Power protocol (nutdrv_qx),
+#  - apcsmart: APC Smart protocol (apcsmart),
+#  - shut: MGE SHUT protocol (mge-shut), HID reports over a serial line,
+#  - bcmxcp: Powerware BCM/XCP protocol (bcmxcp), checksummed binary blocks.
+#
+# The UPS state comes from a script, one line per step:
+#	<seconds> <variable>=<value> ...
+# for example:
+#	0	status=OL input.voltage=230 battery.charge=100 ups.load=25
+#	60	status=OB input.voltage=0 battery.charge=80 battery.runtime=900
+#	120	status=OB,LB battery.charge=15 battery.runtime=120
+#	180	status=OL input.voltage=230
+# where status holds comma separated NUT status flags. Unset variables keep
+# a default value.
+#
+# The time the bytes take on the line at the configured baud rate (8N1)
+# and the response latency of the UPS are added to each transaction.
+# Bursts of transactions separated by more than the cycle gap are counted
+# as driver poll cycles; the statistics are printed on exit (SIGINT or
+# SIGTERM), and upon SIGUSR1.
+
+import sys
+import os
+import pty
+import tty
+import time
+import errno
+import select
+import signal
+import getopt
+import struct
+
+DEFAULTS = {
+	"ups.mfr": "NUT",
+	"ups.model": "Simulator",
+	"ups.firmware": "1.0",
+	"ups.serial": "SIM0001",
+	"status": "OL",
+	"input.voltage": 230.0,
+	"input.voltage.nominal": 230.0,
+	"input.frequency": 50.0,
+	"output.voltage": 230.0,
+	"output.frequency": 50.0,
+	"output.current": 1.5,
+	"ups.load": 25.0,
+	"ups.temperature": 30.0,
+	"battery.charge": 100.0,
+	"battery.voltage": 27.2,
+	"battery.voltage.nominal": 24.0,
+	"battery.runtime": 1800.0,
+}
+
+class State:
+
+	def __init__(self, script, loop):
+		self.steps = []
+		self.loop = loop
+		self.start = time.time()
+		if script:
+			for line in open(script):
+				fields = line.split("#")[0].split()
+				if not fields:
+					continue
+				assignments = {}
+				for field in fields[1:]:
+					name, value = field.split("=", 1)
+					try:
+						assignments[name] = float(value)
+					except ValueError:
+						assignments[name] = value
+				self.steps.append((float(fields[0]), assignments))
+		self.steps.sort(key = lambda step: step[0])
+
+	def current(self):
+		"""the UPS state at this time of the script"""
+		clock = time.time() - self.start
+		if self.loop and self.steps and self.steps[-1][0] > 0:
+			clock %= self.steps[-1][0]
+		state = dict(DEFAULTS)
+		for at, assignments in self.steps:
+			if at > clock:
+				break
+			state.update(assignments)
+		state["flags"] = set(str(state["status"]).split(","))
+		return state
+
+class Stats:
+
+	def __init__(self, gap):
+		self.gap = gap
+		self.transactions = 0
+		self.unanswered = 0
+		self.bytes_in = 0
+		self.bytes_out = 0
+		self.cycles = []	# [start, end, transactions]
+		self.last = 0
+
+	def account(self, request, response, start, end):
+		self.transactions += 1
+		self.bytes_in += len(request)
+		self.bytes_out += len(response)
+		if not response:
+			self.unanswered += 1
+		if not self.cycles or start - self.last > self.gap:
+			self.cycles.append([start, end, 0])
+		cycle = self.cycles[-1]
+		cycle[1] = end
+		cycle[2] += 1
+		self.last = end
+
+	def report(self, out):
+		out.write("transactions: %d (%d unanswered)\n" % (self.transactions, self.unanswered))
+		out.write("bytes: %d in, %d out\n" % (self.bytes_in, self.bytes_out))
+		if self.cycles:
+			first = self.cycles[0]
+			out.write("init: %d transactions, %.3f s\n" % (first[2], first[1] - first[0]))
+		# the last cycle may have been interrupted
+		cycles = self.cycles[1:-1]
+		out.write("cycles: %d\n" % len(cycles))
+		if cycles:
+			out.write("transactions/cycle: %.1f\n" % (float(sum(c[2] for c in cycles)) / len(cycles)))
+			out.write("cycle time: %.3f s\n" % (sum(c[1] - c[0] for c in cycles) / len(cycles)))
+		out.flush()
+
+#
+# Protocols: each one splits the input in requests, and answers them
+#
+
+class Megatec:
+
+	name = "megatec"
+
+	def split(self, buf):
+		"""return (request, rest of the buffer), or (None, buf)"""
+		pos = buf.find(b"\r")
+		if pos < 0:
+			return None, buf
+		return buf[:pos + 1], buf[pos + 1:]
+
+	def bits(self, state, names):
+		return "".join(("1" if state["flags"] & set(name.split("|")) else "0") for name in names)
+
+	def q1(self, s):
+		bits = self.bits(s, ("OB", "LB", "BYPASS|BOOST|TRIM", "ALARM", "OFF", "CAL|TEST", "FSD", "BEEPER"))
+		return "(%05.1f %05.1f %05.1f %03d %04.1f %04.1f %04.1f %s\r" % (s["input.voltage"], s["input.voltage"],
+			s["output.voltage"], s["ups.load"], s["input.frequency"], s["battery.voltage"], s["ups.temperature"], bits)
+
+	def answer(self, request, s):
+		cmd = request.decode("latin-1")
+		if cmd == "Q1\r":
+			return self.q1(s)
+		if cmd == "F\r":
+			return "#%05.1f %03d %05.1f %04.1f\r" % (s["input.voltage.nominal"], 4, s["battery.voltage.nominal"], 50.0)
+		if cmd == "I\r":
+			return "#%-15.15s %-10.10s %-10.10s\r" % (s["ups.mfr"], s["ups.model"], s["ups.firmware"])
+		# instant commands are not acknowledged
+		if cmd in ("Q\r", "C\r", "T\r", "TL\r", "CT\r") or cmd[0] in "ST":
+			return ""
+		# unknown commands are echoed back
+		return cmd
+
+class Voltronic(Megatec):
+
+	name = "voltronic"
+
+	# static replies, from the nutdrv_qx testing table
+	STATIC = {
+		"QRI\r": "(230.0 004 024.0 50.0\r",
+		"QMD\r": "(#######OLHVT1K0 ###1000 80 2/2 230 230 02 12.0\r",
+		"QFS\r": "(OK\r",
+		"QID\r": "(685653211455\r",
+		"QFLAG\r": "(EpashcjDbroegfl\r",
+		"QWS\r": "(0000000000000000000000000000000000000000000000000000000000000000\r",
+		"QHE\r": "(242 218\r",
+		"QBYV\r": "(264 170\r",
+		"QBYF\r": "(53.0 47.0\r",
+		"QBT\r": "(01\r",
+		"QGR\r": "(00\r",
+		"RE0\r": "#20\r",
+	}
+
+	def answer(self, request, s):
+		cmd = request.decode("latin-1")
+		if cmd == "QGS\r":
+			bits = self.bits(s, ("OB", "LB", "BYPASS|BOOST|TRIM", "ALARM", "-", "CAL|TEST", "FSD", "BEEPER", "-", "-"))
+			return "(%05.1f %04.1f %05.1f %04.1f %05.1f %03d %05.1f ---.- %05.1f ---.- %05.1f 10%s\r" % (
+				s["input.voltage"], s["input.frequency"], s["output.voltage"], s["output.frequency"],
+				s["output.current"], s["ups.load"], 369.1, s["battery.voltage"], s["ups.temperature"], bits)
+		if cmd == "QPI\r":
+			return "(PI01\r"
+		if cmd == "QBV\r":
+			return "(%05.1f 02 01 %03d %03d\r" % (s["battery.voltage"], s["battery.charge"], s["battery.runtime"] / 60)
+		if cmd == "QMOD\r":
+			return "(B\r" if "OB" in s["flags"] else "(L\r"
+		if cmd == "QMF\r":
+			return "(#####%s\r" % s["ups.mfr"]
+		if cmd == "QVFW\r":
+			return "(VERFW:%s\r" % s["ups.firmware"]
+		if cmd == "I\r":
+			return Megatec.answer(self, request, s)
+		if cmd == "F\r":
+			return Megatec.answer(self, request, s)
+		if cmd in self.STATIC:
+			return self.STATIC[cmd]
+		if cmd.startswith("QSK"):
+			return "(NAK\r"
+		# commands and settings
+		return "(ACK\r" if cmd[0] in "PSBHTW" else "(NAK\r"
+
+class APCSmart:
+
+	name = "apcsmart"
+
+	# on a known firmware, the driver uses the compatibility table of
+	# apcsmart_tabs.c rather than asking the command set
+	FIRMWARE = "6QD"
+
+	def __init__(self):
+		self.status = None
+
+	def split(self, buf):
+		if not buf:
+			return None, buf
+		return buf[:1], buf[1:]
+
+	def status_byte(self, s):
+		flags = s["flags"]
+		value = 0
+		for bit, name in ((0, "CAL"), (1, "TRIM"), (2, "BOOST"), (3, "OL"), (4, "OB"), (5, "OVER"), (6, "LB"), (7, "RB")):
+			if name in flags:
+				value |= 1 << bit
+		return value
+
+	def alert(self, s):
+		"""return the asynchronous alert characters on status changes"""
+		status = self.status_byte(s)
+		out = ""
+		if self.status is not None:
+			changed = status ^ self.status
+			if changed & (1 << 4):
+				out += "!" if status & (1 << 4) else "$"
+			if changed & (1 << 6) and status & (1 << 6):
+				out += "%"
+		self.status = status
+		return out
+
+	def answer(self, request, s):
+		cmd = request.decode("latin-1")
+		values = {
+			"Y": "SM",
+			"R": "BYE",
+			"V": self.FIRMWARE,
+			"Q": "%02X" % self.status_byte(s),
+			"\x01": s["ups.model"],
+			"n": s["ups.serial"],
+			"b": "50.14.D",
+			"m": "01/01/15",
+			"x": "01/01/15",
+			"c": "UPS_IDEN",
+			"C": "%05.1f" % s["ups.temperature"],
+			"P": "%05.1f" % s["ups.load"],
+			"L": "%05.1f" % s["input.voltage"],
+			"M": "%05.1f" % s["input.voltage"],
+			"N": "%05.1f" % s["input.voltage"],
+			"F": "%05.2f" % s["input.frequency"],
+			"O": "%05.1f" % s["output.voltage"],
+			"f": "%05.1f" % s["battery.charge"],
+			"B": "%05.2f" % s["battery.voltage"],
+			"j": "%04d:" % (s["battery.runtime"] / 60),
+			"G": "S" if "OB" in s["flags"] else "O",
+			"X": "OK",
+			"9": "FF",
+			"E": "336",
+			"r": "000",
+			"p": "020",
+			"e": "00",
+			"l": "196",
+			"u": "253",
+			"s": "H",
+			"o": "230",
+			"g": "024",
+			"q": "02",
+			"k": "0",
+			"7": "0F",
+			"8": "FF",
+		}
+		if cmd in values:
+			return values[cmd] + "\r\n"
+		if cmd == "\x1b":
+			return ""
+		# shutdown and test commands
+		if cmd in "@ADKSUWZ":
+			return "OK\r\n"
+		return "NA\r\n"
+
+class SHUT:
+
+	name = "shut"
+
+	SYNC = 0x18
+	ACK = 0x06
+	NOK = 0x15
+	REQUEST = 0x01
+	RESPONSE = 0x04
+	LAST = 0x80
+
+	# HID usages (with their usage page) of the report descriptor
+	UPS = 0x00840004
+	POWERSUMMARY = 0x00840024
+	PRESENTSTATUS = 0x00840002
+	POWERCONVERTER = 0x00840016
+	INPUT = 0x0084001a
+	OUTPUT = 0x0084001c
+
+	# feature reports: id, collection path, [(usage, bits, unit exponent, value)]
+	# a usage of 0 is padding
+	REPORTS = (
+		(1, (UPS, POWERSUMMARY), [(0x00850066, 8, 0, lambda s: s["battery.charge"])]),
+		(2, (UPS, POWERSUMMARY), [(0x00850068, 16, 0, lambda s: s["battery.runtime"])]),
+		(3, (UPS, POWERSUMMARY), [(0x00840035, 8, 0, lambda s: s["ups.load"])]),
+		(4, (UPS, POWERSUMMARY, PRESENTSTATUS), [
+			(0x008500d0, 1, 0, lambda s: "OL" in s["flags"]),
+			(0x00850044, 1, 0, lambda s: "CHRG" in s["flags"]),
+			(0x00850045, 1, 0, lambda s: "OB" in s["flags"]),
+			(0x00850042, 1, 0, lambda s: "LB" in s["flags"]),
+			(0, 4, 0, None)]),
+		(5, (UPS, POWERCONVERTER, (INPUT, 1)), [
+			(0x00840030, 16, -1, lambda s: s["input.voltage"]),
+			(0x00840032, 16, -1, lambda s: s["input.frequency"])]),
+		(6, (UPS, POWERCONVERTER, OUTPUT), [(0x00840030, 16, -1, lambda s: s["output.voltage"])]),
+	)
+
+	STRINGS = { 1: "ups.mfr", 2: "ups.model", 3: "ups.serial" }
+
+	def __init__(self):
+		self.pending = []	# response frames not yet acknowledged
+		self.sent = None	# last frame sent, for a NOK
+		self.setting = False	# the data frame of a SET_REPORT is next
+		self.rdesc = self.report_descriptor()
+
+	def item(self, prefix, value, size = 1):
+		return bytes([prefix | {1: 1, 2: 2, 4: 3}[size]]) + (value & ((1 << (8 * size)) - 1)).to_bytes(size, "little")
+
+	def report_descriptor(self):
+		desc = b""
+		path = ()
+		for reportid, collections, fields in self.REPORTS:
+			# close and open collections down to this report
+			common = 0
+			while common < min(len(path), len(collections)) and path[common] == collections[common]:
+				common += 1
+			desc += b"\xc0" * (len(path) - common)
+			for collection in collections[common:]:
+				usage, index = collection if isinstance(collection, tuple) else (collection, 0)
+				desc += self.item(0x08, usage, 4)
+				desc += self.item(0xa0, (0x80 | index) if index else (1 if usage == self.UPS else 0))
+			path = collections
+			desc += self.item(0x84, reportid)
+			for usage, bits, exponent, value in fields:
+				if usage:
+					desc += self.item(0x08, usage, 4)
+				desc += self.item(0x14, 0)
+				desc += self.item(0x24, (1 << min(bits, 15)) - 1, 2)
+				desc += self.item(0x54, exponent & 0x0f)
+				desc += self.item(0x74, bits) + self.item(0x94, 1)
+				desc += self.item(0xb0, 0x02 if usage else 0x01)
+		return desc + b"\xc0" * len(path)
+
+	def report(self, reportid, s):
+		for rid, collections, fields in self.REPORTS:
+			if rid != reportid:
+				continue
+			data, offset = 0, 0
+			for usage, bits, exponent, value in fields:
+				if value:
+					logical = int(round(float(value(s)) / 10 ** exponent))
+					data |= (logical & ((1 << bits) - 1)) << offset
+				offset += bits
+			return bytes([reportid]) + data.to_bytes((offset + 7) // 8, "little")
+		return None
+
+	def string(self, value):
+		value = str(value).encode("utf-16-le")
+		return bytes([len(value) + 2, 3]) + value
+
+	def descriptor(self, kind, index, s):
+		if kind == 0x01:
+			return bytes([18, 1, 0x10, 0x01, 0, 0, 0, 8, 0x63, 0x04, 0xff, 0xff, 0x00, 0x01, 1, 2, 3, 1])
+		if kind == 0x21:
+			return bytes([9, 0x21, 0x10, 0x01, 0, 1, 0x22]) + len(self.rdesc).to_bytes(2, "little")
+		if kind == 0x22:
+			return self.rdesc
+		if kind == 0x03 and index in self.STRINGS:
+			return self.string(s[self.STRINGS[index]])
+		return None
+
+	def split(self, buf):
+		if not buf:
+			return None, buf
+		if buf[0] not in (self.REQUEST, self.REQUEST | self.LAST):
+			return buf[:1], buf[1:]
+		if len(buf) < 2:
+			return None, buf
+		size = 3 + (buf[1] & 0x0f)
+		if len(buf) < size:
+			return None, buf
+		return buf[:size], buf[size:]
+
+	def frames(self, data):
+		"""the response frames carrying data, 8 bytes at most each"""
+		frames = []
+		for pos in range(0, max(len(data), 1), 8):
+			chunk = data[pos:pos + 8]
+			kind = self.RESPONSE | (self.LAST if pos + 8 >= len(data) else 0)
+			checksum = 0
+			for byte in chunk:
+				checksum ^= byte
+			frames.append(bytes([kind, (len(chunk) << 4) | len(chunk)]) + chunk + bytes([checksum]))
+		return frames
+
+	def send(self):
+		self.sent = self.pending.pop(0) if self.pending else None
+		return self.sent or b""
+
+	def control(self, ctrl, s):
+		requesttype, request = ctrl[0], ctrl[1]
+		value = int.from_bytes(ctrl[2:4], "little")
+		length = int.from_bytes(ctrl[6:8], "little")
+		data = None
+		if requesttype == 0xa1 and request == 0x01:
+			data = self.report(value & 0xff, s)
+		elif requesttype in (0x80, 0x81) and request == 0x06:
+			data = self.descriptor(value >> 8, value & 0xff, s)
+		elif requesttype == 0x21 and request == 0x09:
+			self.setting = True
+		if data is not None:
+			self.pending = self.frames(data[:length])
+
+	def answer(self, request, s):
+		if request[0] == self.SYNC:
+			self.pending = []
+			return chr(self.SYNC)
+		if request[0] == self.ACK:
+			return self.send().decode("latin-1")
+		if request[0] == self.NOK:
+			return (self.sent or b"").decode("latin-1")
+		if len(request) < 3:
+			return ""
+		checksum = 0
+		for byte in request[2:-1]:
+			checksum ^= byte
+		if checksum != request[-1]:
+			return chr(self.NOK)
+		# the data of a SET_REPORT change nothing in the state
+		if self.setting:
+			self.setting = False
+		elif len(request) == 11:
+			self.control(request[2:10], s)
+		return (bytes([self.ACK]) + self.send()).decode("latin-1")
+
+class BCMXCP:
+
+	name = "bcmxcp"
+
+	START = 0xab
+	# largest data of an answer frame, longer blocks are split
+	FRAME = 121
+
+	# meters: number, format, value; formats are floating point ones
+	# (width and precision in packed BCD), or 0xf0 for a long integer
+	METERS = (
+		(27, 0x41, lambda s: s["output.frequency"]),
+		(28, 0x41, lambda s: s["input.frequency"]),
+		(33, 0x41, lambda s: s["battery.voltage"]),
+		(34, 0x30, lambda s: s["battery.charge"]),
+		(35, 0xf0, lambda s: s["battery.runtime"]),
+		(47, 0x30, lambda s: s["ups.load"]),
+		(56, 0x30, lambda s: s["input.voltage"]),
+		(63, 0x30, lambda s: s["ups.temperature"]),
+		(78, 0x30, lambda s: s["output.voltage"]),
+	)
+
+	# alarms: number, NUT status flag; the alarm block holds a byte
+	# for each supported alarm, in the order of their numbers
+	ALARMS = ((56, "LB"), (168, "OB"))
+	# the whole alarm map is sent, as bcmxcp reads the alarms beyond its
+	# end as the first one of the alarm block
+	ALARM_MAP = 33
+
+	CONFIG = 80
+	LIMITS = 32
+
+	def split(self, buf):
+		if not buf:
+			return None, buf
+		# the ESC taking the UPS out of its menu, or line noise
+		if buf[0] != self.START:
+			return buf[:1], buf[1:]
+		if len(buf) < 2:
+			return None, buf
+		size = 3 + buf[1]
+		if len(buf) < size:
+			return None, buf
+		return buf[:size], buf[size:]
+
+	def word(self, value):
+		return int(value).to_bytes(2, "little")
+
+	def id_block(self, s):
+		meters = bytearray(max(meter[0] for meter in self.METERS) + 1)
+		for number, format, value in self.METERS:
+			meters[number] = format
+		alarms = bytearray(self.ALARM_MAP)
+		for number, flag in self.ALARMS:
+			alarms[number // 8] |= 1 << (number % 8)
+		model = str(s["ups.model"]).encode("latin-1")
+		# one CPU (firmware 1.0), 1 kVA, single phase
+		return (bytes([1, 0x00, 0x01, 1, 1, 0, len(model)]) + model
+			+ bytes([len(meters)]) + meters + bytes([len(alarms)]) + alarms
+			+ self.word(self.CONFIG) + bytes([0]) + self.word(0) + self.word(0)
+			+ self.word(0) + bytes([8]) + self.word(0) + self.word(0) + self.word(len(self.ALARMS)))
+
+	def meter_block(self, s):
+		data = b""
+		for number, format, value in sorted(self.METERS):
+			if format == 0xf0:
+				data += int(value(s)).to_bytes(4, "little", signed = True)
+			else:
+				data += struct.pack("<f", float(value(s)))
+		return data
+
+	def config_block(self, s):
+		data = bytearray(self.CONFIG)
+		data[8:10] = self.word(s["output.voltage"])
+		data[64:80] = str(s["ups.serial"]).encode("latin-1")[:15].ljust(16, b"\0")
+		return bytes(data)
+
+	def limit_block(self, s):
+		data = bytearray(self.LIMITS)
+		data[0:2] = self.word(s["input.voltage.nominal"])
+		return bytes(data)
+
+	def block(self, command, s):
+		if command == 0x31:
+			return self.id_block(s)
+		if command == 0x33:
+			return bytes([0xf0 if "OB" in s["flags"] else 0x50, 0])
+		if command == 0x34:
+			return self.meter_block(s)
+		if command == 0x35:
+			return bytes([1 if flag in s["flags"] else 0 for number, flag in sorted(self.ALARMS)])
+		if command == 0x36:
+			return self.config_block(s)
+		if command == 0x3b:
+			# no battery test, no external string, charging or discharging
+			return bytes(18) + bytes([0, 1, 2 if "OB" in s["flags"] else 1, 3])
+		if command == 0x3c:
+			return self.limit_block(s)
+		# commands and settings: accepted, no configurable variable
+		return bytes([0x31])
+
+	def frames(self, number, data):
+		"""the answer frames carrying data, with their sequence numbers"""
+		out = b""
+		for pos in range(0, len(data), self.FRAME):
+			chunk = data[pos:pos + self.FRAME]
+			sequence = pos // self.FRAME + 1
+			if pos + self.FRAME >= len(data):
+				sequence |= 0x80
+			frame = bytes([self.START, number, len(chunk), sequence]) + chunk
+			out += frame + bytes([-sum(frame) & 0xff])
+		return out
+
+	def answer(self, request, s):
+		if request[0] != self.START or len(request) < 4 or sum(request) & 0xff:
+			return ""
+		command = request[2]
+		# the authorization code is not answered
+		if command == 0xcf:
+			return ""
+		if command <= 0x43:
+			number = command - 0x30
+		elif command == 0xa0:
+			number = 0x01
+		else:
+			number = 0x09
+		return self.frames(number, self.block(command, s)).decode("latin-1")
+
+PROTOCOLS = { "megatec": Megatec, "voltronic": Voltronic, "apcsmart": APCSmart, "shut": SHUT, "bcmxcp": BCMXCP }
+
+def usage():
+	print("Usage: nut-serialsim.py [options] <protocol>")
+	print("")
+	print("  protocol: %s" % ", ".join(sorted(PROTOCOLS.keys())))
+	print("")
+	print("  -l <link>          symlink to create to the serial port (default: print its name)")
+	print("  -s <script>        UPS state script")
+	print("  -r                 loop over the state script")
+	print("  -b <baud>          line speed, in bits per second (default: 2400, 0: unlimited)")
+	print("  -d <ms>            UPS response latency, in milliseconds (default: 0)")
+	print("  -g <seconds>       idle gap ending a poll cycle (default: 1)")
+	print("  -o <file>          write the statistics to this file on exit")
+
+def main():
+	try:
+		opts, args = getopt.getopt(sys.argv[1:], "hl:s:rb:d:g:o:")
+	except getopt.GetoptError as err:
+		print(err)
+		usage()
+		sys.exit(2)
+
+	link = None
+	script = None
+	loop = False
+	baud = 2400
+	latency = 0.0
+	gap = 1.0
+	statsfile = None
+
+	for opt, arg in opts:
+		if opt == "-h":
+			usage()
+			sys.exit(0)
+		elif opt == "-l":
+			link = arg
+		elif opt == "-s":
+			script = arg
+		elif opt == "-r":
+			loop = True
+		elif opt == "-b":
+			baud = int(arg)
+		elif opt == "-d":
+			latency = float(arg) / 1000
+		elif opt == "-g":
+			gap = float(arg)
+		elif opt == "-o":
+			statsfile = arg
+
+	if len(args) != 1 or args[0] not in PROTOCOLS:
+		usage()
+		sys.exit(2)
+
+	protocol = PROTOCOLS[args[0]]()
+	state = State(script, loop)
+	stats = Stats(gap)
+
+	# keep the slave side open, so that the master side survives the
+	# driver closing the port
+	master, slave = pty.openpty()
+	tty.setraw(slave)
+	port = os.ttyname(slave)
+
+	if link:
+		if os.path.islink(link):
+			os.unlink(link)
+		os.symlink(port, link)
+
+	def report(signum, frame):
+		stats.report(sys.stdout)
+
+	def terminate(signum, frame):
+		if link and os.path.islink(link):
+			os.unlink(link)
+		if statsfile:
+			stats.report(open(statsfile, "w"))
+		else:
+			stats.report(sys.stdout)
+		sys.exit(0)
+
+	signal.signal(signal.SIGUSR1, report)
+	signal.signal(signal.SIGTERM, terminate)
+	signal.signal(signal.SIGINT, terminate)
+
+	sys.stderr.write("nut-serialsim: %s UPS on %s\n" % (protocol.name, link or port))
+
+	# time a byte takes on the line (start bit, 8 data bits, stop bit)
+	bytetime = 10.0 / baud if baud else 0
+	buf = b""
+
+	while True:
+		try:
+			ready = select.select([master], [], [], 0.1)[0]
+		except select.error as err:
+			# interrupted by SIGUSR1
+			if err.args[0] == errno.EINTR:
+				continue
+			raise
+
+		current = state.current()
+
+		if hasattr(protocol, "alert"):
+			alert = protocol.alert(current)
+			if alert:
+				os.write(master, alert.encode("latin-1"))
+
+		if not ready:
+			continue
+
+		start = time.time()
+		buf += os.read(master, 1024)
+
+		while True:
+			request, buf = protocol.split(buf)
+			if request is None:
+				break
+			response = protocol.answer(request, current).encode("latin-1")
+			delay = (len(request) + len(response)) * bytetime + latency
+			if delay > 0:
+				time.sleep(delay)
+			if response:
+				os.write(master, response)
+			end = time.time()
+			stats.account(request, response, start, end)
+			start = end
+
+if __name__ == "__main__":
+	main()
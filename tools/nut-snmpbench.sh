@@ -0,0 +1,101 @@
+#!/bin/sh
+################################################################################
+#
+# nut-snmpbench
+#   An utility to benchmark the snmp-ups driver against the SNMP agent
+#   simulator (nut-snmpsim.py), to judge changes of the driver SNMP engine
+#   objectively, without a real device.
+#   For each mib, the driver polls the simulator during the given duration,
+#   and the requests and varbinds per poll cycle, the cycle time and the
+#   CPU time used by the driver are reported.
+#
+#   Mibs are given as 'mib' (the walk is synthesized from the mib2nut table)
+#   or 'mib:walkfile' (recorded with 'snmpwalk -On -v1 -c public host .1').
+#   The simulator options (latency, loss, max varbinds) are passed through
+#   the SNMPSIM_OPTS environment variable, for example: SNMPSIM_OPTS="-l 20"
+#
+################################################################################
+
+strUsage="Usage: nut-snmpbench <driver path> [duration] [mib[:walkfile] ...]"
+
+DRIVER="$1"
+DURATION="${2:-60}"
+POLLFREQ="${POLLFREQ:-5}"
+PORT="${PORT:-16100}"
+TOOLSDIR="`dirname $0`"
+
+if [ -z "$DRIVER" -o ! -x "$DRIVER" ]; then
+	echo "$strUsage"
+	echo "  driver path: the snmp-ups binary to benchmark"
+	echo "  duration: of each run, in seconds (default: 60)"
+	echo "  mibs: default to 'ietf eaton_epdu apcc'"
+	exit 1
+fi
+
+shift
+[ $# -gt 0 ] && shift
+MIBS="${*:-ietf eaton_epdu apcc}"
+
+WORKDIR="`mktemp -d /tmp/nut-snmpbench.XXXXXX`" || exit 1
+trap 'rm -rf "$WORKDIR"' 0
+
+# CPU time (user + system) of a process, in clock ticks
+cputicks()
+{
+	awk '{ print $14 + $15 }' /proc/$1/stat 2>/dev/null || echo 0
+}
+
+printf "%-12s %8s %10s %10s %10s %10s %10s\n" "mib" "cycles" "req/cycle" "vb/cycle" "cycle(s)" "cpu(s)" "cpu/cycle"
+
+for spec in $MIBS; do
+	mib="${spec%%:*}"
+	walk="${spec#*:}"
+
+	if [ "$walk" = "$spec" ]; then
+		source="-m $mib"
+	else
+		source="$walk"
+	fi
+
+	python "$TOOLSDIR/nut-snmpsim.py" -p $PORT -o "$WORKDIR/$mib.stats" $SNMPSIM_OPTS $source 2>/dev/null &
+	simpid=$!
+	sleep 1
+
+	cat > "$WORKDIR/ups.conf" <<EOF
+[bench]
+	driver = snmp-ups
+	port = 127.0.0.1:$PORT
+	mibs = $mib
+	pollfreq = $POLLFREQ
+	pollinterval = 1
+EOF
+
+	NUT_CONFPATH="$WORKDIR" NUT_STATEPATH="$WORKDIR" \
+		"$DRIVER" -a bench -u "`id -un`" -D > "$WORKDIR/$mib.log" 2>&1 &
+	driverpid=$!
+	sleep $DURATION
+
+	ticks=`cputicks $driverpid`
+	kill $driverpid 2>/dev/null
+	wait $driverpid 2>/dev/null
+	kill $simpid
+	wait $simpid 2>/dev/null
+
+	if [ ! -s "$WORKDIR/$mib.stats" ]; then
+		echo "$mib: no statistics, see the driver output:"
+		tail -5 "$WORKDIR/$mib.log"
+		continue
+	fi
+
+	awk -v mib="$mib" -v ticks="$ticks" -v hz="`getconf CLK_TCK`" -F ': *' '
+		$1 == "cycles" { cycles = $2 }
+		$1 == "requests/cycle" { req = $2 }
+		$1 == "varbinds/cycle" { vb = $2 }
+		$1 == "cycle time" { time = $2 + 0 }
+		END {
+			cpu = ticks / hz
+			printf "%-12s %8d %10.1f %10.1f %10.3f %10.2f %10.3f\n", mib, cycles, req, vb, time, cpu, cycles ? cpu / cycles : 0
+		}' "$WORKDIR/$mib.stats"
+
+	PORT=`expr $PORT + 1`
+done
@@ -0,0 +1,583 @@
+#!/usr/bin/env python
+#
+#   This program is free software; you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation; either version 2 of the License, or
+#   (at your option) any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program; if not, write to the Free Software
+#   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+# This program is a minimal SNMP (v1 and v2c) agent, answering GET,
+# GETNEXT, GETBULK and SET requests on localhost from a recorded walk, to
+# exercise and benchmark the snmp-ups driver without a real device.
+#
+# The walk is either recorded from a device, with numeric OIDs:
+#	snmpwalk -On -v1 -c public <device> .1 > device.walk
+# or synthesized from the mib2nut tables of snmp-ups (drivers/*-mib.c),
+# with placeholder values, using the "-m" option and the mib name used in
+# ups.conf ("mibs" option).
+#
+# Requests are answered one at a time, like most embedded agents do, after
+# the configured latency. Bursts of requests separated by more than the
+# cycle gap are counted as driver poll cycles; the statistics are printed
+# on exit (SIGINT or SIGTERM), and upon SIGUSR1.
+
+import sys
+import os
+import errno
+import re
+import glob
+import time
+import socket
+import signal
+import random
+import getopt
+
+# ASN.1 / SNMP tags
+ASN_INTEGER = 0x02
+ASN_OCTET_STR = 0x04
+ASN_NULL = 0x05
+ASN_OID = 0x06
+ASN_SEQUENCE = 0x30
+ASN_IPADDRESS = 0x40
+ASN_COUNTER = 0x41
+ASN_GAUGE = 0x42
+ASN_TIMETICKS = 0x43
+ASN_OPAQUE = 0x44
+ASN_COUNTER64 = 0x46
+SNMP_NOSUCHOBJECT = 0x80
+SNMP_NOSUCHINSTANCE = 0x81
+SNMP_ENDOFMIBVIEW = 0x82
+
+PDU_GET = 0xa0
+PDU_GETNEXT = 0xa1
+PDU_RESPONSE = 0xa2
+PDU_SET = 0xa3
+PDU_GETBULK = 0xa5
+
+PDU_NAMES = { PDU_GET: "get", PDU_GETNEXT: "getnext", PDU_SET: "set", PDU_GETBULK: "getbulk" }
+
+ERR_TOOBIG = 1
+ERR_NOSUCHNAME = 2
+ERR_BADVALUE = 3
+ERR_NOCREATION = 11
+
+#
+# BER encoding
+#
+
+def ber_length(n):
+	if n < 0x80:
+		return bytearray([n])
+	out = bytearray()
+	while n:
+		out.insert(0, n & 0xff)
+		n >>= 8
+	return bytearray([0x80 | len(out)]) + out
+
+def ber_tlv(tag, data):
+	return bytearray([tag]) + ber_length(len(data)) + data
+
+def ber_int(value, tag = ASN_INTEGER, unsigned = False):
+	out = bytearray()
+	while True:
+		out.insert(0, value & 0xff)
+		value >>= 8
+		if unsigned:
+			if value == 0 and not out[0] & 0x80:
+				break
+		elif (value == 0 and not out[0] & 0x80) or (value == -1 and out[0] & 0x80):
+			break
+	return ber_tlv(tag, out)
+
+def ber_oid(oid):
+	out = bytearray([oid[0] * 40 + oid[1]])
+	for sub in oid[2:]:
+		chunk = bytearray([sub & 0x7f])
+		sub >>= 7
+		while sub:
+			chunk.insert(0, 0x80 | (sub & 0x7f))
+			sub >>= 7
+		out += chunk
+	return ber_tlv(ASN_OID, out)
+
+def ber_value(tag, value):
+	if tag == ASN_INTEGER:
+		return ber_int(value)
+	if tag in (ASN_COUNTER, ASN_GAUGE, ASN_TIMETICKS, ASN_COUNTER64):
+		return ber_int(value, tag, True)
+	if tag == ASN_OID:
+		return ber_oid(value)
+	if tag in (ASN_NULL, SNMP_NOSUCHOBJECT, SNMP_NOSUCHINSTANCE, SNMP_ENDOFMIBVIEW):
+		return ber_tlv(tag, bytearray())
+	return ber_tlv(tag, bytearray(value))
+
+#
+# BER decoding
+#
+
+def ber_decode(data, pos = 0):
+	"""return (tag, content, next position)"""
+	tag = data[pos]
+	length = data[pos + 1]
+	pos += 2
+	if length & 0x80:
+		count = length & 0x7f
+		length = 0
+		for i in range(count):
+			length = (length << 8) | data[pos + i]
+		pos += count
+	if pos + length > len(data):
+		raise ValueError("truncated")
+	return tag, data[pos:pos + length], pos + length
+
+def ber_items(data):
+	pos = 0
+	items = []
+	while pos < len(data):
+		tag, content, pos = ber_decode(data, pos)
+		items.append((tag, content))
+	return items
+
+def decode_int(content):
+	value = 0
+	for byte in content:
+		value = (value << 8) | byte
+	if content and content[0] & 0x80:
+		value -= 1 << (8 * len(content))
+	return value
+
+def decode_oid(content):
+	oid = [content[0] // 40, content[0] % 40]
+	sub = 0
+	for byte in content[1:]:
+		sub = (sub << 7) | (byte & 0x7f)
+		if not byte & 0x80:
+			oid.append(sub)
+			sub = 0
+	return tuple(oid)
+
+def decode_value(tag, content):
+	if tag == ASN_INTEGER:
+		return decode_int(content)
+	if tag in (ASN_COUNTER, ASN_GAUGE, ASN_TIMETICKS, ASN_COUNTER64):
+		value = 0
+		for byte in content:
+			value = (value << 8) | byte
+		return value
+	if tag == ASN_OID:
+		return decode_oid(content)
+	return bytearray(content)
+
+#
+# MIB database
+#
+
+def parse_oid(text):
+	return tuple(int(sub) for sub in text.strip().strip(".").split("."))
+
+def format_oid(oid):
+	return "." + ".".join(str(sub) for sub in oid)
+
+class Database:
+
+	def __init__(self):
+		self.values = {}
+		self.order = []
+
+	def set(self, oid, tag, value):
+		if oid not in self.values:
+			self.order = None
+		self.values[oid] = (tag, value)
+
+	def get(self, oid):
+		return self.values.get(oid)
+
+	def next(self, oid):
+		"""return the first OID after oid, or None"""
+		if self.order is None:
+			self.order = sorted(self.values.keys())
+		lo, hi = 0, len(self.order)
+		while lo < hi:
+			mid = (lo + hi) // 2
+			if self.order[mid] <= oid:
+				lo = mid + 1
+			else:
+				hi = mid
+		if lo < len(self.order):
+			return self.order[lo]
+		return None
+
+	def load_walk(self, filename):
+		"""load the output of snmpwalk -On"""
+		line_re = re.compile(r'^(\.?[0-9][0-9.]*)\s*=\s*(?:([A-Za-z0-9-]+):\s*)?(.*)$')
+		last = None
+		for line in open(filename):
+			line = line.rstrip("\r\n")
+			match = line_re.match(line)
+			if not match:
+				# continuation of a multi-line string
+				if last is not None and last[1] == ASN_OCTET_STR:
+					tag, value = self.values[last[0]]
+					self.values[last[0]] = (tag, value + bytearray(b"\n") + bytearray(line.rstrip('"').encode("latin-1")))
+				continue
+			oid = parse_oid(match.group(1))
+			kind = (match.group(2) or "").upper()
+			text = match.group(3).strip()
+			last = None
+			if kind == "" and text.startswith("No "):
+				continue
+			tag, value = parse_walk_value(kind, text)
+			self.set(oid, tag, value)
+			last = (oid, tag)
+
+	def load_mib2nut(self, srcdir, mibname, instances):
+		"""synthesize a walk covering the OIDs of a mib2nut table"""
+		for filename in sorted(glob.glob(os.path.join(srcdir, "*-mib.c"))):
+			source = re.sub(r'/\*.*?\*/', '', open(filename).read(), flags = re.S)
+			defines = dict(re.findall(r'^\s*#\s*define\s+(\w+)\s+(.+?)\s*$', source, re.M))
+			for fields in re.findall(r'mib2nut_info_t\s+\w+\s*=\s*\{(.*?)\}\s*;', source, re.S):
+				fields = [f.strip() for f in fields.split(",")]
+				if expand_c_string(fields[0], defines) != mibname:
+					continue
+				table = fields[4]
+				body = re.search(r'snmp_info_t\s+' + table + r'\s*\[\s*\]\s*=\s*\{(.*?)\n\}\s*;', source, re.S)
+				if not body:
+					sys.exit("%s: table %s not found" % (filename, table))
+				for entry in re.findall(r'\{\s*("[^"]*")\s*,([^,]*),([^,]*),([^,]*),', body.group(1)):
+					name = expand_c_string(entry[0], defines)
+					oid = expand_c_string(entry[3], defines)
+					if not oid:
+						continue
+					if "ST_FLAG_STRING" in entry[1]:
+						tag, value = ASN_OCTET_STR, bytearray(name.encode("ascii"))
+					else:
+						tag, value = ASN_INTEGER, 1
+					if "%i" in oid:
+						for i in range(1, instances + 1):
+							self.set(parse_oid(oid.replace("%i", str(i))), tag, value)
+					else:
+						self.set(parse_oid(oid), tag, value)
+				# auto check OID, and sysObjectID for the "auto" mibs
+				oid = expand_c_string(fields[3], defines)
+				if oid and self.get(parse_oid(oid)) is None:
+					self.set(parse_oid(oid), ASN_OCTET_STR, bytearray(mibname.encode("ascii")))
+				if len(fields) > 5:
+					oid = expand_c_string(fields[5], defines)
+					if oid:
+						self.set((1, 3, 6, 1, 2, 1, 1, 2, 0), ASN_OID, parse_oid(oid))
+				self.set((1, 3, 6, 1, 2, 1, 1, 1, 0), ASN_OCTET_STR, bytearray(("NUT SNMP simulator (%s)" % mibname).encode("ascii")))
+				return
+		sys.exit("mib2nut table %s not found in %s" % (mibname, srcdir))
+
+def expand_c_string(expr, defines, depth = 0):
+	"""evaluate a C string expression made of literals and macros"""
+	out = ""
+	for token in re.findall(r'"[^"]*"|\w+', expr):
+		if token.startswith('"'):
+			out += token[1:-1]
+		elif token in defines and depth < 8:
+			out += expand_c_string(defines[token], defines, depth + 1)
+		elif token == "NULL":
+			return None
+	return out
+
+def parse_walk_value(kind, text):
+	if kind == "INTEGER":
+		match = re.search(r'\((-?\d+)\)', text) or re.search(r'-?\d+', text)
+		return ASN_INTEGER, int(match.group(1) if match.groups() else match.group(0))
+	if kind in ("GAUGE32", "UNSIGNED32", "COUNTER32", "COUNTER64"):
+		tag = { "GAUGE32": ASN_GAUGE, "UNSIGNED32": ASN_GAUGE, "COUNTER32": ASN_COUNTER, "COUNTER64": ASN_COUNTER64 }[kind]
+		return tag, int(re.search(r'\d+', text).group(0))
+	if kind == "TIMETICKS":
+		return ASN_TIMETICKS, int(re.search(r'\d+', text).group(0))
+	if kind == "OID":
+		return ASN_OID, parse_oid(text)
+	if kind == "IPADDRESS":
+		return ASN_IPADDRESS, bytearray(int(byte) for byte in text.split("."))
+	if kind in ("HEX-STRING", "OPAQUE"):
+		tag = ASN_OPAQUE if kind == "OPAQUE" else ASN_OCTET_STR
+		return tag, bytearray(int(byte, 16) for byte in re.findall(r'[0-9A-Fa-f]{2}', text))
+	if kind == "NULL":
+		return ASN_NULL, None
+	# STRING, or an empty string ("")
+	if len(text) >= 2 and text.startswith('"') and text.endswith('"'):
+		text = text[1:-1]
+	elif text.startswith('"'):
+		text = text[1:]
+	return ASN_OCTET_STR, bytearray(text.encode("latin-1"))
+
+#
+# Agent
+#
+
+class Stats:
+
+	def __init__(self, gap):
+		self.gap = gap
+		self.requests = {}
+		self.varbinds = 0
+		self.dropped = 0
+		self.errors = 0
+		self.cycles = []	# [start, end, requests, varbinds]
+		self.last = 0
+
+	def account(self, pdu, varbinds, now):
+		self.requests[pdu] = self.requests.get(pdu, 0) + 1
+		self.varbinds += varbinds
+		if not self.cycles or now - self.last > self.gap:
+			self.cycles.append([now, now, 0, 0])
+		cycle = self.cycles[-1]
+		cycle[1] = now
+		cycle[2] += 1
+		cycle[3] += varbinds
+		self.last = now
+
+	def report(self, out):
+		total = sum(self.requests.values())
+		out.write("requests: %d (%s)\n" % (total,
+			", ".join("%s %d" % (PDU_NAMES[pdu], count) for pdu, count in sorted(self.requests.items()))))
+		out.write("varbinds: %d\n" % self.varbinds)
+		out.write("dropped: %d\n" % self.dropped)
+		out.write("errors: %d\n" % self.errors)
+		if self.cycles:
+			first = self.cycles[0]
+			out.write("init: %d requests, %d varbinds, %.3f s\n" % (first[2], first[3], first[1] - first[0]))
+		# the last cycle may have been interrupted
+		cycles = self.cycles[1:-1]
+		out.write("cycles: %d\n" % len(cycles))
+		if cycles:
+			out.write("requests/cycle: %.1f\n" % (float(sum(c[2] for c in cycles)) / len(cycles)))
+			out.write("varbinds/cycle: %.1f\n" % (float(sum(c[3] for c in cycles)) / len(cycles)))
+			out.write("cycle time: %.3f s\n" % (sum(c[1] - c[0] for c in cycles) / len(cycles)))
+		out.flush()
+
+class Agent:
+
+	def __init__(self, db, community, latency, loss, maxvarbinds, stats):
+		self.db = db
+		self.community = bytearray(community.encode("ascii"))
+		self.latency = latency
+		self.loss = loss
+		self.maxvarbinds = maxvarbinds
+		self.stats = stats
+
+	def handle(self, data):
+		"""return the response to the request in data, or None"""
+		tag, message, pos = ber_decode(data)
+		items = ber_items(message)
+		version = decode_int(items[0][1])
+		community = items[1][1]
+		pdutype, pdu = items[2]
+
+		if version not in (0, 1) or community != self.community or pdutype not in PDU_NAMES:
+			self.stats.dropped += 1
+			return None
+
+		fields = ber_items(pdu)
+		reqid = decode_int(fields[0][1])
+		arg1 = decode_int(fields[1][1])
+		arg2 = decode_int(fields[2][1])
+		varbinds = []
+		for vbtag, vb in ber_items(fields[3][1]):
+			(otag, ocontent), (vtag, vcontent) = ber_items(vb)
+			varbinds.append((decode_oid(ocontent), vtag, vcontent))
+
+		self.stats.account(pdutype, len(varbinds), time.time())
+
+		if self.loss and random.random() * 100 < self.loss:
+			self.stats.dropped += 1
+			return None
+
+		if pdutype == PDU_GETBULK and version == 0:
+			self.stats.dropped += 1
+			return None
+
+		status, index, results = self.process(version, pdutype, varbinds, arg1, arg2)
+
+		body = bytearray()
+		if status:
+			# error responses echo the request varbinds
+			self.stats.errors += 1
+			for oid, vtag, vcontent in varbinds:
+				body += ber_tlv(ASN_SEQUENCE, ber_oid(oid) + ber_tlv(vtag, vcontent))
+		else:
+			for oid, vtag, value in results:
+				body += ber_tlv(ASN_SEQUENCE, ber_oid(oid) + ber_value(vtag, value))
+
+		response = ber_int(reqid) + ber_int(status) + ber_int(index) + ber_tlv(ASN_SEQUENCE, body)
+		response = ber_int(version) + ber_value(ASN_OCTET_STR, community) + ber_tlv(PDU_RESPONSE, response)
+
+		if self.latency:
+			time.sleep(self.latency)
+
+		return ber_tlv(ASN_SEQUENCE, response)
+
+	def process(self, version, pdutype, varbinds, arg1, arg2):
+		"""return (error status, error index, result varbinds)"""
+		if self.maxvarbinds and pdutype != PDU_GETBULK and len(varbinds) > self.maxvarbinds:
+			return ERR_TOOBIG, 0, []
+
+		results = []
+
+		if pdutype == PDU_GETBULK:
+			nonrep = max(0, min(arg1, len(varbinds)))
+			for i, (oid, vtag, vcontent) in enumerate(varbinds[:nonrep]):
+				results.append(self.lookup_next(version, oid))
+			repeaters = [oid for oid, vtag, vcontent in varbinds[nonrep:]]
+			for rep in range(max(0, arg2)):
+				if not repeaters:
+					break
+				row = [self.lookup_next(version, oid) for oid in repeaters]
+				results += row
+				repeaters = [oid for oid, vtag, value in row]
+				if all(vtag == SNMP_ENDOFMIBVIEW for oid, vtag, value in row):
+					break
+			if self.maxvarbinds:
+				results = results[:self.maxvarbinds]
+			return 0, 0, results
+
+		for i, (oid, vtag, vcontent) in enumerate(varbinds):
+			if pdutype == PDU_GET:
+				entry = self.db.get(oid)
+				if entry is None:
+					if version == 0:
+						return ERR_NOSUCHNAME, i + 1, []
+					results.append((oid, SNMP_NOSUCHOBJECT, None))
+				else:
+					results.append((oid, entry[0], entry[1]))
+			elif pdutype == PDU_GETNEXT:
+				result = self.lookup_next(version, oid)
+				if result[1] == SNMP_ENDOFMIBVIEW and version == 0:
+					return ERR_NOSUCHNAME, i + 1, []
+				results.append(result)
+			else:
+				if self.db.get(oid) is None:
+					return (ERR_NOSUCHNAME if version == 0 else ERR_NOCREATION), i + 1, []
+				value = decode_value(vtag, vcontent)
+				self.db.set(oid, vtag, value)
+				results.append((oid, vtag, value))
+
+		return 0, 0, results
+
+	def lookup_next(self, version, oid):
+		nextoid = self.db.next(oid)
+		if nextoid is None:
+			return (oid, SNMP_ENDOFMIBVIEW, None)
+		tag, value = self.db.get(nextoid)
+		return (nextoid, tag, value)
+
+def usage():
+	print("Usage: nut-snmpsim.py [options] <walk file | -m mib>")
+	print("")
+	print("  -p <port>          UDP port to listen to on localhost (default: 16100)")
+	print("  -c <community>     community (default: public)")
+	print("  -m <mib>           synthesize a walk from this mib2nut table (ups.conf \"mibs\")")
+	print("  -s <srcdir>        directory of the mib2nut tables (default: ../drivers)")
+	print("  -i <instances>     instances of the indexed OIDs, with -m (default: 8)")
+	print("  -l <ms>            latency of each response, in milliseconds (default: 0)")
+	print("  -L <percent>       percentage of requests to drop (default: 0)")
+	print("  -V <varbinds>      max. varbinds per request (default: unlimited)")
+	print("  -g <seconds>       idle gap ending a poll cycle (default: 1)")
+	print("  -o <file>          write the statistics to this file on exit")
+
+def main():
+	try:
+		opts, args = getopt.getopt(sys.argv[1:], "hp:c:m:s:i:l:L:V:g:o:")
+	except getopt.GetoptError as err:
+		print(err)
+		usage()
+		sys.exit(2)
+
+	port = 16100
+	community = "public"
+	mib = None
+	srcdir = os.path.join(os.path.dirname(os.path.abspath(sys.argv[0])), "..", "drivers")
+	instances = 8
+	latency = 0.0
+	loss = 0.0
+	maxvarbinds = 0
+	gap = 1.0
+	statsfile = None
+
+	for opt, arg in opts:
+		if opt == "-h":
+			usage()
+			sys.exit(0)
+		elif opt == "-p":
+			port = int(arg)
+		elif opt == "-c":
+			community = arg
+		elif opt == "-m":
+			mib = arg
+		elif opt == "-s":
+			srcdir = arg
+		elif opt == "-i":
+			instances = int(arg)
+		elif opt == "-l":
+			latency = float(arg) / 1000
+		elif opt == "-L":
+			loss = float(arg)
+		elif opt == "-V":
+			maxvarbinds = int(arg)
+		elif opt == "-g":
+			gap = float(arg)
+		elif opt == "-o":
+			statsfile = arg
+
+	db = Database()
+	if mib:
+		db.load_mib2nut(srcdir, mib, instances)
+	elif len(args) == 1:
+		db.load_walk(args[0])
+	else:
+		usage()
+		sys.exit(2)
+
+	stats = Stats(gap)
+	agent = Agent(db, community, latency, loss, maxvarbinds, stats)
+
+	sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+	sock.bind(("127.0.0.1", port))
+
+	def report(signum, frame):
+		stats.report(sys.stdout)
+
+	def terminate(signum, frame):
+		if statsfile:
+			stats.report(open(statsfile, "w"))
+		else:
+			stats.report(sys.stdout)
+		sys.exit(0)
+
+	signal.signal(signal.SIGUSR1, report)
+	signal.signal(signal.SIGTERM, terminate)
+	signal.signal(signal.SIGINT, terminate)
+
+	sys.stderr.write("nut-snmpsim: serving %d OIDs on 127.0.0.1:%d\n" % (len(db.values), port))
+
+	while True:
+		try:
+			data, peer = sock.recvfrom(65535)
+		except socket.error as err:
+			# interrupted by SIGUSR1
+			if err.errno == errno.EINTR:
+				continue
+			raise
+		try:
+			response = agent.handle(bytearray(data))
+		except (ValueError, IndexError):
+			stats.dropped += 1
+			continue
+		if response is not None:
+			sock.sendto(bytes(response), peer)
+
+if __name__ == "__main__":
+	main()